@@ -0,0 +1,112 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compares the scalar, SSE4.2 and AVX2 scans of utils::ScanUtils inside the
+// request parser.
+//
+// Usage: bench_header_scan [seconds]
+//
+// For every instruction set this CPU supports, network::Request parses a
+// curl request and a browser request with long User-Agent and Cookie
+// headers, on one core. The speedup column is relative to scalar.
+
+#include "staxys/network/request.h"
+#include "staxys/utils/scan_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using staxys::network::Request;
+using staxys::utils::ScanUtils;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const std::string CURL_REQUEST = "GET /index.html HTTP/1.1\r\n"
+                                 "Host: localhost:8080\r\n"
+                                 "User-Agent: curl/8.5.0\r\n"
+                                 "Accept: */*\r\n"
+                                 "\r\n";
+
+const std::string BROWSER_REQUEST =
+    "GET /assets/css/site.min.css?v=20250112 HTTP/1.1\r\n"
+    "Host: www.example.com\r\n"
+    "Connection: keep-alive\r\n"
+    "sec-ch-ua: \"Chromium\";v=\"131\", \"Not_A Brand\";v=\"24\"\r\n"
+    "sec-ch-ua-mobile: ?0\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/131.0.0.0 "
+    "Safari/537.36\r\n"
+    "sec-ch-ua-platform: \"Linux\"\r\n"
+    "Accept: text/css,*/*;q=0.1\r\n"
+    "Sec-Fetch-Site: same-origin\r\n"
+    "Sec-Fetch-Mode: no-cors\r\n"
+    "Sec-Fetch-Dest: style\r\n"
+    "Referer: https://www.example.com/blog/2025/01/a-fairly-long-article-title\r\n"
+    "Accept-Encoding: gzip, deflate, br, zstd\r\n"
+    "Accept-Language: en-GB,en-US;q=0.9,en;q=0.8\r\n"
+    "Cookie: session=4f6c2a9e1b7d4c3a8e5f0b2d9c6a1e3f; theme=dark; consent=1; "
+    "_ga=GA1.1.1234567890.1736676000; _ga_ABCDEF1234=GS1.1.1736676000.1.1.1736676100.0.0.0\r\n"
+    "If-None-Match: \"6789abcd-1f40\"\r\n"
+    "If-Modified-Since: Sun, 12 Jan 2025 10:00:00 GMT\r\n"
+    "\r\n";
+
+/// Parses \p text repeatedly for \p seconds.
+/// \return Requests parsed per second.
+double measure(const std::string &text, const double seconds) {
+  Request request;
+  uint64_t parsed = 0;
+  auto started = Clock::now();
+  auto deadline = started + std::chrono::duration<double>(seconds);
+  while (Clock::now() < deadline) {
+    for (int i = 0; i < 1000; ++i) {
+      request.reset();
+      parsed += request.parse(text) == Request::Status::COMPLETE ? 1 : 0;
+    }
+  }
+  return static_cast<double>(parsed) / std::chrono::duration<double>(Clock::now() - started).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  double seconds = argc > 1 ? std::max(std::atof(argv[1]), 0.1) : 2.0;
+  auto detected = ScanUtils::active_isa();
+
+  std::printf("detected: %s\n", ScanUtils::isa_name(detected));
+  std::printf("%-8s %-8s %14s %12s %8s\n", "request", "isa", "requests/s", "MiB/s", "speedup");
+
+  for (const auto &[name, text] : {std::pair{"curl", &CURL_REQUEST}, std::pair{"browser", &BROWSER_REQUEST}}) {
+    double scalar = 0;
+    for (auto isa : {ScanUtils::Isa::SCALAR, ScanUtils::Isa::SSE42, ScanUtils::Isa::AVX2}) {
+      if (!ScanUtils::use_isa(isa)) {
+        std::printf("%-8s %-8s %14s\n", name, ScanUtils::isa_name(isa), "unsupported");
+        continue;
+      }
+      auto rate = measure(*text, seconds);
+      if (isa == ScanUtils::Isa::SCALAR) {
+        scalar = rate;
+      }
+      std::printf("%-8s %-8s %14.0f %12.1f %7.2fx\n", name, ScanUtils::isa_name(isa), rate,
+                  rate * static_cast<double>(text->size()) / (1024.0 * 1024.0), rate / scalar);
+    }
+  }
+
+  ScanUtils::use_isa(detected);
+  return EXIT_SUCCESS;
+}
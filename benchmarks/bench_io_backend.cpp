@@ -0,0 +1,201 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compares the epoll and io_uring event loops serving the same request.
+//
+// Usage: bench_io_backend [path] [connections] [seconds] [static_root] [cache]
+//
+// For each backend a Server is started in-process on a loopback port and
+// driven by keep-alive client connections, one thread each, that send one
+// request at a time. Reported are requests per second and the p50/p99
+// round-trip latency. Passing "cache" as the last argument serves the files
+// from the in-memory cache instead of with sendfile.
+
+#include "staxys/config/engine_config.h"
+#include "staxys/network/server.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int BASE_PORT = 18600;
+
+struct Result {
+  uint64_t requests = 0;
+  uint64_t errors = 0;
+  std::vector<uint32_t> latencies_us;
+};
+
+int connect_to(const int port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(static_cast<uint16_t>(port));
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+    close(fd);
+    return -1;
+  }
+  int enable = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+  return fd;
+}
+
+/// Reads one response (head plus Content-Length body) from \p fd.
+bool read_response(const int fd, std::string &buffer) {
+  buffer.clear();
+  std::size_t body_length = 0;
+  std::size_t head_length = std::string::npos;
+  char chunk[16 * 1024];
+  while (head_length == std::string::npos || buffer.size() < head_length + body_length) {
+    auto received = recv(fd, chunk, sizeof(chunk), 0);
+    if (received <= 0) {
+      return false;
+    }
+    buffer.append(chunk, static_cast<std::size_t>(received));
+    if (head_length == std::string::npos) {
+      auto end = buffer.find("\r\n\r\n");
+      if (end == std::string::npos) {
+        continue;
+      }
+      head_length = end + 4;
+      auto header = buffer.find("Content-Length:");
+      if (header != std::string::npos && header < end) {
+        body_length = std::strtoull(buffer.c_str() + header + 15, nullptr, 10);
+      }
+    }
+  }
+  return true;
+}
+
+void run_client(const int port, const std::string &request, const std::atomic<bool> &running, Result &result) {
+  int fd = connect_to(port);
+  std::string buffer;
+  while (running.load(std::memory_order_relaxed)) {
+    if (fd < 0) {
+      ++result.errors;
+      fd = connect_to(port);
+      continue;
+    }
+    auto started = Clock::now();
+    if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size()) ||
+        !read_response(fd, buffer)) {
+      ++result.errors;
+      close(fd);
+      fd = connect_to(port);
+      continue;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - started);
+    result.latencies_us.push_back(static_cast<uint32_t>(elapsed.count()));
+    ++result.requests;
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+}
+
+uint32_t percentile(const std::vector<uint32_t> &sorted, const double fraction) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  auto index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1));
+  return sorted[index];
+}
+
+void run_backend(const std::string &backend, const int port, const std::string &path, const int connections,
+                 const int seconds, const std::string &static_root, const bool cache) {
+  auto config = std::make_shared<staxys::config::EngineConfig>();
+  config->listen_ports({"127.0.0.1:" + std::to_string(port)});
+  config->io_backend(backend);
+  config->worker_connections(connections + 16);
+  if (!static_root.empty()) {
+    config->server_static_root(static_root);
+  }
+  config->cache_enabled(cache);
+
+  staxys::network::Server server(config);
+  if (!server.listen()) {
+    std::fprintf(stderr, "%s: failed to listen on port %d\n", backend.c_str(), port);
+    return;
+  }
+  std::thread server_thread([&server] { server.run(); });
+
+  auto request = "GET " + path + " HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: keep-alive\r\n\r\n";
+  std::atomic<bool> running{true};
+  std::vector<Result> results(static_cast<std::size_t>(connections));
+  std::vector<std::thread> clients;
+  for (auto &result : results) {
+    clients.emplace_back(run_client, port, std::cref(request), std::cref(running), std::ref(result));
+  }
+
+  auto started = Clock::now();
+  std::this_thread::sleep_for(std::chrono::seconds(seconds));
+  running.store(false, std::memory_order_relaxed);
+  for (auto &client : clients) {
+    client.join();
+  }
+  auto elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+
+  server.stop();
+  server_thread.join();
+
+  Result total;
+  for (auto &result : results) {
+    total.requests += result.requests;
+    total.errors += result.errors;
+    total.latencies_us.insert(total.latencies_us.end(), result.latencies_us.begin(), result.latencies_us.end());
+  }
+  std::sort(total.latencies_us.begin(), total.latencies_us.end());
+
+  std::printf("%-10s %12.0f %10u %10u %10llu\n", backend.c_str(), static_cast<double>(total.requests) / elapsed,
+              percentile(total.latencies_us, 0.50), percentile(total.latencies_us, 0.99),
+              static_cast<unsigned long long>(total.errors));
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::string path = argc > 1 ? argv[1] : "/index.html";
+  int connections = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 16;
+  int seconds = argc > 3 ? std::max(std::atoi(argv[3]), 1) : 5;
+  std::string static_root = argc > 4 ? argv[4] : "";
+  bool cache = argc > 5 && std::strcmp(argv[5], "cache") == 0;
+
+  std::printf("GET %s, %d connections, %d s per backend%s\n", path.c_str(), connections, seconds,
+              cache ? ", in-memory cache" : "");
+  std::printf("%-10s %12s %10s %10s %10s\n", "backend", "req/s", "p50 (us)", "p99 (us)", "errors");
+
+  auto port = BASE_PORT;
+  for (const auto *backend : {"epoll", "io_uring"}) {
+    run_backend(backend, port++, path, connections, seconds, static_root, cache);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compares the perfect hash lookup of utils::MimeTypes with the linear scan
+// over a table of extensions that FileUtils::mime_type used to do.
+//
+// Usage: bench_mime_types [seconds]
+//
+// Both look up the types of a mix of request paths, most of them common web
+// formats, some in upper case and some unknown, on one core.
+
+#include "staxys/utils/mime_types.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <utility>
+
+using staxys::utils::MimeTypes;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const std::string_view PATHS[] = {
+    "/index.html",
+    "/css/site.min.css",
+    "/js/app.js",
+    "/img/logo.png",
+    "/img/hero.JPG",
+    "/fonts/inter.woff2",
+    "/favicon.ico",
+    "/api/data.json",
+    "/docs/README",
+    "/video/intro.webm",
+    "/downloads/tool.tgz",
+    "/img/icons.svg",
+    "/js/app.js.map",
+    "/robots.txt",
+    "/img/photo.avif",
+    "/sitemap.xml",
+    "/assets/module.mjs",
+    "/archive.tar.gz",
+    "/site.webmanifest",
+    "/audio/theme.ogg",
+};
+
+const std::pair<std::string_view, std::string_view> LINEAR_TYPES[] = {
+    {"html", "text/html; charset=utf-8"},
+    {"htm", "text/html; charset=utf-8"},
+    {"css", "text/css; charset=utf-8"},
+    {"js", "text/javascript; charset=utf-8"},
+    {"mjs", "text/javascript; charset=utf-8"},
+    {"json", "application/json"},
+    {"map", "application/json"},
+    {"webmanifest", "application/manifest+json"},
+    {"txt", "text/plain; charset=utf-8"},
+    {"md", "text/markdown; charset=utf-8"},
+    {"csv", "text/csv; charset=utf-8"},
+    {"xml", "application/xml"},
+    {"svg", "image/svg+xml"},
+    {"png", "image/png"},
+    {"jpg", "image/jpeg"},
+    {"jpeg", "image/jpeg"},
+    {"gif", "image/gif"},
+    {"webp", "image/webp"},
+    {"avif", "image/avif"},
+    {"ico", "image/x-icon"},
+    {"woff", "font/woff"},
+    {"woff2", "font/woff2"},
+    {"ttf", "font/ttf"},
+    {"otf", "font/otf"},
+    {"wasm", "application/wasm"},
+    {"pdf", "application/pdf"},
+    {"zip", "application/zip"},
+    {"gz", "application/gzip"},
+    {"mp4", "video/mp4"},
+    {"webm", "video/webm"},
+    {"mp3", "audio/mpeg"},
+    {"ogg", "audio/ogg"},
+    {"wav", "audio/wav"},
+};
+
+/// The lookup as FileUtils::mime_type did it before the perfect hash.
+std::string_view linear_lookup(const std::string_view path) {
+  auto dot = path.rfind('.');
+  auto slash = path.rfind('/');
+  if (dot == std::string_view::npos || (slash != std::string_view::npos && dot < slash)) {
+    return "application/octet-stream";
+  }
+  auto extension = path.substr(dot + 1);
+  for (const auto &[name, type] : LINEAR_TYPES) {
+    if (name.size() != extension.size()) {
+      continue;
+    }
+    bool equal = true;
+    for (std::size_t i = 0; i < name.size() && equal; ++i) {
+      equal = name[i] == std::tolower(static_cast<unsigned char>(extension[i]));
+    }
+    if (equal) {
+      return type;
+    }
+  }
+  return "application/octet-stream";
+}
+
+/// Runs \p lookup over PATHS for \p seconds.
+/// \return Lookups per second.
+template <typename Lookup> double measure(Lookup lookup, const double seconds) {
+  std::size_t total = 0;
+  uint64_t lookups = 0;
+  auto started = Clock::now();
+  auto deadline = started + std::chrono::duration<double>(seconds);
+  while (Clock::now() < deadline) {
+    for (int i = 0; i < 1000; ++i) {
+      for (auto path : PATHS) {
+        total += lookup(path).size();
+      }
+    }
+    lookups += 1000 * std::size(PATHS);
+  }
+  auto elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+  // Keeps the lookups from being optimized away.
+  if (total == 0) {
+    std::printf("no lookups\n");
+  }
+  return static_cast<double>(lookups) / elapsed;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  double seconds = argc > 1 ? std::max(std::atof(argv[1]), 0.1) : 2.0;
+
+  auto linear = measure(linear_lookup, seconds);
+  auto hashed = measure([](std::string_view path) { return MimeTypes::for_path(path).header; }, seconds);
+
+  std::printf("%-14s %16s %8s\n", "lookup", "lookups/s", "speedup");
+  std::printf("%-14s %16.0f %7.2fx\n", "linear", linear, 1.0);
+  std::printf("%-14s %16.0f %7.2fx\n", "perfect hash", hashed, hashed / linear);
+  return EXIT_SUCCESS;
+}
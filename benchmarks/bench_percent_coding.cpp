@@ -0,0 +1,92 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures utils::UriUtils percent-encoding and decoding against memcpy.
+//
+// Usage: bench_percent_coding [seconds]
+//
+// Each input is decoded into a separate buffer, decoded in place (from a
+// fresh copy each time, which the memcpy column also pays for) and encoded,
+// on one core with the instruction set ScanUtils picked for this CPU.
+
+#include "staxys/utils/scan_utils.h"
+#include "staxys/utils/uri_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using staxys::utils::ScanUtils;
+using staxys::utils::UriUtils;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const std::string INPUTS[] = {
+    "/assets/css/site.min.css",
+    "/blog/2025/01/a-fairly-long-article-title-that-goes-on-for-a-while/images/header-photo-large.webp",
+    "/files/Annual%20Report%202024%20%28final%29.pdf",
+    "/%E6%97%A5%E6%9C%AC%E8%AA%9E/%E3%83%86%E3%82%B9%E3%83%88.html",
+};
+
+/// Runs \p operation repeatedly for \p seconds.
+/// \return Megabytes of input handled per second.
+template <typename Operation> double measure(const std::size_t size, const double seconds, Operation operation) {
+  uint64_t done = 0;
+  std::size_t sink = 0;
+  auto started = Clock::now();
+  auto deadline = started + std::chrono::duration<double>(seconds);
+  while (Clock::now() < deadline) {
+    for (int i = 0; i < 1000; ++i) {
+      sink += operation();
+      ++done;
+    }
+  }
+  auto elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+  if (sink == 0) {
+    std::printf("no output\n");
+  }
+  return static_cast<double>(done * size) / elapsed / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  double seconds = argc > 1 ? std::max(std::atof(argv[1]), 0.1) : 1.0;
+  std::printf("isa: %s\n", ScanUtils::isa_name(ScanUtils::active_isa()));
+  std::printf("%5s %10s %10s %10s %10s   (MiB/s of input)\n", "bytes", "memcpy", "decode", "in place", "encode");
+
+  for (const auto &input : INPUTS) {
+    std::vector<char> buffer(input.size() * 3);
+    auto copy = measure(input.size(), seconds, [&] {
+      std::memcpy(buffer.data(), input.data(), input.size());
+      asm volatile("" : : "r"(buffer.data()) : "memory");
+      return input.size();
+    });
+    auto decode = measure(input.size(), seconds, [&] { return UriUtils::decode(input, buffer.data()); });
+    auto in_place = measure(input.size(), seconds, [&] {
+      std::memcpy(buffer.data(), input.data(), input.size());
+      return UriUtils::decode(std::string_view(buffer.data(), input.size()), buffer.data());
+    });
+    auto encode = measure(input.size(), seconds, [&] { return UriUtils::encode(input, buffer.data()); });
+    std::printf("%5zu %10.0f %10.0f %10.0f %10.0f\n", input.size(), copy, decode, in_place, encode);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures network::Request on a single core.
+//
+// Usage: bench_request_parser [seconds]
+//
+// Each case parses the same request over and over and reports parsed
+// requests per second and throughput. "split" feeds the browser request in
+// three reads, "pipelined" parses 16 back-to-back requests from one buffer.
+
+#include "staxys/network/request.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using staxys::network::Request;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const std::string CURL_REQUEST = "GET /index.html HTTP/1.1\r\n"
+                                 "Host: localhost:8080\r\n"
+                                 "User-Agent: curl/8.5.0\r\n"
+                                 "Accept: */*\r\n"
+                                 "\r\n";
+
+const std::string BROWSER_REQUEST =
+    "GET /assets/css/site.min.css?v=20250112 HTTP/1.1\r\n"
+    "Host: www.example.com\r\n"
+    "Connection: keep-alive\r\n"
+    "sec-ch-ua: \"Chromium\";v=\"131\", \"Not_A Brand\";v=\"24\"\r\n"
+    "sec-ch-ua-mobile: ?0\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/131.0.0.0 "
+    "Safari/537.36\r\n"
+    "sec-ch-ua-platform: \"Linux\"\r\n"
+    "Accept: text/css,*/*;q=0.1\r\n"
+    "Sec-Fetch-Site: same-origin\r\n"
+    "Sec-Fetch-Mode: no-cors\r\n"
+    "Sec-Fetch-Dest: style\r\n"
+    "Referer: https://www.example.com/blog/2025/01/a-fairly-long-article-title\r\n"
+    "Accept-Encoding: gzip, deflate, br, zstd\r\n"
+    "Accept-Language: en-GB,en-US;q=0.9,en;q=0.8\r\n"
+    "Cookie: session=4f6c2a9e1b7d4c3a8e5f0b2d9c6a1e3f; theme=dark; consent=1\r\n"
+    "If-None-Match: \"6789abcd-1f40\"\r\n"
+    "If-Modified-Since: Sun, 12 Jan 2025 10:00:00 GMT\r\n"
+    "\r\n";
+
+/// Calls \p body (which parses some requests and returns how many) until
+/// \p seconds have passed, then prints the rate.
+template <typename Body>
+void run_case(const char *name, const std::size_t bytes_per_call, const double seconds, Body body) {
+  uint64_t requests = 0;
+  uint64_t calls = 0;
+  auto started = Clock::now();
+  auto deadline = started + std::chrono::duration<double>(seconds);
+  while (Clock::now() < deadline) {
+    for (int i = 0; i < 1000; ++i) {
+      requests += body();
+    }
+    calls += 1000;
+  }
+  auto elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+  std::printf("%-12s %14.0f %12.1f\n", name, static_cast<double>(requests) / elapsed,
+              static_cast<double>(calls * bytes_per_call) / elapsed / (1024.0 * 1024.0));
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  double seconds = argc > 1 ? std::max(std::atof(argv[1]), 0.1) : 2.0;
+  Request request;
+
+  std::printf("%-12s %14s %12s\n", "case", "requests/s", "MiB/s");
+
+  run_case("curl", CURL_REQUEST.size(), seconds, [&request] {
+    request.reset();
+    return request.parse(CURL_REQUEST) == Request::Status::COMPLETE ? 1 : 0;
+  });
+
+  run_case("browser", BROWSER_REQUEST.size(), seconds, [&request] {
+    request.reset();
+    return request.parse(BROWSER_REQUEST) == Request::Status::COMPLETE ? 1 : 0;
+  });
+
+  std::string_view browser(BROWSER_REQUEST);
+  run_case("split", BROWSER_REQUEST.size(), seconds, [&request, browser] {
+    request.reset();
+    request.parse(browser.substr(0, 100));
+    request.parse(browser.substr(0, 400));
+    return request.parse(browser) == Request::Status::COMPLETE ? 1 : 0;
+  });
+
+  std::string pipelined;
+  for (int i = 0; i < 16; ++i) {
+    pipelined += BROWSER_REQUEST;
+  }
+  run_case("pipelined", pipelined.size(), seconds, [&request, &pipelined] {
+    std::string_view remaining(pipelined);
+    int parsed = 0;
+    while (!remaining.empty()) {
+      request.reset();
+      if (request.parse(remaining) != Request::Status::COMPLETE) {
+        break;
+      }
+      remaining.remove_prefix(request.size());
+      ++parsed;
+    }
+    return parsed;
+  });
+
+  return EXIT_SUCCESS;
+}
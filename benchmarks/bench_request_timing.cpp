@@ -0,0 +1,94 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures what timing the phases of a request costs the worker: the clock
+// reads and histogram records Server::process and Connection::advance_output
+// make for each request, once with CycleClock and once with clock_gettime.
+//
+// Usage: bench_request_timing [seconds]
+//
+// A request reads the clock at most three times: once for the event loop
+// wakeup that delivers it, whose reading also stands in for its accept and
+// its completed send, and once each when it is parsed and handled. Here
+// every request has a wakeup of its own, the worst case. It records the
+// receive, handle, send and total phases into the histograms of a
+// WorkerMetrics, on one core.
+
+#include "staxys/core/cycle_clock.h"
+#include "staxys/core/metrics.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+
+using staxys::core::CycleClock;
+using staxys::core::WorkerMetrics;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t monotonic_ns() {
+  timespec now{};
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000 + static_cast<uint64_t>(now.tv_nsec);
+}
+
+/// Times requests with \p now into \p metrics for \p seconds.
+/// \return Nanoseconds per request.
+template <typename Now> double measure(Now now, WorkerMetrics &metrics, const double seconds) {
+  uint64_t requests = 0;
+  auto started = Clock::now();
+  auto deadline = started + std::chrono::duration<double>(seconds);
+  while (Clock::now() < deadline) {
+    for (int i = 0; i < 10000; ++i) {
+      auto received_at = now();
+      auto parsed_at = now();
+      metrics.time(WorkerMetrics::RECEIVE, parsed_at - received_at);
+      auto handled_at = now();
+      metrics.time(WorkerMetrics::HANDLE, handled_at - parsed_at);
+      // Sent in the same wakeup, which counts as taking no time.
+      auto sent_at = std::max(received_at, handled_at);
+      metrics.time(WorkerMetrics::SEND, sent_at - handled_at);
+      metrics.time(WorkerMetrics::TOTAL, sent_at - received_at);
+    }
+    requests += 10000;
+  }
+  auto elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+  return elapsed * 1e9 / static_cast<double>(requests);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  double seconds = argc > 1 ? std::max(std::atof(argv[1]), 0.1) : 2.0;
+  CycleClock::calibrate();
+  auto metrics = std::make_unique<WorkerMetrics>();
+
+  auto monotonic = measure(monotonic_ns, *metrics, seconds);
+  auto cycles = measure(CycleClock::now, *metrics, seconds);
+
+  std::printf("counter: %s\n", CycleClock::tsc() ? "tsc" : "CLOCK_MONOTONIC");
+  std::printf("%-16s %14s\n", "clock", "ns/request");
+  std::printf("%-16s %14.1f\n", "clock_gettime", monotonic);
+  std::printf("%-16s %14.1f\n", "CycleClock", cycles);
+  std::printf("total p50 %.0f ns, p99.9 %.0f ns\n",
+              static_cast<double>(CycleClock::to_ns(metrics->phases[WorkerMetrics::TOTAL].quantile(0.5))),
+              static_cast<double>(CycleClock::to_ns(metrics->phases[WorkerMetrics::TOTAL].quantile(0.999))));
+  return EXIT_SUCCESS;
+}
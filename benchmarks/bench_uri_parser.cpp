@@ -0,0 +1,94 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compares utils::UriUtils::parse with the std::regex parser it replaced.
+//
+// Usage: bench_uri_parser [seconds]
+//
+// Each URI is parsed over and over on one core by the old regex parser (a
+// new std::regex per call and an "http://" prefix added by concatenation),
+// by the UriView overload and by the UriComponents wrapper. The speedup
+// columns are relative to regex.
+
+#include "staxys/utils/uri_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <regex>
+#include <string>
+
+using staxys::utils::UriUtils;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const std::string URIS[] = {
+    "/index.html",
+    "www.example.com:8080/path/to/resource?query=param",
+    "https://www.example.com/assets/css/site.min.css?v=20250112&theme=dark#main",
+};
+
+/// The parser before the rewrite, kept to measure against.
+bool regex_parse(const std::string &uri, UriUtils::UriComponents &components) {
+  std::string uri_temp = uri;
+  if (uri_temp.find("://") == std::string::npos) {
+    uri_temp = "http://" + uri_temp;
+  }
+  std::smatch match;
+  std::regex uri_regex(R"(^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?)");
+  if (!std::regex_match(uri_temp, match, uri_regex)) {
+    return false;
+  }
+  components.scheme = match[2].str();
+  components.host = match[4].str();
+  components.path = match[5].length() == 0 ? "/" : match[5].str();
+  components.fragment = match[9].str();
+  return true;
+}
+
+/// Runs \p parse repeatedly for \p seconds.
+/// \return Parses per second.
+template <typename Parse> double measure(const double seconds, Parse parse) {
+  uint64_t parsed = 0;
+  auto started = Clock::now();
+  auto deadline = started + std::chrono::duration<double>(seconds);
+  while (Clock::now() < deadline) {
+    for (int i = 0; i < 1000; ++i) {
+      parsed += parse() ? 1 : 0;
+    }
+  }
+  return static_cast<double>(parsed) / std::chrono::duration<double>(Clock::now() - started).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  double seconds = argc > 1 ? std::max(std::atof(argv[1]), 0.1) : 2.0;
+  std::printf("%-76s %12s %12s %12s %9s %9s\n", "uri", "regex/s", "view/s", "components/s", "view", "comps");
+
+  for (const auto &uri : URIS) {
+    UriUtils::UriComponents components;
+    UriUtils::UriView view;
+    auto regex = measure(seconds, [&] { return regex_parse(uri, components); });
+    auto views = measure(seconds, [&] { return UriUtils::parse(uri, view); });
+    auto copies = measure(seconds, [&] { return UriUtils::parse(uri, components); });
+    std::printf("%-76s %12.0f %12.0f %12.0f %8.0fx %8.0fx\n", uri.c_str(), regex, views, copies, views / regex,
+                copies / regex);
+  }
+  return EXIT_SUCCESS;
+}
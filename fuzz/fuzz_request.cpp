@@ -0,0 +1,93 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Feeds arbitrary bytes to network::Request the way a connection does: in
+// chunks whose size comes from the first input byte, consuming pipelined
+// requests as they complete. Every request must parse the same as when the
+// whole input is given at once, and every slice must lie inside the buffer.
+
+#include "staxys/network/request.h"
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+using staxys::network::Request;
+
+namespace {
+
+void check_inside(const std::string_view slice, const std::string &buffer) {
+  if (slice.empty()) {
+    return;
+  }
+  if (slice.data() < buffer.data() || slice.data() + slice.size() > buffer.data() + buffer.size()) {
+    std::abort();
+  }
+}
+
+void check_request(const Request &request, const std::string &buffer) {
+  if (request.size() > buffer.size()) {
+    std::abort();
+  }
+  check_inside(request.method(), buffer);
+  check_inside(request.target(), buffer);
+  check_inside(request.version(), buffer);
+  check_inside(request.body(), buffer);
+  for (std::size_t i = 0; i < request.header_count(); ++i) {
+    check_inside(request.header(i).name, buffer);
+    check_inside(request.header(i).value, buffer);
+  }
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, std::size_t size) {
+  if (size == 0) {
+    return 0;
+  }
+  std::size_t chunk = data[0] % 32 + 1;
+  std::string input(reinterpret_cast<const char *>(data + 1), size - 1);
+
+  std::string buffer;
+  std::size_t offset = 0;
+  Request request(512, 16);
+  while (offset < input.size()) {
+    buffer.append(input, offset, chunk);
+    offset += chunk;
+
+    while (!buffer.empty()) {
+      auto status = request.parse(buffer);
+      if (status == Request::Status::INCOMPLETE) {
+        break;
+      }
+      if (status != Request::Status::COMPLETE) {
+        return 0;
+      }
+      check_request(request, buffer);
+
+      // The same bytes parsed in one go must give the same request.
+      Request whole(512, 16);
+      if (whole.parse(std::string_view(buffer).substr(0, request.size())) != Request::Status::COMPLETE ||
+          whole.target() != request.target() || whole.header_count() != request.header_count() ||
+          whole.keep_alive() != request.keep_alive()) {
+        std::abort();
+      }
+
+      buffer.erase(0, request.size());
+      request.reset();
+    }
+  }
+  return 0;
+}
@@ -17,6 +17,7 @@
 #ifndef STAXYS_ENGINE_CONFIG_H
 #define STAXYS_ENGINE_CONFIG_H
 
+#include <cstddef>
 #include <map>
 #include <string>
 #include <vector>
@@ -52,6 +53,18 @@ public:
   const std::string &access_log() const { return m_access_log; };
   void access_log(const std::string &access_log) { m_access_log = access_log; };
 
+  const std::size_t access_log_buffer() const { return m_access_log_buffer; };
+  void access_log_buffer(const std::size_t access_log_buffer) { m_access_log_buffer = access_log_buffer; };
+
+  const std::string &access_log_overflow() const { return m_access_log_overflow; };
+  void access_log_overflow(const std::string &access_log_overflow) { m_access_log_overflow = access_log_overflow; };
+
+  const int access_log_flush() const { return m_access_log_flush; };
+  void access_log_flush(const int access_log_flush) { m_access_log_flush = access_log_flush; };
+
+  const std::string &access_log_format() const { return m_access_log_format; };
+  void access_log_format(const std::string &access_log_format) { m_access_log_format = access_log_format; };
+
   const std::string &error_log() const { return m_error_log; };
   void error_log(const std::string &error_log) { m_error_log = error_log; };
 
@@ -73,11 +86,17 @@ public:
   const int worker_connections() const { return m_worker_connections; };
   void worker_connections(const int worker_connections) { m_worker_connections = worker_connections; };
 
+  const std::string &io_backend() const { return m_io_backend; };
+  void io_backend(const std::string &io_backend) { m_io_backend = io_backend; };
+
+  const std::size_t sendfile_max_chunk() const { return m_sendfile_max_chunk; };
+  void sendfile_max_chunk(const std::size_t sendfile_max_chunk) { m_sendfile_max_chunk = sendfile_max_chunk; };
+
   const bool http2_enabled() const { return m_http2_enabled; };
   void http2_enabled(const bool http2_enabled) { m_http2_enabled = http2_enabled; };
 
-  const std::string &client_max_body_size() const { return m_client_max_body_size; };
-  void client_max_body_size(const std::string &client_max_body_size) { m_client_max_body_size = client_max_body_size; };
+  std::size_t client_max_body_size() const { return m_client_max_body_size; }
+  void client_max_body_size(const std::size_t client_max_body_size) { m_client_max_body_size = client_max_body_size; }
 
   const int client_body_timeout() const { return m_client_body_timeout; };
   void client_body_timeout(const int client_body_timeout) { m_client_body_timeout = client_body_timeout; };
@@ -97,21 +116,53 @@ public:
   const bool enable_basic_auth() const { return m_enable_basic_auth; };
   void enable_basic_auth(const bool enable_basic_auth) { m_enable_basic_auth = enable_basic_auth; };
 
+  const std::string &static_watch() const { return m_static_watch; };
+  void static_watch(const std::string &static_watch) { m_static_watch = static_watch; };
+
   const bool cache_enabled() const { return m_cache_enabled; };
   void cache_enabled(const bool cache_enabled) { m_cache_enabled = cache_enabled; };
 
+  const std::size_t cache_max_size() const { return m_cache_max_size; };
+  void cache_max_size(const std::size_t cache_max_size) { m_cache_max_size = cache_max_size; };
+
+  const std::size_t cache_max_file_size() const { return m_cache_max_file_size; };
+  void cache_max_file_size(const std::size_t cache_max_file_size) { m_cache_max_file_size = cache_max_file_size; };
+
   const std::string &cache_path() const { return m_cache_path; };
   void cache_path(const std::string &cache_path) { m_cache_path = cache_path; };
 
   const int cache_duration() const { return m_cache_duration; };
   void cache_duration(const int cache_duration) { m_cache_duration = cache_duration; };
 
+  const bool compression_enabled() const { return m_compression_enabled; };
+  void compression_enabled(const bool compression_enabled) { m_compression_enabled = compression_enabled; };
+
+  const int compression_level() const { return m_compression_level; };
+  void compression_level(const int compression_level) { m_compression_level = compression_level; };
+
+  const std::size_t compression_min_size() const { return m_compression_min_size; };
+  void compression_min_size(const std::size_t compression_min_size) { m_compression_min_size = compression_min_size; };
+
+  const std::vector<std::string> &compression_types() const { return m_compression_types; };
+  void compression_types(const std::vector<std::string> &compression_types) {
+    m_compression_types = compression_types;
+  }
+
+  const std::size_t compression_contexts() const { return m_compression_contexts; };
+  void compression_contexts(const std::size_t compression_contexts) { m_compression_contexts = compression_contexts; };
+
   const bool health_check_enabled() const { return m_health_check_enabled; };
   void health_check_enabled(const bool health_check_enabled) { m_health_check_enabled = health_check_enabled; };
 
   const std::string &health_check_url() const { return m_health_check_url; };
   void health_check_url(const std::string &health_check_url) { m_health_check_url = health_check_url; };
 
+  const std::string &metrics_url() const { return m_metrics_url; };
+  void metrics_url(const std::string &metrics_url) { m_metrics_url = metrics_url; };
+
+  const bool request_timing() const { return m_request_timing; };
+  void request_timing(const bool request_timing) { m_request_timing = request_timing; };
+
 private:
   std::string m_user;
   std::string m_pid_file;
@@ -121,26 +172,44 @@ private:
   std::string m_default_error_page;
   std::map<int, std::string> m_error_pages;
   std::string m_access_log;
+  std::size_t m_access_log_buffer = 1024 * 1024;
+  std::string m_access_log_overflow = "block";
+  int m_access_log_flush = 1;
+  std::string m_access_log_format = "text";
   std::string m_error_log;
   std::string m_log_level;
-  bool m_ssl_enabled;
+  bool m_ssl_enabled = false;
   std::string m_ssl_cert;
   std::string m_ssl_key;
-  int m_worker_processes;
-  int m_worker_connections;
-  bool m_http2_enabled;
-  std::string m_client_max_body_size;
-  int m_client_body_timeout;
-  int m_send_timeout;
-  int m_keep_alive_timeout;
+  int m_worker_processes = 1;
+  int m_worker_connections = 1024;
+  std::string m_io_backend = "epoll";
+  std::size_t m_sendfile_max_chunk = 2 * 1024 * 1024;
+  bool m_http2_enabled = false;
+  std::size_t m_client_max_body_size = 1024 * 1024;
+  int m_client_body_timeout = 60;
+  int m_send_timeout = 60;
+  int m_keep_alive_timeout = 75;
   std::vector<std::string> m_allowed_ip;
   std::vector<std::string> m_denied_ip;
-  bool m_enable_basic_auth;
-  bool m_cache_enabled;
+  bool m_enable_basic_auth = false;
+  std::string m_static_watch = "inotify";
+  bool m_cache_enabled = false;
+  std::size_t m_cache_max_size = 64 * 1024 * 1024;
+  std::size_t m_cache_max_file_size = 256 * 1024;
   std::string m_cache_path;
-  int m_cache_duration;
-  bool m_health_check_enabled;
+  int m_cache_duration = 3600;
+  bool m_compression_enabled = false;
+  int m_compression_level = 6;
+  std::size_t m_compression_min_size = 1024;
+  std::vector<std::string> m_compression_types = {"text/html",       "text/css",         "text/plain",
+                                                   "text/javascript", "application/json", "application/xml",
+                                                   "image/svg+xml"};
+  std::size_t m_compression_contexts = 16;
+  bool m_health_check_enabled = false;
   std::string m_health_check_url;
+  std::string m_metrics_url;
+  bool m_request_timing = false;
 };
 } // namespace staxys::config
 
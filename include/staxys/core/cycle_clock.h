@@ -0,0 +1,76 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_CYCLE_CLOCK_H
+#define STAXYS_CYCLE_CLOCK_H
+
+#include <cstdint>
+#include <ctime>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace staxys::core {
+
+/// A monotonic clock read from the CPU's time stamp counter.
+/// \details now() is a single rdtsc, a few nanoseconds where a clock_gettime
+///          costs some twenty, which is cheap enough to time every phase of
+///          every request. Ticks are turned into nanoseconds with a scale
+///          measured against CLOCK_MONOTONIC by calibrate(). Where the
+///          counter does not tick at a constant rate across cores and
+///          power states, or on other architectures, ticks are nanoseconds
+///          of CLOCK_MONOTONIC instead.
+class CycleClock {
+public:
+  static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    if (s_tsc) {
+      return __rdtsc();
+    }
+#endif
+    timespec time{};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000 + static_cast<uint64_t>(time.tv_nsec);
+  }
+
+  /// Measures the rate of the counter, once per process; forked children
+  /// inherit it. Takes about CALIBRATION_MS the first time.
+  static void calibrate();
+
+  static uint64_t to_ns(uint64_t ticks) {
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(ticks) * s_ns_per_tick) >> SCALE_BITS);
+  }
+
+  static uint64_t from_ns(uint64_t ns) {
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(ns) << SCALE_BITS) / s_ns_per_tick);
+  }
+
+  /// Whether now() reads the time stamp counter.
+  static bool tsc() { return s_tsc; }
+
+  static constexpr int CALIBRATION_MS = 20;
+
+private:
+  static constexpr unsigned SCALE_BITS = 32;
+
+  static inline bool s_tsc = false;
+  // Nanoseconds per tick as a fixed-point number with SCALE_BITS fraction bits.
+  static inline uint64_t s_ns_per_tick = uint64_t{1} << SCALE_BITS;
+};
+
+} // namespace staxys::core
+
+#endif // STAXYS_CYCLE_CLOCK_H
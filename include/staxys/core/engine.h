@@ -18,6 +18,7 @@
 #define STAXYS_ENGINE_H
 
 #include "staxys/config/engine_config.h"
+#include "staxys/core/server_manager.h"
 #include <csignal>
 #include <memory>
 
@@ -34,9 +35,10 @@ public:
 
 private:
   int main_task();
-  bool m_is_running = false;
+  volatile std::sig_atomic_t m_is_running = false;
   bool m_is_daemon = false;
   std::shared_ptr<const staxys::config::EngineConfig> m_config;
+  std::unique_ptr<ServerManager> m_server_manager;
 };
 
 struct EngineSignalData {
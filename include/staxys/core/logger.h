@@ -17,6 +17,156 @@
 #ifndef STAXYS_LOGGER_H
 #define STAXYS_LOGGER_H
 
-// TODO: Implement Logger
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace staxys::core {
+
+/// The leveled log of the server's own messages, which goes to the error log.
+/// \details Messages are written with STAXYS_LOG, which compares the level
+///          before anything is formatted, so disabled messages cost a relaxed
+///          load. Every STAXYS_LOG in the code is a call site of its own: a
+///          message identical to the last one written from its site is only
+///          counted, and a site writes at most LINES_PER_SECOND lines a
+///          second, the rest being counted too. The counts are written as
+///          "last message repeated N times" and "N messages suppressed" once
+///          the site logs in a later second, or by the error log's writer
+///          within about a second, so a flood of per-request errors turns
+///          into a line or two a second. Lines go to a logging::ErrorLog,
+///          which writes them from a background thread once start()ed.
+class Logger {
+public:
+  /// VERBOSE is the level named "debug"; DEBUG itself is a macro in debug builds.
+  enum class Level : int { VERBOSE, INFO, WARNING, ERROR, OFF };
+
+  /// Where in the code a message comes from, with what that site has held back.
+  class Site {
+  public:
+    Site(const char *file, int line);
+
+  private:
+    friend class Logger;
+
+    const char *m_file;
+    int m_line;
+    Site *m_next = nullptr;
+    Level m_level = Level::INFO;
+    bool m_has_last = false;
+    uint64_t m_last_hash = 0;
+    uint64_t m_repeated = 0;
+    uint64_t m_suppressed = 0;
+    int64_t m_second = 0;
+    unsigned m_lines = 0;
+  };
+
+  struct Stats {
+    uint64_t lines = 0;
+    uint64_t repeated = 0;
+    uint64_t suppressed = 0;
+    uint64_t dropped = 0;
+  };
+
+  /// Lines a call site writes per second at most.
+  static constexpr unsigned LINES_PER_SECOND = 10;
+  /// Longer messages are cut short.
+  static constexpr std::size_t MAX_MESSAGE = 1024;
+
+  static bool enabled(Level level) { return level >= s_level.load(std::memory_order_relaxed); }
+  static Level level() { return s_level.load(std::memory_order_relaxed); }
+  static void set_level(Level level) { s_level.store(level, std::memory_order_relaxed); }
+
+  /// The level named by a log_level setting: "debug", "info", "warn",
+  /// "error" or "off".
+  /// \return false for an unknown name, leaving \p level unchanged.
+  static bool parse_level(std::string_view name, Level &level);
+
+  static std::string_view level_name(Level level);
+
+  /// Sends the lines from now on to the file at \p path, or to stderr if it
+  /// is empty. Not safe while other threads log.
+  /// \return false if the file could not be opened; lines then go to stderr.
+  static bool open(const std::string &path);
+
+  /// Starts writing from a background thread; called again in a forked
+  /// child, which has no thread of its parent's.
+  static bool start();
+
+  /// Writes out the held-back counts and what is buffered, and joins the thread.
+  static void stop();
+
+  /// Reopens the error log after rotation. Async-signal-safe.
+  static void reopen();
+
+  static Stats stats();
+
+  /// Writes \p message from \p site unless it is held back; STAXYS_LOG calls it.
+  static void write(Level level, Site &site, std::string_view message);
+
+  /// Writes the counts of sites that have held messages back since an
+  /// earlier second.
+  static void flush_sites();
+
+private:
+  /// Writes the counts \p site has held back and clears them. Called with
+  /// the sites locked.
+  static void write_counts(Site &site);
+
+  static inline std::atomic<Level> s_level{Level::INFO};
+};
+
+/// One message, formatted into inline storage and written when destroyed.
+class LogMessage {
+public:
+  LogMessage(Logger::Level level, Logger::Site &site) : m_level(level), m_site(site) {}
+  ~LogMessage() { Logger::write(m_level, m_site, {m_text, m_length}); }
+
+  LogMessage(const LogMessage &) = delete;
+  LogMessage &operator=(const LogMessage &) = delete;
+
+  LogMessage &operator<<(std::string_view text);
+  LogMessage &operator<<(const char *text) { return *this << std::string_view(text ? text : "(null)"); }
+  LogMessage &operator<<(const std::string &text) { return *this << std::string_view(text); }
+  LogMessage &operator<<(char c) { return *this << std::string_view(&c, 1); }
+  LogMessage &operator<<(bool value) { return *this << (value ? "true" : "false"); }
+  LogMessage &operator<<(double value);
+
+  template <typename T>
+    requires std::is_integral_v<T>
+  LogMessage &operator<<(T value) {
+    char digits[24];
+    auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    return *this << std::string_view(digits, static_cast<std::size_t>(end - digits));
+  }
+
+private:
+  Logger::Level m_level;
+  Logger::Site &m_site;
+  std::size_t m_length = 0;
+  char m_text[Logger::MAX_MESSAGE];
+};
+
+/// Gives the message expression of STAXYS_LOG the type void.
+struct LogVoidify {
+  void operator&(const LogMessage &) const {}
+};
+
+} // namespace staxys::core
+
+/// Logs what is streamed into it at \p level (VERBOSE, INFO, WARNING or
+/// ERROR), e.g. STAXYS_LOG(ERROR) << "Failed to bind " << address; nothing
+/// after the level is evaluated if the level is disabled.
+#define STAXYS_LOG(level)                                                                                              \
+  !::staxys::core::Logger::enabled(::staxys::core::Logger::Level::level)                                               \
+      ? static_cast<void>(0)                                                                                           \
+      : ::staxys::core::LogVoidify() &                                                                                 \
+            ::staxys::core::LogMessage(::staxys::core::Logger::Level::level, []() -> ::staxys::core::Logger::Site & {  \
+              static ::staxys::core::Logger::Site site(__FILE__, __LINE__);                                            \
+              return site;                                                                                             \
+            }())
 
 #endif // STAXYS_LOGGER_H
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_METRICS_H
+#define STAXYS_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+namespace staxys::core {
+
+/// A counter or gauge with a single writer, readable from other processes.
+/// \details The writer adds with a relaxed load and store, which compile to
+///          plain moves: no locked instruction, since nobody else writes.
+///          Readers see every value whole, if not always the latest one.
+class Counter {
+public:
+  void add(const uint64_t count = 1) {
+    m_value.store(m_value.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+  }
+  void set(const uint64_t value) { m_value.store(value, std::memory_order_relaxed); }
+  uint64_t value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint64_t> m_value{0};
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "counters live in memory shared between processes");
+
+/// Durations counted in log-linear buckets, as in HDR histograms.
+/// \details Every power of two is split into 2^SUB_BUCKET_BITS buckets of
+///          equal width, so a bucket is at most 1/8 of its values wide and
+///          any duration up to 2^64 ticks fits in a few kilobytes. Recording is
+///          a bit scan and two counter increments. Histograms of several
+///          writers merge by adding their buckets.
+class Histogram {
+public:
+  static constexpr unsigned SUB_BUCKET_BITS = 3;
+  static constexpr std::size_t SUB_BUCKETS = std::size_t{1} << SUB_BUCKET_BITS;
+  static constexpr std::size_t BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+  void record(const uint64_t value) {
+    m_buckets[bucket(value)].add();
+    m_sum.add(value);
+  }
+
+  /// Adds the counts of \p other to this histogram, whose writer the caller is.
+  void merge(const Histogram &other);
+
+  uint64_t count() const;
+  uint64_t sum() const { return m_sum.value(); }
+  uint64_t bucket_count(const std::size_t index) const { return m_buckets[index].value(); }
+
+  /// Values recorded that are below \p limit, counting a bucket only if all
+  /// of it is.
+  uint64_t count_below(uint64_t limit) const;
+
+  /// The upper end of the bucket holding the \p quantile (0 to 1) of the
+  /// values recorded, or 0 if there are none.
+  uint64_t quantile(double quantile) const;
+
+  static std::size_t bucket(const uint64_t value) {
+    if (value < SUB_BUCKETS) {
+      return static_cast<std::size_t>(value);
+    }
+    auto shift = static_cast<unsigned>(63 - __builtin_clzll(value)) - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + static_cast<std::size_t>((value >> shift) & (SUB_BUCKETS - 1));
+  }
+
+  /// The smallest value of bucket \p index.
+  static uint64_t lower_bound(std::size_t index);
+
+  /// The largest value of bucket \p index.
+  static uint64_t upper_bound(std::size_t index);
+
+private:
+  std::array<Counter, BUCKETS> m_buckets;
+  Counter m_sum;
+};
+
+/// The metrics of one worker, written by that worker alone.
+/// \details Aligned to cache lines, so that workers never write to the same
+///          line. Requests, responses, bytes and connections are counted as
+///          they happen; the rest is copied in by the worker about once a
+///          second from the statistics its parts keep anyway.
+struct alignas(64) WorkerMetrics {
+  /// Responses counted by the first digit of their status, 1xx to 5xx.
+  static constexpr std::size_t STATUS_CLASSES = 5;
+
+  /// The phases of a request, each timed in CycleClock ticks from the end of
+  /// the one before it.
+  enum Phase : std::size_t {
+    CONNECT, ///< From accepting a connection to the first bytes of its first request.
+    RECEIVE, ///< From the first bytes of a request to having parsed it.
+    HANDLE,  ///< From having parsed a request to queueing its response.
+    SEND,    ///< From queueing a response to writing its last byte.
+    TOTAL,   ///< From the first bytes of a request to the last byte of its response.
+    PHASES
+  };
+
+  Counter requests;
+  std::array<Counter, STATUS_CLASSES> responses;
+  std::array<Histogram, PHASES> phases;
+
+  Counter bytes_sent;
+  Counter connections_accepted;
+  Counter connections_active;
+  Counter accept_queue;
+  Counter cache_hits;
+  Counter cache_misses;
+  Counter cache_entries;
+  Counter cache_bytes;
+  Counter resolution_hits;
+  Counter resolution_misses;
+  Counter access_log_lines;
+  Counter access_log_dropped;
+  Counter error_log_lines;
+  Counter error_log_suppressed;
+  Counter error_log_dropped;
+
+  /// Counts a response with \p status.
+  void respond(const int status) {
+    auto status_class = static_cast<unsigned>(status / 100 - 1);
+    if (status_class < STATUS_CLASSES) {
+      responses[status_class].add();
+    }
+  }
+
+  void time(const Phase phase, const uint64_t ticks) { phases[phase].record(ticks); }
+
+  /// Zeroes the gauges of a worker that is gone; its counters carry on.
+  void clear_gauges();
+};
+
+/// The metrics of all workers, in memory shared between the processes.
+/// \details Created by the master before the workers are forked; each worker
+///          writes its own WorkerMetrics and any of them can sum up all of
+///          them on demand.
+class Metrics {
+public:
+  ~Metrics();
+
+  Metrics(const Metrics &) = delete;
+  Metrics &operator=(const Metrics &) = delete;
+
+  /// Maps shared memory for the metrics of \p workers workers.
+  /// \return nullptr if the memory could not be mapped.
+  static std::unique_ptr<Metrics> create(std::size_t workers);
+
+  std::size_t size() const { return m_size; }
+  WorkerMetrics &worker(const std::size_t index) { return m_workers[index]; }
+  const WorkerMetrics &worker(const std::size_t index) const { return m_workers[index]; }
+
+  /// Sums up the workers and appends them to \p out in the Prometheus text
+  /// exposition format.
+  void render(std::pmr::string &out) const;
+
+private:
+  Metrics(WorkerMetrics *workers, std::size_t size) : m_workers(workers), m_size(size) {}
+
+  WorkerMetrics *m_workers;
+  std::size_t m_size;
+};
+
+} // namespace staxys::core
+
+#endif // STAXYS_METRICS_H
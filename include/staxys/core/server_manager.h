@@ -17,6 +17,102 @@
 #ifndef STAXYS_SERVER_MANAGER_H
 #define STAXYS_SERVER_MANAGER_H
 
-// TODO: Implement ServerManager
+#include "staxys/config/engine_config.h"
+#include "staxys/core/metrics.h"
+#include "staxys/network/server.h"
+#include <chrono>
+#include <csignal>
+#include <memory>
+#include <sys/types.h>
+#include <vector>
+
+namespace staxys::core {
+
+/// Pre-forks the worker processes and keeps them alive.
+/// \details The master process never accepts connections itself. Each worker
+///          is pinned to one CPU and runs its own network::Server with
+///          SO_REUSEPORT listeners, so workers share nothing and the kernel
+///          balances accepts between them. Workers that die unexpectedly are
+///          forked again; a worker that cannot even open its listeners stops
+///          the whole manager, since a fresh fork would fail the same way.
+///          The workers' metrics live in memory the master maps before the
+///          first fork, so that any worker can report those of all.
+class ServerManager {
+public:
+  explicit ServerManager(std::shared_ptr<const staxys::config::EngineConfig> config) : m_config(std::move(config)) {}
+  ~ServerManager() = default;
+
+  ServerManager(const ServerManager &) = delete;
+  ServerManager &operator=(const ServerManager &) = delete;
+
+  /// Forks the workers and supervises them until stop() is called.
+  /// \details Only returns in the master process; workers exit directly.
+  /// \return EXIT_SUCCESS after a clean shutdown, EXIT_FAILURE otherwise.
+  int run();
+
+  /// Asks the master to shut the workers down, or a worker to stop serving.
+  /// Safe to call from a signal handler.
+  void stop();
+
+  /// Asks the master to replace every worker with a fresh fork; workers
+  /// ignore it. Safe to call from a signal handler.
+  void restart();
+
+  /// Has the workers reopen their log files, e.g. after logrotate moved them.
+  /// Safe to call from a signal handler.
+  void reopen_logs();
+
+  /// Wakes the master to reap a worker that exited. Safe to call from a
+  /// signal handler.
+  void child_exited();
+
+  /// The number of workers to run; worker_processes = 0 means one per CPU.
+  std::size_t worker_count() const;
+
+private:
+  struct Worker {
+    pid_t pid = -1;
+    int cpu = -1;
+    std::chrono::steady_clock::time_point started;
+  };
+
+  /// Forks the worker for slot \p index. The child never returns from here.
+  /// \return false if fork failed.
+  bool spawn_worker(std::size_t index);
+
+  /// Body of a worker process.
+  /// \return The worker's exit status.
+  int run_worker(const Worker &worker);
+
+  /// Blocks until a signal handler calls one of the methods above.
+  void wait_for_signal();
+
+  /// Acts on the restart and reopen_logs requests made since the last call.
+  /// \return false if a worker could not be forked again.
+  bool handle_requests();
+
+  /// Sends SIGTERM to every live worker and reaps them, escalating to SIGKILL
+  /// for workers that do not exit within the grace period.
+  void stop_workers();
+
+  /// The CPUs this process may run on, in ascending order.
+  static std::vector<int> available_cpus();
+
+  std::shared_ptr<const staxys::config::EngineConfig> m_config;
+  std::vector<Worker> m_workers;
+  std::vector<int> m_cpus;
+  // One slot per entry of m_workers; nullptr if the memory could not be mapped.
+  std::unique_ptr<Metrics> m_metrics;
+  std::unique_ptr<staxys::network::Server> m_server;
+  pid_t m_master_pid = -1;
+  volatile std::sig_atomic_t m_running = false;
+  volatile std::sig_atomic_t m_restart_requested = false;
+  volatile std::sig_atomic_t m_reopen_requested = false;
+  // Written by the signal handlers in the master, so that its loop wakes up.
+  int m_wake_fd = -1;
+  bool m_is_worker = false;
+};
+
+} // namespace staxys::core
 
 #endif // STAXYS_SERVER_MANAGER_H
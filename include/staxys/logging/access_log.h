@@ -17,6 +17,147 @@
 #ifndef STAXYS_ACCESS_LOG_H
 #define STAXYS_ACCESS_LOG_H
 
-// TODO: Implement AccessLog
+#include "staxys/logging/access_record.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/uio.h>
+#include <thread>
+
+namespace staxys::logging {
+
+/// The access log of one worker: an AccessRecord per request, written to its
+/// file by a background thread as a line of text or in the binary format of
+/// AccessRecordEncoder.
+/// \details The worker's thread formats each record and copies it into a ring
+///          of bytes that only it writes to, and the flusher thread writes
+///          out everything published so far with one writev, once the ring
+///          is half full or at least every flush interval. Neither side takes
+///          a lock: the worker publishes records by advancing the head, the
+///          flusher frees space by advancing the tail. A record that does not
+///          fit is dropped and counted with Overflow::DROP; with
+///          Overflow::BLOCK the worker waits for the flusher instead.
+///          In the binary format the worker only writes varints and copies
+///          strings, with the raw time; the flusher turns what it takes from
+///          the ring into one frame, in which repeated strings are interned.
+///          reopen() may be called from a signal handler, so that the file
+///          can be rotated with SIGUSR1.
+class AccessLog {
+public:
+  enum class Overflow { DROP, BLOCK };
+  enum class Format { TEXT, BINARY };
+
+  struct Stats {
+    uint64_t lines = 0;
+    uint64_t dropped = 0;
+    uint64_t bytes_written = 0;
+    uint64_t writes = 0;
+  };
+
+  static constexpr std::size_t MAX_LINE = AccessRecordText::MAX_LINE;
+  static constexpr std::size_t DEFAULT_CAPACITY = 1024 * 1024;
+  static constexpr std::chrono::milliseconds DEFAULT_FLUSH_INTERVAL{1000};
+
+  /// \param capacity Size of the ring, rounded up to a power of two of at
+  ///        least twice MAX_LINE.
+  AccessLog(std::string path, std::size_t capacity = DEFAULT_CAPACITY, Overflow overflow = Overflow::BLOCK,
+            std::chrono::milliseconds flushInterval = DEFAULT_FLUSH_INTERVAL, Format format = Format::TEXT);
+  ~AccessLog();
+
+  AccessLog(const AccessLog &) = delete;
+  AccessLog &operator=(const AccessLog &) = delete;
+
+  /// Opens the file for appending and starts the flusher.
+  /// \return false if the file could not be opened or the thread not started.
+  bool start();
+
+  /// Writes out what is left and joins the flusher; called by the destructor.
+  void stop();
+
+  /// Appends \p record, stamped with the current time unless it has one.
+  /// Must only be called from one thread.
+  void log(const AccessRecord &record);
+
+  /// Makes the flusher write out what it has and then reopen the file at
+  /// its path, e.g. after logrotate moved it. Async-signal-safe.
+  void reopen();
+
+  /// Counters since start(); read from any thread.
+  Stats stats() const;
+
+  const std::string &path() const { return m_path; }
+
+  /// The overflow policy named by an access_log_overflow setting ("drop"
+  /// or "block").
+  /// \return false for an unknown name, leaving \p overflow unchanged.
+  static bool parse_overflow(std::string_view name, Overflow &overflow);
+
+  /// The format named by an access_log_format setting ("text" or "binary").
+  /// \return false for an unknown name, leaving \p format unchanged.
+  static bool parse_format(std::string_view name, Format &format);
+
+private:
+  /// Copies \p line into the ring, waiting or dropping it if there is no room.
+  void publish(const char *line, std::size_t size);
+
+  void run();
+
+  /// Writes the lines between the tail and \p head and frees their space.
+  void flush_text(uint64_t head);
+
+  /// Takes the records between the tail and \p head out of the ring and
+  /// writes them as one frame.
+  void flush_binary(uint64_t head);
+
+  /// Writes all of \p vectors, reporting and dropping what cannot be written.
+  void write_out(iovec *vectors, int count);
+
+  /// Opens m_path for appending.
+  /// \return The fd, or -1 with the error reported.
+  int open_file() const;
+
+  std::string m_path;
+  std::size_t m_capacity;
+  Overflow m_overflow;
+  std::chrono::milliseconds m_flush_interval;
+  Format m_format;
+  std::unique_ptr<char[]> m_ring;
+  // The flusher's copy of the records taken from the ring, and the frame it
+  // turns them into; only allocated for the binary format.
+  std::unique_ptr<char[]> m_records;
+  std::unique_ptr<char[]> m_frame;
+  AccessRecordEncoder m_frame_encoder;
+  AccessRecordDecoder m_decoder;
+  int m_fd = -1;
+  int m_wake_fd = -1;
+  std::thread m_thread;
+  std::atomic<bool> m_stopping{false};
+  std::atomic<bool> m_reopen{false};
+
+  // Written by the worker only. The tail it saw last saves reading the
+  // flusher's cache line for every line.
+  alignas(64) std::atomic<uint64_t> m_head{0};
+  uint64_t m_cached_tail = 0;
+  // The "[10/Oct/2000:13:55:36 +0000]" of the current second.
+  int64_t m_time_second = -1;
+  char m_time[AccessRecordText::TIME_SIZE]{};
+  std::size_t m_time_length = 0;
+  // Writes every record on its own, without interning, so that it needs
+  // nothing from the records before it.
+  AccessRecordEncoder m_encoder{false};
+  std::atomic<uint64_t> m_lines{0};
+  std::atomic<uint64_t> m_dropped{0};
+
+  // Written by the flusher only.
+  alignas(64) std::atomic<uint64_t> m_tail{0};
+  std::atomic<uint64_t> m_bytes_written{0};
+  std::atomic<uint64_t> m_writes{0};
+};
+
+} // namespace staxys::logging
 
 #endif // STAXYS_ACCESS_LOG_H
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_ACCESS_RECORD_H
+#define STAXYS_ACCESS_RECORD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace staxys::logging {
+
+/// What the access log records about one request, in either of its formats.
+struct AccessRecord {
+  /// Microseconds since the epoch; 0 stands for the time it is logged.
+  int64_t time = 0;
+  /// The client address, "-" if empty.
+  std::string_view client;
+  /// The request line is logged as "-" if \p method is empty.
+  std::string_view method;
+  std::string_view target;
+  int minor_version = 1;
+  int status = 0;
+  /// Body bytes; negative if not known when the record is written, e.g. for
+  /// a body compressed while it is sent.
+  int64_t bytes = -1;
+  std::string_view referer;
+  std::string_view user_agent;
+};
+
+/// Access records as text: the lines of the text access log, or JSON.
+class AccessRecordText {
+public:
+  /// Longest line; longer fields are cut short so that the line fits.
+  static constexpr std::size_t MAX_LINE = 4096;
+  /// Room for the "[10/Oct/2000:13:55:36 +0000]" of format_time().
+  static constexpr std::size_t TIME_SIZE = 32;
+
+  /// Writes the time field of the lines logged in \p second (since the
+  /// epoch) to \p time, which holds TIME_SIZE bytes.
+  /// \return Its length.
+  static std::size_t format_time(int64_t second, char *time);
+
+  /// Writes \p record as a line in the common log format with the Referer
+  /// and User-Agent added, to \p line, which holds MAX_LINE bytes.
+  /// \details '"', '\' and bytes that are not printable ASCII are escaped as
+  ///          \xHH, so that a field cannot break the line up or fake another.
+  /// \param time format_time() of the record's second.
+  /// \return The length of the line, which ends in '\n'.
+  static std::size_t to_text(const AccessRecord &record, std::string_view time, char *line);
+
+  /// Writes \p record as a JSON object on one line to \p line, which holds
+  /// MAX_LINE bytes; bytes that are not printable ASCII are escaped as
+  /// \u00HH. Long fields are cut short, but the object is always complete.
+  /// \return The length of the line, which ends in '\n'.
+  static std::size_t to_json(const AccessRecord &record, char *line);
+};
+
+/// Writes access records in the binary format of the access log.
+/// \details A binary log is a series of frames, each the 4 bytes of MAGIC,
+///          the payload length as a varint and a payload of records. Every
+///          record is its length as a varint followed by, again as varints,
+///          the zigzag difference of its time from the previous record's
+///          (the first record's from 0), the status, the body bytes plus
+///          one (0 if not known) and the minor HTTP version, then the client,
+///          method, target, Referer and User-Agent. A string is 0 if empty,
+///          its length times two plus one followed by its bytes where it
+///          first occurs in the frame, and its index among the strings of
+///          the frame so far plus one, times two, where it repeats. A frame
+///          is complete on its own, so frames of several writers may be
+///          interleaved in one file; decoders skip what follows the known
+///          fields of a record, which leaves room for fields to be added.
+class AccessRecordEncoder {
+public:
+  static constexpr std::string_view MAGIC = {"SXL\1", 4};
+  /// Longest record; longer strings are cut short so that it fits.
+  static constexpr std::size_t MAX_RECORD = 4096;
+  /// Longest frame header.
+  static constexpr std::size_t MAX_FRAME_HEADER = MAGIC.size() + 10;
+
+  /// \param intern Whether a string repeated in a frame is written as a
+  ///        reference, which costs a hash table that may allocate.
+  explicit AccessRecordEncoder(bool intern = true) : m_intern(intern) {}
+
+  /// Appends \p record to the frame in \p out, which holds MAX_RECORD bytes.
+  /// \return The length of the record.
+  std::size_t encode(const AccessRecord &record, char *out);
+
+  /// Starts a new frame, which forgets the strings and time of the last one.
+  void reset();
+
+  /// Writes the header of a frame with \p payloadSize bytes of records to
+  /// \p header, which holds MAX_FRAME_HEADER bytes.
+  /// \return Its length.
+  static std::size_t frame_header(std::size_t payloadSize, char *header);
+
+private:
+  bool m_intern;
+  int64_t m_time = 0;
+  // Views into the frame being written, which outlives them.
+  std::unordered_map<std::string_view, uint64_t> m_strings;
+  uint64_t m_string_count = 0;
+};
+
+/// Reads the records of the binary access log back.
+class AccessRecordDecoder {
+public:
+  enum class Status { RECORD, END, INVALID };
+
+  /// Reads a frame header from the front of \p data.
+  /// \return The header length, 0 if \p data holds only part of a header,
+  ///         or -1 if it does not start with one.
+  static int parse_frame_header(std::string_view data, uint64_t &payloadSize);
+
+  /// Reads the next record of a frame's payload from the front of
+  /// \p payload and removes it; the strings of \p record point into the
+  /// payload, which must stay unchanged until the frame is done.
+  /// \return END once \p payload is empty, INVALID if it is malformed.
+  Status decode(std::string_view &payload, AccessRecord &record);
+
+  /// Starts a new frame.
+  void reset();
+
+private:
+  int64_t m_time = 0;
+  std::vector<std::string_view> m_strings;
+};
+
+} // namespace staxys::logging
+
+#endif // STAXYS_ACCESS_RECORD_H
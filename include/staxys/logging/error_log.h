@@ -17,6 +17,99 @@
 #ifndef STAXYS_ERROR_LOG_H
 #define STAXYS_ERROR_LOG_H
 
-// TODO: Implement ErrorLog
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace staxys::logging {
+
+/// The error log file, or stderr, written by a background thread.
+/// \details Any thread appends whole lines to a buffer, holding a mutex only
+///          for the copy; the writer thread swaps in the spare buffer and
+///          writes the full one with one write, once it is half full or at
+///          least every flush interval. Lines that do not fit are dropped and
+///          counted, so a thread that logs never waits for the disk. Before
+///          start() and after stop() lines are written right away instead.
+///          reopen() may be called from a signal handler, so that the file
+///          can be rotated with SIGUSR1.
+class ErrorLog {
+public:
+  static constexpr std::size_t DEFAULT_CAPACITY = 256 * 1024;
+  static constexpr std::chrono::milliseconds DEFAULT_FLUSH_INTERVAL{1000};
+
+  /// \param path The file to append to; empty for stderr.
+  explicit ErrorLog(std::string path = {}, std::size_t capacity = DEFAULT_CAPACITY,
+                    std::chrono::milliseconds flushInterval = DEFAULT_FLUSH_INTERVAL);
+  ~ErrorLog();
+
+  ErrorLog(const ErrorLog &) = delete;
+  ErrorLog &operator=(const ErrorLog &) = delete;
+
+  /// Opens the file for appending.
+  /// \return false if it could not be opened; lines then go to stderr.
+  bool open();
+
+  /// Starts the writer thread, which calls \p tick before each write, e.g.
+  /// to add lines that are due.
+  /// \return false if the thread could not be started.
+  bool start(std::function<void()> tick = {});
+
+  /// Writes out what is left and joins the writer; called by the destructor.
+  void stop();
+
+  /// Appends \p line, which ends in '\n'. Safe from any thread.
+  void write(std::string_view line);
+
+  /// Makes the writer reopen the file at its path after writing out what
+  /// it has, e.g. after logrotate moved it. Async-signal-safe.
+  void reopen();
+
+  /// Lines dropped because the buffer was full.
+  uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+  const std::string &path() const { return m_path; }
+
+  /// Keep the buffer consistent across fork(), for pthread_atfork handlers.
+  /// \details The child has no writer thread and leaves the parent's lines
+  ///          to the parent; it may start() a writer of its own.
+  void prepare_fork();
+  void parent_after_fork();
+  void child_after_fork();
+
+private:
+  void run();
+
+  /// Writes what is buffered.
+  void flush();
+
+  /// Writes all of \p data to the file, or to stderr if it is not open.
+  void write_out(std::string_view data);
+
+  std::string m_path;
+  std::size_t m_capacity;
+  std::chrono::milliseconds m_flush_interval;
+  int m_fd = -1;
+  int m_wake_fd = -1;
+  // Released unjoined in a forked child, where the thread does not exist.
+  std::unique_ptr<std::thread> m_thread;
+  std::function<void()> m_tick;
+  std::atomic<bool> m_stopping{false};
+  std::atomic<bool> m_reopen{false};
+  std::atomic<uint64_t> m_dropped{0};
+
+  std::mutex m_mutex;
+  std::string m_buffer;
+  // Only touched by the writer, which swaps it with m_buffer.
+  std::string m_writing;
+};
+
+} // namespace staxys::logging
 
 #endif // STAXYS_ERROR_LOG_H
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_BUFFER_POOL_H
+#define STAXYS_BUFFER_POOL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace staxys::network {
+
+/// Per-worker pool of 4, 16 and 64 KiB I/O buffers.
+/// \details Connections borrow a buffer only while they have input buffered
+///          and hand it back as soon as it has been consumed, so idle
+///          keep-alive connections hold none. Returned buffers are kept for
+///          reuse up to \p maxIdleBytes per size class and freed beyond that,
+///          which keeps the footprint flat however many connections come
+///          and go. Not synchronised; one pool belongs to one event loop.
+class BufferPool {
+public:
+  static constexpr std::array<std::size_t, 3> BUFFER_SIZES = {4 * 1024, 16 * 1024, 64 * 1024};
+  static constexpr std::size_t DEFAULT_MAX_IDLE_BYTES = 1024 * 1024;
+
+  /// A borrowed buffer, given back to its pool when destroyed.
+  class Buffer {
+  public:
+    Buffer() = default;
+    ~Buffer();
+
+    Buffer(Buffer &&other) noexcept;
+    Buffer &operator=(Buffer &&other) noexcept;
+
+    char *data() const { return m_data.get(); }
+    std::size_t capacity() const { return m_data == nullptr ? 0 : BUFFER_SIZES[m_size_class]; }
+    explicit operator bool() const { return m_data != nullptr; }
+
+  private:
+    friend class BufferPool;
+    Buffer(BufferPool *pool, std::unique_ptr<char[]> data, uint8_t sizeClass)
+        : m_pool(pool), m_data(std::move(data)), m_size_class(sizeClass) {}
+
+    BufferPool *m_pool = nullptr;
+    std::unique_ptr<char[]> m_data;
+    uint8_t m_size_class = 0;
+  };
+
+  struct Stats {
+    std::size_t buffer_size;
+    /// Buffers currently lent out.
+    std::size_t in_use;
+    /// Buffers kept for reuse.
+    std::size_t idle;
+    /// Most buffers ever lent out at once.
+    std::size_t high_water;
+  };
+
+  explicit BufferPool(std::size_t maxIdleBytes = DEFAULT_MAX_IDLE_BYTES);
+
+  BufferPool(const BufferPool &) = delete;
+  BufferPool &operator=(const BufferPool &) = delete;
+
+  /// Lends the smallest buffer of at least \p capacity bytes.
+  /// \return An empty Buffer if \p capacity exceeds the largest size.
+  Buffer acquire(std::size_t capacity);
+
+  /// Occupancy of every size class, smallest first.
+  std::array<Stats, BUFFER_SIZES.size()> stats() const;
+
+private:
+  struct SizeClass {
+    std::vector<std::unique_ptr<char[]>> idle;
+    std::size_t max_idle = 0;
+    std::size_t in_use = 0;
+    std::size_t high_water = 0;
+  };
+
+  void give_back(std::unique_ptr<char[]> data, uint8_t sizeClass);
+
+  std::array<SizeClass, BUFFER_SIZES.size()> m_classes;
+};
+
+/// Received bytes waiting to be parsed, in a buffer borrowed from a BufferPool.
+/// \details The buffer is borrowed when the first byte arrives, moves to the
+///          next larger size when full, and goes back to the pool once
+///          everything has been consumed.
+class ReadBuffer {
+public:
+  explicit ReadBuffer(BufferPool &pool) : m_pool(&pool) {}
+
+  const char *data() const { return m_buffer.data(); }
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  /// Free space after the buffered bytes to receive into, moving to a larger
+  /// buffer if this one is full.
+  /// \return An empty span once the largest buffer is full.
+  std::span<char> prepare();
+
+  /// Adds \p count bytes received into the space from prepare().
+  void commit(std::size_t count) { m_size += count; }
+
+  /// Copies \p count bytes to the end.
+  /// \return false if they do not fit into the largest buffer.
+  bool append(const char *bytes, std::size_t count);
+
+  /// Drops the first \p count bytes; an empty buffer goes back to the pool.
+  void consume(std::size_t count);
+
+  /// Gives the buffer back to the pool if nothing is buffered.
+  void trim();
+
+private:
+  /// Moves the buffered bytes to a buffer of at least \p capacity bytes.
+  bool grow(std::size_t capacity);
+
+  BufferPool *m_pool;
+  BufferPool::Buffer m_buffer;
+  std::size_t m_size = 0;
+};
+
+} // namespace staxys::network
+
+#endif // STAXYS_BUFFER_POOL_H
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_BYTE_RANGES_H
+#define STAXYS_BYTE_RANGES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace staxys::network {
+
+/// The ranges of a "Range: bytes=..." header, resolved against the length of
+/// the representation they select from.
+/// \details Ranges past the end are dropped and ranges running past it are
+///          cut short. What is left is sorted, and ranges that overlap or
+///          touch are merged, so a client cannot make the server send the
+///          same bytes many times over. A header this class does not
+///          understand, or one asking for more than MAX_RANGES separate
+///          ranges, is ignored and the whole representation sent, as RFC 9110
+///          allows.
+class ByteRanges {
+public:
+  /// Most ranges answered as parts of a multipart/byteranges body.
+  static constexpr std::size_t MAX_RANGES = 8;
+
+  struct Range {
+    uint64_t first;
+    uint64_t length;
+  };
+
+  enum class Result {
+    IGNORED,       ///< Send the whole representation with 200.
+    SATISFIABLE,   ///< Send the ranges with 206.
+    UNSATISFIABLE, ///< Answer 416; no range overlaps the representation.
+  };
+
+  /// Parses \p header for a representation of \p size bytes.
+  Result parse(std::string_view header, uint64_t size);
+
+  std::size_t count() const { return m_count; }
+  const Range &operator[](std::size_t index) const { return m_ranges[index]; }
+
+private:
+  /// Adds a range, merging it with any it overlaps or touches.
+  /// \return false if there is no room for it.
+  bool add(uint64_t first, uint64_t last);
+
+  std::array<Range, MAX_RANGES> m_ranges{};
+  std::size_t m_count = 0;
+};
+
+} // namespace staxys::network
+
+#endif // STAXYS_BYTE_RANGES_H
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_COMPRESSOR_H
+#define STAXYS_COMPRESSOR_H
+
+#include "staxys/network/content_coding.h"
+#include "staxys/network/response.h"
+#include "staxys/static_content/open_file_cache.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct z_stream_s;
+struct ZSTD_CCtx_s;
+
+namespace staxys::network {
+
+class CompressorPool;
+
+/// A reusable gzip or zstd context with its buffers, streamed as a response
+/// body by Response::finish(BodyStream::Ptr).
+/// \details Input is read from a file BUFFER_SIZE bytes at a time, or taken
+///          straight from memory, and each call to next() hands out at most
+///          BUFFER_SIZE compressed bytes, so a body is never held whole.
+///          zstd is only available when built with STAXYS_HAVE_ZSTD.
+class Compressor final : public BodyStream {
+public:
+  static constexpr std::size_t BUFFER_SIZE = 16 * 1024;
+
+  Compressor(ContentCoding::Coding coding, int level);
+  ~Compressor() override;
+
+  Compressor(const Compressor &) = delete;
+  Compressor &operator=(const Compressor &) = delete;
+
+  ContentCoding::Coding coding() const { return m_coding; }
+
+  /// Whether the context could be set up.
+  bool valid() const;
+
+  /// Starts a new stream over \p length bytes of \p file from \p offset.
+  void start(std::shared_ptr<const static_content::OpenFile> file, uint64_t offset, uint64_t length);
+
+  /// Starts a new stream over \p body, which is referenced until the stream ends.
+  void start(std::string_view body);
+
+  bool next(std::string_view &chunk) override;
+
+  /// Returns the context to its pool, if it came from one.
+  void release() override;
+
+  /// Compresses all of \p body into \p output.
+  /// \return false if the codec failed.
+  bool compress(std::string_view body, std::string &output);
+
+private:
+  friend class CompressorPool;
+
+  /// Runs the codec over m_pending into m_output.
+  /// \param finish Whether m_pending is the last of the input.
+  /// \return false if the codec failed.
+  bool step(bool finish, std::size_t &produced);
+
+  void reset_codec();
+
+  ContentCoding::Coding m_coding;
+  CompressorPool *m_pool = nullptr;
+  z_stream_s *m_deflate = nullptr;
+  ZSTD_CCtx_s *m_zstd = nullptr;
+  bool m_valid = false;
+  bool m_ended = false;
+
+  std::shared_ptr<const static_content::OpenFile> m_file;
+  uint64_t m_offset = 0;
+  uint64_t m_left = 0;
+  std::string_view m_pending;
+  std::unique_ptr<char[]> m_input;
+  std::unique_ptr<char[]> m_output;
+};
+
+/// A worker's compression contexts, created on first use and reused after.
+/// \details Setting up a context allocates a few hundred KiB, so contexts
+///          live as long as the worker and a response only borrows one. At
+///          most \p capacity exist at a time; when all of them are in use
+///          acquire() fails and the response goes out uncompressed. Like
+///          the rest of a worker's state, the pool is not thread-safe.
+class CompressorPool {
+public:
+  using Handle = std::unique_ptr<Compressor, BodyStream::Releaser>;
+
+  CompressorPool(int level, std::size_t capacity);
+
+  /// Codings this build can produce.
+  static uint8_t supported();
+
+  /// An idle context for \p coding, or nullptr when none can be had.
+  Handle acquire(ContentCoding::Coding coding);
+
+  /// Contexts created so far.
+  std::size_t size() const { return m_contexts.size(); }
+
+private:
+  friend class Compressor;
+
+  void put_back(Compressor *compressor);
+
+  int m_level;
+  std::size_t m_capacity;
+  std::vector<std::unique_ptr<Compressor>> m_contexts;
+  std::vector<Compressor *> m_idle;
+};
+
+} // namespace staxys::network
+
+#endif // STAXYS_COMPRESSOR_H
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_CONDITIONAL_H
+#define STAXYS_CONDITIONAL_H
+
+#include "staxys/network/request.h"
+#include <ctime>
+#include <string_view>
+
+namespace staxys::network {
+
+/// The conditional request headers of RFC 9110 section 13 that matter for
+/// static files: If-None-Match, If-Modified-Since and If-Range.
+class Conditional {
+public:
+  /// Whether the client's copy is current, so that 304 Not Modified answers
+  /// a GET or HEAD.
+  /// \details If-None-Match is compared weakly; when it is present,
+  ///          If-Modified-Since is not looked at.
+  /// \param etag The entity tag of the representation that would be sent.
+  /// \param modified Its modification time.
+  static bool not_modified(const Request &request, std::string_view etag, time_t modified);
+
+  /// Whether a Range header may be honoured: either there is no If-Range,
+  /// or it holds the current strong entity tag or exact Last-Modified date.
+  static bool range_applies(const Request &request, std::string_view etag, std::string_view lastModified);
+
+  /// Whether the If-None-Match style \p list is "*" or holds \p etag.
+  /// \param weak Compare weakly, ignoring W/ prefixes; otherwise weak tags never match.
+  static bool etag_listed(std::string_view list, std::string_view etag, bool weak);
+};
+
+} // namespace staxys::network
+
+#endif // STAXYS_CONDITIONAL_H
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_CONNECTION_H
+#define STAXYS_CONNECTION_H
+
+#include "staxys/core/cycle_clock.h"
+#include "staxys/core/metrics.h"
+#include "staxys/network/buffer_pool.h"
+#include "staxys/network/request.h"
+#include "staxys/network/response.h"
+#include "staxys/network/timing_wheel.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <netinet/in.h>
+#include <string_view>
+#include <sys/socket.h>
+#include <vector>
+
+namespace staxys::network {
+
+/// A single accepted client socket and its pending I/O.
+/// \details Connections are owned by the event loop and never shared between
+///          threads, so none of the state here is synchronised.
+class Connection {
+public:
+  /// \param buffers Pool the read buffer is borrowed from while input is pending.
+  /// \param arenas Where the arenas of the connection's responses get their blocks.
+  /// \param metrics Where the bytes written to the client are counted and
+  ///        the sending of responses timed, e.g. the worker's; none if nullptr.
+  Connection(int fd, BufferPool &buffers, std::pmr::memory_resource *arenas = std::pmr::get_default_resource(),
+             core::WorkerMetrics *metrics = nullptr)
+      : m_fd(fd), m_read_buffer(buffers), m_arenas(arenas), m_metrics(metrics) {}
+  ~Connection();
+
+  Connection(const Connection &) = delete;
+  Connection &operator=(const Connection &) = delete;
+
+  int fd() const { return m_fd; }
+
+  /// Bytes received from the client that have not been consumed yet.
+  ReadBuffer &read_buffer() { return m_read_buffer; }
+
+  /// Parser state of the request currently being received.
+  Request &request() { return m_request; }
+
+  /// Where the event loop keeps its CycleClock reading for the current
+  /// wakeup, which stands in for the time of accepts, first bytes and
+  /// completed sends so that those cost no clock read of their own.
+  void wakeup_clock(const uint64_t *ticks) { m_wakeup_clock = ticks; }
+
+  /// The event loop's reading for the current wakeup; a fresh reading if the
+  /// connection has no loop to share one.
+  uint64_t wakeup_time() const { return m_wakeup_clock ? *m_wakeup_clock : core::CycleClock::now(); }
+
+  /// CycleClock ticks at which the connection was accepted, until the first
+  /// request has been timed from it; 0 if it was not stamped.
+  uint64_t accepted_at() const { return m_accepted_at; }
+  void accepted_at(const uint64_t ticks) { m_accepted_at = ticks; }
+
+  /// CycleClock ticks at which the first bytes of the request being received
+  /// were seen; 0 between requests.
+  uint64_t received_at() const { return m_received_at; }
+  void received_at(const uint64_t ticks) { m_received_at = ticks; }
+
+  /// Drops the first \p count bytes of the read buffer once a request has been handled.
+  void consume(std::size_t count);
+
+  /// Starts the next response, queued behind any that are still unsent.
+  /// \details May move earlier responses, so it must not be called while a
+  ///          message from output_message() is still in use.
+  Response &respond(int status);
+
+  /// The response most recently started with respond().
+  const Response &last_response() const { return m_responses[m_response_count - 1]; }
+  Response &last_response() { return m_responses[m_response_count - 1]; }
+
+  /// Whether anything queued is still waiting to be written.
+  bool has_pending_output() const { return m_first_unsent < m_response_count; }
+
+  /// Responses queued and not yet completely written.
+  std::size_t queued_responses() const { return m_response_count - m_first_unsent; }
+
+  /// Unsent responses, or unsent bytes of them, at which the output is backlogged.
+  static constexpr std::size_t MAX_QUEUED_RESPONSES = 16;
+  static constexpr std::size_t MAX_QUEUED_BYTES = 256 * 1024;
+
+  /// Whether so much output is queued that no further requests should be
+  /// read or answered until some of it has been written.
+  /// \details Keeps a client that pipelines requests without reading the
+  ///          responses from making the worker queue them without bound.
+  bool output_backlogged() const;
+
+  /// Whether the event loop stopped reading from the client because the
+  /// output was backlogged, and has to start again once it has drained.
+  bool input_paused() const { return m_input_paused; }
+  void input_paused(const bool inputPaused) { m_input_paused = inputPaused; }
+
+  enum class FlushResult {
+    DONE,        ///< Nothing is left to write.
+    WOULD_BLOCK, ///< The socket buffer is full; wait until it is writable.
+    YIELDED,     ///< \p fileBudget was used up; call again on a later iteration.
+    FAILED,      ///< The peer is gone and the connection should be closed.
+  };
+
+  /// Writes queued output until the socket would block, in one sendmsg per
+  /// batch of iovecs and sendfile for file bodies.
+  /// \param fileBudget Upper bound on file and streamed body bytes sent by
+  ///        this call, so one large body cannot hold up the other
+  ///        connections of the worker; 0 means no bound.
+  FlushResult flush(std::size_t fileBudget = 0);
+
+  /// A msghdr whose iovecs cover the unsent output of the queued responses up
+  /// to the next file body or the end of the current chunk of a streamed
+  /// body, for loops that submit the write themselves. It
+  /// stays valid until the next call to respond(), output_message() or
+  /// advance_output(), and is empty if a file body is next.
+  msghdr *output_message();
+
+  /// Whether the last output_message() covers all queued output, i.e. nothing
+  /// is left once it has been written in full.
+  bool output_is_final() const { return m_output_is_final; }
+
+  /// The unsent part of the file body at which the last output_message()
+  /// stopped, if it stopped at one with room left for another iovec.
+  bool output_file(Response::FileRange &range) const;
+
+  /// Appends \p size bytes at \p data, the start of the output_file()
+  /// range as mapped or read by the loop, to the last output_message().
+  /// \details Must only follow an output_file() that returned true, and
+  ///          \p data has to stay untouched until the message is written.
+  void extend_output(const char *data, std::size_t size);
+
+  /// The part of a file body that has to be sent next, if a file body is next.
+  bool pending_file(Response::FileRange &range) const;
+
+  /// Marks \p count bytes of queued output as written, timing the responses
+  /// this completes if they were stamped with Response::timing().
+  void advance_output(std::size_t count);
+
+  /// Gives up ownership of the socket, e.g. after an asynchronous close.
+  void release_fd() { m_fd = -1; }
+
+  bool close_after_write() const { return m_close_after_write; }
+  void close_after_write(const bool close_after_write) { m_close_after_write = close_after_write; }
+
+  /// The client's address as text, looked up on first use; "-" if it has none.
+  std::string_view peer_address();
+
+  /// The timeout of whatever the connection is waiting for, armed by the event loop.
+  TimingWheel::Timer &timer() { return m_timer; }
+
+private:
+  /// Upper bound on iovecs per send; more output goes out in further sends.
+  static constexpr std::size_t MAX_OUTPUT_VECTORS = 64;
+
+  int m_fd;
+  bool m_close_after_write = false;
+  bool m_input_paused = false;
+  ReadBuffer m_read_buffer;
+  std::pmr::memory_resource *m_arenas;
+  core::WorkerMetrics *m_metrics;
+  const uint64_t *m_wakeup_clock = nullptr;
+  uint64_t m_accepted_at = 0;
+  uint64_t m_received_at = 0;
+  Request m_request;
+  // The first m_response_count entries are queued in order, those before
+  // m_first_unsent fully written. Entries are reused once all are sent.
+  std::vector<Response> m_responses;
+  std::size_t m_response_count = 0;
+  std::size_t m_first_unsent = 0;
+  std::array<iovec, MAX_OUTPUT_VECTORS> m_output_vectors{};
+  msghdr m_output_message{};
+  bool m_output_is_final = false;
+  // Queued bytes the last output_message() does not cover, and whether a
+  // streamed body is among them, whose length is not known yet.
+  std::size_t m_output_left = 0;
+  bool m_output_streaming = false;
+  bool m_output_has_file = false;
+  Response::FileRange m_output_file{};
+  TimingWheel::Timer m_timer;
+  // Empty until peer_address() has looked it up.
+  std::array<char, INET6_ADDRSTRLEN> m_peer_address{};
+  std::size_t m_peer_address_length = 0;
+};
+
+} // namespace staxys::network
+
+#endif // STAXYS_CONNECTION_H
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_CONTENT_CODING_H
+#define STAXYS_CONTENT_CODING_H
+
+#include <cstdint>
+#include <string_view>
+
+namespace staxys::network {
+
+/// Content codings (RFC 9110 section 8.4) the server can send.
+class ContentCoding {
+public:
+  /// Bit flags, so the codings a client accepts fit in one byte.
+  enum Coding : uint8_t { GZIP = 1 << 0, BROTLI = 1 << 1, ZSTD = 1 << 2 };
+
+  /// The codings an Accept-Encoding value allows.
+  /// \details Codings with q=0 are refused; "*" stands for every coding not
+  ///          listed explicitly. Names are matched case-insensitively and
+  ///          "x-gzip" counts as gzip. An empty value accepts nothing.
+  /// \return A combination of Coding flags.
+  static uint8_t accepted(std::string_view acceptEncoding);
+
+  /// The token for a single coding, e.g. "br" for BROTLI.
+  static std::string_view name(Coding coding);
+};
+
+} // namespace staxys::network
+
+#endif // STAXYS_CONTENT_CODING_H
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_EPOLL_EVENT_LOOP_H
+#define STAXYS_EPOLL_EVENT_LOOP_H
+
+#include "staxys/network/event_loop.h"
+#include <memory>
+#include <vector>
+
+namespace staxys::network {
+
+/// Readiness-based loop on a single edge-triggered epoll set.
+/// \details Every listening socket and every accepted connection is registered
+///          once with EPOLLET, so a connection costs one fd and one Connection
+///          object rather than a thread, and writes never need an epoll_ctl.
+///          Connections are looked up by fd, which keeps dispatch O(1).
+///          A connection that used up its file budget for one iteration is
+///          resumed on the next without waiting for an edge, and so is
+///          one that stopped reading while its output was backlogged.
+class EpollEventLoop final : public EventLoop {
+public:
+  using EventLoop::EventLoop;
+  ~EpollEventLoop() override;
+
+  bool init() override;
+  int run() override;
+  const char *name() const override { return "epoll"; }
+
+private:
+  void accept_connections(int listenerFd);
+  void handle_event(int fd, unsigned int events);
+  void read_from(Connection &connection);
+
+  /// Writes pending output and closes the connection if it failed or is done.
+  void write_to(Connection &connection);
+
+  /// Resumes the connections whose last flush yielded, or whose backlog
+  /// has drained so that they can read again.
+  void resume_deferred();
+
+  /// Closes the connections whose timeout has passed.
+  void close_expired();
+  void close_connection(int fd);
+
+  int m_epoll_fd = -1;
+  std::vector<SlabAllocator<Connection>::Ptr> m_connections;
+  std::vector<int> m_deferred;
+};
+
+} // namespace staxys::network
+
+#endif // STAXYS_EPOLL_EVENT_LOOP_H
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_EVENT_LOOP_H
+#define STAXYS_EVENT_LOOP_H
+
+#include "staxys/core/cycle_clock.h"
+#include "staxys/core/metrics.h"
+#include "staxys/network/buffer_pool.h"
+#include "staxys/network/connection.h"
+#include "staxys/network/slab_allocator.h"
+#include "staxys/network/timing_wheel.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace staxys::network {
+
+/// The protocol side of a connection, called by whichever event loop is running.
+class ConnectionHandler {
+public:
+  virtual ~ConnectionHandler() = default;
+
+  /// Consumes complete requests from the connection's read buffer and queues
+  /// their responses.
+  /// \return false if the connection is unusable and must be closed at once.
+  virtual bool process(Connection &connection) = 0;
+
+  /// Called by the loop every tick interval, if one is set.
+  virtual void tick() {}
+};
+
+/// The I/O side of a worker: accepts on the listening sockets, moves bytes in
+/// and out of connections, and hands received data to a ConnectionHandler.
+/// \details Implementations are single-threaded and own every Connection they
+///          accept. They return from run() once \p running turns false and the
+///          wake fd has been signalled. Each connection has one timer in the
+///          loop's timing wheel, re-armed whenever it makes progress; loops
+///          wait no longer than the wheel's next expiry and close all
+///          connections that timed out in one batch per iteration.
+class EventLoop {
+public:
+  /// \param listeners Non-blocking listening sockets, owned by the caller.
+  /// \param wakeFd An eventfd the caller writes to when \p running changes.
+  /// \param maxConnections Connections beyond this are accepted and closed.
+  /// \param running Cleared by the caller to make run() return.
+  /// \param handler Protocol layer for received data.
+  EventLoop(std::vector<int> listeners, int wakeFd, std::size_t maxConnections, const std::atomic<bool> &running,
+            ConnectionHandler &handler)
+      : m_listeners(std::move(listeners)), m_wake_fd(wakeFd), m_max_connections(maxConnections), m_running(running),
+        m_handler(handler), m_timers(TIMER_TICK_MS, monotonic_ms()) {}
+  virtual ~EventLoop() = default;
+
+  EventLoop(const EventLoop &) = delete;
+  EventLoop &operator=(const EventLoop &) = delete;
+
+  /// Creates the kernel objects the loop needs and registers the listeners.
+  /// \return false if the backend is unavailable on this kernel.
+  virtual bool init() = 0;
+
+  /// Runs until the owner clears the running flag.
+  /// \return EXIT_SUCCESS on a clean shutdown, EXIT_FAILURE otherwise.
+  virtual int run() = 0;
+
+  /// Name of the backend as spelled in the io_backend setting.
+  virtual const char *name() const = 0;
+
+  std::size_t connection_count() const { return m_connection_count; }
+
+  /// Has the loop count accepted connections and sent bytes in \p metrics.
+  void metrics(core::WorkerMetrics *metrics) { m_metrics = metrics; }
+
+  /// Has the loop read the CycleClock once per wakeup and share that reading
+  /// with its connections, which time the phases of their requests from it.
+  /// Off by default; the connections accepted from then on are timed.
+  void request_timing(const bool requestTiming) { m_request_timing = requestTiming; }
+
+  /// Has the loop call ConnectionHandler::tick() about every \p intervalMs
+  /// milliseconds; 0 stops it.
+  void tick_interval(uint64_t intervalMs);
+
+  /// Occupancy of the connection slabs and the read buffer pool.
+  SlabAllocator<Connection>::Stats connection_stats() const { return m_connection_slab.stats(); }
+  std::array<BufferPool::Stats, BufferPool::BUFFER_SIZES.size()> buffer_stats() const { return m_buffer_pool.stats(); }
+
+  /// Caps the file bytes one connection sends per loop iteration, from the
+  /// sendfile_max_chunk setting; 0 removes the cap.
+  void max_file_chunk(const std::size_t maxFileChunk) { m_max_file_chunk = maxFileChunk; }
+
+  /// Caps request bodies, from the client_max_body_size setting. Whole
+  /// requests are capped at MAX_BUFFERED_INPUT regardless, since they have
+  /// to fit into the read buffer.
+  void max_body_size(const std::size_t maxBodySize) { m_max_body_size = maxBodySize; }
+
+  /// Sets the timeouts, in seconds, after which a connection is closed: while
+  /// idle between requests, between reads of a partly received request, and
+  /// between writes of queued output. 0 disables one.
+  void timeouts(int keepAlive, int clientBody, int send);
+
+  /// Creates the loop named by an io_backend setting ("epoll" or "io_uring").
+  /// \return nullptr for an unknown backend name.
+  static std::unique_ptr<EventLoop> create(const std::string &backend, std::vector<int> listeners, int wakeFd,
+                                           std::size_t maxConnections, const std::atomic<bool> &running,
+                                           ConnectionHandler &handler);
+
+protected:
+  /// Input a connection may buffer without the handler consuming any of it.
+  static constexpr std::size_t MAX_BUFFERED_INPUT = 64 * 1024;
+  static_assert(MAX_BUFFERED_INPUT <= BufferPool::BUFFER_SIZES.back(), "input has to fit into a pooled buffer");
+
+  /// Makes a connection for an accepted socket from the worker's slabs.
+  SlabAllocator<Connection>::Ptr make_connection(const int fd) {
+    auto connection = m_connection_slab.make(fd, m_buffer_pool, &m_arena_pool, m_metrics);
+    connection->request().limit_size(m_max_body_size, MAX_BUFFERED_INPUT);
+    if (m_metrics) {
+      m_metrics->connections_accepted.add();
+    }
+    if (m_request_timing) {
+      connection->wakeup_clock(&m_wakeup);
+      connection->accepted_at(m_wakeup);
+    }
+    return connection;
+  }
+
+  /// Reads the clock for the wakeup that has just begun, if requests are timed.
+  void stamp_wakeup() {
+    if (m_request_timing) {
+      m_wakeup = core::CycleClock::now();
+    }
+  }
+
+  /// Resolution of connection timeouts.
+  static constexpr uint64_t TIMER_TICK_MS = 100;
+
+  /// Milliseconds on a coarse monotonic clock.
+  static uint64_t monotonic_ms();
+
+  /// Re-arms the connection's timer with the timeout of the phase it is in.
+  void refresh_timer(Connection &connection);
+
+  /// How long the loop may wait for events before a timer is due.
+  /// \return -1 if no timer is armed.
+  int timer_timeout() const { return m_timers.timeout_ms(monotonic_ms()); }
+
+  /// Collects the timers that have expired since the last call, and calls
+  /// the handler's tick() if it is due.
+  /// \details Each timer's data is the fd of its connection. The list is
+  ///          reused by the next call.
+  const std::vector<TimingWheel::Timer *> &expire_timers();
+
+  std::vector<int> m_listeners;
+  int m_wake_fd;
+  std::size_t m_max_connections;
+  std::size_t m_connection_count = 0;
+  core::WorkerMetrics *m_metrics = nullptr;
+  bool m_request_timing = false;
+  // CycleClock ticks at the start of the current wakeup, while requests are timed.
+  uint64_t m_wakeup = 0;
+  std::size_t m_max_file_chunk = 0;
+  std::size_t m_max_body_size = SIZE_MAX;
+  const std::atomic<bool> &m_running;
+  ConnectionHandler &m_handler;
+  BufferPool m_buffer_pool;
+  // Blocks of the per-request arenas, kept for reuse once a request ends.
+  std::pmr::unsynchronized_pool_resource m_arena_pool;
+  SlabAllocator<Connection> m_connection_slab;
+  TimingWheel m_timers;
+  std::vector<TimingWheel::Timer *> m_expired;
+  // Not a connection's; re-armed every m_tick_interval_ms while that is set.
+  TimingWheel::Timer m_tick_timer;
+  uint64_t m_tick_interval_ms = 0;
+  uint64_t m_keep_alive_timeout_ms = 75 * 1000;
+  uint64_t m_client_body_timeout_ms = 60 * 1000;
+  uint64_t m_send_timeout_ms = 60 * 1000;
+};
+
+} // namespace staxys::network
+
+#endif // STAXYS_EVENT_LOOP_H
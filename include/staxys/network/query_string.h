@@ -0,0 +1,90 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_QUERY_STRING_H
+#define STAXYS_QUERY_STRING_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace staxys::network {
+
+/// The query of a URI, split into parameters only when first read.
+/// \details Most requests never look at their query, so assigning one only
+///          records the span. The first read splits it on '&' into a flat
+///          vector of views of the still-encoded names and values, drawn
+///          from the memory resource given, e.g. the arena of the request.
+///          Repeated names are all kept, in order; a piece without '=' is a
+///          parameter with an empty value. Values are decoded on demand as
+///          a form submission encodes them: '+' is a space and %XX a byte.
+///          The raw query must outlive this object.
+class QueryString {
+public:
+  /// A parameter as it appears in the query, still encoded.
+  struct Parameter {
+    std::string_view name;
+    std::string_view value;
+  };
+  using Parameters = std::pmr::vector<Parameter>;
+
+  explicit QueryString(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+      : m_parameters(resource) {}
+
+  /// Replaces the query; \p raw is the part after '?', without the fragment.
+  void assign(std::string_view raw);
+
+  std::string_view raw() const { return m_raw; }
+
+  /// Number of parameters, counting each repetition of a name.
+  std::size_t size() const { return parameters().size(); }
+
+  bool empty() const { return size() == 0; }
+
+  Parameters::const_iterator begin() const { return parameters().begin(); }
+  Parameters::const_iterator end() const { return parameters().end(); }
+
+  /// The first parameter whose decoded name is \p name, or nullptr.
+  const Parameter *find(std::string_view name) const;
+
+  /// How many parameters have the decoded name \p name.
+  std::size_t count(std::string_view name) const;
+
+  /// Decodes the value of the first parameter named \p name into \p value.
+  /// \return false if there is no such parameter or its value has a
+  ///         malformed escape.
+  bool value(std::string_view name, std::pmr::string &value) const;
+
+  /// Form-decodes \p raw into \p output, which needs room for raw.size()
+  /// bytes and may be raw.data() itself.
+  /// \return The decoded size, or std::string_view::npos if \p raw has a
+  ///         malformed escape.
+  static std::size_t decode(std::string_view raw, char *output);
+
+private:
+  const Parameters &parameters() const;
+
+  std::string_view m_raw;
+  // Filled on first read; mutable because reading is logically const.
+  mutable Parameters m_parameters;
+  mutable bool m_parsed = true;
+};
+
+} // namespace staxys::network
+
+#endif // STAXYS_QUERY_STRING_H
@@ -17,6 +17,143 @@
 #ifndef STAXYS_REQUEST_H
 #define STAXYS_REQUEST_H
 
-// TODO: Implement Request
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace staxys::network {
+
+/// One header field of a parsed request.
+struct Header {
+  std::string_view name;
+  std::string_view value;
+};
+
+/// Incremental HTTP/1.1 request parser.
+/// \details parse() is called with everything received so far for the
+///          current request, starting at its first byte, and picks up where
+///          the previous call stopped, so a request may arrive split across
+///          any number of reads. Nothing is copied: the method, target,
+///          version, headers and body are slices of the buffer passed to the
+///          last parse() call and stay valid until that buffer changes.
+///          Bytes past size() belong to the next pipelined request; call
+///          reset() after consuming size() bytes to parse it.
+class Request {
+public:
+  enum class Status {
+    INCOMPLETE,
+    COMPLETE,
+    BAD_REQUEST,
+    URI_TOO_LONG,
+    HEADERS_TOO_LARGE,
+    PAYLOAD_TOO_LARGE,
+    NOT_IMPLEMENTED,
+    VERSION_NOT_SUPPORTED,
+  };
+
+  /// Upper bound on the request line plus all header lines.
+  static constexpr std::size_t MAX_HEAD_SIZE = 16 * 1024;
+
+  /// Upper bound on the number of header fields; storage for them is inline.
+  static constexpr std::size_t MAX_HEADERS = 64;
+
+  explicit Request(std::size_t maxHeadSize = MAX_HEAD_SIZE, std::size_t maxHeaders = MAX_HEADERS);
+
+  /// Continues parsing \p input, which must start with the bytes passed to
+  /// the previous call.
+  /// \return COMPLETE once the head and the Content-Length body are
+  ///         available, INCOMPLETE if more input is needed, or the error to
+  ///         answer with. Errors are final until reset().
+  Status parse(std::string_view input);
+
+  /// Forgets the current request so the next one can be parsed.
+  void reset();
+
+  /// Fails requests with a body of more than \p maxBodySize bytes, or of
+  /// more than \p maxSize bytes with the head, as PAYLOAD_TOO_LARGE as soon
+  /// as the head has been parsed. The limits are kept across reset().
+  void limit_size(std::size_t maxBodySize, std::size_t maxSize);
+
+  Status status() const { return m_status; }
+  bool failed() const { return m_status != Status::INCOMPLETE && m_status != Status::COMPLETE; }
+
+  std::string_view method() const { return slice(m_method); }
+  std::string_view target() const { return slice(m_target); }
+  std::string_view version() const { return slice(m_version); }
+
+  /// 0 for HTTP/1.0, 1 for HTTP/1.1.
+  int minor_version() const { return m_minor_version; }
+
+  /// Whether the connection may carry another request after this one.
+  bool keep_alive() const { return m_keep_alive; }
+
+  std::size_t header_count() const { return m_header_count; }
+  Header header(std::size_t index) const { return {slice(m_headers[index].name), slice(m_headers[index].value)}; }
+
+  /// Value of the first header named \p name (case-insensitive), or an
+  /// empty view if there is none.
+  std::string_view header(std::string_view name) const;
+
+  std::size_t content_length() const { return m_content_length; }
+  std::string_view body() const { return {m_base + m_head_size, m_content_length}; }
+
+  /// Bytes taken by the request line and headers, including the blank line.
+  std::size_t head_size() const { return m_head_size; }
+
+  /// Bytes taken by the whole request, body included.
+  std::size_t size() const { return m_head_size + m_content_length; }
+
+private:
+  enum class Phase : uint8_t { REQUEST_LINE, HEADERS, BODY, DONE };
+
+  /// Offsets instead of views, so growing the buffer between calls is fine.
+  struct Slice {
+    uint32_t offset = 0;
+    uint32_t length = 0;
+  };
+
+  struct HeaderSlice {
+    Slice name;
+    Slice value;
+  };
+
+  std::string_view slice(const Slice &slice) const { return {m_base + slice.offset, slice.length}; }
+
+  /// Line parsers start at m_line_start and advance it past the line.
+  /// \return COMPLETE once the line is consumed, INCOMPLETE if it has not
+  ///         fully arrived, or the error to answer with.
+  Status parse_request_line(std::string_view input);
+  Status parse_header_line(std::string_view input);
+  Status apply_header(std::string_view name, std::string_view value);
+  Status finish_head();
+  static Status end_of_line(std::string_view input, std::size_t position, std::size_t &next);
+  Status fail(Status status);
+
+  std::size_t m_max_head_size;
+  std::size_t m_max_headers;
+  std::size_t m_max_body_size = SIZE_MAX;
+  std::size_t m_max_size = SIZE_MAX;
+
+  const char *m_base = nullptr;
+  Status m_status = Status::INCOMPLETE;
+  Phase m_phase = Phase::REQUEST_LINE;
+  std::size_t m_line_start = 0;
+  std::size_t m_head_size = 0;
+
+  Slice m_method;
+  Slice m_target;
+  Slice m_version;
+  int m_minor_version = 1;
+  bool m_keep_alive = true;
+  bool m_has_host = false;
+  bool m_has_content_length = false;
+  std::size_t m_content_length = 0;
+
+  std::size_t m_header_count = 0;
+  std::array<HeaderSlice, MAX_HEADERS> m_headers;
+};
+
+} // namespace staxys::network
 
 #endif // STAXYS_REQUEST_H
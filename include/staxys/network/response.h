@@ -17,6 +17,216 @@
 #ifndef STAXYS_RESPONSE_H
 #define STAXYS_RESPONSE_H
 
-// TODO: Implement Response
+#include "staxys/static_content/open_file_cache.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+namespace staxys::network {
+
+/// A body that is produced piece by piece while the response is sent, e.g.
+/// compressed on the fly, so it never has to be held in memory whole.
+class BodyStream {
+public:
+  /// Hands a stream back to its owner, such as a pool, instead of deleting it.
+  struct Releaser {
+    void operator()(BodyStream *stream) const { stream->release(); }
+  };
+  using Ptr = std::unique_ptr<BodyStream, Releaser>;
+
+  virtual ~BodyStream() = default;
+
+  /// Produces the next piece of the body into \p chunk, which stays valid
+  /// until the next call; an empty \p chunk ends the body.
+  /// \return false if the body cannot be completed.
+  virtual bool next(std::string_view &chunk) = 0;
+
+  /// Called once the response is done with the stream.
+  virtual void release() = 0;
+};
+
+/// An HTTP/1.1 response kept as a list of byte segments for writev/sendmsg.
+/// \details The status line, the Server and Date headers and the Connection
+///          header come from precomputed spans; other header values and the
+///          body are referenced, not copied, and must stay alive until the
+///          response has been sent. Only short formatted values (numbers, the
+///          current Date line) live in the response's own inline scratch, so
+///          building a response allocates nothing. A file body is kept as a
+///          range of an open file, to be sent with sendfile. A streamed body
+///          is sent with chunked transfer coding, one chunk of the stream at
+///          a time; the segments and scratch are reused for every chunk.
+///          Longer generated content goes into the response's arena, which
+///          lives exactly as long as the request and is freed in one step.
+class Response {
+public:
+  /// Segment and scratch capacity; exceeding either throws std::length_error.
+  static constexpr std::size_t MAX_SEGMENTS = 24;
+  static constexpr std::size_t SCRATCH_SIZE = 192;
+
+  /// Starts a response with its status line, Server and Date headers.
+  explicit Response(int status = 200) : Response(status, std::pmr::get_default_resource()) {}
+
+  /// Starts a response whose arena draws its blocks from \p upstream, e.g.
+  /// a pool shared by the connections of a worker.
+  Response(int status, std::pmr::memory_resource *upstream);
+
+  /// Reuses this object for a new response.
+  void reset(int status);
+
+  int status() const { return m_status; }
+
+  /// Adds "name: value"; both views are referenced until the response is sent.
+  Response &header(std::string_view name, std::string_view value);
+
+  /// Adds a header whose value is copied, for values that do not outlive the call.
+  Response &header_copy(std::string_view name, std::string_view value);
+
+  /// Adds preformatted header lines, each ending in CRLF; referenced until sent.
+  Response &headers(std::string_view lines);
+
+  Response &content_length(uint64_t length);
+
+  /// Adds the precomputed "Connection: keep-alive" or "Connection: close" line.
+  Response &keep_alive(bool keepAlive);
+
+  /// Ends the header block; \p body is referenced until the response is sent.
+  Response &finish(std::string_view body = {});
+
+  /// Ends the header block with \p length bytes of \p file from \p offset
+  /// as the body; the response keeps the file open until it is sent.
+  Response &finish(std::shared_ptr<const static_content::OpenFile> file, uint64_t offset, uint64_t length);
+
+  /// Adds \p bytes to the body of a finished response, e.g. the framing of a
+  /// multipart body; referenced until the response is sent.
+  Response &body(std::string_view bytes);
+
+  /// Adds \p length bytes of \p file from \p offset to the body of a finished
+  /// response. All file parts of one response must come from the same file.
+  Response &body(std::shared_ptr<const static_content::OpenFile> file, uint64_t offset, uint64_t length);
+
+  /// Ends the header block with a chunked body drawn from \p stream; adds the
+  /// Transfer-Encoding header and produces the first chunk right away.
+  Response &finish(BodyStream::Ptr stream);
+
+  /// Memory for per-request data the response references, such as generated
+  /// body parts; everything in it is freed at once when the response is
+  /// reset or destroyed.
+  std::pmr::memory_resource *arena();
+
+  /// Keeps \p owner alive until the response is sent or reset, for
+  /// referenced bytes that belong to a shared object such as a cache entry.
+  Response &retain(std::shared_ptr<const void> owner);
+
+  bool finished() const { return m_finished; }
+
+  /// Stamps the CycleClock ticks at which the request was first received and
+  /// this response was queued, so that the connection can time it once sent.
+  void timing(const uint64_t receivedAt, const uint64_t queuedAt) {
+    m_received_at = receivedAt;
+    m_queued_at = queuedAt;
+  }
+  uint64_t received_at() const { return m_received_at; }
+  /// 0 if the response was not stamped.
+  uint64_t queued_at() const { return m_queued_at; }
+
+  /// Whether more of a streamed body is still to come after the unsent bytes.
+  bool streaming() const { return static_cast<bool>(m_stream); }
+
+  /// Whether a streamed body broke off; the bytes sent are not a complete response.
+  bool failed() const { return m_failed; }
+
+  /// Total bytes of the response produced so far.
+  std::size_t size() const { return m_size; }
+
+  /// Bytes of the body of a finished response, or -1 for a streamed body,
+  /// whose length is only known once all of it has been produced.
+  int64_t body_size() const {
+    return m_chunked ? -1 : static_cast<int64_t>(m_finished ? m_size - m_header_size : 0);
+  }
+
+  /// Bytes not yet written.
+  std::size_t remaining() const { return m_size - m_sent; }
+
+  /// Writes iovecs for the unsent bytes into \p vectors, stopping at a file range.
+  /// \details The iovecs point into this object, so they are invalidated if
+  ///          it moves.
+  /// \return How many of the \p capacity entries were filled.
+  std::size_t gather(iovec *vectors, std::size_t capacity) const;
+
+  /// The unsent part of a file range, if the response has reached one.
+  struct FileRange {
+    const static_content::OpenFile *file;
+    int fd;
+    off_t offset;
+    uint64_t length;
+  };
+
+  /// \return false if the next unsent bytes are not part of a file range.
+  bool pending_file(FileRange &range) const;
+
+  /// The unsent part of the file range at which gather() stops, for loops
+  /// that send file bodies from memory together with what precedes them.
+  /// \return false if no file range is left to send.
+  bool next_file(FileRange &range) const;
+
+  /// Marks up to \p count bytes as written, pulling the next chunk of a
+  /// streamed body once everything before it has been written.
+  /// \return The part of \p count beyond the end of this response.
+  std::size_t advance(std::size_t count);
+
+  /// Reason phrase for a status code, e.g. "Not Found".
+  static std::string_view reason(int status);
+
+private:
+  enum class Source : uint8_t { MEMORY, SCRATCH, FILE };
+
+  /// Memory segments have data set; scratch segments an offset into
+  /// m_scratch, file segments an offset into m_file.
+  struct Segment {
+    const char *data;
+    uint64_t offset;
+    uint64_t length;
+    Source source;
+  };
+
+  void append(std::string_view bytes);
+  void append_copy(std::string_view bytes);
+
+  /// Appends the next chunk of m_stream, or the last chunk once it has ended.
+  void pull();
+  const char *segment_data(const Segment &segment) const {
+    return segment.source == Source::SCRATCH ? m_scratch.data() + segment.offset : segment.data;
+  }
+
+  int m_status = 200;
+  bool m_finished = false;
+  bool m_failed = false;
+  bool m_chunked = false;
+  std::size_t m_size = 0;
+  std::size_t m_header_size = 0;
+  std::size_t m_sent = 0;
+  uint64_t m_received_at = 0;
+  uint64_t m_queued_at = 0;
+  std::size_t m_segment_count = 0;
+  std::size_t m_scratch_used = 0;
+  // First segment not yet completely written, and the bytes of it already written.
+  std::size_t m_send_segment = 0;
+  std::size_t m_send_offset = 0;
+  std::array<Segment, MAX_SEGMENTS> m_segments;
+  std::array<char, SCRATCH_SIZE> m_scratch;
+  std::shared_ptr<const static_content::OpenFile> m_file;
+  std::shared_ptr<const void> m_retained;
+  BodyStream::Ptr m_stream;
+  std::pmr::memory_resource *m_upstream;
+  // Created on first use and kept across reset(), which only releases its blocks.
+  std::unique_ptr<std::pmr::monotonic_buffer_resource> m_arena;
+};
+
+} // namespace staxys::network
 
 #endif // STAXYS_RESPONSE_H
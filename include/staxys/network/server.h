@@ -17,6 +17,196 @@
 #ifndef STAXYS_SERVER_H
 #define STAXYS_SERVER_H
 
-// TODO: Implement Server
+#include "staxys/config/engine_config.h"
+#include "staxys/core/metrics.h"
+#include "staxys/logging/access_log.h"
+#include "staxys/network/byte_ranges.h"
+#include "staxys/network/compressor.h"
+#include "staxys/network/connection.h"
+#include "staxys/network/event_loop.h"
+#include "staxys/static_content/cache.h"
+#include "staxys/static_content/open_file_cache.h"
+#include "staxys/static_content/resolution_cache.h"
+#include "staxys/static_content/watcher.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace staxys::network {
+
+/// The HTTP server of one worker process.
+/// \details Owns the listening sockets and the protocol handling, and runs
+///          them on the event loop selected by the io_backend setting. Which
+///          loop is running is invisible to callers. Requests are answered
+///          with files below server_static_root, sent with sendfile, or
+///          from memory when cache_enabled is set and the file is small.
+///          Precompressed .br and .gz siblings are preferred when the client
+///          accepts them; otherwise, with compression_enabled, text is
+///          compressed on the fly. Range requests and revalidation with
+///          If-None-Match or If-Modified-Since are answered from the
+///          validators of the open file. The health check URL is answered
+///          with a fixed response, and the metrics URL with the metrics of
+///          all workers in the Prometheus text format.
+class Server final : public ConnectionHandler {
+public:
+  /// \param metrics The metrics shared by the workers, of which this server
+  ///        writes slot \p worker; nullptr to keep metrics of its own.
+  explicit Server(std::shared_ptr<const staxys::config::EngineConfig> config, core::Metrics *metrics = nullptr,
+                  std::size_t worker = 0);
+  ~Server() override;
+
+  Server(const Server &) = delete;
+  Server &operator=(const Server &) = delete;
+
+  /// Binds a listening socket for every entry in EngineConfig::listen_ports().
+  /// \details Entries are either a bare port ("8080") or an IPv4 address and a
+  ///          port ("127.0.0.1:8080"). With \p reusePort every worker process
+  ///          binds its own SO_REUSEPORT socket and the kernel spreads incoming
+  ///          connections across them, so no two workers wake for the same accept.
+  /// \param reusePort Whether to set SO_REUSEPORT on the listening sockets.
+  /// \return true if every port was bound, false otherwise.
+  bool listen(bool reusePort = false);
+
+  /// Runs the configured event loop until stop() is called.
+  /// \details Falls back to epoll if io_uring is configured but unavailable.
+  /// \return EXIT_SUCCESS on a clean shutdown, EXIT_FAILURE otherwise.
+  int run();
+
+  /// Asks the event loop to return. Safe to call from a signal handler or
+  /// from another thread.
+  void stop();
+
+  bool process(Connection &connection) override;
+
+  /// Copies the statistics of the loop, caches and logs into the metrics.
+  void tick() override;
+
+  /// Makes the access log reopen its file. Safe to call from a signal handler.
+  void reopen_logs();
+
+  /// The access log, or nullptr if access_log is off.
+  const logging::AccessLog *access_log() const { return m_access_log.get(); }
+
+  /// The in-memory file cache, or nullptr if cache_enabled is off.
+  const static_content::Cache *cache() const { return m_cache.get(); }
+
+  const core::Metrics &metrics() const { return *m_metrics; }
+
+private:
+  /// Opens one non-blocking listening socket for a "port" or "address:port" entry.
+  /// \return The socket fd, or -1 on failure.
+  static int open_listener(const std::string &entry, bool reusePort);
+
+  /// Raises RLIMIT_NOFILE so worker_connections can actually be reached.
+  void raise_fd_limit() const;
+
+  /// Logs the last response queued on \p connection, for \p request if it
+  /// was parsed completely.
+  void log_access(Connection &connection, const Request *request);
+
+  /// Counts the last response queued on \p connection and, with
+  /// request_timing on, stamps it for timing, for a request parsed at
+  /// \p parsedAt in CycleClock ticks.
+  void count(Connection &connection, uint64_t parsedAt);
+
+  /// Queues the response if \p request is for the health check or metrics URL.
+  /// \return false if it is for neither.
+  bool serve_endpoint(Connection &connection, const Request &request, bool keepAlive);
+
+  /// Queues the response for a GET or HEAD of a file below the static root.
+  void serve_static(Connection &connection, const Request &request, bool keepAlive);
+
+  /// Resolves m_path, the mapped request path, to the file it serves and
+  /// caches the result under it; m_path then names that file.
+  /// \return nullptr if the path does not name a file that can be served,
+  ///         in which case a redirect or error response has been queued.
+  std::shared_ptr<const static_content::Resolution> resolve(Connection &connection, const Request &request,
+                                                            bool keepAlive);
+
+  /// Queues a 206 response with the satisfiable \p ranges of \p file, as a
+  /// multipart/byteranges body if there are several.
+  void serve_ranges(Connection &connection, const Request &request,
+                    std::shared_ptr<const static_content::OpenFile> file, const utils::MimeType &mimeType,
+                    ContentCoding::Coding encoding, bool vary, const ByteRanges &ranges, bool keepAlive);
+
+  /// Whether bodies of \p mimeType are compressed on the fly, decided once
+  /// per resolution; small bodies are still sent as they are.
+  bool compressible(const utils::MimeType &mimeType) const;
+
+  /// Queues \p file compressed with \p coding: from the cache if the file
+  /// is cacheable, otherwise streamed as it is sent.
+  /// \return false if no response was queued and it should go out uncompressed.
+  bool serve_compressed(Connection &connection, const Request &request,
+                        std::shared_ptr<const static_content::OpenFile> file, const utils::MimeType &mimeType,
+                        ContentCoding::Coding coding, bool keepAlive);
+
+  /// Starts watching the static root as configured by static_watch.
+  void start_watcher();
+
+  /// Drops the cache entries of files the watcher saw change.
+  void apply_changes();
+
+  /// Logs the peak occupancy of the connection slabs and read buffers.
+  void report_pools() const;
+
+  /// The cached copy of \p file, opened from \p path, read into the cache
+  /// on a miss with \p mimeType as its Content-Type.
+  /// \return nullptr if the file is not cacheable or could not be read.
+  std::shared_ptr<const static_content::CachedFile> cached_file(const std::string &path,
+                                                                const static_content::OpenFile &file,
+                                                                const utils::MimeType &mimeType);
+
+  /// The cached copy of the file at m_path compressed with \p coding,
+  /// compressed and stored on a miss.
+  /// \return nullptr if the file is not cacheable or could not be compressed.
+  std::shared_ptr<const static_content::CachedFile>
+  compressed_file(const static_content::OpenFile &file, const utils::MimeType &mimeType,
+                  ContentCoding::Coding coding);
+
+  /// The cache key of \p path compressed with \p coding, which no file path can equal.
+  static void compressed_key(std::string &key, const std::string &path, ContentCoding::Coding coding);
+
+  /// The totals tick() last added to the metrics, which count on from there
+  /// across restarts of the worker.
+  struct Published {
+    uint64_t cache_hits = 0;
+    uint64_t cache_misses = 0;
+    uint64_t resolution_hits = 0;
+    uint64_t resolution_misses = 0;
+    uint64_t access_log_lines = 0;
+    uint64_t access_log_dropped = 0;
+    uint64_t error_log_lines = 0;
+    uint64_t error_log_suppressed = 0;
+    uint64_t error_log_dropped = 0;
+  };
+
+  std::shared_ptr<const staxys::config::EngineConfig> m_config;
+  std::vector<int> m_listeners;
+  int m_wake_fd = -1;
+  std::size_t m_max_connections = 0;
+  bool m_request_timing = false;
+  std::atomic<bool> m_running{true};
+  std::unique_ptr<EventLoop> m_loop;
+  static_content::OpenFileCache m_open_files;
+  static_content::ResolutionCache m_resolutions;
+  std::unique_ptr<static_content::Cache> m_cache;
+  std::unique_ptr<CompressorPool> m_compressors;
+  std::unique_ptr<static_content::Watcher> m_watcher;
+  static_content::Watcher::Changes m_changes;
+  std::unique_ptr<logging::AccessLog> m_access_log;
+  std::unique_ptr<core::Metrics> m_own_metrics;
+  core::Metrics *m_metrics;
+  core::WorkerMetrics *m_worker_metrics;
+  Published m_published;
+  std::string m_health_check_url;
+  // Reused for every request so mapping a target does not allocate.
+  std::string m_path;
+  std::string m_sibling_path;
+  // Boundary of the last multipart body; starts out random and counts up.
+  uint64_t m_boundary = 0;
+};
+
+} // namespace staxys::network
 
 #endif // STAXYS_SERVER_H
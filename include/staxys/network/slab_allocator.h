@@ -0,0 +1,114 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_SLAB_ALLOCATOR_H
+#define STAXYS_SLAB_ALLOCATOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace staxys::network {
+
+/// Per-worker allocator for fixed-size objects such as connections.
+/// \details Objects are carved out of slabs of \p objectsPerSlab slots and
+///          freed slots are reused most-recently-freed first, so connection
+///          churn neither fragments the heap nor calls into malloc once the
+///          slabs cover the peak. Slabs are kept until the allocator is
+///          destroyed, which has to happen after every object it made.
+///          Not synchronised.
+template <typename T> class SlabAllocator {
+public:
+  /// Destroys the object and returns its slot to the allocator.
+  struct Deleter {
+    SlabAllocator *allocator = nullptr;
+    void operator()(T *object) const { allocator->destroy(object); }
+  };
+  using Ptr = std::unique_ptr<T, Deleter>;
+
+  struct Stats {
+    /// Objects currently alive.
+    std::size_t in_use;
+    /// Slots in all slabs.
+    std::size_t capacity;
+    /// Most objects ever alive at once.
+    std::size_t high_water;
+  };
+
+  explicit SlabAllocator(std::size_t objectsPerSlab = 64)
+      : m_objects_per_slab(std::max<std::size_t>(objectsPerSlab, 1)) {}
+
+  SlabAllocator(const SlabAllocator &) = delete;
+  SlabAllocator &operator=(const SlabAllocator &) = delete;
+
+  /// Constructs a T from \p args in a free slot, adding a slab if there is none.
+  template <typename... Args> Ptr make(Args &&...args) {
+    if (m_free == nullptr) {
+      add_slab();
+    }
+    auto slot = m_free;
+    m_free = slot->next;
+    T *object;
+    try {
+      object = ::new (static_cast<void *>(slot->storage)) T(std::forward<Args>(args)...);
+    } catch (...) {
+      slot->next = m_free;
+      m_free = slot;
+      throw;
+    }
+    m_high_water = std::max(m_high_water, ++m_in_use);
+    return Ptr(object, Deleter{this});
+  }
+
+  Stats stats() const { return {m_in_use, m_slabs.size() * m_objects_per_slab, m_high_water}; }
+
+private:
+  union Slot {
+    Slot *next;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+
+  void add_slab() {
+    m_slabs.push_back(std::make_unique<Slot[]>(m_objects_per_slab));
+    auto &slab = m_slabs.back();
+    // Threaded in reverse so the slab is handed out front to back.
+    for (auto index = m_objects_per_slab; index-- > 0;) {
+      slab[index].next = m_free;
+      m_free = &slab[index];
+    }
+  }
+
+  void destroy(T *object) {
+    object->~T();
+    auto slot = reinterpret_cast<Slot *>(object);
+    slot->next = m_free;
+    m_free = slot;
+    --m_in_use;
+  }
+
+  std::size_t m_objects_per_slab;
+  std::vector<std::unique_ptr<Slot[]>> m_slabs;
+  Slot *m_free = nullptr;
+  std::size_t m_in_use = 0;
+  std::size_t m_high_water = 0;
+};
+
+} // namespace staxys::network
+
+#endif // STAXYS_SLAB_ALLOCATOR_H
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_TIMING_WHEEL_H
+#define STAXYS_TIMING_WHEEL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace staxys::network {
+
+/// Timeouts of one worker's connections, kept in a hierarchical timing wheel.
+/// \details Four levels of 64 slots each; a timer sits in the level whose
+///          slot width fits the time left until it expires, and moves down a
+///          level whenever the wheel reaches its slot. Timers are intrusive
+///          list nodes owned by their connection, so arming, re-arming and
+///          cancelling are O(1) and allocate nothing. Occupancy bitmaps give
+///          the time until the next slot that holds a timer, which the event
+///          loop uses as its wait timeout. Time is counted in ticks of
+///          \p tickMs milliseconds; timers fire up to one tick late.
+class TimingWheel {
+public:
+  static constexpr unsigned LEVEL_BITS = 6;
+  static constexpr unsigned SLOTS = 1U << LEVEL_BITS;
+  static constexpr unsigned LEVELS = 4;
+
+  /// One pending timeout; disarms itself when destroyed.
+  class Timer {
+  public:
+    Timer() = default;
+    ~Timer();
+
+    Timer(const Timer &) = delete;
+    Timer &operator=(const Timer &) = delete;
+
+    bool armed() const { return m_wheel != nullptr; }
+
+    /// Free for the owner, e.g. the fd of the connection.
+    uint64_t data = 0;
+
+  private:
+    friend class TimingWheel;
+
+    TimingWheel *m_wheel = nullptr;
+    Timer *m_previous = nullptr;
+    Timer *m_next = nullptr;
+    uint64_t m_expires = 0;
+    uint8_t m_level = 0;
+    uint8_t m_slot = 0;
+  };
+
+  /// \param tickMs Resolution of the wheel.
+  /// \param nowMs Current time on the clock later passed to advance().
+  TimingWheel(uint64_t tickMs, uint64_t nowMs);
+  ~TimingWheel();
+
+  TimingWheel(const TimingWheel &) = delete;
+  TimingWheel &operator=(const TimingWheel &) = delete;
+
+  /// Makes \p timer expire \p delayMs from the last advance(), moving it if it
+  /// is already armed. Delays beyond the span of the wheel are shortened to it.
+  void arm(Timer &timer, uint64_t delayMs);
+
+  /// Disarms \p timer; does nothing if it is not armed.
+  void cancel(Timer &timer);
+
+  /// Moves the wheel on to \p nowMs and disarms every timer that has expired
+  /// by then, appending it to \p expired.
+  /// \return How many timers expired.
+  std::size_t advance(uint64_t nowMs, std::vector<Timer *> &expired);
+
+  /// Milliseconds from \p nowMs until advance() may next have work to do.
+  /// \return -1 if no timer is armed.
+  int timeout_ms(uint64_t nowMs) const;
+
+  /// Number of armed timers.
+  std::size_t size() const { return m_size; }
+
+private:
+  void insert(Timer &timer);
+  void unlink(Timer &timer);
+
+  /// Re-inserts the timers of a slot in a higher level into the levels below.
+  void cascade(unsigned level, unsigned slot);
+
+  uint64_t m_tick_ms;
+  // The last tick advance() has processed.
+  uint64_t m_current;
+  std::size_t m_size = 0;
+  std::array<std::array<Timer *, SLOTS>, LEVELS> m_slots{};
+  std::array<uint64_t, LEVELS> m_occupied{};
+};
+
+} // namespace staxys::network
+
+#endif // STAXYS_TIMING_WHEEL_H
@@ -17,34 +17,41 @@
 #ifndef STAXYS_URI_H
 #define STAXYS_URI_H
 
-#include <map>
+#include "staxys/network/query_string.h"
+#include "staxys/utils/uri_utils.h"
+#include <memory_resource>
 #include <string>
+#include <string_view>
 
 namespace staxys::network {
 
+/// A parsed URL; its own copy of the text lives in \p resource, typically the
+/// arena of the request it came with, and every part is a view into it.
+/// \details The query is only split into parameters when first read. A Uri
+///          cannot be copied or moved, as that would leave the views behind.
 class Uri {
 public:
-  explicit Uri(std::string url);
+  explicit Uri(std::string_view url, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+  Uri(const Uri &) = delete;
+  Uri &operator=(const Uri &) = delete;
   ~Uri() = default;
   const bool is_valid_uri() const { return m_is_valid; }
-  const std::string &query_parameter(const std::string &key) const { return m_query.at(key); }
-  const std::string &port() const { return m_port; }
-  const std::string &scheme() const { return m_scheme; }
-  const std::string &host() const { return m_host; }
-  const std::string &path() const { return m_path; }
-  const std::map<std::string, std::string> &query() const { return m_query; }
-  const int query_size() const { return m_query.size(); }
-  const std::string &raw() const { return m_raw; }
-  const std::string &fragment() const { return m_fragment; }
+  /// The still-encoded value of the first parameter named \p key.
+  /// \throws std::out_of_range if there is no parameter named \p key.
+  std::string_view query_parameter(std::string_view key) const;
+  std::string_view port() const { return m_parts.port; }
+  std::string_view scheme() const { return m_parts.scheme; }
+  std::string_view host() const { return m_parts.host; }
+  std::string_view path() const { return m_parts.path; }
+  const QueryString &query() const { return m_query; }
+  const int query_size() const { return static_cast<int>(m_query.size()); }
+  const std::pmr::string &raw() const { return m_raw; }
+  std::string_view fragment() const { return m_parts.fragment; }
 
 private:
-  std::string m_raw;
-  std::string m_port;
-  std::string m_scheme;
-  std::string m_host;
-  std::string m_path;
-  std::string m_fragment;
-  std::map<std::string, std::string> m_query;
+  std::pmr::string m_raw;
+  utils::UriUtils::UriView m_parts;
+  QueryString m_query;
   bool m_is_valid;
 };
 
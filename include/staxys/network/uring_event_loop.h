@@ -0,0 +1,179 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_URING_EVENT_LOOP_H
+#define STAXYS_URING_EVENT_LOOP_H
+
+#include "staxys/network/event_loop.h"
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+namespace staxys::network {
+
+/// Completion-based loop on io_uring, driven through the raw syscalls.
+/// \details One multishot accept per listener and one multishot recv per
+///          connection stay armed for their whole lifetime, and receives draw
+///          from a provided buffer ring shared by all connections, so an idle
+///          connection pins no receive buffer. Queued responses go out as one
+///          IORING_OP_SENDMSG; when the connection is to be closed afterwards
+///          the close is linked to the final send so both go in one submission.
+///          Everything is batched into a single io_uring_enter per iteration.
+///          Kernels on which the registered ring hands out no buffers get
+///          the same buffers through IORING_OP_PROVIDE_BUFFERS instead.
+///          io_uring has no sendfile, so a file body goes out in the same
+///          SENDMSG as the headers before it, from the mapping its OpenFile
+///          keeps; the send copies from the page cache once, as sendfile
+///          does, and a response with a file body takes one submission. A
+///          file that cannot be mapped is read in chunks into a pooled buffer
+///          by an IORING_OP_READ linked to the send. An IORING_OP_TIMEOUT
+///          ends the wait when the next connection timer is due.
+class UringEventLoop final : public EventLoop {
+public:
+  using EventLoop::EventLoop;
+  ~UringEventLoop() override;
+
+  bool init() override;
+  int run() override;
+  const char *name() const override { return "io_uring"; }
+
+  /// Whether init() registers a buffer ring; without one, receive buffers
+  /// are handed over with IORING_OP_PROVIDE_BUFFERS as on older kernels.
+  void buffer_ring(const bool bufferRing) { m_buffer_ring_enabled = bufferRing; }
+
+  /// Whether file bodies are sent from a mapping of the file; without one,
+  /// they are read into pooled buffers as files that cannot be mapped are.
+  void file_mapping(const bool fileMapping) { m_file_mapping_enabled = fileMapping; }
+
+private:
+  enum class Operation : uint8_t { ACCEPT = 1, RECV, SEND, CLOSE, CANCEL, WAKE, PROVIDE, READ, TIMEOUT };
+
+  /// Same layout as __kernel_timespec, which the kernel reads on submission.
+  struct TimeoutSpec {
+    int64_t seconds;
+    int64_t nanoseconds;
+  };
+
+  /// Per-fd state; the generation tells completions for a closed connection
+  /// apart from those of a new connection that reused its fd. A slot is only
+  /// freed once none of its operations is still in the kernel.
+  struct Slot {
+    SlabAllocator<Connection>::Ptr connection;
+    uint32_t generation = 0;
+    bool recv_armed = false;
+    bool send_in_flight = false;
+    bool read_in_flight = false;
+    bool close_in_flight = false;
+    bool closing = false;
+    // Holds the chunk of an unmapped file body being read and sent.
+    BufferPool::Buffer file_buffer;
+    // Input that did not fit into the read buffer after the recv was paused
+    // but before its cancellation took effect, held in its receive buffers
+    // until the backlog has drained.
+    std::vector<std::pair<uint16_t, uint32_t>> parked;
+    std::size_t parked_bytes = 0;
+  };
+
+  static uint64_t encode(Operation operation, int fd, uint32_t generation);
+
+  bool map_rings(unsigned entries);
+  bool setup_buffer_ring();
+  bool probe_buffer_ring();
+  void provide_buffers(uint16_t firstId, unsigned count);
+  void provide_returned_buffers();
+  /// Makes room for \p count submissions, handing the queued ones to the
+  /// kernel if needed, so that a linked chain is not split.
+  bool reserve_sqes(unsigned count);
+  io_uring_sqe *next_sqe();
+  bool submit_and_wait();
+
+  void arm_accept(int listenerFd);
+  void arm_recv(int fd);
+  void arm_wake();
+
+  /// Stops receiving on a connection whose output is backlogged; serve()
+  /// arms the recv again once it has drained.
+  void pause_recv(Slot &slot);
+
+  /// Moves parked input into the read buffer as far as it fits.
+  /// \return false if none of it did.
+  bool unpark(Slot &slot);
+
+  /// Submits a timeout for the next timer unless an earlier one is in flight.
+  void arm_timeout();
+  void cancel_recv(const Slot &slot);
+  void recycle_buffer(uint16_t bufferId);
+
+  void handle_completion(const io_uring_cqe &cqe);
+  void on_accept(int listenerFd, int result, uint32_t flags);
+  void on_recv(Slot &slot, int result, uint32_t flags);
+  void on_send(Slot &slot, int result);
+  void on_read(Slot &slot);
+  void on_close(Slot &slot, int result);
+  void on_closing_completion(Slot &slot, Operation operation, int result, uint32_t flags);
+
+  /// Runs the handler over buffered input and submits any output it queued.
+  void serve(Slot &slot);
+
+  /// Closes the connections whose timeout has passed.
+  void close_expired();
+
+  /// Shuts the socket down and frees the slot once the kernel is done with it.
+  void close_connection(Slot &slot);
+
+  int m_ring_fd = -1;
+  void *m_sq_ring = nullptr;
+  void *m_cq_ring = nullptr;
+  std::size_t m_sq_ring_size = 0;
+  std::size_t m_cq_ring_size = 0;
+  io_uring_sqe *m_sqes = nullptr;
+  std::size_t m_sqes_size = 0;
+  unsigned *m_sq_head = nullptr;
+  unsigned *m_sq_tail = nullptr;
+  unsigned *m_sq_array = nullptr;
+  unsigned m_sq_mask = 0;
+  unsigned m_sq_entries = 0;
+  unsigned *m_cq_head = nullptr;
+  unsigned *m_cq_tail = nullptr;
+  unsigned m_cq_mask = 0;
+  io_uring_cqe *m_cqes = nullptr;
+  unsigned m_to_submit = 0;
+
+  io_uring_buf_ring *m_buffer_ring = nullptr;
+  std::size_t m_buffer_ring_size = 0;
+  char *m_buffers = nullptr;
+  uint16_t m_buffer_tail = 0;
+  bool m_buffer_ring_enabled = true;
+  bool m_use_buffer_ring = false;
+  std::vector<uint16_t> m_returned_buffers;
+
+  bool m_file_mapping_enabled = true;
+
+  std::vector<Slot> m_slots;
+
+  TimeoutSpec m_timeout_spec{};
+  // When the earliest timeout in flight completes; UINT64_MAX if none is.
+  uint64_t m_timeout_deadline = UINT64_MAX;
+};
+
+} // namespace staxys::network
+
+#endif // STAXYS_URING_EVENT_LOOP_H
@@ -17,6 +17,129 @@
 #ifndef STAXYS_CACHE_H
 #define STAXYS_CACHE_H
 
-// TODO: Implement Cache
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+#include <unordered_map>
+
+namespace staxys::static_content {
+
+/// A small file held in memory, with the response headers that describe it.
+struct CachedFile {
+  /// Preformatted header lines, e.g. "Content-Type: text/css\r\nContent-Length: 7\r\n".
+  std::string headers;
+  std::string body;
+  /// Identity of the file the body was read from.
+  dev_t device = 0;
+  ino_t inode = 0;
+  off_t size = 0;
+  timespec modified{};
+
+  /// Whether \p info still describes the file the body was read from.
+  bool matches(const struct stat &info) const;
+};
+
+/// In-memory cache of small, hot static files keyed by resolved path.
+/// \details Entries are spread over shards by the hash of their path, each
+///          guarded by its own mutex, so threads sharing one cache rarely
+///          contend and a single-threaded worker pays one uncontended lock
+///          per lookup. Every shard evicts with a segmented LRU: new entries
+///          go to a probationary segment and move to the protected one on
+///          their second hit, so a scan of one-off requests cannot flush the
+///          files that are actually hot. Entries expire after the TTL and are
+///          dropped as soon as the file on disk no longer matches them.
+class Cache {
+public:
+  static constexpr std::size_t SHARD_COUNT = 16;
+
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t insertions = 0;
+    uint64_t evictions = 0;
+    std::size_t entries = 0;
+    std::size_t bytes = 0;
+  };
+
+  /// \param maxBytes Byte budget over all shards, including bookkeeping.
+  /// \param maxFileSize Largest file body that is cached.
+  /// \param ttlMs How long an entry may be served before it is read again.
+  Cache(std::size_t maxBytes, std::size_t maxFileSize, uint64_t ttlMs);
+
+  Cache(const Cache &) = delete;
+  Cache &operator=(const Cache &) = delete;
+
+  /// Whether a file of \p size bytes is small enough to be cached.
+  bool admits(uint64_t size) const { return size <= m_max_file_size; }
+
+  /// The entry for \p path if it is fresh and matches \p info, the fstat of
+  /// the file as it is now; stale entries are dropped.
+  std::shared_ptr<const CachedFile> find(const std::string &path, const struct stat &info);
+
+  /// Adds or replaces the entry for \p path, evicting as needed.
+  /// \return false if the entry is too large to be cached.
+  bool insert(const std::string &path, std::shared_ptr<const CachedFile> file);
+
+  void erase(const std::string &path);
+
+  void clear();
+
+  Stats stats() const;
+
+private:
+  struct Node {
+    std::string path;
+    std::shared_ptr<const CachedFile> file;
+    uint64_t expires_at;
+    std::size_t charge;
+    bool protected_segment;
+  };
+  using NodeList = std::list<Node>;
+
+  struct Shard {
+    mutable std::mutex mutex;
+    // Most recently used first. Keys view the path stored in the node.
+    NodeList probation;
+    NodeList protected_nodes;
+    std::unordered_map<std::string_view, NodeList::iterator> index;
+    std::size_t probation_bytes = 0;
+    std::size_t protected_bytes = 0;
+  };
+
+  static uint64_t now_ms();
+
+  Shard &shard_for(const std::string &path);
+
+  /// Removes \p node from its segment and the index. The shard must be locked.
+  static void unlink(Shard &shard, NodeList::iterator node);
+
+  /// Moves \p node to the protected segment, demoting its least recently
+  /// used entries to probation while the segment is over its share.
+  void promote(Shard &shard, NodeList::iterator node) const;
+
+  /// Evicts from the tail of probation, then of protected, until the shard
+  /// fits its budget. The shard must be locked.
+  void evict(Shard &shard);
+
+  std::size_t m_shard_budget;
+  std::size_t m_protected_budget;
+  std::size_t m_max_file_size;
+  uint64_t m_ttl_ms;
+  std::array<Shard, SHARD_COUNT> m_shards;
+
+  std::atomic<uint64_t> m_hits{0};
+  std::atomic<uint64_t> m_misses{0};
+  std::atomic<uint64_t> m_insertions{0};
+  std::atomic<uint64_t> m_evictions{0};
+};
+
+} // namespace staxys::static_content
 
 #endif // STAXYS_CACHE_H
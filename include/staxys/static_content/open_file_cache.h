@@ -0,0 +1,134 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_OPEN_FILE_CACHE_H
+#define STAXYS_OPEN_FILE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+#include <unordered_map>
+
+namespace staxys::static_content {
+
+/// A read-only file descriptor and the fstat taken when it was opened.
+/// \details Shared between the cache and every response still sending from
+///          it, so evicting or replacing a cache entry never closes a file
+///          under an in-progress sendfile. The ETag and Last-Modified
+///          validators are formatted once when the file is opened, so a
+///          revalidation served from the cache needs neither a system call
+///          nor any formatting. Loops that cannot sendfile send from a
+///          mapping of the file, made on first use and kept as long as the
+///          descriptor.
+class OpenFile {
+public:
+  OpenFile(int fd, const struct stat &info);
+  ~OpenFile();
+
+  OpenFile(const OpenFile &) = delete;
+  OpenFile &operator=(const OpenFile &) = delete;
+
+  int fd() const { return m_fd; }
+  const struct stat &info() const { return m_info; }
+  uint64_t size() const { return static_cast<uint64_t>(m_info.st_size); }
+  bool is_directory() const { return S_ISDIR(m_info.st_mode); }
+
+  /// The strong entity tag, quotes included, e.g. "\"67839a20-1f40\"".
+  std::string_view etag() const;
+
+  /// The modification time as an HTTP date.
+  std::string_view last_modified() const;
+
+  /// "ETag: ...\r\nLast-Modified: ...\r\n"; with \p weak the entity tag is
+  /// marked weak, for representations such as compressed ones that are not
+  /// byte-for-byte the file.
+  std::string_view validators(bool weak = false) const;
+
+  /// The file mapped read-only, shared with the page cache; mapped by the
+  /// first call, so that files only ever sent with sendfile are not.
+  /// \details Like the cache that hands the file out, not thread-safe.
+  /// \return nullptr for an empty file or one that cannot be mapped.
+  const char *mapping() const;
+
+private:
+  int m_fd;
+  struct stat m_info;
+  mutable void *m_mapping = nullptr;
+  mutable bool m_mapped = false;
+  // The weak header lines followed by the strong ones.
+  std::string m_validators;
+  std::size_t m_strong_offset = 0;
+  std::size_t m_etag_length = 0;
+};
+
+/// Open descriptors of recently served files, keyed by path.
+/// \details A hit costs a hash lookup and no system call. Entries are
+///          revalidated with stat() once they are older than the validity
+///          period and reopened if the file was replaced or changed. Failed
+///          lookups are cached the same way, so requests for a missing file
+///          do not each pay for an open(). The least recently used entry is
+///          evicted beyond the capacity. Each worker owns its own cache; it is
+///          not thread-safe.
+class OpenFileCache {
+public:
+  static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+  static constexpr uint64_t DEFAULT_VALIDITY_MS = 1000;
+
+  explicit OpenFileCache(std::size_t capacity = DEFAULT_CAPACITY, uint64_t validityMs = DEFAULT_VALIDITY_MS)
+      : m_capacity(capacity), m_validity_ns(validityMs * 1000000) {}
+
+  /// Opens \p path, or returns the cached descriptor for it.
+  /// \param error Set to the errno of a failed open, e.g. ENOENT or EACCES.
+  /// \return The open file, or nullptr if it could not be opened.
+  std::shared_ptr<const OpenFile> open(const std::string &path, int &error);
+
+  /// Drops the entry for \p path so the next open() goes to the filesystem.
+  void invalidate(const std::string &path);
+
+  void clear();
+
+  std::size_t size() const { return m_entries.size(); }
+
+private:
+  struct Entry {
+    std::shared_ptr<const OpenFile> file;
+    int error = 0;
+    uint64_t checked_at = 0;
+    std::list<std::string>::iterator position;
+  };
+
+  static uint64_t now_ns();
+
+  /// Whether the file at \p path is still the one \p entry describes.
+  static bool still_valid(const std::string &path, const Entry &entry);
+
+  /// Opens and fstats \p path into \p entry.
+  static void load(const std::string &path, Entry &entry);
+
+  std::size_t m_capacity;
+  uint64_t m_validity_ns;
+  // Most recently used first.
+  std::list<std::string> m_order;
+  std::unordered_map<std::string, Entry> m_entries;
+};
+
+} // namespace staxys::static_content
+
+#endif // STAXYS_OPEN_FILE_CACHE_H
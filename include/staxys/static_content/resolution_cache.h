@@ -0,0 +1,132 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_RESOLUTION_CACHE_H
+#define STAXYS_RESOLUTION_CACHE_H
+
+#include "staxys/static_content/open_file_cache.h"
+#include "staxys/utils/mime_types.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace staxys::static_content {
+
+/// What a request path below the static root was resolved to.
+struct Resolution {
+  /// Most sibling files, such as precompressed copies, kept with a file.
+  static constexpr std::size_t MAX_SIBLINGS = 2;
+
+  /// The file served, with the default index appended for a directory.
+  std::string path;
+  std::shared_ptr<const OpenFile> file;
+  const utils::MimeType *mime_type = nullptr;
+  /// Whether bodies of this type are compressed on the fly if large enough.
+  bool compressible = false;
+  /// Files next to \p file in the order their owner looks for them, e.g.
+  /// the .br and .gz copies; nullptr where there is none worth serving.
+  std::array<std::shared_ptr<const OpenFile>, MAX_SIBLINGS> siblings;
+};
+
+/// Resolved static files keyed by the normalized request path mapped below
+/// the static root, so a hot URL is served without building the file path,
+/// looking up its MIME type or touching the filesystem.
+/// \details Entries are spread over shards by the hash of their key, each
+///          guarded by its own mutex and evicting its least recently used
+///          entry beyond its share of the capacity. Lookups take a view and
+///          allocate nothing. With a validity period, entries are dropped
+///          once older than it; with none, they last until invalidated, for
+///          a server that learns of changes from a watcher. Each shard also
+///          orders its entries by the file they resolve to, so that
+///          invalidating a file or directory is a lookup and a walk over the
+///          paths below it rather than a scan of the whole cache.
+class ResolutionCache {
+public:
+  static constexpr std::size_t SHARD_COUNT = 16;
+
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    std::size_t entries = 0;
+  };
+
+  /// \param validityMs How long an entry is used; 0 keeps it until invalidated.
+  ResolutionCache(std::size_t capacity, uint64_t validityMs);
+
+  ResolutionCache(const ResolutionCache &) = delete;
+  ResolutionCache &operator=(const ResolutionCache &) = delete;
+
+  /// Changes the validity period of entries inserted from now on.
+  void validity(uint64_t validityMs) { m_validity_ms = validityMs; }
+
+  /// The fresh entry for \p key, or nullptr.
+  std::shared_ptr<const Resolution> find(std::string_view key);
+
+  /// Adds or replaces the entry for \p key.
+  void insert(std::string_view key, std::shared_ptr<const Resolution> resolution);
+
+  /// Drops every entry whose file is \p path, lies below it, or is \p path
+  /// with extensions removed as a file is of its siblings ("a.css" of
+  /// "a.css.gz").
+  void invalidate(std::string_view path);
+
+  void clear();
+
+  Stats stats() const;
+
+private:
+  struct Node {
+    std::string key;
+    std::shared_ptr<const Resolution> resolution;
+    uint64_t expires_at;
+  };
+  using NodeList = std::list<Node>;
+
+  struct Shard {
+    mutable std::mutex mutex;
+    // Most recently used first. Keys view the key stored in the node.
+    NodeList nodes;
+    std::unordered_map<std::string_view, NodeList::iterator> index;
+    // Keys view the path of the resolution in the node.
+    std::multimap<std::string_view, NodeList::iterator> by_file;
+  };
+
+  static uint64_t now_ms();
+
+  Shard &shard_for(std::string_view key);
+
+  /// Removes \p node from \p shard and both its indexes.
+  static void erase(Shard &shard, NodeList::iterator node);
+
+  std::size_t m_shard_capacity;
+  uint64_t m_validity_ms;
+  std::array<Shard, SHARD_COUNT> m_shards;
+
+  std::atomic<uint64_t> m_hits{0};
+  std::atomic<uint64_t> m_misses{0};
+};
+
+} // namespace staxys::static_content
+
+#endif // STAXYS_RESOLUTION_CACHE_H
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_WATCHER_H
+#define STAXYS_WATCHER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace staxys::static_content {
+
+/// Watches the static root from a background thread and reports what changed.
+/// \details With inotify every directory below the root is watched. Where
+///          inotify is unavailable or its watch limit is reached, the thread
+///          instead rescans the tree every poll interval and compares what it
+///          finds with the previous scan. Changes are only collected here;
+///          the worker takes them with take_changes() and invalidates its own
+///          caches, so no cache is touched from two threads.
+class Watcher {
+public:
+  enum class Mode { INOTIFY, POLL };
+
+  /// What changed since the previous take_changes().
+  struct Changes {
+    /// A directory moved or disappeared, or events were lost: drop everything.
+    bool everything = false;
+    /// Files that were written, created, deleted or moved.
+    std::vector<std::string> paths;
+  };
+
+  static constexpr std::chrono::milliseconds DEFAULT_POLL_INTERVAL{2000};
+
+  explicit Watcher(std::string root, std::chrono::milliseconds pollInterval = DEFAULT_POLL_INTERVAL);
+  ~Watcher();
+
+  Watcher(const Watcher &) = delete;
+  Watcher &operator=(const Watcher &) = delete;
+
+  /// Starts the thread.
+  /// \param preferred POLL skips inotify; INOTIFY falls back to polling if it fails.
+  /// \return false if the thread could not be started.
+  bool start(Mode preferred = Mode::INOTIFY);
+
+  /// Stops and joins the thread; called by the destructor.
+  void stop();
+
+  /// The mechanism in use; INOTIFY until the thread had to fall back.
+  Mode mode() const { return m_mode.load(std::memory_order_relaxed); }
+
+  /// Whether changes are waiting; a relaxed load, cheap enough for every request.
+  bool has_changes() const { return m_pending.load(std::memory_order_relaxed); }
+
+  /// Moves the collected changes into \p changes.
+  /// \return false if nothing changed.
+  bool take_changes(Changes &changes);
+
+private:
+  /// What a scan remembers about a file to tell whether it changed.
+  struct FileState {
+    ino_t inode;
+    off_t size;
+    int64_t modified_ns;
+  };
+
+  bool init_inotify();
+  bool add_watches(const std::string &directory);
+  void run(Mode preferred);
+
+  /// Handles inotify events until stop(), or until a watch cannot be added.
+  /// \return false if the caller should fall back to polling.
+  bool run_inotify();
+  void run_poll();
+
+  /// Lists every regular file below the root.
+  void scan(std::unordered_map<std::string, FileState> &files) const;
+
+  /// Waits up to \p timeoutMs for the inotify fd or the stop signal.
+  /// \return false once stop() was called.
+  bool wait(int timeoutMs) const;
+
+  void report(std::string path);
+  void report_everything();
+
+  std::string m_root;
+  std::chrono::milliseconds m_poll_interval;
+  std::atomic<Mode> m_mode{Mode::INOTIFY};
+  int m_inotify_fd = -1;
+  int m_stop_fd = -1;
+  std::unordered_map<int, std::string> m_directories;
+  std::thread m_thread;
+
+  std::mutex m_mutex;
+  Changes m_changes;
+  std::atomic<bool> m_pending{false};
+};
+
+} // namespace staxys::static_content
+
+#endif // STAXYS_WATCHER_H
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_DATE_UTILS_H
+#define STAXYS_DATE_UTILS_H
+
+#include <cstddef>
+#include <ctime>
+#include <string_view>
+
+namespace staxys::utils {
+
+/// HTTP dates in the IMF-fixdate form of RFC 9110, e.g. "Sun, 06 Nov 1994 08:49:37 GMT".
+class DateUtils {
+public:
+  /// Length of a formatted date, without a terminating NUL.
+  static constexpr std::size_t HTTP_DATE_LENGTH = 29;
+
+  /// Writes \p time as an IMF-fixdate into \p out, which must hold
+  /// HTTP_DATE_LENGTH + 1 bytes.
+  /// \return The length written, without the terminating NUL.
+  static std::size_t format_http_date(time_t time, char *out);
+
+  /// Parses an IMF-fixdate. The obsolete RFC 850 and asctime forms are not
+  /// accepted, so conditions that use them are ignored, as RFC 9110 allows
+  /// for dates a recipient cannot parse.
+  /// \return false if \p text is not a valid IMF-fixdate.
+  static bool parse_http_date(std::string_view text, time_t &time);
+};
+
+} // namespace staxys::utils
+
+#endif // STAXYS_DATE_UTILS_H
@@ -17,6 +17,28 @@
 #ifndef STAXYS_FILE_UTILS_H
 #define STAXYS_FILE_UTILS_H
 
-// TODO: Implement FileUtils
+#include <string>
+#include <string_view>
+
+namespace staxys::utils {
+
+/// Mapping of request targets onto the static root.
+class FileUtils {
+public:
+  /// Builds the filesystem path for a request target below \p root.
+  /// \details The query is dropped, percent-escapes in the path are decoded
+  ///          and dot segments removed. A target that is not an absolute
+  ///          path, contains an encoded NUL or '/', or climbs above the root
+  ///          with ".." is refused, so the result never leaves \p root. A
+  ///          trailing '/' is kept.
+  /// \return false if the target is refused.
+  static bool map_target(std::string_view root, std::string_view target, std::string &path);
+
+  /// Content-Type for a file name, from its extension; application/octet-stream
+  /// if the extension is unknown. See MimeTypes for the header line itself.
+  static std::string_view mime_type(std::string_view path);
+};
+
+} // namespace staxys::utils
 
 #endif // STAXYS_FILE_UTILS_H
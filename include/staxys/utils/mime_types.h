@@ -0,0 +1,83 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_MIME_TYPES_H
+#define STAXYS_MIME_TYPES_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace staxys::utils {
+
+/// A media type, kept as the complete header line that announces it.
+struct MimeType {
+  static constexpr std::string_view HEADER_PREFIX = "Content-Type: ";
+
+  /// "Content-Type: <value>\r\n", ready to go into a response as it is.
+  std::string_view header;
+
+  /// The field value, e.g. "text/html; charset=utf-8".
+  constexpr std::string_view value() const {
+    return header.substr(HEADER_PREFIX.size(), header.size() - HEADER_PREFIX.size() - 2);
+  }
+
+  /// The type without parameters, e.g. "text/html", to classify content by.
+  constexpr std::string_view essence() const {
+    auto text = value();
+    return text.substr(0, text.find(';'));
+  }
+};
+
+/// Media types of static files by file name extension.
+/// \details The built-in types are laid out in a perfect hash table when
+///          the server is compiled: a lookup hashes the extension, ignoring
+///          case, picks the bucket's seed, hashes again with it and compares
+///          the one slot it lands on, without allocating or building strings.
+///          A mime.types file can add to or override them; it is laid out
+///          the same way when loaded, at startup.
+class MimeTypes {
+public:
+  /// Longer extensions are never known.
+  static constexpr std::size_t MAX_EXTENSION = 32;
+
+  /// The type of a file from the extension of its name, or fallback().
+  static const MimeType &for_path(std::string_view path);
+
+  /// The type for \p extension, given without the dot, or fallback().
+  static const MimeType &for_extension(std::string_view extension);
+
+  /// application/octet-stream, for files of unknown type.
+  static const MimeType &fallback();
+
+  /// Number of extensions known.
+  static std::size_t size();
+
+  /// Adds the types in \p path, in the mime.types format of one media type
+  /// followed by its extensions per line and '#' comments, to the built-in
+  /// ones; an extension listed in the file replaces the built-in type.
+  /// \details Invalid lines are reported and skipped. Not safe while other
+  ///          threads look types up; types handed out earlier stay valid.
+  /// \return false if the file could not be read, leaving the types as they were.
+  static bool load(const std::string &path);
+
+  /// Goes back to the built-in types alone.
+  static void reset();
+};
+
+} // namespace staxys::utils
+
+#endif // STAXYS_MIME_TYPES_H
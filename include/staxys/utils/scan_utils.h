@@ -0,0 +1,71 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STAXYS_SCAN_UTILS_H
+#define STAXYS_SCAN_UTILS_H
+
+#include <cstddef>
+
+namespace staxys::utils {
+
+/// Character-class scans for the HTTP parser and URI percent-coding.
+/// \details Each scan returns the index of the first byte outside its class,
+///          or \p size if there is none, so the delimiter search and the
+///          validation of the bytes before it are one pass. On x86-64 the
+///          SSE4.2 or AVX2 version is picked at startup from CPUID; every
+///          version returns exactly what the scalar one does.
+class ScanUtils {
+public:
+  enum class Isa { SCALAR, SSE42, AVX2 };
+
+  /// First byte that is not a tchar (RFC 9110 section 5.6.2), e.g. the ':'
+  /// after a field name or the space after a method.
+  static std::size_t find_non_token(const char *data, std::size_t size);
+
+  /// First byte that may not appear in a field value: a control character
+  /// other than HT (which includes CR and LF), or DEL.
+  static std::size_t find_non_value(const char *data, std::size_t size);
+
+  /// First byte that may not appear in a request target: a control
+  /// character, space or DEL.
+  static std::size_t find_non_target(const char *data, std::size_t size);
+
+  /// First byte that is not unreserved in a URI (RFC 3986 section 2.3), i.e.
+  /// the next one percent-encoding has to escape.
+  static std::size_t find_non_unreserved(const char *data, std::size_t size);
+
+  /// The same scans on a specific instruction set, for tests and benchmarks.
+  static std::size_t find_non_token(Isa isa, const char *data, std::size_t size);
+  static std::size_t find_non_value(Isa isa, const char *data, std::size_t size);
+  static std::size_t find_non_target(Isa isa, const char *data, std::size_t size);
+  static std::size_t find_non_unreserved(Isa isa, const char *data, std::size_t size);
+
+  /// Whether this CPU can run \p isa.
+  static bool is_supported(Isa isa);
+
+  /// The instruction set the unqualified scans use.
+  static Isa active_isa();
+
+  /// Switches the unqualified scans to \p isa if it is supported.
+  /// \return false if it is not, leaving the active one unchanged.
+  static bool use_isa(Isa isa);
+
+  static const char *isa_name(Isa isa);
+};
+
+} // namespace staxys::utils
+
+#endif // STAXYS_SCAN_UTILS_H
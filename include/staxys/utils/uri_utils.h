@@ -17,40 +17,124 @@
 #ifndef STAXYS_URI_UTILS_H
 #define STAXYS_URI_UTILS_H
 
+#include <cstddef>
+#include <functional>
 #include <map>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 
 namespace staxys::utils {
 
 class UriUtils {
 public:
+  /// Query parameters by name; looked up with any string type.
+  using QueryMap = std::pmr::map<std::pmr::string, std::pmr::string, std::less<>>;
+
+  /// The parts of a URI, allocated from the memory resource they were
+  /// constructed with, e.g. the arena of the request they belong to.
   struct UriComponents {
-    std::string scheme;
-    std::string host;
-    std::string port;
-    std::string path;
-    std::map<std::string, std::string> query;
-    std::string fragment;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+    explicit UriComponents(const allocator_type &allocator = {})
+        : scheme(allocator), host(allocator), port(allocator), path(allocator), query(allocator),
+          fragment(allocator) {}
+    UriComponents(const UriComponents &other, const allocator_type &allocator)
+        : scheme(other.scheme, allocator), host(other.host, allocator), port(other.port, allocator),
+          path(other.path, allocator), query(other.query, allocator), fragment(other.fragment, allocator) {}
+
+    std::pmr::string scheme;
+    std::pmr::string host;
+    std::pmr::string port;
+    std::pmr::string path;
+    QueryMap query;
+    std::pmr::string fragment;
   };
 
-  static bool parse(const std::string &, UriComponents &);
+  /// The parts of a URI as views into the string they were parsed from,
+  /// which must outlive them.
+  struct UriView {
+    std::string_view scheme;
+    std::string_view userinfo;
+    std::string_view host;
+    std::string_view port;
+    std::string_view path;
+    std::string_view query;
+    std::string_view fragment;
+  };
+
+  /// Splits \p uri into its parts by the grammar of RFC 3986, in one pass and
+  /// without allocating.
+  /// \details A URI that does not start with "scheme://" is read as starting
+  ///          with its authority and gets the scheme "http", so "example.com"
+  ///          and "/index.html" both parse. An empty path is "/". An IP-literal
+  ///          host keeps its brackets.
+  /// \return false if \p uri is empty or not a URI, e.g. it contains a space,
+  ///         a malformed percent-escape or a port that is not a number.
+  static bool parse(std::string_view uri, UriView &view);
+
+  /// Parses like the UriView overload, then copies the parts into
+  /// \p components and splits the query into parameters.
+  static bool parse(std::string_view uri, UriComponents &components);
 
+  /// Percent-encodes every byte of \p input that is not unreserved.
   static std::string encode(const std::string &);
 
+  /// Percent-decodes \p input.
+  /// \return An empty string if \p input has a malformed escape.
   static std::string decode(const std::string &);
 
+  /// Bytes the percent-encoding of \p input takes.
+  static std::size_t encoded_size(std::string_view input);
+
+  /// Percent-encodes \p input into \p output, which needs room for
+  /// encoded_size(input) bytes.
+  /// \details Runs of unreserved bytes are found with the vector scans of
+  ///          ScanUtils and copied whole; only the bytes between them go
+  ///          through the hex table.
+  /// \return The encoded size.
+  static std::size_t encode(std::string_view input, char *output);
+
+  /// Percent-decodes \p input into \p output, which needs room for
+  /// input.size() bytes and may be input.data() itself to decode in place.
+  /// \details Runs without a '%' are found with memchr and moved whole, or
+  ///          not at all when decoding in place, so clean input costs about
+  ///          as much as a memcpy.
+  /// \return The decoded size, or std::string_view::npos if \p input has a
+  ///         '%' not followed by two hex digits; \p output then holds part
+  ///         of the result.
+  static std::size_t decode(std::string_view input, char *output);
+
+  /// Value of the hex digit \p c, in either case.
+  /// \return The value, or -1 if \p c is not a hex digit.
+  static int hex_value(char c);
+
+  /// Decodes the path of an origin-form request target and removes its dot
+  /// segments, into \p output, which needs room for path.size() bytes and
+  /// may be path.data() itself.
+  /// \details Each segment is decoded before it is looked at, so "%2e%2e"
+  ///          counts as "..". Nothing is allocated. A path that ends in a dot
+  ///          segment keeps a trailing '/'.
+  /// \return The normalized size, or std::string_view::npos if \p path does
+  ///         not start with '/', has a malformed escape, decodes a '/' or NUL
+  ///         inside a segment, or climbs above the root with "..".
+  static std::size_t normalize_path(std::string_view path, char *output);
+
+  /// Resolves \p relative against \p base as RFC 3986 section 5.2 does,
+  /// removing dot segments from the merged path.
+  /// \return An empty string if \p base is not a valid URI.
   static std::string resolve(const std::string &, const std::string &);
 
-  static bool validate(const std::string &);
+  static bool validate(std::string_view);
 
   static std::string get_path(const std::string &);
 
-  static std::map<std::string, std::string> get_query(const std::string &);
+  static QueryMap get_query(const std::string &);
 
   static std::string join(const std::string &, const std::string &);
 
 private:
-  static bool parse_query(const std::string &, std::map<std::string, std::string> &);
+  static bool parse_query(std::string_view, QueryMap &);
 };
 
 } // namespace staxys::utils
@@ -17,6 +17,7 @@
 #include "staxys/config/loader.h"
 #include "staxys/config/validator.h"
 #include "staxys/core/engine.h"
+#include "staxys/utils/mime_types.h"
 #include <boost/program_options.hpp>
 #include <boost/program_options/options_description.hpp>
 #include <cstdlib>
@@ -77,6 +78,9 @@ int main(int argc, char *argv[]) {
     std::string command = variables_map["command"].as<std::string>();
     std::cout << "Command: " << command << std::endl;
 
+    // Optional: adds to or overrides the built-in MIME types.
+    staxys::utils::MimeTypes::load("/etc/staxys/mime_types");
+
     staxys::core::Engine engine(config);
 
     if (command == "start") {
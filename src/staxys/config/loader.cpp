@@ -16,18 +16,106 @@
 
 #include "staxys/config/loader.h"
 
+#include "staxys/core/logger.h"
 #include "staxys/utils/string_utils.h"
+#include <algorithm>
 #include <fstream>
-#include <iostream>
+#include <limits>
 #include <regex>
+#include <stdexcept>
 
 namespace staxys::config {
 
+namespace {
+/// Parses a byte count with an optional k, m or g suffix, e.g. "512k".
+/// \throws std::invalid_argument If \p value is negative, has an unknown
+///         suffix or does not fit a std::size_t once scaled.
+std::size_t parse_size(const std::string &value) {
+  // std::stoull would take "-1" as the largest value there is.
+  if (value.empty() || value.front() == '-') {
+    throw std::invalid_argument("invalid size: " + value);
+  }
+  std::size_t digits = 0;
+  auto number = std::stoull(value, &digits);
+  auto suffix = value.substr(digits);
+  std::size_t scale = 1;
+  switch (suffix.empty() ? '\0' : suffix.size() == 1 ? suffix[0] : '?') {
+  case '\0':
+    break;
+  case 'k':
+  case 'K':
+    scale = 1024;
+    break;
+  case 'm':
+  case 'M':
+    scale = 1024 * 1024;
+    break;
+  case 'g':
+  case 'G':
+    scale = 1024 * 1024 * 1024;
+    break;
+  default:
+    throw std::invalid_argument("invalid size: " + value);
+  }
+  if (number > std::numeric_limits<std::size_t>::max() / scale) {
+    throw std::invalid_argument("size out of range: " + value);
+  }
+  return number * scale;
+}
+
+/// Parses a duration in seconds with an optional s, m, h or d suffix, e.g. "2m".
+/// \throws std::invalid_argument If \p value is negative, has an unknown
+///         suffix or does not fit an int once scaled.
+int parse_duration(const std::string &value) {
+  if (value.empty() || value.front() == '-') {
+    throw std::invalid_argument("invalid duration: " + value);
+  }
+  std::size_t digits = 0;
+  auto number = std::stoi(value, &digits);
+  auto suffix = value.substr(digits);
+  int scale = 1;
+  switch (suffix.empty() ? 's' : suffix.size() == 1 ? suffix[0] : '?') {
+  case 's':
+    break;
+  case 'm':
+    scale = 60;
+    break;
+  case 'h':
+    scale = 60 * 60;
+    break;
+  case 'd':
+    scale = 24 * 60 * 60;
+    break;
+  default:
+    throw std::invalid_argument("invalid duration: " + value);
+  }
+  if (number > std::numeric_limits<int>::max() / scale) {
+    throw std::invalid_argument("duration out of range: " + value);
+  }
+  return number * scale;
+}
+
+/// Splits a semicolon-separated list, dropping blanks around each entry.
+std::vector<std::string> parse_list(const std::string &value) {
+  std::vector<std::string> entries;
+  std::size_t start = 0;
+  while (start <= value.size()) {
+    auto end = std::min(value.find(';', start), value.size());
+    auto entry = utils::StringUtils::trim(value.substr(start, end - start));
+    if (!entry.empty()) {
+      entries.push_back(entry);
+    }
+    start = end + 1;
+  }
+  return entries;
+}
+} // namespace
+
 std::shared_ptr<const EngineConfig> Loader::load_engine_config(const std::string &server_config_path) {
   auto engine_config = std::make_shared<EngineConfig>();
   std::ifstream file(server_config_path);
   if (!file.is_open()) {
-    std::cout << "Failed to open file: " << server_config_path << std::endl;
+    STAXYS_LOG(ERROR) << "Failed to open file: " << server_config_path;
     return engine_config;
   }
 
@@ -97,6 +185,14 @@ std::shared_ptr<const EngineConfig> Loader::load_engine_config(const std::string
         engine_config->access_log(value);
       } else if (key == "access_log") {
         engine_config->access_log(value);
+      } else if (key == "access_log_buffer") {
+        engine_config->access_log_buffer(parse_size(value));
+      } else if (key == "access_log_overflow") {
+        engine_config->access_log_overflow(value);
+      } else if (key == "access_log_flush") {
+        engine_config->access_log_flush(parse_duration(value));
+      } else if (key == "access_log_format") {
+        engine_config->access_log_format(value);
       } else if (key == "error_log") {
         engine_config->error_log(value);
       } else if (key == "log_level") {
@@ -108,38 +204,63 @@ std::shared_ptr<const EngineConfig> Loader::load_engine_config(const std::string
       } else if (key == "ssl_key") {
         engine_config->ssl_key(value);
       } else if (key == "worker_processes") {
-        engine_config->worker_processes(std::stoi(value));
+        // "auto" (stored as 0) runs one worker per available CPU.
+        engine_config->worker_processes(value == "auto" ? 0 : std::stoi(value));
       } else if (key == "worker_connections") {
         engine_config->worker_connections(std::stoi(value));
+      } else if (key == "io_backend") {
+        engine_config->io_backend(value);
+      } else if (key == "sendfile_max_chunk") {
+        engine_config->sendfile_max_chunk(parse_size(value));
       } else if (key == "http2_enabled") {
         engine_config->http2_enabled(value == "false");
       } else if (key == "client_max_body_size") {
-        engine_config->client_max_body_size(value);
+        engine_config->client_max_body_size(parse_size(value));
       } else if (key == "client_body_timeout") {
-        // TODO: parse shorthand time values
+        engine_config->client_body_timeout(parse_duration(value));
       } else if (key == "send_timeout") {
-        engine_config->send_timeout(std::stoi(value));
+        engine_config->send_timeout(parse_duration(value));
       } else if (key == "keep_alive_timeout") {
-        engine_config->keep_alive_timeout(std::stoi(value));
+        engine_config->keep_alive_timeout(parse_duration(value));
       } else if (key == "allowed_ips") {
         // TODO: handle allowed ip's
       } else if (key == "denied_ips") {
         // TODO: handle denied ip's
       } else if (key == "enable_basic_auth") {
         engine_config->enable_basic_auth(value == "false");
+      } else if (key == "static_watch") {
+        engine_config->static_watch(value);
       } else if (key == "cache_enabled") {
-        engine_config->cache_enabled(value == "false");
+        engine_config->cache_enabled(value == "true");
+      } else if (key == "cache_max_size") {
+        engine_config->cache_max_size(parse_size(value));
+      } else if (key == "cache_max_file_size") {
+        engine_config->cache_max_file_size(parse_size(value));
       } else if (key == "cache_path") {
         engine_config->cache_path(value);
       } else if (key == "cache_duration") {
-        engine_config->cache_duration(std::stoi(value));
+        engine_config->cache_duration(parse_duration(value));
+      } else if (key == "compression_enabled") {
+        engine_config->compression_enabled(value == "true");
+      } else if (key == "compression_level") {
+        engine_config->compression_level(std::stoi(value));
+      } else if (key == "compression_min_size") {
+        engine_config->compression_min_size(parse_size(value));
+      } else if (key == "compression_types") {
+        engine_config->compression_types(parse_list(value));
+      } else if (key == "compression_contexts") {
+        engine_config->compression_contexts(std::stoul(value));
       } else if (key == "health_check_enabled") {
-        engine_config->health_check_enabled(value == "false");
+        engine_config->health_check_enabled(value == "true");
       } else if (key == "health_check_url") {
         engine_config->health_check_url(value);
+      } else if (key == "metrics_url") {
+        engine_config->metrics_url(value);
+      } else if (key == "request_timing") {
+        engine_config->request_timing(value == "true");
       } else {
         // TODO: We may not want to log this in production environments
-        std::cout << "Unknown key: " << key << std::endl;
+        STAXYS_LOG(WARNING) << "Unknown key: " << key;
       }
     }
 
@@ -147,7 +268,7 @@ std::shared_ptr<const EngineConfig> Loader::load_engine_config(const std::string
   } catch (const std::exception &e) {
 
     // TODO: We may not want to log this in production environments
-    std::cerr << "Error parsing engine config: " << e.what() << std::endl;
+    STAXYS_LOG(ERROR) << "Error parsing engine config: " << e.what();
     return engine_config;
   }
 }
@@ -15,13 +15,13 @@
  */
 
 #include "staxys/config/validator.h"
-#include <iostream>
+#include "staxys/core/logger.h"
 
 namespace staxys::config {
 
     bool Validator::validate_engine_config(const std::shared_ptr<const EngineConfig> &config) {
         if (config->listen_ports().empty()) {
-            std::cerr << "No ports have been defined for Staxys to listen on." << std::endl;
+            STAXYS_LOG(ERROR) << "No ports have been defined for Staxys to listen on.";
             return false;
         }
         return true;
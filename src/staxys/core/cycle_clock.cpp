@@ -0,0 +1,69 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/core/cycle_clock.h"
+#include <mutex>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace staxys::core {
+
+namespace {
+std::once_flag calibrated;
+
+/// Whether the time stamp counter ticks at the same rate on every core and
+/// in every power state, so that it can stand in for a clock.
+bool invariant_tsc() {
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned eax = 0;
+  unsigned ebx = 0;
+  unsigned ecx = 0;
+  unsigned edx = 0;
+  if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0) {
+    return false;
+  }
+  return (edx & (1U << 8)) != 0;
+#else
+  return false;
+#endif
+}
+} // namespace
+
+void CycleClock::calibrate() {
+  std::call_once(calibrated, [] {
+    if (!invariant_tsc()) {
+      return;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    // now() still reads CLOCK_MONOTONIC here.
+    auto start_ns = now();
+    auto start_ticks = __rdtsc();
+    uint64_t end_ns;
+    do {
+      end_ns = now();
+    } while (end_ns - start_ns < static_cast<uint64_t>(CALIBRATION_MS) * 1000000);
+    auto ticks = __rdtsc() - start_ticks;
+    if (ticks == 0) {
+      return;
+    }
+    s_ns_per_tick = static_cast<uint64_t>((static_cast<unsigned __int128>(end_ns - start_ns) << SCALE_BITS) / ticks);
+    s_tsc = true;
+#endif
+  });
+}
+
+} // namespace staxys::core
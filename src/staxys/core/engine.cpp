@@ -15,17 +15,24 @@
  */
 
 #include "staxys/core/engine.h"
+#include "staxys/core/logger.h"
 #include "staxys/utils/daemon_utils.h"
-#include <iostream>
 #include <signal.h>
-#include <unistd.h>
 
 namespace staxys::core {
 
 EngineSignalData *g_signal_data = nullptr;
 
 int Engine::start_application(const bool asDaemon) {
-  std::cout << "Starting the application..." << std::endl;
+  auto level = Logger::Level::INFO;
+  if (!m_config->log_level().empty() && !Logger::parse_level(m_config->log_level(), level)) {
+    STAXYS_LOG(WARNING) << "Unknown log_level '" << m_config->log_level() << "'; using info.";
+  }
+  Logger::set_level(level);
+  if (!m_config->error_log().empty()) {
+    Logger::open(m_config->error_log());
+  }
+  STAXYS_LOG(INFO) << "Starting the application...";
 
   struct sigaction sa;
   sa.sa_flags = SA_SIGINFO;
@@ -38,42 +45,44 @@ int Engine::start_application(const bool asDaemon) {
   sigaction(SIGTERM, &sa, nullptr);
   sigaction(SIGINT, &sa, nullptr);
   sigaction(SIGHUP, &sa, nullptr);
+  sigaction(SIGUSR1, &sa, nullptr);
+  sigaction(SIGCHLD, &sa, nullptr);
 
   if (!asDaemon) {
     m_is_running = true;
     return main_task();
   }
 
-  std::cout << "Running as a daemon..." << std::endl;
+  STAXYS_LOG(INFO) << "Running as a daemon...";
   if (!utils::DaemonUtils::validate_daemon_configuration(m_config->user(), m_config->pid_file())) {
     return EXIT_FAILURE;
   }
 
   if (utils::DaemonUtils::start(m_config->pid_file())) {
-    std::cout << "Application started successfully." << std::endl;
+    STAXYS_LOG(INFO) << "Application started successfully.";
     m_is_running = true;
     return main_task();
   }
 
-  std::cerr << "Failed to start the application." << std::endl;
+  STAXYS_LOG(ERROR) << "Failed to start the application.";
   return EXIT_FAILURE;
 }
 
 int Engine::stop_application() {
-  std::cout << "Stopping the application..." << std::endl;
+  STAXYS_LOG(INFO) << "Stopping the application...";
 
   if (utils::DaemonUtils::stop(m_config->pid_file())) {
-    std::cout << "Application stopped successfully." << std::endl;
+    STAXYS_LOG(INFO) << "Application stopped successfully.";
     m_is_running = false;
     return EXIT_SUCCESS;
   }
 
-  std::cerr << "Failed to stop the application." << std::endl;
+  STAXYS_LOG(ERROR) << "Failed to stop the application.";
   return EXIT_FAILURE;
 }
 
 int Engine::restart_application() {
-  std::cout << "Restarting the application..." << std::endl;
+  STAXYS_LOG(INFO) << "Restarting the application...";
   if (stop_application() == EXIT_FAILURE) {
     return EXIT_FAILURE;
   }
@@ -82,30 +91,51 @@ int Engine::restart_application() {
 }
 
 int Engine::main_task() {
-  std::cout << "Running the main task..." << std::endl;
-  while (m_is_running) {
-    sleep(1);
-  }
-  std::cout << "Main task is stopping." << std::endl;
-  return EXIT_SUCCESS;
+  // After daemonizing, whose fork the writer thread would not survive.
+  Logger::start();
+  STAXYS_LOG(INFO) << "Running the main task...";
+  m_server_manager = std::make_unique<ServerManager>(m_config);
+  auto result = m_server_manager->run();
+  m_server_manager.reset();
+  STAXYS_LOG(INFO) << "Main task is stopping.";
+  Logger::stop();
+  return result;
 }
 
 void Engine::signal_handler(int signal, siginfo_t *info, void *context) {
   EngineSignalData *data = g_signal_data;
   Engine &engine = *data->engine;
 
+  // Only flags and eventfd writes here: the code this signal interrupted may
+  // hold the Logger's lock or the heap's. The ServerManager's loop logs and
+  // does the actual work.
   switch (signal) {
   case SIGTERM:
   case SIGINT:
-    std::cout << "Received termination signal. Stopping application..." << std::endl;
-    engine.stop_application();
+    // `staxys stop` already removed the PID file before signalling us, so
+    // only the workers (or, inside a worker, its event loop) need stopping.
+    engine.m_is_running = false;
+    if (engine.m_server_manager) {
+      engine.m_server_manager->stop();
+    }
     break;
   case SIGHUP:
-    std::cout << "Received SIGHUP signal. Restarting application..." << std::endl;
-    engine.restart_application();
+    if (engine.m_server_manager) {
+      engine.m_server_manager->restart();
+    }
+    break;
+  case SIGUSR1:
+    // logrotate has moved the log files; the workers open new ones.
+    if (engine.m_server_manager) {
+      engine.m_server_manager->reopen_logs();
+    }
+    break;
+  case SIGCHLD:
+    if (engine.m_server_manager) {
+      engine.m_server_manager->child_exited();
+    }
     break;
   default:
-    std::cerr << "Unhandled signal " << signal << std::endl;
     break;
   }
 }
@@ -14,4 +14,233 @@
  * limitations under the License.
  */
 
-#include "staxys/core/logger.h"
\ No newline at end of file
+#include "staxys/core/logger.h"
+#include "staxys/logging/access_record.h"
+#include "staxys/logging/error_log.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <pthread.h>
+#include <unistd.h>
+
+namespace staxys::core {
+
+namespace {
+// Guards the sites and what they hold back.
+std::mutex sites_mutex;
+Logger::Site *first_site = nullptr;
+
+// Never destroyed, so that messages logged while the process exits still
+// have somewhere to go.
+logging::ErrorLog *active_log = new logging::ErrorLog();
+
+std::atomic<uint64_t> lines_written{0};
+std::atomic<uint64_t> lines_repeated{0};
+std::atomic<uint64_t> lines_suppressed{0};
+
+std::once_flag fork_handlers;
+
+int64_t current_second() {
+  timespec now{};
+  clock_gettime(CLOCK_REALTIME_COARSE, &now);
+  return now.tv_sec;
+}
+
+/// FNV-1a; a site only compares a message with its own last one.
+uint64_t hash(const std::string_view text) {
+  uint64_t value = 14695981039346656037ULL;
+  for (auto c : text) {
+    value = (value ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+  }
+  return value;
+}
+
+/// Writes "[10/Oct/2000:13:55:36 +0000] [error] 1234: message".
+void emit(const Logger::Level level, const std::string_view message) {
+  char line[Logger::MAX_MESSAGE + 96];
+  auto length = logging::AccessRecordText::format_time(current_second(), line);
+  auto append = [&](const std::string_view text) {
+    auto count = std::min(text.size(), sizeof(line) - 1 - length);
+    std::memcpy(line + length, text.data(), count);
+    length += count;
+  };
+  char pid[16];
+  auto pid_end = std::to_chars(pid, pid + sizeof(pid), getpid()).ptr;
+  append(" [");
+  append(Logger::level_name(level));
+  append("] ");
+  append({pid, static_cast<std::size_t>(pid_end - pid)});
+  append(": ");
+  append(message);
+  line[length++] = '\n';
+  active_log->write({line, length});
+}
+} // namespace
+
+Logger::Site::Site(const char *file, const int line) : m_file(file), m_line(line) {
+  std::lock_guard lock(sites_mutex);
+  m_next = first_site;
+  first_site = this;
+}
+
+bool Logger::parse_level(const std::string_view name, Level &level) {
+  if (name == "debug") {
+    level = Level::VERBOSE;
+  } else if (name == "info") {
+    level = Level::INFO;
+  } else if (name == "warn" || name == "warning") {
+    level = Level::WARNING;
+  } else if (name == "error") {
+    level = Level::ERROR;
+  } else if (name == "off") {
+    level = Level::OFF;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void Logger::write_counts(Site &site) {
+  if (site.m_repeated == 0 && site.m_suppressed == 0) {
+    return;
+  }
+  const char *name = std::strrchr(site.m_file, '/');
+  name = name ? name + 1 : site.m_file;
+  char text[160];
+  auto put = [&](const int length) {
+    emit(site.m_level, {text, static_cast<std::size_t>(std::clamp(length, 0, static_cast<int>(sizeof(text) - 1)))});
+  };
+  if (site.m_repeated > 0) {
+    put(std::snprintf(text, sizeof(text), "%s:%d: last message repeated %llu times", name, site.m_line,
+                      static_cast<unsigned long long>(site.m_repeated)));
+    site.m_repeated = 0;
+  }
+  if (site.m_suppressed > 0) {
+    put(std::snprintf(text, sizeof(text), "%s:%d: %llu messages suppressed", name, site.m_line,
+                      static_cast<unsigned long long>(site.m_suppressed)));
+    site.m_suppressed = 0;
+  }
+}
+
+std::string_view Logger::level_name(const Level level) {
+  switch (level) {
+  case Level::VERBOSE:
+    return "debug";
+  case Level::INFO:
+    return "info";
+  case Level::WARNING:
+    return "warn";
+  case Level::ERROR:
+    return "error";
+  case Level::OFF:
+    break;
+  }
+  return "off";
+}
+
+bool Logger::open(const std::string &path) {
+  auto *log = new logging::ErrorLog(path);
+  auto opened = log->open();
+  auto *previous = active_log;
+  active_log = log;
+  previous->stop();
+  delete previous;
+  return opened;
+}
+
+bool Logger::start() {
+  std::call_once(fork_handlers, [] {
+    pthread_atfork(
+        [] {
+          sites_mutex.lock();
+          active_log->prepare_fork();
+        },
+        [] {
+          active_log->parent_after_fork();
+          sites_mutex.unlock();
+        },
+        [] {
+          active_log->child_after_fork();
+          sites_mutex.unlock();
+        });
+  });
+  return active_log->start(flush_sites);
+}
+
+void Logger::stop() {
+  {
+    std::lock_guard lock(sites_mutex);
+    for (auto *site = first_site; site; site = site->m_next) {
+      write_counts(*site);
+    }
+  }
+  active_log->stop();
+}
+
+void Logger::reopen() { active_log->reopen(); }
+
+Logger::Stats Logger::stats() {
+  Stats stats;
+  stats.lines = lines_written.load(std::memory_order_relaxed);
+  stats.repeated = lines_repeated.load(std::memory_order_relaxed);
+  stats.suppressed = lines_suppressed.load(std::memory_order_relaxed);
+  stats.dropped = active_log->dropped();
+  return stats;
+}
+
+void Logger::write(const Level level, Site &site, const std::string_view message) {
+  auto second = current_second();
+  auto message_hash = hash(message);
+  std::lock_guard lock(sites_mutex);
+  if (site.m_second != second) {
+    write_counts(site);
+    site.m_second = second;
+    site.m_lines = 0;
+  }
+  if (site.m_has_last && site.m_last_hash == message_hash) {
+    ++site.m_repeated;
+    lines_repeated.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (site.m_lines >= LINES_PER_SECOND) {
+    ++site.m_suppressed;
+    lines_suppressed.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  // Held-back counts belong before the message that ends the run.
+  write_counts(site);
+  site.m_level = level;
+  site.m_has_last = true;
+  site.m_last_hash = message_hash;
+  ++site.m_lines;
+  emit(level, message);
+  lines_written.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Logger::flush_sites() {
+  auto second = current_second();
+  std::lock_guard lock(sites_mutex);
+  for (auto *site = first_site; site; site = site->m_next) {
+    if (site->m_second != second) {
+      write_counts(*site);
+    }
+  }
+}
+
+LogMessage &LogMessage::operator<<(const std::string_view text) {
+  auto count = std::min(text.size(), sizeof(m_text) - m_length);
+  std::memcpy(m_text + m_length, text.data(), count);
+  m_length += count;
+  return *this;
+}
+
+LogMessage &LogMessage::operator<<(const double value) {
+  char digits[32];
+  auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+  return *this << std::string_view(digits, static_cast<std::size_t>(end - digits));
+}
+
+} // namespace staxys::core
@@ -0,0 +1,266 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/core/metrics.h"
+#include "staxys/core/cycle_clock.h"
+#include "staxys/core/logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <sys/mman.h>
+
+namespace staxys::core {
+
+namespace {
+const std::string_view STATUS_LABELS[WorkerMetrics::STATUS_CLASSES] = {
+    R"(code="1xx")", R"(code="2xx")", R"(code="3xx")", R"(code="4xx")", R"(code="5xx")"};
+
+const std::string_view PHASE_LABELS[WorkerMetrics::PHASES] = {
+    R"(phase="connect")", R"(phase="receive")", R"(phase="handle")", R"(phase="send")", R"(phase="total")"};
+
+/// The quantiles exported for each phase, with their labels.
+struct Quantile {
+  double value;
+  std::string_view label;
+};
+const Quantile PHASE_QUANTILES[] = {
+    {0.5, R"(,quantile="0.5")"}, {0.99, R"(,quantile="0.99")"}, {0.999, R"(,quantile="0.999")"}};
+
+/// A bucket of the exported request duration, with its upper bound.
+struct DurationBucket {
+  uint64_t nanoseconds;
+  std::string_view label;
+};
+const DurationBucket DURATION_BUCKETS[] = {
+    {100000, R"(le="0.0001")"},     {250000, R"(le="0.00025")"},    {500000, R"(le="0.0005")"},
+    {1000000, R"(le="0.001")"},     {2500000, R"(le="0.0025")"},    {5000000, R"(le="0.005")"},
+    {10000000, R"(le="0.01")"},     {25000000, R"(le="0.025")"},    {50000000, R"(le="0.05")"},
+    {100000000, R"(le="0.1")"},     {250000000, R"(le="0.25")"},    {500000000, R"(le="0.5")"},
+    {1000000000, R"(le="1")"},      {2500000000, R"(le="2.5")"}};
+
+/// Appends the lines of one metric in the Prometheus text format.
+class Writer {
+public:
+  explicit Writer(std::pmr::string &out) : m_out(out) {}
+
+  /// Starts a metric of \p type ("counter", "gauge", "histogram" or "summary").
+  void begin(const std::string_view name, const std::string_view type, const std::string_view help) {
+    m_out.append("# HELP ").append(name).append(" ").append(help).append("\n# TYPE ");
+    m_out.append(name).append(" ").append(type).append("\n");
+  }
+
+  /// Appends a sample of \p name with \p labels, e.g. code="2xx", if any.
+  template <typename T> void sample(const std::string_view name, const std::string_view labels, const T value) {
+    m_out.append(name);
+    if (!labels.empty()) {
+      m_out.append("{").append(labels).append("}");
+    }
+    char digits[32];
+    auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    m_out.append(" ").append(digits, end).append("\n");
+  }
+
+  template <typename T>
+  void metric(const std::string_view name, const std::string_view type, const std::string_view help, const T value) {
+    begin(name, type, help);
+    sample(name, {}, value);
+  }
+
+private:
+  std::pmr::string &m_out;
+};
+
+/// Sums \p field over the workers.
+template <typename Field> uint64_t sum(const Metrics &metrics, const Field field) {
+  uint64_t total = 0;
+  for (std::size_t i = 0; i < metrics.size(); ++i) {
+    total += (metrics.worker(i).*field).value();
+  }
+  return total;
+}
+
+double seconds(const uint64_t ticks) { return static_cast<double>(CycleClock::to_ns(ticks)) / 1e9; }
+} // namespace
+
+void Histogram::merge(const Histogram &other) {
+  for (std::size_t i = 0; i < BUCKETS; ++i) {
+    if (auto count = other.m_buckets[i].value()) {
+      m_buckets[i].add(count);
+    }
+  }
+  m_sum.add(other.m_sum.value());
+}
+
+uint64_t Histogram::count() const {
+  uint64_t total = 0;
+  for (const auto &bucket : m_buckets) {
+    total += bucket.value();
+  }
+  return total;
+}
+
+uint64_t Histogram::count_below(const uint64_t limit) const {
+  uint64_t total = 0;
+  for (std::size_t i = 0; i < BUCKETS && upper_bound(i) < limit; ++i) {
+    total += m_buckets[i].value();
+  }
+  return total;
+}
+
+uint64_t Histogram::quantile(const double quantile) const {
+  auto total = count();
+  if (total == 0) {
+    return 0;
+  }
+  // The rank of the value wanted, counting from 1.
+  auto rank = std::clamp<uint64_t>(static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(total))), 1, total);
+  uint64_t seen = 0;
+  for (std::size_t i = 0; i < BUCKETS; ++i) {
+    seen += m_buckets[i].value();
+    if (seen >= rank) {
+      return upper_bound(i);
+    }
+  }
+  return upper_bound(BUCKETS - 1);
+}
+
+uint64_t Histogram::lower_bound(const std::size_t index) {
+  if (index < SUB_BUCKETS) {
+    return index;
+  }
+  auto shift = index / SUB_BUCKETS - 1;
+  return (SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+}
+
+uint64_t Histogram::upper_bound(const std::size_t index) {
+  if (index < SUB_BUCKETS) {
+    return index;
+  }
+  auto shift = index / SUB_BUCKETS - 1;
+  return lower_bound(index) + ((uint64_t{1} << shift) - 1);
+}
+
+void WorkerMetrics::clear_gauges() {
+  connections_active.set(0);
+  accept_queue.set(0);
+  cache_entries.set(0);
+  cache_bytes.set(0);
+}
+
+Metrics::~Metrics() { munmap(m_workers, m_size * sizeof(WorkerMetrics)); }
+
+std::unique_ptr<Metrics> Metrics::create(const std::size_t workers) {
+  auto size = std::max<std::size_t>(workers, 1);
+  auto memory = mmap(nullptr, size * sizeof(WorkerMetrics), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    STAXYS_LOG(ERROR) << "Failed to map memory for the metrics: " << strerror(errno);
+    return nullptr;
+  }
+  auto *first = static_cast<WorkerMetrics *>(memory);
+  for (std::size_t i = 0; i < size; ++i) {
+    new (first + i) WorkerMetrics();
+  }
+  return std::unique_ptr<Metrics>(new Metrics(first, size));
+}
+
+void Metrics::render(std::pmr::string &out) const {
+  Writer writer(out);
+  writer.metric("staxys_workers", "gauge", "Worker processes.", m_size);
+  writer.metric("staxys_requests_total", "counter", "Requests answered.", sum(*this, &WorkerMetrics::requests));
+
+  writer.begin("staxys_responses_total", "counter", "Responses by status class.");
+  for (std::size_t i = 0; i < WorkerMetrics::STATUS_CLASSES; ++i) {
+    uint64_t total = 0;
+    for (std::size_t worker = 0; worker < m_size; ++worker) {
+      total += m_workers[worker].responses[i].value();
+    }
+    writer.sample("staxys_responses_total", STATUS_LABELS[i], total);
+  }
+
+  writer.metric("staxys_sent_bytes_total", "counter", "Bytes written to clients.",
+                sum(*this, &WorkerMetrics::bytes_sent));
+  writer.metric("staxys_connections_accepted_total", "counter", "Connections accepted.",
+                sum(*this, &WorkerMetrics::connections_accepted));
+  writer.metric("staxys_connections_active", "gauge", "Connections open.",
+                sum(*this, &WorkerMetrics::connections_active));
+  writer.metric("staxys_accept_queue_length", "gauge", "Connections waiting in the listen backlogs.",
+                sum(*this, &WorkerMetrics::accept_queue));
+
+  auto hits = sum(*this, &WorkerMetrics::cache_hits);
+  auto misses = sum(*this, &WorkerMetrics::cache_misses);
+  writer.metric("staxys_cache_hits_total", "counter", "Files answered from the cache.", hits);
+  writer.metric("staxys_cache_misses_total", "counter", "Cacheable files that had to be read.", misses);
+  writer.metric("staxys_cache_hit_ratio", "gauge", "Share of cache lookups that hit.",
+                hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses));
+  writer.metric("staxys_cache_entries", "gauge", "Files in the cache.", sum(*this, &WorkerMetrics::cache_entries));
+  writer.metric("staxys_cache_bytes", "gauge", "Bytes held by the cache.", sum(*this, &WorkerMetrics::cache_bytes));
+  writer.metric("staxys_resolution_cache_hits_total", "counter", "Request paths resolved from the cache.",
+                sum(*this, &WorkerMetrics::resolution_hits));
+  writer.metric("staxys_resolution_cache_misses_total", "counter", "Request paths resolved on the file system.",
+                sum(*this, &WorkerMetrics::resolution_misses));
+
+  writer.metric("staxys_access_log_lines_total", "counter", "Access log records written.",
+                sum(*this, &WorkerMetrics::access_log_lines));
+  writer.metric("staxys_access_log_dropped_total", "counter", "Access log records dropped.",
+                sum(*this, &WorkerMetrics::access_log_dropped));
+  writer.metric("staxys_error_log_lines_total", "counter", "Error log lines written by the workers.",
+                sum(*this, &WorkerMetrics::error_log_lines));
+  writer.metric("staxys_error_log_suppressed_total", "counter", "Error log messages held back as repeated or excess.",
+                sum(*this, &WorkerMetrics::error_log_suppressed));
+  writer.metric("staxys_error_log_dropped_total", "counter", "Error log lines dropped.",
+                sum(*this, &WorkerMetrics::error_log_dropped));
+
+  std::array<Histogram, WorkerMetrics::PHASES> phases;
+  for (std::size_t i = 0; i < m_size; ++i) {
+    for (std::size_t phase = 0; phase < WorkerMetrics::PHASES; ++phase) {
+      phases[phase].merge(m_workers[i].phases[phase]);
+    }
+  }
+
+  const auto &total = phases[WorkerMetrics::TOTAL];
+  writer.begin("staxys_request_duration_seconds", "histogram",
+               "Time from the first bytes of a request to the last byte of its response.");
+  for (const auto &bucket : DURATION_BUCKETS) {
+    writer.sample("staxys_request_duration_seconds_bucket", bucket.label,
+                  total.count_below(CycleClock::from_ns(bucket.nanoseconds) + 1));
+  }
+  auto count = total.count();
+  writer.sample("staxys_request_duration_seconds_bucket", "le=\"+Inf\"", count);
+  writer.sample("staxys_request_duration_seconds_sum", {}, seconds(total.sum()));
+  writer.sample("staxys_request_duration_seconds_count", {}, count);
+
+  // Quantiles are the upper ends of their buckets, at most 1/8 too high.
+  writer.begin("staxys_request_phase_seconds", "summary",
+               "Time spent in each phase of a request: connect (accept to first bytes, first request only), "
+               "receive (to parsed), handle (to response queued), send (to last byte written) and total.");
+  for (std::size_t phase = 0; phase < WorkerMetrics::PHASES; ++phase) {
+    char labels[64];
+    auto phase_end = std::copy(PHASE_LABELS[phase].begin(), PHASE_LABELS[phase].end(), labels);
+    for (const auto &quantile : PHASE_QUANTILES) {
+      auto end = std::copy(quantile.label.begin(), quantile.label.end(), phase_end);
+      writer.sample("staxys_request_phase_seconds", std::string_view(labels, static_cast<std::size_t>(end - labels)),
+                    seconds(phases[phase].quantile(quantile.value)));
+    }
+    writer.sample("staxys_request_phase_seconds_sum", PHASE_LABELS[phase], seconds(phases[phase].sum()));
+    writer.sample("staxys_request_phase_seconds_count", PHASE_LABELS[phase], phases[phase].count());
+  }
+}
+
+} // namespace staxys::core
@@ -14,4 +14,328 @@
  * limitations under the License.
  */
 
-#include "staxys/core/server_manager.h"
\ No newline at end of file
+#include "staxys/core/server_manager.h"
+#include "staxys/core/cycle_clock.h"
+#include "staxys/core/logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace staxys::core {
+
+namespace {
+// Exit status a worker uses when it cannot open its listeners. Re-forking
+// would only fail again, so the master gives up instead.
+const int WORKER_STARTUP_FAILURE = 3;
+
+// A worker that dies sooner than this after being forked is re-forked only
+// after the same delay, so a crash on every request cannot spin the master.
+const auto RESPAWN_THROTTLE = std::chrono::seconds(1);
+
+const auto SHUTDOWN_GRACE_PERIOD = std::chrono::seconds(10);
+const auto SHUTDOWN_POLL_INTERVAL = std::chrono::milliseconds(50);
+} // namespace
+
+std::size_t ServerManager::worker_count() const {
+  if (m_config->worker_processes() > 0) {
+    return static_cast<std::size_t>(m_config->worker_processes());
+  }
+  auto cpus = available_cpus();
+  return cpus.empty() ? 1 : cpus.size();
+}
+
+std::vector<int> ServerManager::available_cpus() {
+  std::vector<int> cpus;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+    return cpus;
+  }
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &set)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+int ServerManager::run() {
+  m_master_pid = getpid();
+  m_cpus = available_cpus();
+  m_workers.assign(worker_count(), Worker{});
+  m_metrics = Metrics::create(m_workers.size());
+  // Once here rather than in every worker, which inherit the result.
+  CycleClock::calibrate();
+  m_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_wake_fd < 0) {
+    STAXYS_LOG(ERROR) << "Failed to create the master's wake fd: " << strerror(errno);
+    return EXIT_FAILURE;
+  }
+  m_running = true;
+
+  STAXYS_LOG(INFO) << "Starting " << m_workers.size() << " worker process(es)...";
+  for (std::size_t i = 0; i < m_workers.size() && m_running; ++i) {
+    if (!spawn_worker(i)) {
+      m_running = false;
+      stop_workers();
+      close(m_wake_fd);
+      m_wake_fd = -1;
+      return EXIT_FAILURE;
+    }
+  }
+
+  auto result = EXIT_SUCCESS;
+  while (m_running) {
+    if (!handle_requests()) {
+      result = EXIT_FAILURE;
+      break;
+    }
+
+    int status = 0;
+    auto pid = waitpid(-1, &status, WNOHANG);
+    if (pid == 0) {
+      wait_for_signal();
+      continue;
+    }
+    if (pid < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      STAXYS_LOG(ERROR) << "waitpid failed: " << strerror(errno);
+      result = EXIT_FAILURE;
+      break;
+    }
+
+    auto worker = std::find_if(m_workers.begin(), m_workers.end(), [pid](const Worker &w) { return w.pid == pid; });
+    if (worker == m_workers.end()) {
+      continue;
+    }
+    worker->pid = -1;
+    if (m_metrics) {
+      m_metrics->worker(static_cast<std::size_t>(worker - m_workers.begin())).clear_gauges();
+    }
+
+    if (!m_running) {
+      break;
+    }
+
+    if (WIFEXITED(status) && WEXITSTATUS(status) == WORKER_STARTUP_FAILURE) {
+      STAXYS_LOG(ERROR) << "Worker " << pid << " could not start; shutting down.";
+      result = EXIT_FAILURE;
+      break;
+    }
+
+    if (WIFSIGNALED(status)) {
+      STAXYS_LOG(WARNING) << "Worker " << pid << " was killed by signal " << WTERMSIG(status) << "; restarting it.";
+    } else {
+      STAXYS_LOG(WARNING) << "Worker " << pid << " exited with status " << WEXITSTATUS(status) << "; restarting it.";
+    }
+
+    if (std::chrono::steady_clock::now() - worker->started < RESPAWN_THROTTLE) {
+      std::this_thread::sleep_for(RESPAWN_THROTTLE);
+    }
+    if (m_running && !spawn_worker(static_cast<std::size_t>(worker - m_workers.begin()))) {
+      result = EXIT_FAILURE;
+      break;
+    }
+  }
+
+  if (!m_running) {
+    STAXYS_LOG(INFO) << "Received a termination signal; stopping the workers...";
+  }
+  m_running = false;
+  stop_workers();
+  close(m_wake_fd);
+  m_wake_fd = -1;
+  return result;
+}
+
+void ServerManager::wait_for_signal() {
+  // The eventfd stays readable until drained, so a signal that arrived after
+  // the last waitpid() is not missed.
+  pollfd wake{m_wake_fd, POLLIN, 0};
+  if (poll(&wake, 1, -1) > 0) {
+    eventfd_t value;
+    eventfd_read(m_wake_fd, &value);
+  }
+}
+
+bool ServerManager::handle_requests() {
+  if (m_reopen_requested) {
+    m_reopen_requested = false;
+    STAXYS_LOG(INFO) << "Reopening the log files...";
+    Logger::reopen();
+    for (const auto &worker : m_workers) {
+      if (worker.pid > 0) {
+        kill(worker.pid, SIGUSR1);
+      }
+    }
+  }
+
+  if (m_restart_requested) {
+    m_restart_requested = false;
+    STAXYS_LOG(INFO) << "Received SIGHUP; restarting the workers...";
+    stop_workers();
+    for (std::size_t i = 0; i < m_workers.size(); ++i) {
+      if (m_metrics) {
+        m_metrics->worker(i).clear_gauges();
+      }
+      if (m_running && !spawn_worker(i)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void ServerManager::stop() {
+  m_running = false;
+  if (m_is_worker) {
+    if (m_server) {
+      m_server->stop();
+    }
+    return;
+  }
+  if (m_wake_fd >= 0) {
+    eventfd_write(m_wake_fd, 1);
+  }
+}
+
+void ServerManager::restart() {
+  if (m_is_worker) {
+    return;
+  }
+  m_restart_requested = true;
+  if (m_wake_fd >= 0) {
+    eventfd_write(m_wake_fd, 1);
+  }
+}
+
+void ServerManager::reopen_logs() {
+  // Inside a worker both only set a flag and write an eventfd.
+  if (m_is_worker) {
+    Logger::reopen();
+    if (m_server) {
+      m_server->reopen_logs();
+    }
+    return;
+  }
+  m_reopen_requested = true;
+  if (m_wake_fd >= 0) {
+    eventfd_write(m_wake_fd, 1);
+  }
+}
+
+void ServerManager::child_exited() {
+  if (!m_is_worker && m_wake_fd >= 0) {
+    eventfd_write(m_wake_fd, 1);
+  }
+}
+
+bool ServerManager::spawn_worker(const std::size_t index) {
+  auto &worker = m_workers[index];
+  worker.cpu = m_cpus.empty() ? -1 : m_cpus[index % m_cpus.size()];
+  worker.started = std::chrono::steady_clock::now();
+
+  auto pid = fork();
+  if (pid < 0) {
+    STAXYS_LOG(ERROR) << "Failed to fork worker: " << strerror(errno);
+    return false;
+  }
+
+  if (pid == 0) {
+    m_is_worker = true;
+    // run_worker() tears down what the worker owns; std::exit() would also run
+    // the master's static destructors and flush stdio it had buffered.
+    _exit(run_worker(worker));
+  }
+
+  worker.pid = pid;
+  return true;
+}
+
+int ServerManager::run_worker(const Worker &worker) {
+  // Workers must not outlive the master, and reloads are the master's job.
+  prctl(PR_SET_PDEATHSIG, SIGTERM);
+  close(m_wake_fd);
+  m_wake_fd = -1;
+  signal(SIGHUP, SIG_IGN);
+  if (getppid() != m_master_pid) {
+    return EXIT_FAILURE;
+  }
+
+  if (worker.cpu >= 0) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(worker.cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+      STAXYS_LOG(WARNING) << "Failed to pin worker to CPU " << worker.cpu << ": " << strerror(errno);
+    }
+  }
+
+  // The master's writer thread did not come along through fork().
+  Logger::start();
+  m_server = std::make_unique<network::Server>(m_config, m_metrics.get(),
+                                               static_cast<std::size_t>(&worker - m_workers.data()));
+  if (!m_server->listen(true)) {
+    Logger::stop();
+    return WORKER_STARTUP_FAILURE;
+  }
+
+  // A signal may have arrived while the listeners were being opened.
+  auto result = m_running ? m_server->run() : EXIT_SUCCESS;
+  m_server.reset();
+  Logger::stop();
+  return result;
+}
+
+void ServerManager::stop_workers() {
+  for (const auto &worker : m_workers) {
+    if (worker.pid > 0) {
+      kill(worker.pid, SIGTERM);
+    }
+  }
+
+  auto deadline = std::chrono::steady_clock::now() + SHUTDOWN_GRACE_PERIOD;
+  while (true) {
+    auto alive = false;
+    for (auto &worker : m_workers) {
+      if (worker.pid <= 0) {
+        continue;
+      }
+      auto reaped = waitpid(worker.pid, nullptr, WNOHANG);
+      if (reaped == worker.pid || (reaped < 0 && errno == ECHILD)) {
+        worker.pid = -1;
+      } else {
+        alive = true;
+      }
+    }
+
+    if (!alive) {
+      return;
+    }
+
+    if (std::chrono::steady_clock::now() >= deadline) {
+      for (auto &worker : m_workers) {
+        if (worker.pid > 0) {
+          STAXYS_LOG(WARNING) << "Worker " << worker.pid << " did not stop in time; killing it.";
+          kill(worker.pid, SIGKILL);
+          waitpid(worker.pid, nullptr, 0);
+          worker.pid = -1;
+        }
+      }
+      return;
+    }
+
+    std::this_thread::sleep_for(SHUTDOWN_POLL_INTERVAL);
+  }
+}
+
+} // namespace staxys::core
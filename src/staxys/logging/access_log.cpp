@@ -14,4 +14,303 @@
  * limitations under the License.
  */
 
-#include "staxys/logging/access_log.h"
\ No newline at end of file
+#include "staxys/logging/access_log.h"
+#include "staxys/core/logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace staxys::logging {
+
+namespace {
+/// Power of two at least \p size.
+std::size_t ceil_power_of_two(const std::size_t size) {
+  std::size_t power = 1;
+  while (power < size) {
+    power <<= 1;
+  }
+  return power;
+}
+} // namespace
+
+AccessLog::AccessLog(std::string path, const std::size_t capacity, const Overflow overflow,
+                     const std::chrono::milliseconds flushInterval, const Format format)
+    : m_path(std::move(path)), m_capacity(ceil_power_of_two(std::max(capacity, 2 * MAX_LINE))),
+      m_overflow(overflow), m_flush_interval(std::max(flushInterval, std::chrono::milliseconds(1))),
+      m_format(format), m_ring(new char[m_capacity]) {
+  if (m_format == Format::BINARY) {
+    m_records.reset(new char[m_capacity]);
+    m_frame.reset(new char[AccessRecordEncoder::MAX_FRAME_HEADER + m_capacity + AccessRecordEncoder::MAX_RECORD]);
+  }
+}
+
+AccessLog::~AccessLog() { stop(); }
+
+bool AccessLog::start() {
+  if (m_thread.joinable()) {
+    return true;
+  }
+  m_fd = open_file();
+  if (m_fd < 0) {
+    return false;
+  }
+  m_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_wake_fd < 0) {
+    STAXYS_LOG(ERROR) << "Failed to create the access log wake fd: " << strerror(errno);
+    close(m_fd);
+    m_fd = -1;
+    return false;
+  }
+
+  // Signals stay with the worker's thread, whose loop reacts to them.
+  sigset_t all;
+  sigset_t previous;
+  sigfillset(&all);
+  pthread_sigmask(SIG_BLOCK, &all, &previous);
+  try {
+    m_stopping = false;
+    m_thread = std::thread(&AccessLog::run, this);
+  } catch (const std::system_error &e) {
+    STAXYS_LOG(ERROR) << "Failed to start the access log thread: " << e.what();
+  }
+  pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+  if (!m_thread.joinable()) {
+    stop();
+    return false;
+  }
+  return true;
+}
+
+void AccessLog::stop() {
+  if (m_thread.joinable()) {
+    m_stopping = true;
+    eventfd_write(m_wake_fd, 1);
+    m_thread.join();
+  }
+  if (m_wake_fd >= 0) {
+    close(m_wake_fd);
+    m_wake_fd = -1;
+  }
+  if (m_fd >= 0) {
+    close(m_fd);
+    m_fd = -1;
+  }
+}
+
+void AccessLog::log(const AccessRecord &record) {
+  static_assert(AccessRecordEncoder::MAX_RECORD <= MAX_LINE);
+  if (!m_thread.joinable()) {
+    return;
+  }
+  auto stamped = record;
+  if (stamped.time == 0) {
+    timespec now{};
+    clock_gettime(CLOCK_REALTIME, &now);
+    stamped.time = static_cast<int64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+  }
+
+  char line[MAX_LINE];
+  if (m_format == Format::BINARY) {
+    m_encoder.reset();
+    publish(line, m_encoder.encode(stamped, line));
+    return;
+  }
+  auto second = stamped.time / 1000000 - (stamped.time % 1000000 < 0 ? 1 : 0);
+  if (second != m_time_second) {
+    m_time_length = AccessRecordText::format_time(second, m_time);
+    m_time_second = second;
+  }
+  publish(line, AccessRecordText::to_text(stamped, {m_time, m_time_length}, line));
+}
+
+void AccessLog::reopen() {
+  m_reopen.store(true, std::memory_order_relaxed);
+  if (m_wake_fd >= 0) {
+    eventfd_write(m_wake_fd, 1);
+  }
+}
+
+AccessLog::Stats AccessLog::stats() const {
+  Stats stats;
+  stats.lines = m_lines.load(std::memory_order_relaxed);
+  stats.dropped = m_dropped.load(std::memory_order_relaxed);
+  stats.bytes_written = m_bytes_written.load(std::memory_order_relaxed);
+  stats.writes = m_writes.load(std::memory_order_relaxed);
+  return stats;
+}
+
+bool AccessLog::parse_overflow(const std::string_view name, Overflow &overflow) {
+  if (name == "drop") {
+    overflow = Overflow::DROP;
+  } else if (name == "block") {
+    overflow = Overflow::BLOCK;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool AccessLog::parse_format(const std::string_view name, Format &format) {
+  if (name == "text") {
+    format = Format::TEXT;
+  } else if (name == "binary") {
+    format = Format::BINARY;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void AccessLog::publish(const char *line, const std::size_t size) {
+  auto head = m_head.load(std::memory_order_relaxed);
+  if (head + size - m_cached_tail > m_capacity) {
+    m_cached_tail = m_tail.load(std::memory_order_acquire);
+    while (head + size - m_cached_tail > m_capacity) {
+      eventfd_write(m_wake_fd, 1);
+      if (m_overflow == Overflow::DROP) {
+        m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+      }
+      m_tail.wait(m_cached_tail, std::memory_order_acquire);
+      m_cached_tail = m_tail.load(std::memory_order_acquire);
+    }
+  }
+
+  auto offset = head & (m_capacity - 1);
+  auto first = std::min(size, m_capacity - offset);
+  std::memcpy(m_ring.get() + offset, line, first);
+  std::memcpy(m_ring.get(), line + first, size - first);
+  m_head.store(head + size, std::memory_order_release);
+  m_lines.store(m_lines.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+  // Wake the flusher early once the ring is half full, rather than on every line.
+  auto half = m_capacity / 2;
+  if (head - m_cached_tail < half && head + size - m_cached_tail >= half) {
+    eventfd_write(m_wake_fd, 1);
+  }
+}
+
+void AccessLog::run() {
+  pollfd wake{m_wake_fd, POLLIN, 0};
+  while (true) {
+    poll(&wake, 1, static_cast<int>(m_flush_interval.count()));
+    eventfd_t count = 0;
+    eventfd_read(m_wake_fd, &count);
+
+    auto stopping = m_stopping.load(std::memory_order_acquire);
+    auto head = m_head.load(std::memory_order_acquire);
+    if (m_format == Format::BINARY) {
+      flush_binary(head);
+    } else {
+      flush_text(head);
+    }
+    if (m_reopen.exchange(false, std::memory_order_relaxed)) {
+      auto fd = open_file();
+      if (fd >= 0) {
+        close(m_fd);
+        m_fd = fd;
+      }
+    }
+    if (stopping) {
+      return;
+    }
+  }
+}
+
+void AccessLog::flush_text(const uint64_t head) {
+  auto tail = m_tail.load(std::memory_order_relaxed);
+  if (tail == head) {
+    return;
+  }
+  auto offset = tail & (m_capacity - 1);
+  auto length = head - tail;
+  auto first = std::min<uint64_t>(length, m_capacity - offset);
+  iovec vectors[2] = {{m_ring.get() + offset, first}, {m_ring.get(), length - first}};
+  write_out(vectors, length > first ? 2 : 1);
+  m_tail.store(head, std::memory_order_release);
+  m_tail.notify_one();
+}
+
+void AccessLog::flush_binary(const uint64_t head) {
+  auto tail = m_tail.load(std::memory_order_relaxed);
+  if (tail == head) {
+    return;
+  }
+  auto offset = tail & (m_capacity - 1);
+  auto length = head - tail;
+  auto first = std::min<uint64_t>(length, m_capacity - offset);
+  std::memcpy(m_records.get(), m_ring.get() + offset, first);
+  std::memcpy(m_records.get() + first, m_ring.get(), length - first);
+  // The worker can go on while the copy is encoded and written.
+  m_tail.store(head, std::memory_order_release);
+  m_tail.notify_one();
+
+  // Interning and time differences only ever make a record shorter, so the
+  // frame takes no more room than the records in the ring did.
+  char *payload = m_frame.get() + AccessRecordEncoder::MAX_FRAME_HEADER;
+  std::size_t payload_size = 0;
+  std::string_view records(m_records.get(), length);
+  AccessRecord record;
+  m_frame_encoder.reset();
+  while (true) {
+    m_decoder.reset();
+    if (m_decoder.decode(records, record) != AccessRecordDecoder::Status::RECORD) {
+      break;
+    }
+    payload_size += m_frame_encoder.encode(record, payload + payload_size);
+  }
+
+  char header[AccessRecordEncoder::MAX_FRAME_HEADER];
+  auto header_size = AccessRecordEncoder::frame_header(payload_size, header);
+  std::memcpy(payload - header_size, header, header_size);
+  iovec frame = {payload - header_size, header_size + payload_size};
+  write_out(&frame, 1);
+}
+
+void AccessLog::write_out(iovec *vectors, int count) {
+  while (count > 0) {
+    auto written = writev(m_fd, vectors, count);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      // Records that cannot be written are lost rather than kept until the
+      // ring fills up and holds up the worker.
+      STAXYS_LOG(ERROR) << "Failed to write the access log " << m_path << ": " << strerror(errno);
+      return;
+    }
+    m_bytes_written.store(m_bytes_written.load(std::memory_order_relaxed) + static_cast<uint64_t>(written),
+                          std::memory_order_relaxed);
+    m_writes.store(m_writes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    auto rest = static_cast<std::size_t>(written);
+    while (count > 0 && rest >= vectors->iov_len) {
+      rest -= vectors->iov_len;
+      ++vectors;
+      --count;
+    }
+    if (count > 0) {
+      vectors->iov_base = static_cast<char *>(vectors->iov_base) + rest;
+      vectors->iov_len -= rest;
+    }
+  }
+}
+
+int AccessLog::open_file() const {
+  auto fd = open(m_path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    STAXYS_LOG(ERROR) << "Failed to open the access log " << m_path << ": " << strerror(errno);
+  }
+  return fd;
+}
+
+} // namespace staxys::logging
@@ -0,0 +1,403 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/logging/access_record.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace staxys::logging {
+
+namespace {
+const char HEX_DIGITS[] = "0123456789ABCDEF";
+const char *const MONTHS[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+/// More than the fixed parts of a JSON line after its first string take, so
+/// that cutting the strings short always leaves room to close the object.
+constexpr std::size_t JSON_RESERVE = 192;
+
+/// Appends to a line without running past its end, which is kept free for
+/// the final '\n'. Escaped text also stops at the limit, which may be set
+/// short of the end to keep room for what has to follow it.
+class LineWriter {
+public:
+  LineWriter(char *line, std::size_t capacity, std::size_t reserve = 0)
+      : m_out(line), m_end(line + capacity - 1), m_limit(m_end - reserve) {}
+
+  void put(const std::string_view text) {
+    auto count = std::min<std::size_t>(text.size(), static_cast<std::size_t>(m_end - m_out));
+    std::memcpy(m_out, text.data(), count);
+    m_out += count;
+  }
+
+  /// Appends \p text, or "-" if it is empty, with '"', '\' and bytes that
+  /// are not printable ASCII escaped as \xHH.
+  void put_escaped(const std::string_view text) {
+    if (text.empty()) {
+      put("-");
+      return;
+    }
+    for (auto c : text) {
+      auto byte = static_cast<unsigned char>(c);
+      if (byte >= 0x20 && byte < 0x7f && byte != '"' && byte != '\\') {
+        if (m_out >= m_limit) {
+          return;
+        }
+        *m_out++ = c;
+        continue;
+      }
+      if (m_limit - m_out < 4) {
+        return;
+      }
+      *m_out++ = '\\';
+      *m_out++ = 'x';
+      *m_out++ = HEX_DIGITS[byte >> 4];
+      *m_out++ = HEX_DIGITS[byte & 0xf];
+    }
+  }
+
+  /// Appends \p text as the inside of a JSON string, with bytes that are
+  /// not printable ASCII escaped as \u00HH.
+  void put_json(const std::string_view text) {
+    for (auto c : text) {
+      auto byte = static_cast<unsigned char>(c);
+      if (byte >= 0x20 && byte < 0x7f && byte != '"' && byte != '\\') {
+        if (m_out >= m_limit) {
+          return;
+        }
+        *m_out++ = c;
+        continue;
+      }
+      if (byte == '"' || byte == '\\') {
+        if (m_limit - m_out < 2) {
+          return;
+        }
+        *m_out++ = '\\';
+        *m_out++ = c;
+        continue;
+      }
+      if (m_limit - m_out < 6) {
+        return;
+      }
+      std::memcpy(m_out, "\\u00", 4);
+      m_out[4] = HEX_DIGITS[byte >> 4];
+      m_out[5] = HEX_DIGITS[byte & 0xf];
+      m_out += 6;
+    }
+  }
+
+  void put_number(const int64_t number) {
+    char digits[24];
+    auto end = std::to_chars(digits, digits + sizeof(digits), number).ptr;
+    put({digits, static_cast<std::size_t>(end - digits)});
+  }
+
+  /// Ends the line with '\n'.
+  /// \return Its length.
+  std::size_t finish(const char *line) {
+    *m_out++ = '\n';
+    return static_cast<std::size_t>(m_out - line);
+  }
+
+private:
+  char *m_out;
+  char *m_end;
+  char *m_limit;
+};
+
+void put_varint(char *&out, uint64_t value) {
+  while (value >= 0x80) {
+    *out++ = static_cast<char>(value | 0x80);
+    value >>= 7;
+  }
+  *out++ = static_cast<char>(value);
+}
+
+/// Reads a varint from the front of \p data.
+/// \return Its length, 0 if \p data ends inside it, or -1 if it is longer
+///         than any 64-bit value.
+int get_varint(const std::string_view data, uint64_t &value) {
+  value = 0;
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    if (i == 10) {
+      return -1;
+    }
+    auto byte = static_cast<unsigned char>(data[i]);
+    value |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+    if (byte < 0x80) {
+      return static_cast<int>(i + 1);
+    }
+  }
+  return data.size() >= 10 ? -1 : 0;
+}
+
+/// Reads and removes a varint from the front of \p data.
+bool take_varint(std::string_view &data, uint64_t &value) {
+  auto length = get_varint(data, value);
+  if (length <= 0) {
+    return false;
+  }
+  data.remove_prefix(static_cast<std::size_t>(length));
+  return true;
+}
+
+std::size_t varint_size(uint64_t value) {
+  std::size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+uint64_t zigzag(const int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(const uint64_t value) { return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1); }
+
+int to_int(const uint64_t value) { return static_cast<int>(std::min<uint64_t>(value, INT_MAX)); }
+} // namespace
+
+std::size_t AccessRecordText::format_time(const int64_t second, char *time) {
+  auto seconds = static_cast<time_t>(second);
+  tm fields{};
+  gmtime_r(&seconds, &fields);
+  auto length = std::snprintf(time, TIME_SIZE, "[%02d/%s/%04d:%02d:%02d:%02d +0000]", fields.tm_mday,
+                              MONTHS[fields.tm_mon], fields.tm_year + 1900, fields.tm_hour, fields.tm_min,
+                              fields.tm_sec);
+  return std::min<std::size_t>(static_cast<std::size_t>(std::max(length, 0)), TIME_SIZE - 1);
+}
+
+std::size_t AccessRecordText::to_text(const AccessRecord &record, const std::string_view time, char *line) {
+  // client user [time] "GET /path HTTP/1.1" status bytes "referer" "user agent"; there is
+  // no authentication yet, so the user is always "-".
+  LineWriter writer(line, MAX_LINE);
+  writer.put(record.client.empty() ? "-" : record.client);
+  writer.put(" - ");
+  writer.put(time);
+  writer.put(" \"");
+  if (record.method.empty()) {
+    writer.put("-");
+  } else {
+    writer.put_escaped(record.method);
+    writer.put(" ");
+    writer.put_escaped(record.target);
+    writer.put(record.minor_version == 0 ? " HTTP/1.0" : " HTTP/1.1");
+  }
+  writer.put("\" ");
+  writer.put_number(record.status);
+  writer.put(" ");
+  if (record.bytes < 0) {
+    writer.put("-");
+  } else {
+    writer.put_number(record.bytes);
+  }
+  writer.put(" \"");
+  writer.put_escaped(record.referer);
+  writer.put("\" \"");
+  writer.put_escaped(record.user_agent);
+  writer.put("\"");
+  return writer.finish(line);
+}
+
+std::size_t AccessRecordText::to_json(const AccessRecord &record, char *line) {
+  auto seconds = static_cast<time_t>(record.time >= 0 ? record.time / 1000000 : (record.time + 1) / 1000000 - 1);
+  auto microseconds = record.time - static_cast<int64_t>(seconds) * 1000000;
+  tm fields{};
+  gmtime_r(&seconds, &fields);
+  char time[40];
+  auto time_length = std::snprintf(time, sizeof(time), "%04d-%02d-%02dT%02d:%02d:%02d.%06dZ", fields.tm_year + 1900,
+                                   fields.tm_mon + 1, fields.tm_mday, fields.tm_hour, fields.tm_min, fields.tm_sec,
+                                   static_cast<int>(microseconds));
+
+  LineWriter writer(line, MAX_LINE, JSON_RESERVE);
+  writer.put("{\"time\":\"");
+  writer.put({time, static_cast<std::size_t>(std::clamp(time_length, 0, static_cast<int>(sizeof(time) - 1)))});
+  writer.put("\",\"client\":\"");
+  writer.put_json(record.client);
+  writer.put("\",\"method\":\"");
+  writer.put_json(record.method);
+  writer.put("\",\"target\":\"");
+  writer.put_json(record.target);
+  writer.put("\",\"protocol\":\"");
+  if (!record.method.empty()) {
+    writer.put(record.minor_version == 0 ? "HTTP/1.0" : "HTTP/1.1");
+  }
+  writer.put("\",\"status\":");
+  writer.put_number(record.status);
+  writer.put(",\"bytes\":");
+  if (record.bytes < 0) {
+    writer.put("null");
+  } else {
+    writer.put_number(record.bytes);
+  }
+  writer.put(",\"referer\":\"");
+  writer.put_json(record.referer);
+  writer.put("\",\"user_agent\":\"");
+  writer.put_json(record.user_agent);
+  writer.put("\"}");
+  return writer.finish(line);
+}
+
+std::size_t AccessRecordEncoder::encode(const AccessRecord &record, char *out) {
+  // The record goes after room for the longest length prefix, then moves up
+  // if its length takes fewer bytes.
+  constexpr std::size_t LENGTH_ROOM = 2;
+  static_assert(MAX_RECORD <= 1U << (7 * LENGTH_ROOM));
+  char *start = out + LENGTH_ROOM;
+  char *end = out + MAX_RECORD;
+  char *cursor = start;
+
+  put_varint(cursor, zigzag(record.time - m_time));
+  m_time = record.time;
+  put_varint(cursor, static_cast<uint64_t>(std::max(record.status, 0)));
+  put_varint(cursor, record.bytes < 0 ? 0 : static_cast<uint64_t>(record.bytes) + 1);
+  put_varint(cursor, static_cast<uint64_t>(std::max(record.minor_version, 0)));
+
+  // Strings first written here; interned once the record is in place.
+  std::array<std::pair<std::size_t, std::size_t>, 5> added{};
+  std::size_t added_count = 0;
+  const std::array<std::string_view, 5> strings = {record.client, record.method, record.target, record.referer,
+                                                   record.user_agent};
+  for (std::size_t i = 0; i < strings.size(); ++i) {
+    auto text = strings[i];
+    if (m_intern && !text.empty()) {
+      auto found = m_strings.find(text);
+      if (found != m_strings.end()) {
+        put_varint(cursor, (found->second + 1) << 1);
+        continue;
+      }
+    }
+    // Two bytes for this string's length and one for each one after it.
+    auto room = static_cast<std::size_t>(end - cursor);
+    auto needed = 2 + (strings.size() - i - 1);
+    text = text.substr(0, room > needed ? room - needed : 0);
+    if (text.empty()) {
+      put_varint(cursor, 0);
+      continue;
+    }
+    put_varint(cursor, (static_cast<uint64_t>(text.size()) << 1) | 1);
+    std::memcpy(cursor, text.data(), text.size());
+    if (m_intern) {
+      added[added_count++] = {static_cast<std::size_t>(cursor - start), text.size()};
+    }
+    cursor += text.size();
+  }
+
+  auto length = static_cast<std::size_t>(cursor - start);
+  auto prefix = varint_size(length);
+  char *body = out + prefix;
+  if (prefix < LENGTH_ROOM) {
+    std::memmove(body, start, length);
+  }
+  char *prefix_cursor = out;
+  put_varint(prefix_cursor, length);
+  for (std::size_t i = 0; i < added_count; ++i) {
+    // A string repeated within the record keeps the index of its first copy,
+    // but every copy has one in the decoder's numbering.
+    m_strings.emplace(std::string_view(body + added[i].first, added[i].second), m_string_count++);
+  }
+  return prefix + length;
+}
+
+void AccessRecordEncoder::reset() {
+  m_time = 0;
+  m_strings.clear();
+  m_string_count = 0;
+}
+
+std::size_t AccessRecordEncoder::frame_header(const std::size_t payloadSize, char *header) {
+  std::memcpy(header, MAGIC.data(), MAGIC.size());
+  char *cursor = header + MAGIC.size();
+  put_varint(cursor, payloadSize);
+  return static_cast<std::size_t>(cursor - header);
+}
+
+int AccessRecordDecoder::parse_frame_header(const std::string_view data, uint64_t &payloadSize) {
+  const auto &magic = AccessRecordEncoder::MAGIC;
+  if (data.size() < magic.size()) {
+    return magic.starts_with(data) ? 0 : -1;
+  }
+  if (!data.starts_with(magic)) {
+    return -1;
+  }
+  auto length = get_varint(data.substr(magic.size()), payloadSize);
+  return length <= 0 ? length : static_cast<int>(magic.size()) + length;
+}
+
+AccessRecordDecoder::Status AccessRecordDecoder::decode(std::string_view &payload, AccessRecord &record) {
+  if (payload.empty()) {
+    return Status::END;
+  }
+  uint64_t length = 0;
+  if (!take_varint(payload, length) || length > payload.size()) {
+    return Status::INVALID;
+  }
+  auto body = payload.substr(0, length);
+
+  uint64_t time = 0;
+  uint64_t status = 0;
+  uint64_t bytes = 0;
+  uint64_t minor_version = 0;
+  if (!take_varint(body, time) || !take_varint(body, status) || !take_varint(body, bytes) ||
+      !take_varint(body, minor_version)) {
+    return Status::INVALID;
+  }
+  m_time += unzigzag(time);
+  record.time = m_time;
+  record.status = to_int(status);
+  record.bytes = bytes == 0 ? -1 : static_cast<int64_t>(std::min<uint64_t>(bytes - 1, INT64_MAX));
+  record.minor_version = to_int(minor_version);
+
+  for (auto *text : {&record.client, &record.method, &record.target, &record.referer, &record.user_agent}) {
+    uint64_t value = 0;
+    if (!take_varint(body, value)) {
+      return Status::INVALID;
+    }
+    if (value == 0) {
+      *text = {};
+    } else if ((value & 1) != 0) {
+      auto size = value >> 1;
+      if (size > body.size()) {
+        return Status::INVALID;
+      }
+      *text = body.substr(0, size);
+      body.remove_prefix(size);
+      m_strings.push_back(*text);
+    } else {
+      auto index = (value >> 1) - 1;
+      if (index >= m_strings.size()) {
+        return Status::INVALID;
+      }
+      *text = m_strings[index];
+    }
+  }
+  // Whatever follows belongs to fields added after these.
+  payload.remove_prefix(length);
+  return Status::RECORD;
+}
+
+void AccessRecordDecoder::reset() {
+  m_time = 0;
+  m_strings.clear();
+}
+
+} // namespace staxys::logging
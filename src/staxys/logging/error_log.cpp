@@ -14,4 +14,187 @@
  * limitations under the License.
  */
 
-#include "staxys/logging/error_log.h"
\ No newline at end of file
+#include "staxys/logging/error_log.h"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace staxys::logging {
+
+ErrorLog::ErrorLog(std::string path, const std::size_t capacity, const std::chrono::milliseconds flushInterval)
+    : m_path(std::move(path)), m_capacity(capacity),
+      m_flush_interval(std::max(flushInterval, std::chrono::milliseconds(1))) {}
+
+ErrorLog::~ErrorLog() {
+  stop();
+  if (m_fd >= 0) {
+    close(m_fd);
+  }
+}
+
+bool ErrorLog::open() {
+  if (m_path.empty()) {
+    return true;
+  }
+  auto fd = ::open(m_path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    std::fprintf(stderr, "Failed to open the error log %s: %s\n", m_path.c_str(), strerror(errno));
+    return false;
+  }
+  std::lock_guard lock(m_mutex);
+  if (m_fd >= 0) {
+    close(m_fd);
+  }
+  m_fd = fd;
+  return true;
+}
+
+bool ErrorLog::start(std::function<void()> tick) {
+  if (m_thread) {
+    return true;
+  }
+  m_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_wake_fd < 0) {
+    std::fprintf(stderr, "Failed to create the error log wake fd: %s\n", strerror(errno));
+    return false;
+  }
+  m_tick = std::move(tick);
+  m_stopping = false;
+
+  // Signals stay with the threads that react to them.
+  sigset_t all;
+  sigset_t previous;
+  sigfillset(&all);
+  pthread_sigmask(SIG_BLOCK, &all, &previous);
+  {
+    std::lock_guard lock(m_mutex);
+    m_buffer.reserve(m_capacity);
+    m_writing.reserve(m_capacity);
+    try {
+      m_thread = std::make_unique<std::thread>(&ErrorLog::run, this);
+    } catch (const std::system_error &e) {
+      std::fprintf(stderr, "Failed to start the error log thread: %s\n", e.what());
+    }
+  }
+  pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+  if (!m_thread) {
+    close(m_wake_fd);
+    m_wake_fd = -1;
+    return false;
+  }
+  return true;
+}
+
+void ErrorLog::stop() {
+  std::unique_ptr<std::thread> thread;
+  {
+    std::lock_guard lock(m_mutex);
+    thread = std::move(m_thread);
+  }
+  if (thread) {
+    m_stopping = true;
+    eventfd_write(m_wake_fd, 1);
+    thread->join();
+  }
+  if (m_wake_fd >= 0) {
+    close(m_wake_fd);
+    m_wake_fd = -1;
+  }
+}
+
+void ErrorLog::write(const std::string_view line) {
+  std::lock_guard lock(m_mutex);
+  if (!m_thread) {
+    write_out(line);
+    return;
+  }
+  auto size = m_buffer.size();
+  if (size + line.size() > m_capacity) {
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  m_buffer.append(line);
+  // Wake the writer early once the buffer is half full, rather than on every line.
+  auto half = m_capacity / 2;
+  if (size < half && m_buffer.size() >= half) {
+    eventfd_write(m_wake_fd, 1);
+  }
+}
+
+void ErrorLog::reopen() {
+  m_reopen.store(true, std::memory_order_relaxed);
+  if (m_wake_fd >= 0) {
+    eventfd_write(m_wake_fd, 1);
+  }
+}
+
+void ErrorLog::prepare_fork() { m_mutex.lock(); }
+
+void ErrorLog::parent_after_fork() { m_mutex.unlock(); }
+
+void ErrorLog::child_after_fork() {
+  static_cast<void>(m_thread.release());
+  m_buffer.clear();
+  m_writing.clear();
+  if (m_wake_fd >= 0) {
+    close(m_wake_fd);
+    m_wake_fd = -1;
+  }
+  m_stopping = false;
+  m_mutex.unlock();
+}
+
+void ErrorLog::run() {
+  pollfd wake{m_wake_fd, POLLIN, 0};
+  while (true) {
+    poll(&wake, 1, static_cast<int>(m_flush_interval.count()));
+    eventfd_t count = 0;
+    eventfd_read(m_wake_fd, &count);
+
+    auto stopping = m_stopping.load(std::memory_order_acquire);
+    if (m_tick) {
+      m_tick();
+    }
+    flush();
+    if (m_reopen.exchange(false, std::memory_order_relaxed)) {
+      open();
+    }
+    if (stopping) {
+      return;
+    }
+  }
+}
+
+void ErrorLog::flush() {
+  {
+    std::lock_guard lock(m_mutex);
+    m_buffer.swap(m_writing);
+  }
+  write_out(m_writing);
+  m_writing.clear();
+}
+
+void ErrorLog::write_out(std::string_view data) {
+  auto fd = m_fd >= 0 ? m_fd : STDERR_FILENO;
+  while (!data.empty()) {
+    auto written = ::write(fd, data.data(), data.size());
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      // There is nowhere left to report this to.
+      return;
+    }
+    data.remove_prefix(static_cast<std::size_t>(written));
+  }
+}
+
+} // namespace staxys::logging
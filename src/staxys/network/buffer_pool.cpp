@@ -0,0 +1,131 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/buffer_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace staxys::network {
+
+BufferPool::Buffer::~Buffer() {
+  if (m_data != nullptr) {
+    m_pool->give_back(std::move(m_data), m_size_class);
+  }
+}
+
+BufferPool::Buffer::Buffer(Buffer &&other) noexcept
+    : m_pool(other.m_pool), m_data(std::move(other.m_data)), m_size_class(other.m_size_class) {}
+
+BufferPool::Buffer &BufferPool::Buffer::operator=(Buffer &&other) noexcept {
+  if (this != &other) {
+    if (m_data != nullptr) {
+      m_pool->give_back(std::move(m_data), m_size_class);
+    }
+    m_pool = other.m_pool;
+    m_data = std::move(other.m_data);
+    m_size_class = other.m_size_class;
+  }
+  return *this;
+}
+
+BufferPool::BufferPool(const std::size_t max_idle_bytes) {
+  for (std::size_t index = 0; index < m_classes.size(); ++index) {
+    m_classes[index].max_idle = max_idle_bytes / BUFFER_SIZES[index];
+  }
+}
+
+BufferPool::Buffer BufferPool::acquire(const std::size_t capacity) {
+  auto fits = std::find_if(BUFFER_SIZES.begin(), BUFFER_SIZES.end(), [&](auto size) { return size >= capacity; });
+  if (fits == BUFFER_SIZES.end()) {
+    return {};
+  }
+  auto index = static_cast<uint8_t>(fits - BUFFER_SIZES.begin());
+  auto &size_class = m_classes[index];
+
+  std::unique_ptr<char[]> data;
+  if (size_class.idle.empty()) {
+    data = std::make_unique_for_overwrite<char[]>(BUFFER_SIZES[index]);
+  } else {
+    data = std::move(size_class.idle.back());
+    size_class.idle.pop_back();
+  }
+  size_class.high_water = std::max(size_class.high_water, ++size_class.in_use);
+  return {this, std::move(data), index};
+}
+
+std::array<BufferPool::Stats, BufferPool::BUFFER_SIZES.size()> BufferPool::stats() const {
+  std::array<Stats, BUFFER_SIZES.size()> stats{};
+  for (std::size_t index = 0; index < m_classes.size(); ++index) {
+    const auto &size_class = m_classes[index];
+    stats[index] = {BUFFER_SIZES[index], size_class.in_use, size_class.idle.size(), size_class.high_water};
+  }
+  return stats;
+}
+
+void BufferPool::give_back(std::unique_ptr<char[]> data, const uint8_t index) {
+  auto &size_class = m_classes[index];
+  --size_class.in_use;
+  if (size_class.idle.size() < size_class.max_idle) {
+    size_class.idle.push_back(std::move(data));
+  }
+}
+
+std::span<char> ReadBuffer::prepare() {
+  if (m_size == m_buffer.capacity() && !grow(m_size + 1)) {
+    return {};
+  }
+  return {m_buffer.data() + m_size, m_buffer.capacity() - m_size};
+}
+
+bool ReadBuffer::append(const char *bytes, const std::size_t count) {
+  if (m_size + count > m_buffer.capacity() && !grow(m_size + count)) {
+    return false;
+  }
+  std::memcpy(m_buffer.data() + m_size, bytes, count);
+  m_size += count;
+  return true;
+}
+
+void ReadBuffer::consume(const std::size_t count) {
+  if (count >= m_size) {
+    m_size = 0;
+    m_buffer = {};
+    return;
+  }
+  std::memmove(m_buffer.data(), m_buffer.data() + count, m_size - count);
+  m_size -= count;
+}
+
+void ReadBuffer::trim() {
+  if (m_size == 0) {
+    m_buffer = {};
+  }
+}
+
+bool ReadBuffer::grow(const std::size_t capacity) {
+  auto larger = m_pool->acquire(std::max(capacity, m_buffer.capacity() + 1));
+  if (!larger) {
+    return false;
+  }
+  if (m_size > 0) {
+    std::memcpy(larger.data(), m_buffer.data(), m_size);
+  }
+  m_buffer = std::move(larger);
+  return true;
+}
+
+} // namespace staxys::network
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/byte_ranges.h"
+#include <algorithm>
+
+namespace staxys::network {
+
+namespace {
+std::string_view trim(std::string_view value) {
+  while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+    value.remove_prefix(1);
+  }
+  while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+    value.remove_suffix(1);
+  }
+  return value;
+}
+
+/// Parses a non-empty run of digits that fits in 64 bits.
+bool parse_number(const std::string_view text, uint64_t &value) {
+  if (text.empty() || text.size() > 19) {
+    return false;
+  }
+  value = 0;
+  for (auto c : text) {
+    if (c < '0' || c > '9') {
+      return false;
+    }
+    value = value * 10 + static_cast<uint64_t>(c - '0');
+  }
+  return true;
+}
+} // namespace
+
+ByteRanges::Result ByteRanges::parse(std::string_view header, const uint64_t size) {
+  m_count = 0;
+  header = trim(header);
+  auto equals = header.find('=');
+  auto unit = trim(header.substr(0, equals));
+  if (equals == std::string_view::npos || unit.size() != 5 ||
+      !std::equal(unit.begin(), unit.end(), "bytes", [](char a, char b) { return (a | 0x20) == b; })) {
+    return Result::IGNORED;
+  }
+
+  auto specs = header.substr(equals + 1);
+  bool any = false;
+  while (!specs.empty()) {
+    auto comma = specs.find(',');
+    auto spec = trim(specs.substr(0, comma));
+    specs = comma == std::string_view::npos ? std::string_view() : specs.substr(comma + 1);
+    if (spec.empty()) {
+      // Empty list elements are allowed.
+      continue;
+    }
+    any = true;
+
+    auto dash = spec.find('-');
+    if (dash == std::string_view::npos) {
+      return Result::IGNORED;
+    }
+    uint64_t first = 0;
+    uint64_t last = 0;
+    if (dash == 0) {
+      // "-500" is the last 500 bytes.
+      uint64_t suffix = 0;
+      if (!parse_number(spec.substr(1), suffix)) {
+        return Result::IGNORED;
+      }
+      if (suffix == 0 || size == 0) {
+        continue;
+      }
+      first = size - std::min(suffix, size);
+      last = size - 1;
+    } else {
+      if (!parse_number(spec.substr(0, dash), first)) {
+        return Result::IGNORED;
+      }
+      auto end = spec.substr(dash + 1);
+      if (end.empty()) {
+        last = UINT64_MAX;
+      } else if (!parse_number(end, last) || last < first) {
+        return Result::IGNORED;
+      }
+      if (first >= size) {
+        continue;
+      }
+      last = std::min(last, size - 1);
+    }
+    if (!add(first, last)) {
+      return Result::IGNORED;
+    }
+  }
+
+  if (!any) {
+    return Result::IGNORED;
+  }
+  return m_count == 0 ? Result::UNSATISFIABLE : Result::SATISFIABLE;
+}
+
+bool ByteRanges::add(uint64_t first, uint64_t last) {
+  // Keep the ranges sorted; fold in every neighbour this one overlaps or touches.
+  auto begin = m_ranges.begin();
+  auto end = begin + static_cast<std::ptrdiff_t>(m_count);
+  auto position = std::find_if(begin, end, [first](const Range &range) { return range.first >= first; });
+  if (position != begin) {
+    auto &previous = *(position - 1);
+    if (previous.first + previous.length >= first) {
+      last = std::max(last, previous.first + previous.length - 1);
+      first = previous.first;
+      --position;
+    }
+  }
+  auto next = position;
+  while (next != end && next->first <= last + 1) {
+    last = std::max(last, next->first + next->length - 1);
+    ++next;
+  }
+
+  auto removed = static_cast<std::size_t>(next - position);
+  if (removed == 0 && m_count == MAX_RANGES) {
+    return false;
+  }
+  // Replace the merged ranges [position, next) with the one new range.
+  if (removed == 0) {
+    std::move_backward(position, end, end + 1);
+  } else {
+    std::move(next, end, position + 1);
+  }
+  m_count = m_count - removed + 1;
+  *position = {first, last - first + 1};
+  return true;
+}
+
+} // namespace staxys::network
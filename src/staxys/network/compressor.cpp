@@ -0,0 +1,217 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/compressor.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <unistd.h>
+#include <zlib.h>
+#ifdef STAXYS_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace staxys::network {
+
+namespace {
+// windowBits for deflate with a gzip header and trailer instead of zlib's.
+const int GZIP_WINDOW_BITS = 15 + 16;
+const int MEMORY_LEVEL = 8;
+} // namespace
+
+Compressor::Compressor(const ContentCoding::Coding coding, const int level)
+    : m_coding(coding), m_input(new char[BUFFER_SIZE]), m_output(new char[BUFFER_SIZE]) {
+  if (coding == ContentCoding::GZIP) {
+    m_deflate = new z_stream{};
+    m_valid = deflateInit2(m_deflate, std::clamp(level, 1, 9), Z_DEFLATED, GZIP_WINDOW_BITS, MEMORY_LEVEL,
+                           Z_DEFAULT_STRATEGY) == Z_OK;
+    if (!m_valid) {
+      delete m_deflate;
+      m_deflate = nullptr;
+    }
+  }
+#ifdef STAXYS_HAVE_ZSTD
+  if (coding == ContentCoding::ZSTD) {
+    m_zstd = ZSTD_createCCtx();
+    m_valid = m_zstd != nullptr &&
+              !ZSTD_isError(ZSTD_CCtx_setParameter(m_zstd, ZSTD_c_compressionLevel, std::max(level, 1)));
+  }
+#endif
+}
+
+Compressor::~Compressor() {
+  if (m_deflate != nullptr) {
+    deflateEnd(m_deflate);
+    delete m_deflate;
+  }
+#ifdef STAXYS_HAVE_ZSTD
+  ZSTD_freeCCtx(m_zstd);
+#endif
+}
+
+bool Compressor::valid() const { return m_valid; }
+
+void Compressor::reset_codec() {
+  if (m_deflate != nullptr) {
+    deflateReset(m_deflate);
+  }
+#ifdef STAXYS_HAVE_ZSTD
+  if (m_zstd != nullptr) {
+    ZSTD_CCtx_reset(m_zstd, ZSTD_reset_session_only);
+  }
+#endif
+  m_ended = false;
+}
+
+void Compressor::start(std::shared_ptr<const static_content::OpenFile> file, const uint64_t offset,
+                       const uint64_t length) {
+  reset_codec();
+  m_file = std::move(file);
+  m_offset = offset;
+  m_left = length;
+  m_pending = {};
+}
+
+void Compressor::start(const std::string_view body) {
+  reset_codec();
+  m_file.reset();
+  m_offset = m_left = 0;
+  m_pending = body;
+}
+
+bool Compressor::next(std::string_view &chunk) {
+  chunk = {};
+  while (!m_ended) {
+    if (m_pending.empty() && m_left > 0) {
+      auto got = pread(m_file->fd(), m_input.get(), std::min<uint64_t>(m_left, BUFFER_SIZE),
+                       static_cast<off_t>(m_offset));
+      if (got < 0 && errno == EINTR) {
+        continue;
+      }
+      if (got <= 0) {
+        // The file shrank or cannot be read; the promised body is lost.
+        return false;
+      }
+      m_pending = {m_input.get(), static_cast<std::size_t>(got)};
+      m_offset += static_cast<uint64_t>(got);
+      m_left -= static_cast<uint64_t>(got);
+    }
+
+    std::size_t produced = 0;
+    if (!step(m_left == 0, produced)) {
+      return false;
+    }
+    if (produced > 0) {
+      chunk = {m_output.get(), produced};
+      return true;
+    }
+  }
+  return true;
+}
+
+bool Compressor::step(const bool finish, std::size_t &produced) {
+  if (m_deflate != nullptr) {
+    auto offered = std::min<std::size_t>(m_pending.size(), UINT_MAX);
+    m_deflate->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(m_pending.data()));
+    m_deflate->avail_in = static_cast<uInt>(offered);
+    m_deflate->next_out = reinterpret_cast<Bytef *>(m_output.get());
+    m_deflate->avail_out = BUFFER_SIZE;
+    // Only the last of the input may be finished; deflate() then keeps
+    // returning Z_OK until the trailer is out.
+    auto result = deflate(m_deflate, finish && offered == m_pending.size() ? Z_FINISH : Z_NO_FLUSH);
+    if (result == Z_STREAM_ERROR) {
+      return false;
+    }
+    m_pending.remove_prefix(offered - m_deflate->avail_in);
+    produced = BUFFER_SIZE - m_deflate->avail_out;
+    m_ended = result == Z_STREAM_END;
+    return true;
+  }
+#ifdef STAXYS_HAVE_ZSTD
+  if (m_zstd != nullptr) {
+    ZSTD_inBuffer input{m_pending.data(), m_pending.size(), 0};
+    ZSTD_outBuffer output{m_output.get(), BUFFER_SIZE, 0};
+    auto left = ZSTD_compressStream2(m_zstd, &output, &input, finish ? ZSTD_e_end : ZSTD_e_continue);
+    if (ZSTD_isError(left)) {
+      return false;
+    }
+    m_pending.remove_prefix(input.pos);
+    produced = output.pos;
+    m_ended = finish && left == 0;
+    return true;
+  }
+#endif
+  return false;
+}
+
+void Compressor::release() {
+  m_file.reset();
+  m_pending = {};
+  if (m_pool != nullptr) {
+    m_pool->put_back(this);
+  }
+}
+
+bool Compressor::compress(const std::string_view body, std::string &output) {
+  start(body);
+  output.clear();
+  std::string_view chunk;
+  while (next(chunk)) {
+    if (chunk.empty()) {
+      return true;
+    }
+    output.append(chunk);
+  }
+  return false;
+}
+
+CompressorPool::CompressorPool(const int level, const std::size_t capacity) : m_level(level), m_capacity(capacity) {
+  m_contexts.reserve(capacity);
+  m_idle.reserve(capacity);
+}
+
+uint8_t CompressorPool::supported() {
+#ifdef STAXYS_HAVE_ZSTD
+  return ContentCoding::GZIP | ContentCoding::ZSTD;
+#else
+  return ContentCoding::GZIP;
+#endif
+}
+
+CompressorPool::Handle CompressorPool::acquire(const ContentCoding::Coding coding) {
+  auto idle = std::find_if(m_idle.rbegin(), m_idle.rend(),
+                           [coding](const Compressor *compressor) { return compressor->coding() == coding; });
+  if (idle != m_idle.rend()) {
+    auto *compressor = *idle;
+    m_idle.erase(std::next(idle).base());
+    return Handle(compressor);
+  }
+
+  if (m_contexts.size() >= m_capacity || !(supported() & coding)) {
+    return nullptr;
+  }
+  auto compressor = std::make_unique<Compressor>(coding, m_level);
+  if (!compressor->valid()) {
+    return nullptr;
+  }
+  compressor->m_pool = this;
+  m_contexts.push_back(std::move(compressor));
+  return Handle(m_contexts.back().get());
+}
+
+void CompressorPool::put_back(Compressor *compressor) { m_idle.push_back(compressor); }
+
+} // namespace staxys::network
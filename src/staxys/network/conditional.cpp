@@ -0,0 +1,94 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/conditional.h"
+#include "staxys/utils/date_utils.h"
+
+namespace staxys::network {
+
+namespace {
+std::string_view trim(std::string_view value) {
+  while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+    value.remove_prefix(1);
+  }
+  while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+    value.remove_suffix(1);
+  }
+  return value;
+}
+
+/// Splits "W/" off an entity tag.
+std::string_view opaque_tag(std::string_view etag, bool &weak) {
+  weak = etag.substr(0, 2) == "W/";
+  return weak ? etag.substr(2) : etag;
+}
+} // namespace
+
+bool Conditional::not_modified(const Request &request, const std::string_view etag, const time_t modified) {
+  auto none_match = request.header("If-None-Match");
+  if (!none_match.empty()) {
+    return etag_listed(none_match, etag, true);
+  }
+
+  auto modified_since = trim(request.header("If-Modified-Since"));
+  time_t since = 0;
+  return !modified_since.empty() && utils::DateUtils::parse_http_date(modified_since, since) && modified <= since;
+}
+
+bool Conditional::range_applies(const Request &request, const std::string_view etag,
+                                const std::string_view last_modified) {
+  auto if_range = trim(request.header("If-Range"));
+  if (if_range.empty()) {
+    return true;
+  }
+  if (if_range.front() == '"' || if_range.substr(0, 2) == "W/") {
+    return etag_listed(if_range, etag, false);
+  }
+  return if_range == last_modified;
+}
+
+bool Conditional::etag_listed(std::string_view list, const std::string_view etag, const bool weak) {
+  bool etag_weak = false;
+  auto wanted = opaque_tag(etag, etag_weak);
+  if (trim(list) == "*") {
+    return true;
+  }
+
+  // Entity tags may contain commas, so the list is split on the quotes.
+  while (true) {
+    auto start = list.find_first_not_of(" \t,");
+    if (start == std::string_view::npos) {
+      return false;
+    }
+    list.remove_prefix(start);
+    bool listed_weak = false;
+    auto rest = opaque_tag(list, listed_weak);
+    if (rest.empty() || rest.front() != '"') {
+      return false;
+    }
+    auto close = rest.find('"', 1);
+    if (close == std::string_view::npos) {
+      return false;
+    }
+    auto tag = rest.substr(0, close + 1);
+    if (tag == wanted && (weak || (!listed_weak && !etag_weak))) {
+      return true;
+    }
+    list = rest.substr(close + 1);
+  }
+}
+
+} // namespace staxys::network
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/connection.h"
+#include "staxys/core/cycle_clock.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace staxys::network {
+
+Connection::~Connection() {
+  if (m_fd >= 0) {
+    close(m_fd);
+  }
+}
+
+void Connection::consume(const std::size_t count) { m_read_buffer.consume(count); }
+
+std::string_view Connection::peer_address() {
+  if (m_peer_address_length == 0) {
+    sockaddr_storage address{};
+    socklen_t length = sizeof(address);
+    const char *text = nullptr;
+    if (getpeername(m_fd, reinterpret_cast<sockaddr *>(&address), &length) == 0) {
+      if (address.ss_family == AF_INET) {
+        text = inet_ntop(AF_INET, &reinterpret_cast<const sockaddr_in &>(address).sin_addr, m_peer_address.data(),
+                         m_peer_address.size());
+      } else if (address.ss_family == AF_INET6) {
+        text = inet_ntop(AF_INET6, &reinterpret_cast<const sockaddr_in6 &>(address).sin6_addr,
+                         m_peer_address.data(), m_peer_address.size());
+      }
+    }
+    if (!text) {
+      std::strcpy(m_peer_address.data(), "-");
+    }
+    m_peer_address_length = std::strlen(m_peer_address.data());
+  }
+  return {m_peer_address.data(), m_peer_address_length};
+}
+
+Response &Connection::respond(const int status) {
+  if (m_first_unsent == m_response_count) {
+    m_first_unsent = m_response_count = 0;
+  }
+  if (m_response_count == m_responses.size()) {
+    m_responses.emplace_back(status, m_arenas);
+  } else {
+    m_responses[m_response_count].reset(status);
+  }
+  return m_responses[m_response_count++];
+}
+
+bool Connection::output_backlogged() const {
+  if (queued_responses() >= MAX_QUEUED_RESPONSES) {
+    return true;
+  }
+  std::size_t bytes = 0;
+  for (auto i = m_first_unsent; i < m_response_count; ++i) {
+    bytes += m_responses[i].remaining();
+  }
+  return bytes >= MAX_QUEUED_BYTES;
+}
+
+msghdr *Connection::output_message() {
+  std::size_t count = 0;
+  std::size_t gathered = 0;
+  std::size_t pending = 0;
+  bool stopped = false;
+  bool streaming = false;
+  m_output_has_file = false;
+  for (auto index = m_first_unsent; index < m_response_count; ++index) {
+    auto &response = m_responses[index];
+    pending += response.remaining();
+    streaming = streaming || response.streaming();
+    if (stopped) {
+      continue;
+    }
+    auto added = response.gather(m_output_vectors.data() + count, MAX_OUTPUT_VECTORS - count);
+    std::size_t bytes = 0;
+    for (auto vector = count; vector < count + added; ++vector) {
+      bytes += m_output_vectors[vector].iov_len;
+    }
+    count += added;
+    gathered += bytes;
+    // Output after a file body has to wait until the file has been sent,
+    // and output after a streamed body until the stream has ended.
+    stopped = bytes < response.remaining() || response.streaming();
+    // With iovecs to spare, gather() can only have stopped at a file body.
+    m_output_has_file = stopped && count < MAX_OUTPUT_VECTORS && response.next_file(m_output_file);
+  }
+  m_output_left = pending - gathered;
+  m_output_streaming = streaming;
+  m_output_is_final = m_output_left == 0 && !streaming;
+
+  m_output_message = msghdr{};
+  m_output_message.msg_iov = m_output_vectors.data();
+  m_output_message.msg_iovlen = count;
+  return &m_output_message;
+}
+
+bool Connection::output_file(Response::FileRange &range) const {
+  if (!m_output_has_file) {
+    return false;
+  }
+  range = m_output_file;
+  return true;
+}
+
+void Connection::extend_output(const char *data, const std::size_t size) {
+  m_output_vectors[m_output_message.msg_iovlen].iov_base = const_cast<char *>(data);
+  m_output_vectors[m_output_message.msg_iovlen].iov_len = size;
+  ++m_output_message.msg_iovlen;
+  m_output_left -= size;
+  m_output_is_final = m_output_left == 0 && !m_output_streaming;
+  m_output_has_file = false;
+}
+
+void Connection::advance_output(std::size_t count) {
+  if (m_metrics) {
+    m_metrics->bytes_sent.add(count);
+  }
+  // Read once for all the responses this completes.
+  uint64_t wakeup = 0;
+  while (count > 0 && m_first_unsent < m_response_count) {
+    auto &response = m_responses[m_first_unsent];
+    count = response.advance(count);
+    if (response.remaining() > 0) {
+      continue;
+    }
+    ++m_first_unsent;
+    if (m_metrics && response.queued_at() != 0 && !response.failed()) {
+      if (wakeup == 0) {
+        wakeup = wakeup_time();
+      }
+      // A send completed in the wakeup that queued it counts as taking no time.
+      auto sent_at = std::max(wakeup, response.queued_at());
+      m_metrics->time(core::WorkerMetrics::SEND, sent_at - response.queued_at());
+      m_metrics->time(core::WorkerMetrics::TOTAL, sent_at - response.received_at());
+    }
+    if (response.failed()) {
+      // A streamed body broke off, which the client can only tell from the
+      // connection closing; the responses queued behind it are dropped.
+      m_response_count = m_first_unsent;
+      m_close_after_write = true;
+      return;
+    }
+  }
+}
+
+bool Connection::pending_file(Response::FileRange &range) const {
+  return m_first_unsent < m_response_count && m_responses[m_first_unsent].pending_file(range);
+}
+
+Connection::FlushResult Connection::flush(const std::size_t file_budget) {
+  std::size_t file_sent = 0;
+  while (has_pending_output()) {
+    Response::FileRange range{};
+    ssize_t sent;
+    if (pending_file(range)) {
+      if (file_budget > 0 && file_sent >= file_budget) {
+        return FlushResult::YIELDED;
+      }
+      auto chunk = file_budget > 0 ? std::min<uint64_t>(range.length, file_budget - file_sent) : range.length;
+      sent = sendfile(m_fd, range.fd, &range.offset, chunk);
+      if (sent == 0) {
+        // The file shrank underneath us; the promised length can no longer be sent.
+        return FlushResult::FAILED;
+      }
+      if (sent > 0) {
+        file_sent += static_cast<std::size_t>(sent);
+      }
+    } else {
+      // A streamed body counts against the budget like a file body.
+      auto streaming = m_responses[m_first_unsent].streaming();
+      if (streaming && file_budget > 0 && file_sent >= file_budget) {
+        return FlushResult::YIELDED;
+      }
+      auto message = output_message();
+      // Cork the headers when a file body or more output follows.
+      sent = sendmsg(m_fd, message, MSG_NOSIGNAL | (m_output_is_final ? 0 : MSG_MORE));
+      if (streaming && sent > 0) {
+        file_sent += static_cast<std::size_t>(sent);
+      }
+    }
+
+    if (sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // The socket is registered edge-triggered for EPOLLOUT, so the loop
+      // calls back here once the kernel has room again.
+      return errno == EAGAIN || errno == EWOULDBLOCK ? FlushResult::WOULD_BLOCK : FlushResult::FAILED;
+    }
+    advance_output(static_cast<std::size_t>(sent));
+  }
+  return FlushResult::DONE;
+}
+
+} // namespace staxys::network
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/content_coding.h"
+#include <cctype>
+
+namespace staxys::network {
+
+namespace {
+const uint8_t ALL_CODINGS = ContentCoding::GZIP | ContentCoding::BROTLI | ContentCoding::ZSTD;
+
+std::string_view trim(std::string_view value) {
+  while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+    value.remove_prefix(1);
+  }
+  while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+    value.remove_suffix(1);
+  }
+  return value;
+}
+
+bool equals_ignore_case(const std::string_view left, const std::string_view right) {
+  if (left.size() != right.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < left.size(); ++i) {
+    if (std::tolower(static_cast<unsigned char>(left[i])) != right[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Whether the parameters after a coding, e.g. ";q=0.5", leave it acceptable.
+bool weight_allows(std::string_view parameters) {
+  while (!parameters.empty()) {
+    auto end = parameters.find(';', 1);
+    auto parameter = trim(parameters.substr(1, end == std::string_view::npos ? end : end - 1));
+    parameters = end == std::string_view::npos ? std::string_view() : parameters.substr(end);
+    if (parameter.size() < 2 || std::tolower(static_cast<unsigned char>(parameter[0])) != 'q' ||
+        parameter[1] != '=') {
+      continue;
+    }
+    // qvalue = ( "0" [ "." 0*3DIGIT ] ) / ( "1" [ "." 0*3("0") ] ); only zero matters.
+    auto weight = parameter.substr(2);
+    if (weight.empty() || weight[0] != '0') {
+      return true;
+    }
+    for (auto c : weight.substr(1)) {
+      if (c != '.' && c != '0') {
+        return true;
+      }
+    }
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+uint8_t ContentCoding::accepted(std::string_view accept_encoding) {
+  uint8_t allowed = 0;
+  uint8_t listed = 0;
+  bool star = false;
+
+  while (!accept_encoding.empty()) {
+    auto comma = accept_encoding.find(',');
+    auto element = accept_encoding.substr(0, comma);
+    accept_encoding = comma == std::string_view::npos ? std::string_view() : accept_encoding.substr(comma + 1);
+
+    auto semicolon = element.find(';');
+    auto token = trim(element.substr(0, semicolon));
+    auto allows = semicolon == std::string_view::npos || weight_allows(element.substr(semicolon));
+
+    uint8_t coding = 0;
+    if (equals_ignore_case(token, "gzip") || equals_ignore_case(token, "x-gzip")) {
+      coding = GZIP;
+    } else if (equals_ignore_case(token, "br")) {
+      coding = BROTLI;
+    } else if (equals_ignore_case(token, "zstd")) {
+      coding = ZSTD;
+    } else if (token == "*") {
+      star = allows;
+      continue;
+    } else {
+      continue;
+    }
+
+    listed |= coding;
+    allowed = allows ? allowed | coding : allowed & ~coding;
+  }
+
+  return star ? allowed | (ALL_CODINGS & ~listed) : allowed;
+}
+
+std::string_view ContentCoding::name(const Coding coding) {
+  switch (coding) {
+  case GZIP:
+    return "gzip";
+  case BROTLI:
+    return "br";
+  case ZSTD:
+    return "zstd";
+  }
+  return {};
+}
+
+} // namespace staxys::network
@@ -0,0 +1,289 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/epoll_event_loop.h"
+#include "staxys/core/logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace staxys::network {
+
+namespace {
+const int MAX_EVENTS = 512;
+} // namespace
+
+EpollEventLoop::~EpollEventLoop() {
+  m_connections.clear();
+  if (m_epoll_fd >= 0) {
+    close(m_epoll_fd);
+  }
+}
+
+bool EpollEventLoop::init() {
+  m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (m_epoll_fd < 0) {
+    STAXYS_LOG(ERROR) << "Failed to create epoll instance: " << strerror(errno);
+    return false;
+  }
+
+  for (auto fd : m_listeners) {
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLET;
+    event.data.fd = fd;
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+      STAXYS_LOG(ERROR) << "Failed to register listener: " << strerror(errno);
+      return false;
+    }
+  }
+
+  // Level-triggered on purpose: the loop only needs to notice it, not drain it.
+  epoll_event wake{};
+  wake.events = EPOLLIN;
+  wake.data.fd = m_wake_fd;
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_wake_fd, &wake) < 0) {
+    STAXYS_LOG(ERROR) << "Failed to register wake fd: " << strerror(errno);
+    return false;
+  }
+
+  return true;
+}
+
+int EpollEventLoop::run() {
+  std::vector<epoll_event> events(MAX_EVENTS);
+
+  while (m_running.load(std::memory_order_relaxed)) {
+    // Connections with deferred output only need a peek at the other events.
+    auto ready = epoll_wait(m_epoll_fd, events.data(), MAX_EVENTS, m_deferred.empty() ? timer_timeout() : 0);
+    if (ready < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      STAXYS_LOG(ERROR) << "epoll_wait failed: " << strerror(errno);
+      return EXIT_FAILURE;
+    }
+
+    stamp_wakeup();
+    // First, so timers armed below count from now rather than from before the wait.
+    close_expired();
+    for (int i = 0; i < ready; ++i) {
+      handle_event(events[i].data.fd, events[i].events);
+    }
+    resume_deferred();
+  }
+
+  return EXIT_SUCCESS;
+}
+
+void EpollEventLoop::handle_event(const int fd, const unsigned int events) {
+  if (fd == m_wake_fd) {
+    return;
+  }
+
+  if (std::find(m_listeners.begin(), m_listeners.end(), fd) != m_listeners.end()) {
+    accept_connections(fd);
+    return;
+  }
+
+  if (static_cast<std::size_t>(fd) >= m_connections.size() || !m_connections[fd]) {
+    return;
+  }
+  auto &connection = *m_connections[fd];
+
+  if (events & (EPOLLERR | EPOLLHUP)) {
+    close_connection(fd);
+    return;
+  }
+
+  if (events & EPOLLIN) {
+    read_from(connection);
+    if (!m_connections[fd]) {
+      return;
+    }
+  }
+
+  if (events & EPOLLOUT) {
+    write_to(connection);
+  } else if (!connection.has_pending_output() && connection.close_after_write()) {
+    close_connection(fd);
+  }
+}
+
+void EpollEventLoop::accept_connections(const int listener_fd) {
+  // Edge-triggered: keep accepting until the backlog is drained or we would
+  // never hear about the remaining connections.
+  while (true) {
+    int fd = accept4(listener_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        STAXYS_LOG(ERROR) << "accept4 failed: " << strerror(errno);
+      }
+      return;
+    }
+
+    if (m_connection_count >= m_max_connections) {
+      close(fd);
+      continue;
+    }
+
+    int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.fd = fd;
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+      close(fd);
+      continue;
+    }
+
+    if (static_cast<std::size_t>(fd) >= m_connections.size()) {
+      m_connections.resize(static_cast<std::size_t>(fd) + 1);
+    }
+    m_connections[fd] = make_connection(fd);
+    ++m_connection_count;
+    refresh_timer(*m_connections[fd]);
+  }
+}
+
+void EpollEventLoop::read_from(Connection &connection) {
+  auto fd = connection.fd();
+  auto &buffer = connection.read_buffer();
+  connection.input_paused(false);
+
+  while (true) {
+    // Further input waits in the socket while the client is not reading.
+    if (connection.output_backlogged()) {
+      connection.input_paused(true);
+      break;
+    }
+    auto space = buffer.prepare();
+    auto received = recv(fd, space.data(), space.size(), 0);
+    if (received < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      close_connection(fd);
+      return;
+    }
+
+    buffer.commit(static_cast<std::size_t>(received));
+    if (received == 0) {
+      // Peer closed its side; answer whatever is already buffered first.
+      connection.close_after_write(true);
+      break;
+    }
+
+    if (buffer.size() >= MAX_BUFFERED_INPUT) {
+      if (!m_handler.process(connection) ||
+          (buffer.size() >= MAX_BUFFERED_INPUT && !connection.output_backlogged())) {
+        close_connection(fd);
+        return;
+      }
+    }
+  }
+
+  // A wakeup without data must not keep a buffer lent out.
+  buffer.trim();
+  if (!m_handler.process(connection)) {
+    close_connection(fd);
+    return;
+  }
+  // Requests left in the buffer behind a backlog have to be resumed too.
+  if (connection.output_backlogged()) {
+    connection.input_paused(true);
+  }
+
+  write_to(connection);
+}
+
+void EpollEventLoop::write_to(Connection &connection) {
+  auto fd = connection.fd();
+  if (connection.has_pending_output()) {
+    switch (connection.flush(m_max_file_chunk)) {
+    case Connection::FlushResult::FAILED:
+      close_connection(fd);
+      return;
+    case Connection::FlushResult::YIELDED:
+      m_deferred.push_back(fd);
+      refresh_timer(connection);
+      return;
+    default:
+      break;
+    }
+  }
+
+  if (!connection.has_pending_output() && connection.close_after_write()) {
+    close_connection(fd);
+    return;
+  }
+  // No edge announces the input left in the socket; read it on the next iteration.
+  if (connection.input_paused() && !connection.output_backlogged()) {
+    m_deferred.push_back(fd);
+  }
+  refresh_timer(connection);
+}
+
+void EpollEventLoop::resume_deferred() {
+  if (m_deferred.empty()) {
+    return;
+  }
+  // write_to() may defer the same connections again for the next iteration.
+  std::vector<int> deferred;
+  deferred.swap(m_deferred);
+  // An EPOLLOUT edge in the same iteration may have deferred a connection twice.
+  std::sort(deferred.begin(), deferred.end());
+  deferred.erase(std::unique(deferred.begin(), deferred.end()), deferred.end());
+  for (auto fd : deferred) {
+    if (static_cast<std::size_t>(fd) >= m_connections.size() || !m_connections[fd]) {
+      continue;
+    }
+    auto &connection = *m_connections[fd];
+    if (connection.input_paused() && !connection.output_backlogged()) {
+      read_from(connection);
+    } else {
+      write_to(connection);
+    }
+  }
+}
+
+void EpollEventLoop::close_expired() {
+  for (auto timer : expire_timers()) {
+    close_connection(static_cast<int>(timer->data));
+  }
+}
+
+void EpollEventLoop::close_connection(const int fd) {
+  if (static_cast<std::size_t>(fd) >= m_connections.size() || !m_connections[fd]) {
+    return;
+  }
+  // Closing the fd also removes it from the epoll set.
+  m_connections[fd].reset();
+  --m_connection_count;
+}
+
+} // namespace staxys::network
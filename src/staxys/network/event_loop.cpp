@@ -0,0 +1,85 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/event_loop.h"
+#include "staxys/network/epoll_event_loop.h"
+#include "staxys/network/uring_event_loop.h"
+#include <algorithm>
+#include <ctime>
+
+namespace staxys::network {
+
+std::unique_ptr<EventLoop> EventLoop::create(const std::string &backend, std::vector<int> listeners, int wake_fd,
+                                             std::size_t max_connections, const std::atomic<bool> &running,
+                                             ConnectionHandler &handler) {
+  if (backend == "epoll") {
+    return std::make_unique<EpollEventLoop>(std::move(listeners), wake_fd, max_connections, running, handler);
+  }
+  if (backend == "io_uring") {
+    return std::make_unique<UringEventLoop>(std::move(listeners), wake_fd, max_connections, running, handler);
+  }
+  return nullptr;
+}
+
+void EventLoop::timeouts(const int keep_alive, const int client_body, const int send) {
+  auto to_ms = [](int seconds) { return static_cast<uint64_t>(std::max(seconds, 0)) * 1000; };
+  m_keep_alive_timeout_ms = to_ms(keep_alive);
+  m_client_body_timeout_ms = to_ms(client_body);
+  m_send_timeout_ms = to_ms(send);
+}
+
+uint64_t EventLoop::monotonic_ms() {
+  timespec now{};
+  clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000 + static_cast<uint64_t>(now.tv_nsec) / 1000000;
+}
+
+void EventLoop::refresh_timer(Connection &connection) {
+  // Pending output waits on the client reading, a partial request on the
+  // client sending; anything else is an idle keep-alive connection.
+  auto timeout = connection.has_pending_output()       ? m_send_timeout_ms
+                 : !connection.read_buffer().empty() ? m_client_body_timeout_ms
+                                                     : m_keep_alive_timeout_ms;
+  auto &timer = connection.timer();
+  if (timeout == 0) {
+    m_timers.cancel(timer);
+    return;
+  }
+  timer.data = static_cast<uint64_t>(connection.fd());
+  m_timers.arm(timer, timeout);
+}
+
+void EventLoop::tick_interval(const uint64_t interval_ms) {
+  m_tick_interval_ms = interval_ms;
+  if (interval_ms == 0) {
+    m_timers.cancel(m_tick_timer);
+  } else {
+    m_timers.arm(m_tick_timer, interval_ms);
+  }
+}
+
+const std::vector<TimingWheel::Timer *> &EventLoop::expire_timers() {
+  m_expired.clear();
+  m_timers.advance(monotonic_ms(), m_expired);
+  if (m_tick_interval_ms > 0 && !m_tick_timer.armed()) {
+    std::erase(m_expired, &m_tick_timer);
+    m_timers.arm(m_tick_timer, m_tick_interval_ms);
+    m_handler.tick();
+  }
+  return m_expired;
+}
+
+} // namespace staxys::network
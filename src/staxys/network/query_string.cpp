@@ -0,0 +1,130 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/query_string.h"
+#include "staxys/utils/uri_utils.h"
+#include <algorithm>
+#include <cstring>
+
+namespace staxys::network {
+
+namespace {
+/// Whether \p raw form-decodes to \p name, decoding as it compares.
+bool decodes_to(std::string_view raw, std::string_view name) {
+  if (raw.find_first_of("%+") == std::string_view::npos) {
+    return raw == name;
+  }
+  std::size_t matched = 0;
+  for (std::size_t i = 0; i < raw.size(); ++i, ++matched) {
+    auto c = raw[i];
+    if (c == '+') {
+      c = ' ';
+    } else if (c == '%') {
+      auto high = raw.size() - i >= 3 ? utils::UriUtils::hex_value(raw[i + 1]) : -1;
+      auto low = raw.size() - i >= 3 ? utils::UriUtils::hex_value(raw[i + 2]) : -1;
+      if (high < 0 || low < 0) {
+        return false;
+      }
+      c = static_cast<char>(high * 16 + low);
+      i += 2;
+    }
+    if (matched == name.size() || name[matched] != c) {
+      return false;
+    }
+  }
+  return matched == name.size();
+}
+} // namespace
+
+void QueryString::assign(const std::string_view raw) {
+  m_raw = raw;
+  m_parameters.clear();
+  m_parsed = raw.empty();
+}
+
+const QueryString::Parameters &QueryString::parameters() const {
+  if (m_parsed) {
+    return m_parameters;
+  }
+  m_parsed = true;
+  for (std::size_t start = 0; start <= m_raw.size();) {
+    auto end = std::min(m_raw.find('&', start), m_raw.size());
+    auto piece = m_raw.substr(start, end - start);
+    if (!piece.empty()) {
+      auto equals = piece.find('=');
+      if (equals == std::string_view::npos) {
+        m_parameters.push_back({piece, {}});
+      } else {
+        m_parameters.push_back({piece.substr(0, equals), piece.substr(equals + 1)});
+      }
+    }
+    start = end + 1;
+  }
+  return m_parameters;
+}
+
+const QueryString::Parameter *QueryString::find(const std::string_view name) const {
+  for (const auto &parameter : parameters()) {
+    if (decodes_to(parameter.name, name)) {
+      return &parameter;
+    }
+  }
+  return nullptr;
+}
+
+std::size_t QueryString::count(const std::string_view name) const {
+  std::size_t count = 0;
+  for (const auto &parameter : parameters()) {
+    count += decodes_to(parameter.name, name) ? 1 : 0;
+  }
+  return count;
+}
+
+bool QueryString::value(const std::string_view name, std::pmr::string &value) const {
+  const auto *parameter = find(name);
+  if (parameter == nullptr) {
+    return false;
+  }
+  value.resize(parameter->value.size());
+  auto size = decode(parameter->value, value.data());
+  if (size == std::string_view::npos) {
+    value.clear();
+    return false;
+  }
+  value.resize(size);
+  return true;
+}
+
+std::size_t QueryString::decode(std::string_view raw, char *output) {
+  // Percent-decode the runs between '+' in bulk; each '+' becomes a space.
+  std::size_t written = 0;
+  while (true) {
+    const auto *plus = raw.empty() ? nullptr : static_cast<const char *>(std::memchr(raw.data(), '+', raw.size()));
+    auto run = plus == nullptr ? raw.size() : static_cast<std::size_t>(plus - raw.data());
+    auto size = utils::UriUtils::decode(raw.substr(0, run), output + written);
+    if (size == std::string_view::npos) {
+      return size;
+    }
+    written += size;
+    if (plus == nullptr) {
+      return written;
+    }
+    output[written++] = ' ';
+    raw.remove_prefix(run + 1);
+  }
+}
+
+} // namespace staxys::network
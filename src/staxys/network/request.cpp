@@ -14,4 +14,298 @@
  * limitations under the License.
  */
 
-#include "staxys/network/request.h"
\ No newline at end of file
+#include "staxys/network/request.h"
+#include "staxys/utils/scan_utils.h"
+#include <algorithm>
+
+namespace staxys::network {
+
+namespace {
+char to_lower(const char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+
+bool equals_ignore_case(std::string_view a, std::string_view b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    if (to_lower(a[i]) != to_lower(b[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string_view trim_whitespace(std::string_view text) {
+  while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+} // namespace
+
+Request::Request(const std::size_t max_head_size, const std::size_t max_headers)
+    : m_max_head_size(std::min<std::size_t>(max_head_size, UINT32_MAX)),
+      m_max_headers(std::min(max_headers, MAX_HEADERS)) {}
+
+void Request::reset() {
+  m_base = nullptr;
+  m_status = Status::INCOMPLETE;
+  m_phase = Phase::REQUEST_LINE;
+  m_line_start = 0;
+  m_head_size = 0;
+  m_method = m_target = m_version = Slice{};
+  m_minor_version = 1;
+  m_keep_alive = true;
+  m_has_host = false;
+  m_has_content_length = false;
+  m_content_length = 0;
+  m_header_count = 0;
+}
+
+void Request::limit_size(const std::size_t max_body_size, const std::size_t max_size) {
+  m_max_body_size = max_body_size;
+  m_max_size = max_size;
+}
+
+std::string_view Request::header(std::string_view name) const {
+  for (std::size_t i = 0; i < m_header_count; ++i) {
+    if (equals_ignore_case(slice(m_headers[i].name), name)) {
+      return slice(m_headers[i].value);
+    }
+  }
+  return {};
+}
+
+Request::Status Request::fail(const Status status) {
+  m_status = status;
+  return status;
+}
+
+Request::Status Request::parse(std::string_view input) {
+  m_base = input.data();
+  if (m_status != Status::INCOMPLETE) {
+    return m_status;
+  }
+
+  while (m_phase == Phase::REQUEST_LINE || m_phase == Phase::HEADERS) {
+    auto phase = m_phase;
+    auto status = phase == Phase::REQUEST_LINE ? parse_request_line(input) : parse_header_line(input);
+    auto head_so_far = status == Status::INCOMPLETE ? input.size() + 1 : m_line_start;
+    if (status != Status::INCOMPLETE && status != Status::COMPLETE) {
+      return fail(status);
+    }
+    if (head_so_far > m_max_head_size) {
+      return fail(phase == Phase::REQUEST_LINE ? Status::URI_TOO_LONG : Status::HEADERS_TOO_LARGE);
+    }
+    if (status == Status::INCOMPLETE) {
+      return status;
+    }
+  }
+
+  if (input.size() - m_head_size < m_content_length) {
+    return Status::INCOMPLETE;
+  }
+  m_phase = Phase::DONE;
+  m_status = Status::COMPLETE;
+  return m_status;
+}
+
+Request::Status Request::end_of_line(std::string_view input, const std::size_t position, std::size_t &next) {
+  // Lines end in CRLF; a bare LF is accepted as RFC 9112 section 2.2 allows.
+  if (input[position] == '\n') {
+    next = position + 1;
+    return Status::COMPLETE;
+  }
+  if (input[position] != '\r') {
+    return Status::BAD_REQUEST;
+  }
+  if (position + 1 == input.size()) {
+    return Status::INCOMPLETE;
+  }
+  next = position + 2;
+  return input[position + 1] == '\n' ? Status::COMPLETE : Status::BAD_REQUEST;
+}
+
+Request::Status Request::parse_request_line(std::string_view input) {
+  auto start = m_line_start;
+  if (start == input.size()) {
+    return Status::INCOMPLETE;
+  }
+
+  // Empty lines before the request line are skipped (RFC 9112 section 2.2).
+  if (input[start] == '\r' || input[start] == '\n') {
+    std::size_t next = 0;
+    auto status = end_of_line(input, start, next);
+    if (status == Status::COMPLETE) {
+      m_line_start = next;
+    }
+    return status;
+  }
+
+  // Each scan stops at the first byte outside its field, which has to be the
+  // expected delimiter; running off the end means the line is still arriving.
+  auto method_end = start + utils::ScanUtils::find_non_token(input.data() + start, input.size() - start);
+  if (method_end == input.size()) {
+    return Status::INCOMPLETE;
+  }
+  if (input[method_end] != ' ' || method_end == start) {
+    return Status::BAD_REQUEST;
+  }
+
+  auto target_start = method_end + 1;
+  auto target_end =
+      target_start + utils::ScanUtils::find_non_target(input.data() + target_start, input.size() - target_start);
+  if (target_end == input.size()) {
+    return Status::INCOMPLETE;
+  }
+  if (input[target_end] != ' ' || target_end == target_start) {
+    return Status::BAD_REQUEST;
+  }
+
+  auto version_start = target_end + 1;
+  auto version_end =
+      version_start + utils::ScanUtils::find_non_target(input.data() + version_start, input.size() - version_start);
+  if (version_end == input.size()) {
+    return Status::INCOMPLETE;
+  }
+  std::size_t next = 0;
+  auto status = end_of_line(input, version_end, next);
+  if (status != Status::COMPLETE) {
+    return status;
+  }
+
+  auto version = input.substr(version_start, version_end - version_start);
+  if (version.size() != 8 || version.substr(0, 5) != "HTTP/" || version[6] != '.' || version[5] < '0' ||
+      version[5] > '9' || version[7] < '0' || version[7] > '9') {
+    return Status::BAD_REQUEST;
+  }
+  if (version[5] != '1' || version[7] > '1') {
+    return Status::VERSION_NOT_SUPPORTED;
+  }
+
+  m_method = {static_cast<uint32_t>(start), static_cast<uint32_t>(method_end - start)};
+  m_target = {static_cast<uint32_t>(target_start), static_cast<uint32_t>(target_end - target_start)};
+  m_version = {static_cast<uint32_t>(version_start), static_cast<uint32_t>(version.size())};
+  m_minor_version = version[7] - '0';
+  // HTTP/1.1 connections persist by default, HTTP/1.0 ones only on request.
+  m_keep_alive = m_minor_version == 1;
+  m_phase = Phase::HEADERS;
+  m_line_start = next;
+  return Status::COMPLETE;
+}
+
+Request::Status Request::parse_header_line(std::string_view input) {
+  auto start = m_line_start;
+  if (start == input.size()) {
+    return Status::INCOMPLETE;
+  }
+
+  std::size_t next = 0;
+  if (input[start] == '\r' || input[start] == '\n') {
+    auto status = end_of_line(input, start, next);
+    if (status != Status::COMPLETE) {
+      return status;
+    }
+    m_head_size = m_line_start = next;
+    m_phase = Phase::BODY;
+    return finish_head();
+  }
+
+  // Obsolete line folding is rejected (RFC 9112 section 5.2).
+  if (input[start] == ' ' || input[start] == '\t') {
+    return Status::BAD_REQUEST;
+  }
+
+  // No whitespace is allowed between the name and the colon (RFC 9112 section 5.1).
+  auto name_end = start + utils::ScanUtils::find_non_token(input.data() + start, input.size() - start);
+  if (name_end == input.size()) {
+    return Status::INCOMPLETE;
+  }
+  if (input[name_end] != ':' || name_end == start) {
+    return Status::BAD_REQUEST;
+  }
+
+  auto value_start = name_end + 1;
+  while (value_start < input.size() && (input[value_start] == ' ' || input[value_start] == '\t')) {
+    ++value_start;
+  }
+  auto value_end =
+      value_start + utils::ScanUtils::find_non_value(input.data() + value_start, input.size() - value_start);
+  if (value_end == input.size()) {
+    return Status::INCOMPLETE;
+  }
+  auto status = end_of_line(input, value_end, next);
+  if (status != Status::COMPLETE) {
+    return status;
+  }
+  while (value_end > value_start && (input[value_end - 1] == ' ' || input[value_end - 1] == '\t')) {
+    --value_end;
+  }
+
+  if (m_header_count == m_max_headers) {
+    return Status::HEADERS_TOO_LARGE;
+  }
+  auto &header = m_headers[m_header_count++];
+  header.name = {static_cast<uint32_t>(start), static_cast<uint32_t>(name_end - start)};
+  header.value = {static_cast<uint32_t>(value_start), static_cast<uint32_t>(value_end - value_start)};
+  m_line_start = next;
+
+  return apply_header(input.substr(start, name_end - start), input.substr(value_start, value_end - value_start));
+}
+
+Request::Status Request::apply_header(std::string_view name, std::string_view value) {
+  if (equals_ignore_case(name, "host")) {
+    if (m_has_host) {
+      return Status::BAD_REQUEST;
+    }
+    m_has_host = true;
+  } else if (equals_ignore_case(name, "content-length")) {
+    // Fifteen digits cannot overflow; finish_head() checks the value against the limits.
+    if (value.empty() || value.size() > 15 || !std::all_of(value.begin(), value.end(), [](char c) {
+          return c >= '0' && c <= '9';
+        })) {
+      return Status::BAD_REQUEST;
+    }
+    std::size_t length = 0;
+    for (auto c : value) {
+      length = length * 10 + static_cast<std::size_t>(c - '0');
+    }
+    if (m_has_content_length && length != m_content_length) {
+      return Status::BAD_REQUEST;
+    }
+    m_has_content_length = true;
+    m_content_length = length;
+  } else if (equals_ignore_case(name, "transfer-encoding")) {
+    // Chunked request bodies are not supported yet.
+    return Status::NOT_IMPLEMENTED;
+  } else if (equals_ignore_case(name, "connection")) {
+    while (!value.empty()) {
+      auto comma = value.find(',');
+      auto option = trim_whitespace(value.substr(0, comma));
+      if (equals_ignore_case(option, "close")) {
+        m_keep_alive = false;
+      } else if (equals_ignore_case(option, "keep-alive") && m_minor_version == 0) {
+        m_keep_alive = true;
+      }
+      value = comma == std::string_view::npos ? std::string_view{} : value.substr(comma + 1);
+    }
+  }
+  return Status::COMPLETE;
+}
+
+Request::Status Request::finish_head() {
+  // A Host header is mandatory in HTTP/1.1 (RFC 9112 section 3.2).
+  if (m_minor_version == 1 && !m_has_host) {
+    return Status::BAD_REQUEST;
+  }
+  // Refused before the body arrives, so the client hears why.
+  if (m_content_length > m_max_body_size || m_head_size + m_content_length > m_max_size) {
+    return Status::PAYLOAD_TOO_LARGE;
+  }
+  return Status::COMPLETE;
+}
+
+} // namespace staxys::network
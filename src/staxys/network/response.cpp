@@ -14,4 +14,360 @@
  * limitations under the License.
  */
 
-#include "staxys/network/response.h"
\ No newline at end of file
+#include "staxys/network/response.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+
+namespace staxys::network {
+
+namespace {
+const std::string_view KEEP_ALIVE_LINE = "Connection: keep-alive\r\n";
+const std::string_view CLOSE_LINE = "Connection: close\r\n";
+const std::string_view CRLF = "\r\n";
+const std::string_view HEADER_SEPARATOR = ": ";
+const std::string_view CHUNKED_LINE = "Transfer-Encoding: chunked\r\n";
+const std::string_view LAST_CHUNK = "0\r\n\r\n";
+
+// First block of a response's arena; enough for the framing of a multipart body.
+const std::size_t ARENA_BLOCK_SIZE = 1024;
+
+/// "Server: staxys\r\nDate: Sun, 12 Jan 2025 10:00:00 GMT\r\n", rebuilt at most
+/// once per second. Workers are single-threaded; thread_local keeps tests and
+/// benchmarks that run several servers in one process correct as well.
+class DateLine {
+public:
+  std::string_view current() {
+    timespec now{};
+    clock_gettime(CLOCK_REALTIME_COARSE, &now);
+    if (now.tv_sec != m_second) {
+      refresh(now.tv_sec);
+    }
+    return {m_line.data(), m_length};
+  }
+
+private:
+  void refresh(const time_t second) {
+    static const char *const DAYS[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+    static const char *const MONTHS[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                         "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    tm time{};
+    gmtime_r(&second, &time);
+    auto length = std::snprintf(m_line.data(), m_line.size(),
+                                "Server: staxys\r\nDate: %s, %02d %s %04d %02d:%02d:%02d GMT\r\n", DAYS[time.tm_wday],
+                                time.tm_mday, MONTHS[time.tm_mon], time.tm_year + 1900, time.tm_hour, time.tm_min,
+                                time.tm_sec);
+    m_length = static_cast<std::size_t>(std::max(length, 0));
+    m_second = second;
+  }
+
+  time_t m_second = -1;
+  std::size_t m_length = 0;
+  std::array<char, 64> m_line{};
+};
+
+thread_local DateLine date_line;
+
+/// Precomputed status lines for the codes the server sends.
+std::string_view status_line(const int status) {
+  switch (status) {
+  case 200:
+    return "HTTP/1.1 200 OK\r\n";
+  case 204:
+    return "HTTP/1.1 204 No Content\r\n";
+  case 206:
+    return "HTTP/1.1 206 Partial Content\r\n";
+  case 301:
+    return "HTTP/1.1 301 Moved Permanently\r\n";
+  case 302:
+    return "HTTP/1.1 302 Found\r\n";
+  case 304:
+    return "HTTP/1.1 304 Not Modified\r\n";
+  case 400:
+    return "HTTP/1.1 400 Bad Request\r\n";
+  case 403:
+    return "HTTP/1.1 403 Forbidden\r\n";
+  case 404:
+    return "HTTP/1.1 404 Not Found\r\n";
+  case 405:
+    return "HTTP/1.1 405 Method Not Allowed\r\n";
+  case 408:
+    return "HTTP/1.1 408 Request Timeout\r\n";
+  case 412:
+    return "HTTP/1.1 412 Precondition Failed\r\n";
+  case 413:
+    return "HTTP/1.1 413 Content Too Large\r\n";
+  case 414:
+    return "HTTP/1.1 414 URI Too Long\r\n";
+  case 416:
+    return "HTTP/1.1 416 Range Not Satisfiable\r\n";
+  case 431:
+    return "HTTP/1.1 431 Request Header Fields Too Large\r\n";
+  case 500:
+    return "HTTP/1.1 500 Internal Server Error\r\n";
+  case 501:
+    return "HTTP/1.1 501 Not Implemented\r\n";
+  case 503:
+    return "HTTP/1.1 503 Service Unavailable\r\n";
+  case 505:
+    return "HTTP/1.1 505 HTTP Version Not Supported\r\n";
+  default:
+    return {};
+  }
+}
+} // namespace
+
+Response::Response(const int status, std::pmr::memory_resource *upstream) : m_upstream(upstream) { reset(status); }
+
+void Response::reset(const int status) {
+  m_status = status;
+  m_finished = m_failed = m_chunked = false;
+  m_size = m_sent = m_header_size = 0;
+  m_received_at = m_queued_at = 0;
+  m_segment_count = m_scratch_used = 0;
+  m_send_segment = m_send_offset = 0;
+  m_file.reset();
+  m_retained.reset();
+  m_stream.reset();
+  if (m_arena) {
+    m_arena->release();
+  }
+
+  auto line = status_line(status);
+  if (!line.empty()) {
+    append(line);
+  } else {
+    char formatted[32];
+    auto length = std::snprintf(formatted, sizeof(formatted), "HTTP/1.1 %03d \r\n", status % 1000);
+    append_copy({formatted, static_cast<std::size_t>(length)});
+  }
+  // Copied rather than referenced: the shared line changes every second,
+  // possibly while this response is still being sent.
+  append_copy(date_line.current());
+}
+
+std::string_view Response::reason(const int status) {
+  auto line = status_line(status);
+  if (line.empty()) {
+    return {};
+  }
+  // "HTTP/1.1 200 " is 13 bytes, and the line ends in CRLF.
+  return line.substr(13, line.size() - 15);
+}
+
+Response &Response::header(std::string_view name, std::string_view value) {
+  append(name);
+  append(HEADER_SEPARATOR);
+  append(value);
+  append(CRLF);
+  return *this;
+}
+
+Response &Response::header_copy(std::string_view name, std::string_view value) {
+  append(name);
+  append(HEADER_SEPARATOR);
+  append_copy(value);
+  append(CRLF);
+  return *this;
+}
+
+Response &Response::headers(std::string_view lines) {
+  append(lines);
+  return *this;
+}
+
+std::pmr::memory_resource *Response::arena() {
+  if (!m_arena) {
+    m_arena = std::make_unique<std::pmr::monotonic_buffer_resource>(ARENA_BLOCK_SIZE, m_upstream);
+  }
+  return m_arena.get();
+}
+
+Response &Response::retain(std::shared_ptr<const void> owner) {
+  m_retained = std::move(owner);
+  return *this;
+}
+
+Response &Response::content_length(const uint64_t length) {
+  char formatted[48];
+  auto size = std::snprintf(formatted, sizeof(formatted), "Content-Length: %llu\r\n",
+                            static_cast<unsigned long long>(length));
+  append_copy({formatted, static_cast<std::size_t>(size)});
+  return *this;
+}
+
+Response &Response::keep_alive(const bool keep_alive) {
+  append(keep_alive ? KEEP_ALIVE_LINE : CLOSE_LINE);
+  return *this;
+}
+
+Response &Response::finish(std::string_view body) {
+  append(CRLF);
+  m_header_size = m_size;
+  if (!body.empty()) {
+    append(body);
+  }
+  m_finished = true;
+  return *this;
+}
+
+Response &Response::finish(std::shared_ptr<const static_content::OpenFile> file, const uint64_t offset,
+                           const uint64_t length) {
+  append(CRLF);
+  m_header_size = m_size;
+  m_finished = true;
+  return body(std::move(file), offset, length);
+}
+
+Response &Response::body(std::string_view bytes) {
+  append(bytes);
+  return *this;
+}
+
+Response &Response::body(std::shared_ptr<const static_content::OpenFile> file, const uint64_t offset,
+                         const uint64_t length) {
+  if (length == 0) {
+    return *this;
+  }
+  if (m_segment_count == MAX_SEGMENTS) {
+    throw std::length_error("Response has too many segments");
+  }
+  m_segments[m_segment_count++] = {nullptr, offset, length, Source::FILE};
+  m_size += length;
+  m_file = std::move(file);
+  return *this;
+}
+
+Response &Response::finish(BodyStream::Ptr stream) {
+  append(CHUNKED_LINE);
+  append(CRLF);
+  m_header_size = m_size;
+  m_chunked = true;
+  m_stream = std::move(stream);
+  m_finished = true;
+  pull();
+  return *this;
+}
+
+void Response::pull() {
+  std::string_view chunk;
+  if (!m_stream->next(chunk)) {
+    m_stream.reset();
+    m_failed = true;
+    return;
+  }
+  if (chunk.empty()) {
+    m_stream.reset();
+    append(LAST_CHUNK);
+    return;
+  }
+  char size[24];
+  auto length = std::snprintf(size, sizeof(size), "%zx\r\n", chunk.size());
+  append_copy({size, static_cast<std::size_t>(length)});
+  append(chunk);
+  append(CRLF);
+}
+
+void Response::append(std::string_view bytes) {
+  if (bytes.empty()) {
+    return;
+  }
+  if (m_segment_count == MAX_SEGMENTS) {
+    throw std::length_error("Response has too many segments");
+  }
+  m_segments[m_segment_count++] = {bytes.data(), 0, bytes.size(), Source::MEMORY};
+  m_size += bytes.size();
+}
+
+void Response::append_copy(std::string_view bytes) {
+  if (bytes.empty()) {
+    return;
+  }
+  if (m_scratch_used + bytes.size() > SCRATCH_SIZE) {
+    throw std::length_error("Response scratch space exhausted");
+  }
+  std::memcpy(m_scratch.data() + m_scratch_used, bytes.data(), bytes.size());
+
+  // Consecutive copies share one segment.
+  auto &last = m_segments[m_segment_count > 0 ? m_segment_count - 1 : 0];
+  if (m_segment_count > 0 && last.source == Source::SCRATCH && last.offset + last.length == m_scratch_used) {
+    last.length += bytes.size();
+  } else {
+    if (m_segment_count == MAX_SEGMENTS) {
+      throw std::length_error("Response has too many segments");
+    }
+    m_segments[m_segment_count++] = {nullptr, m_scratch_used, bytes.size(), Source::SCRATCH};
+  }
+  m_scratch_used += bytes.size();
+  m_size += bytes.size();
+}
+
+std::size_t Response::gather(iovec *vectors, const std::size_t capacity) const {
+  std::size_t count = 0;
+  for (auto index = m_send_segment; index < m_segment_count && count < capacity; ++index) {
+    auto &segment = m_segments[index];
+    if (segment.source == Source::FILE) {
+      break;
+    }
+    auto skip = index == m_send_segment ? m_send_offset : 0;
+    vectors[count].iov_base = const_cast<char *>(segment_data(segment) + skip);
+    vectors[count].iov_len = segment.length - skip;
+    ++count;
+  }
+  return count;
+}
+
+bool Response::pending_file(FileRange &range) const {
+  if (m_send_segment >= m_segment_count || m_segments[m_send_segment].source != Source::FILE) {
+    return false;
+  }
+  auto &segment = m_segments[m_send_segment];
+  range.file = m_file.get();
+  range.fd = m_file->fd();
+  range.offset = static_cast<off_t>(segment.offset + m_send_offset);
+  range.length = segment.length - m_send_offset;
+  return true;
+}
+
+bool Response::next_file(FileRange &range) const {
+  for (auto index = m_send_segment; index < m_segment_count; ++index) {
+    auto &segment = m_segments[index];
+    if (segment.source != Source::FILE) {
+      continue;
+    }
+    auto skip = index == m_send_segment ? m_send_offset : 0;
+    range.file = m_file.get();
+    range.fd = m_file->fd();
+    range.offset = static_cast<off_t>(segment.offset + skip);
+    range.length = segment.length - skip;
+    return true;
+  }
+  return false;
+}
+
+std::size_t Response::advance(std::size_t count) {
+  while (count > 0 && m_send_segment < m_segment_count) {
+    auto left = m_segments[m_send_segment].length - m_send_offset;
+    if (count < left) {
+      m_send_offset += count;
+      m_sent += count;
+      return 0;
+    }
+    count -= left;
+    m_sent += left;
+    ++m_send_segment;
+    m_send_offset = 0;
+  }
+  if (m_stream && m_send_segment == m_segment_count) {
+    // Everything so far is written, so the next chunk starts over with the
+    // segments and scratch; the headers in them have gone out.
+    m_segment_count = m_send_segment = 0;
+    m_scratch_used = 0;
+    pull();
+  }
+  return count;
+}
+
+} // namespace staxys::network
@@ -14,4 +14,955 @@
  * limitations under the License.
  */
 
-#include "staxys/network/server.h"
\ No newline at end of file
+#include "staxys/network/server.h"
+#include "staxys/core/cycle_clock.h"
+#include "staxys/core/logger.h"
+#include "staxys/network/conditional.h"
+#include "staxys/network/content_coding.h"
+#include "staxys/utils/file_utils.h"
+#include "staxys/utils/mime_types.h"
+#include "staxys/utils/string_utils.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <string_view>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace staxys::network {
+
+namespace {
+// Headroom for listeners, log files and anything else the process keeps open.
+const rlim_t RESERVED_FDS = 64;
+
+const std::string DEFAULT_INDEX = "index.html";
+
+// Room for the framing of a multipart body with a few parts.
+const std::size_t MULTIPART_BLOCK_RESERVE = 512;
+
+/// Precompressed siblings looked for next to a file, in order of preference.
+struct Sibling {
+  ContentCoding::Coding coding;
+  std::string_view suffix;
+};
+const Sibling PRECOMPRESSED[] = {{ContentCoding::BROTLI, ".br"}, {ContentCoding::GZIP, ".gz"}};
+static_assert(std::size(PRECOMPRESSED) <= static_content::Resolution::MAX_SIBLINGS);
+
+/// Codings produced on the fly, in order of preference.
+const ContentCoding::Coding ON_THE_FLY[] = {ContentCoding::ZSTD, ContentCoding::GZIP};
+
+// How often the statistics of the worker's parts are copied into its metrics.
+const uint64_t METRICS_INTERVAL_MS = 1000;
+
+// Answers to the health check and metrics URLs.
+const std::string_view HEALTH_CHECK_HEADERS =
+    "Content-Type: text/plain\r\nContent-Length: 3\r\nCache-Control: no-store\r\n";
+const std::string_view HEALTH_CHECK_BODY = "OK\n";
+const std::string_view METRICS_HEADERS = "Content-Type: text/plain; version=0.0.4\r\nCache-Control: no-store\r\n";
+const std::size_t METRICS_RESERVE = 8192;
+
+// Header lines sent with static files, whole so each takes one segment.
+const std::string_view VARY_LINE = "Vary: Accept-Encoding\r\n";
+const std::string_view ACCEPT_RANGES_LINE = "Accept-Ranges: bytes\r\n";
+
+std::string_view content_encoding_line(const ContentCoding::Coding coding) {
+  switch (coding) {
+  case ContentCoding::GZIP:
+    return "Content-Encoding: gzip\r\n";
+  case ContentCoding::BROTLI:
+    return "Content-Encoding: br\r\n";
+  case ContentCoding::ZSTD:
+    return "Content-Encoding: zstd\r\n";
+  }
+  return {};
+}
+
+/// Status code answering a request the parser rejected.
+int error_status(const Request::Status status) {
+  switch (status) {
+  case Request::Status::URI_TOO_LONG:
+    return 414;
+  case Request::Status::HEADERS_TOO_LARGE:
+    return 431;
+  case Request::Status::PAYLOAD_TOO_LARGE:
+    return 413;
+  case Request::Status::NOT_IMPLEMENTED:
+    return 501;
+  case Request::Status::VERSION_NOT_SUPPORTED:
+    return 505;
+  default:
+    return 400;
+  }
+}
+} // namespace
+
+Server::Server(std::shared_ptr<const staxys::config::EngineConfig> config, core::Metrics *metrics,
+               const std::size_t worker)
+    : m_config(std::move(config)),
+      m_resolutions(static_content::OpenFileCache::DEFAULT_CAPACITY,
+                    static_content::OpenFileCache::DEFAULT_VALIDITY_MS),
+      m_metrics(metrics) {
+  if (!m_metrics || worker >= m_metrics->size()) {
+    m_own_metrics = core::Metrics::create(1);
+    if (!m_own_metrics) {
+      throw std::bad_alloc();
+    }
+    m_metrics = m_own_metrics.get();
+  }
+  m_worker_metrics = &m_metrics->worker(m_own_metrics ? 0 : worker);
+  core::CycleClock::calibrate();
+  // Lines the master logged before the fork are its own.
+  auto log_stats = core::Logger::stats();
+  m_published.error_log_lines = log_stats.lines;
+  m_published.error_log_suppressed = log_stats.repeated + log_stats.suppressed;
+  m_published.error_log_dropped = log_stats.dropped;
+  if (m_config->health_check_enabled()) {
+    m_health_check_url = m_config->health_check_url().empty() ? "/health" : m_config->health_check_url();
+  }
+
+  std::random_device random;
+  m_boundary = static_cast<uint64_t>(random()) << 32 | random();
+  m_max_connections = static_cast<std::size_t>(std::max(m_config->worker_connections(), 1));
+  m_request_timing = m_config->request_timing();
+  if (m_config->cache_enabled()) {
+    m_cache = std::make_unique<static_content::Cache>(m_config->cache_max_size(), m_config->cache_max_file_size(),
+                                                      static_cast<uint64_t>(std::max(m_config->cache_duration(), 0)) *
+                                                          1000);
+  }
+  if (m_config->compression_enabled()) {
+    m_compressors = std::make_unique<CompressorPool>(m_config->compression_level(),
+                                                     std::max<std::size_t>(m_config->compression_contexts(), 1));
+  }
+
+  const auto &access_log = m_config->access_log();
+  if (!access_log.empty() && access_log != "off") {
+    auto overflow = logging::AccessLog::Overflow::BLOCK;
+    if (!logging::AccessLog::parse_overflow(m_config->access_log_overflow(), overflow)) {
+      STAXYS_LOG(WARNING) << "Unknown access_log_overflow '" << m_config->access_log_overflow() << "'; using block.";
+    }
+    auto format = logging::AccessLog::Format::TEXT;
+    if (!logging::AccessLog::parse_format(m_config->access_log_format(), format)) {
+      STAXYS_LOG(WARNING) << "Unknown access_log_format '" << m_config->access_log_format() << "'; using text.";
+    }
+    auto flush_interval = std::chrono::seconds(std::max(m_config->access_log_flush(), 1));
+    m_access_log = std::make_unique<logging::AccessLog>(access_log, m_config->access_log_buffer(), overflow,
+                                                        flush_interval, format);
+    if (!m_access_log->start()) {
+      m_access_log.reset();
+    }
+  }
+}
+
+Server::~Server() {
+  m_loop.reset();
+  m_watcher.reset();
+  for (auto fd : m_listeners) {
+    close(fd);
+  }
+  if (m_wake_fd >= 0) {
+    close(m_wake_fd);
+  }
+}
+
+bool Server::listen(const bool reuse_port) {
+  if (m_config->listen_ports().empty()) {
+    STAXYS_LOG(ERROR) << "No ports have been defined for Staxys to listen on.";
+    return false;
+  }
+
+  raise_fd_limit();
+
+  m_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_wake_fd < 0) {
+    STAXYS_LOG(ERROR) << "Failed to create wake fd: " << strerror(errno);
+    return false;
+  }
+
+  for (const auto &entry : m_config->listen_ports()) {
+    auto fd = open_listener(utils::StringUtils::trim(entry), reuse_port);
+    if (fd < 0) {
+      return false;
+    }
+    m_listeners.push_back(fd);
+  }
+
+  return true;
+}
+
+int Server::open_listener(const std::string &entry, const bool reuse_port) {
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+
+  auto port_string = entry;
+  auto separator = entry.rfind(':');
+  if (separator != std::string::npos) {
+    auto host = entry.substr(0, separator);
+    port_string = entry.substr(separator + 1);
+    if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+      STAXYS_LOG(ERROR) << "Invalid listen address: " << entry;
+      return -1;
+    }
+  }
+
+  int port = 0;
+  try {
+    port = std::stoi(port_string);
+  } catch (const std::exception &) {
+    port = 0;
+  }
+  if (port <= 0 || port > 65535) {
+    STAXYS_LOG(ERROR) << "Invalid listen port: " << entry;
+    return -1;
+  }
+  address.sin_port = htons(static_cast<uint16_t>(port));
+
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    STAXYS_LOG(ERROR) << "Failed to create socket for " << entry << ": " << strerror(errno);
+    return -1;
+  }
+
+  int enable = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+  if (reuse_port && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0) {
+    STAXYS_LOG(ERROR) << "Failed to set SO_REUSEPORT on " << entry << ": " << strerror(errno);
+    close(fd);
+    return -1;
+  }
+
+  if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+    STAXYS_LOG(ERROR) << "Failed to bind " << entry << ": " << strerror(errno);
+    close(fd);
+    return -1;
+  }
+
+  if (::listen(fd, SOMAXCONN) < 0) {
+    STAXYS_LOG(ERROR) << "Failed to listen on " << entry << ": " << strerror(errno);
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+void Server::raise_fd_limit() const {
+  rlimit limit{};
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+    return;
+  }
+
+  auto wanted = static_cast<rlim_t>(m_max_connections) + RESERVED_FDS;
+  if (limit.rlim_cur >= wanted) {
+    return;
+  }
+
+  limit.rlim_cur = (limit.rlim_max == RLIM_INFINITY) ? wanted : std::min(wanted, limit.rlim_max);
+  if (setrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur < wanted) {
+    STAXYS_LOG(WARNING) << "Open file limit is " << limit.rlim_cur << ", below worker_connections ("
+                        << m_max_connections << ").";
+  }
+}
+
+int Server::run() {
+  if (m_listeners.empty()) {
+    STAXYS_LOG(ERROR) << "Server::run called before Server::listen.";
+    return EXIT_FAILURE;
+  }
+
+  auto backend = m_config->io_backend();
+  m_loop = EventLoop::create(backend, m_listeners, m_wake_fd, m_max_connections, m_running, *this);
+  if (!m_loop) {
+    STAXYS_LOG(WARNING) << "Unknown io_backend '" << backend << "'; using epoll.";
+  } else if (!m_loop->init()) {
+    STAXYS_LOG(WARNING) << "The " << backend << " backend is unavailable; using epoll.";
+    m_loop.reset();
+  }
+
+  if (!m_loop) {
+    m_loop = EventLoop::create("epoll", m_listeners, m_wake_fd, m_max_connections, m_running, *this);
+    if (!m_loop->init()) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  m_loop->metrics(m_worker_metrics);
+  m_loop->request_timing(m_request_timing);
+  m_loop->max_file_chunk(m_config->sendfile_max_chunk());
+  m_loop->max_body_size(m_config->client_max_body_size());
+  m_loop->timeouts(m_config->keep_alive_timeout(), m_config->client_body_timeout(), m_config->send_timeout());
+  if (!m_config->metrics_url().empty()) {
+    m_loop->tick_interval(METRICS_INTERVAL_MS);
+  }
+  start_watcher();
+  if (!m_running.load(std::memory_order_relaxed)) {
+    return EXIT_SUCCESS;
+  }
+  auto result = m_loop->run();
+  tick();
+  report_pools();
+  return result;
+}
+
+void Server::report_pools() const {
+  std::string buffers;
+  for (const auto &each : m_loop->buffer_stats()) {
+    buffers += ' ' + std::to_string(each.buffer_size / 1024) + "k peak " + std::to_string(each.high_water) + " idle " +
+               std::to_string(each.idle);
+  }
+  auto connections = m_loop->connection_stats();
+  STAXYS_LOG(INFO) << "Worker " << getpid() << ": peak " << connections.high_water << " connections in "
+                   << connections.capacity << " slab slots; read buffers" << buffers;
+}
+
+void Server::stop() {
+  m_running.store(false, std::memory_order_relaxed);
+  if (m_wake_fd >= 0) {
+    eventfd_write(m_wake_fd, 1);
+  }
+}
+
+void Server::tick() {
+  auto &metrics = *m_worker_metrics;
+  auto publish = [](core::Counter &counter, const uint64_t total, uint64_t &published) {
+    counter.add(total - published);
+    published = total;
+  };
+  if (m_loop) {
+    metrics.connections_active.set(m_loop->connection_count());
+  }
+
+  // A listening socket reports the connections waiting to be accepted as unacked.
+  uint64_t queued = 0;
+  for (auto fd : m_listeners) {
+    tcp_info info{};
+    socklen_t length = sizeof(info);
+    if (getsockopt(fd, IPPROTO_TCP, TCP_INFO, &info, &length) == 0) {
+      queued += info.tcpi_unacked;
+    }
+  }
+  metrics.accept_queue.set(queued);
+
+  if (m_cache) {
+    auto stats = m_cache->stats();
+    publish(metrics.cache_hits, stats.hits, m_published.cache_hits);
+    publish(metrics.cache_misses, stats.misses, m_published.cache_misses);
+    metrics.cache_entries.set(stats.entries);
+    metrics.cache_bytes.set(stats.bytes);
+  }
+  auto resolutions = m_resolutions.stats();
+  publish(metrics.resolution_hits, resolutions.hits, m_published.resolution_hits);
+  publish(metrics.resolution_misses, resolutions.misses, m_published.resolution_misses);
+  if (m_access_log) {
+    auto stats = m_access_log->stats();
+    publish(metrics.access_log_lines, stats.lines, m_published.access_log_lines);
+    publish(metrics.access_log_dropped, stats.dropped, m_published.access_log_dropped);
+  }
+  auto log_stats = core::Logger::stats();
+  publish(metrics.error_log_lines, log_stats.lines, m_published.error_log_lines);
+  publish(metrics.error_log_suppressed, log_stats.repeated + log_stats.suppressed, m_published.error_log_suppressed);
+  publish(metrics.error_log_dropped, log_stats.dropped, m_published.error_log_dropped);
+}
+
+void Server::reopen_logs() {
+  if (m_access_log) {
+    m_access_log->reopen();
+  }
+}
+
+bool Server::process(Connection &connection) {
+  auto &buffer = connection.read_buffer();
+  auto &request = connection.request();
+
+  // The last request of this connection has been answered; anything the
+  // client sends after it is dropped.
+  if (request.status() != Request::Status::INCOMPLETE) {
+    connection.consume(buffer.size());
+    return true;
+  }
+
+  // The request being received starts with the first of its bytes seen here,
+  // in the wakeup that delivered them.
+  if (m_request_timing && connection.received_at() == 0 && !buffer.empty()) {
+    auto now = connection.wakeup_time();
+    connection.received_at(now);
+    if (connection.accepted_at() != 0) {
+      m_worker_metrics->time(core::WorkerMetrics::CONNECT, now - connection.accepted_at());
+      connection.accepted_at(0);
+    }
+  }
+
+  // Requests behind a backlog wait in the buffer until it has been written.
+  while (!buffer.empty() && !connection.output_backlogged()) {
+    auto status = request.parse({buffer.data(), buffer.size()});
+    if (status == Request::Status::INCOMPLETE) {
+      break;
+    }
+    uint64_t parsed_at = 0;
+    if (m_request_timing) {
+      parsed_at = core::CycleClock::now();
+      m_worker_metrics->time(core::WorkerMetrics::RECEIVE, parsed_at - connection.received_at());
+    }
+    if (status != Request::Status::COMPLETE) {
+      connection.respond(error_status(status)).content_length(0).keep_alive(false).finish();
+      count(connection, parsed_at);
+      log_access(connection, nullptr);
+      connection.close_after_write(true);
+      connection.consume(buffer.size());
+      break;
+    }
+
+    auto keep_alive = request.keep_alive();
+    if (!serve_endpoint(connection, request, keep_alive)) {
+      serve_static(connection, request, keep_alive);
+    }
+    count(connection, parsed_at);
+    log_access(connection, &request);
+    if (!keep_alive) {
+      connection.close_after_write(true);
+      connection.consume(buffer.size());
+      break;
+    }
+    connection.consume(request.size());
+    request.reset();
+  }
+  if (buffer.empty()) {
+    connection.received_at(0);
+  }
+  return true;
+}
+
+void Server::log_access(Connection &connection, const Request *request) {
+  if (!m_access_log) {
+    return;
+  }
+  const auto &response = connection.last_response();
+  logging::AccessRecord record;
+  record.client = connection.peer_address();
+  if (request) {
+    record.method = request->method();
+    record.target = request->target();
+    record.minor_version = request->minor_version();
+    record.referer = request->header("Referer");
+    record.user_agent = request->header("User-Agent");
+  }
+  record.status = response.status();
+  record.bytes = request && request->method() == "HEAD" ? 0 : response.body_size();
+  m_access_log->log(record);
+}
+
+void Server::count(Connection &connection, const uint64_t parsed_at) {
+  auto &metrics = *m_worker_metrics;
+  auto &response = connection.last_response();
+  metrics.requests.add();
+  metrics.respond(response.status());
+  if (!m_request_timing) {
+    return;
+  }
+  auto handled_at = core::CycleClock::now();
+  metrics.time(core::WorkerMetrics::HANDLE, handled_at - parsed_at);
+  response.timing(connection.received_at(), handled_at);
+  // A pipelined request behind this one is only looked at from here on.
+  connection.received_at(handled_at);
+}
+
+bool Server::serve_endpoint(Connection &connection, const Request &request, const bool keep_alive) {
+  const auto &metrics_url = m_config->metrics_url();
+  if (m_health_check_url.empty() && metrics_url.empty()) {
+    return false;
+  }
+  auto method = request.method();
+  auto head = method == "HEAD";
+  if (method != "GET" && !head) {
+    return false;
+  }
+  auto target = request.target();
+  auto path = target.substr(0, target.find('?'));
+
+  if (path == m_health_check_url) {
+    connection.respond(200)
+        .headers(HEALTH_CHECK_HEADERS)
+        .keep_alive(keep_alive)
+        .finish(head ? std::string_view() : HEALTH_CHECK_BODY);
+    return true;
+  }
+  if (metrics_url.empty() || path != metrics_url) {
+    return false;
+  }
+
+  // This worker's figures are brought up to date; the others' are at most
+  // a tick old.
+  tick();
+  auto &response = connection.respond(200);
+  // Never destroyed: the arena frees its memory when the request ends.
+  auto &body = *std::pmr::polymorphic_allocator<>(response.arena()).new_object<std::pmr::string>();
+  body.reserve(METRICS_RESERVE);
+  m_metrics->render(body);
+  response.headers(METRICS_HEADERS).content_length(body.size()).keep_alive(keep_alive);
+  response.finish(head ? std::string_view() : std::string_view(body));
+  return true;
+}
+
+void Server::serve_static(Connection &connection, const Request &request, const bool keep_alive) {
+  auto method = request.method();
+  auto head = method == "HEAD";
+  if (method != "GET" && !head) {
+    connection.respond(405).header("Allow", "GET, HEAD").content_length(0).keep_alive(keep_alive).finish();
+    return;
+  }
+
+  const auto &root = m_config->server_static_root();
+  if (root.empty()) {
+    connection.respond(404).content_length(0).keep_alive(keep_alive).finish();
+    return;
+  }
+  if (m_watcher && m_watcher->has_changes()) {
+    apply_changes();
+  }
+  if (!utils::FileUtils::map_target(root, request.target(), m_path)) {
+    connection.respond(400).content_length(0).keep_alive(keep_alive).finish();
+    return;
+  }
+
+  auto resolution = m_resolutions.find(m_path);
+  if (!resolution) {
+    resolution = resolve(connection, request, keep_alive);
+    if (!resolution) {
+      return;
+    }
+  }
+  m_path.assign(resolution->path);
+  auto file = resolution->file;
+  const auto &mime_type = *resolution->mime_type;
+
+  // A build-time .br or .gz copy is sent instead when the client takes it.
+  auto accepted = ContentCoding::accepted(request.header("Accept-Encoding"));
+  auto body = file;
+  ContentCoding::Coding encoding{};
+  bool vary = false;
+  for (std::size_t i = 0; i < std::size(PRECOMPRESSED); ++i) {
+    if (!resolution->siblings[i]) {
+      continue;
+    }
+    vary = true;
+    if (accepted & PRECOMPRESSED[i].coding) {
+      body = resolution->siblings[i];
+      encoding = PRECOMPRESSED[i].coding;
+      m_sibling_path.assign(m_path).append(PRECOMPRESSED[i].suffix);
+      break;
+    }
+  }
+
+  // Without a precompressed copy, text can still be compressed on the fly.
+  // Ranges are only served from the file as it is.
+  auto range = request.header("Range");
+  ContentCoding::Coding on_the_fly{};
+  if (!encoding && resolution->compressible && m_compressors && file->size() >= m_config->compression_min_size()) {
+    vary = true;
+    for (auto coding : ON_THE_FLY) {
+      if (range.empty() && (accepted & coding & CompressorPool::supported())) {
+        on_the_fly = coding;
+        break;
+      }
+    }
+  }
+
+  // Revalidation needs nothing but the validators kept with the open file.
+  if (Conditional::not_modified(request, body->etag(), body->info().st_mtim.tv_sec)) {
+    auto &response = connection.respond(304).headers(body->validators(on_the_fly != 0));
+    if (vary) {
+      response.headers(VARY_LINE);
+    }
+    response.keep_alive(keep_alive).finish();
+    response.retain(std::move(body));
+    return;
+  }
+
+  if (on_the_fly && serve_compressed(connection, request, file, mime_type, on_the_fly, keep_alive)) {
+    return;
+  }
+
+  if (!range.empty() && Conditional::range_applies(request, body->etag(), body->last_modified())) {
+    ByteRanges ranges;
+    switch (ranges.parse(range, body->size())) {
+    case ByteRanges::Result::SATISFIABLE:
+      serve_ranges(connection, request, std::move(body), mime_type, encoding, vary, ranges, keep_alive);
+      return;
+    case ByteRanges::Result::UNSATISFIABLE: {
+      char content_range[32];
+      auto length = std::snprintf(content_range, sizeof(content_range), "bytes */%llu",
+                                  static_cast<unsigned long long>(body->size()));
+      connection.respond(416)
+          .header_copy("Content-Range", {content_range, static_cast<std::size_t>(length)})
+          .content_length(0)
+          .keep_alive(keep_alive)
+          .finish();
+      return;
+    }
+    case ByteRanges::Result::IGNORED:
+      break;
+    }
+  }
+
+  const auto &body_path = encoding ? m_sibling_path : m_path;
+  auto cached = cached_file(body_path, *body, mime_type);
+  auto &response = connection.respond(200);
+  if (cached) {
+    response.headers(cached->headers);
+  } else {
+    response.headers(mime_type.header).content_length(body->size()).headers(body->validators());
+  }
+  response.headers(ACCEPT_RANGES_LINE);
+  if (encoding) {
+    response.headers(content_encoding_line(encoding));
+  }
+  if (vary) {
+    response.headers(VARY_LINE);
+  }
+  response.keep_alive(keep_alive);
+
+  if (cached) {
+    response.finish(head ? std::string_view() : std::string_view(cached->body));
+    response.retain(std::move(cached));
+  } else if (head) {
+    response.finish();
+    response.retain(std::move(body));
+  } else {
+    auto size = body->size();
+    response.finish(std::move(body), 0, size);
+  }
+}
+
+std::shared_ptr<const static_content::Resolution> Server::resolve(Connection &connection, const Request &request,
+                                                                  const bool keep_alive) {
+  auto key_length = m_path.size();
+  auto directory = m_path.back() == '/';
+  if (directory) {
+    m_path += m_config->default_index().empty() ? DEFAULT_INDEX : m_config->default_index();
+  }
+
+  int error = 0;
+  auto file = m_open_files.open(m_path, error);
+  if (!file) {
+    auto status = error == EACCES ? 403 : 404;
+    connection.respond(status).content_length(0).keep_alive(keep_alive).finish();
+    return nullptr;
+  }
+
+  if (file->is_directory()) {
+    // Relative links in the index only resolve against a path ending in '/'.
+    auto target = request.target();
+    auto path = target.substr(0, target.find_first_of("?#"));
+    if (directory) {
+      connection.respond(404).content_length(0).keep_alive(keep_alive).finish();
+      return nullptr;
+    }
+    auto &response = connection.respond(301);
+    // Freed with the arena when the request ends.
+    auto location = static_cast<char *>(response.arena()->allocate(path.size() + 1, 1));
+    path.copy(location, path.size());
+    location[path.size()] = '/';
+    response.header("Location", {location, path.size() + 1}).content_length(0).keep_alive(keep_alive).finish();
+    return nullptr;
+  }
+
+  auto resolution = std::make_shared<static_content::Resolution>();
+  resolution->path = m_path;
+  resolution->mime_type = &utils::MimeTypes::for_path(m_path);
+  resolution->compressible = compressible(*resolution->mime_type);
+  // Precompressed copies only count while they are at least as new as the
+  // file itself. The open-file cache remembers missing ones as well.
+  for (std::size_t i = 0; i < std::size(PRECOMPRESSED); ++i) {
+    m_sibling_path.assign(m_path).append(PRECOMPRESSED[i].suffix);
+    auto compressed = m_open_files.open(m_sibling_path, error);
+    if (compressed && !compressed->is_directory() &&
+        compressed->info().st_mtim.tv_sec >= file->info().st_mtim.tv_sec) {
+      resolution->siblings[i] = std::move(compressed);
+    }
+  }
+  resolution->file = std::move(file);
+  m_resolutions.insert(std::string_view(m_path).substr(0, key_length), resolution);
+  return resolution;
+}
+
+void Server::serve_ranges(Connection &connection, const Request &request,
+                          std::shared_ptr<const static_content::OpenFile> file, const utils::MimeType &mime_type,
+                          const ContentCoding::Coding encoding, const bool vary, const ByteRanges &ranges,
+                          const bool keep_alive) {
+  auto head = request.method() == "HEAD";
+  auto &response = connection.respond(206);
+  char content_range[80];
+
+  if (ranges.count() == 1) {
+    const auto &range = ranges[0];
+    auto length = std::snprintf(content_range, sizeof(content_range), "bytes %llu-%llu/%llu",
+                                static_cast<unsigned long long>(range.first),
+                                static_cast<unsigned long long>(range.first + range.length - 1),
+                                static_cast<unsigned long long>(file->size()));
+    response.headers(mime_type.header)
+        .header_copy("Content-Range", {content_range, static_cast<std::size_t>(length)})
+        .content_length(range.length)
+        .headers(file->validators());
+    if (encoding) {
+      response.headers(content_encoding_line(encoding));
+    }
+    if (vary) {
+      response.headers(VARY_LINE);
+    }
+    response.keep_alive(keep_alive);
+    if (head) {
+      response.finish();
+      response.retain(std::move(file));
+    } else {
+      response.finish(std::move(file), range.first, range.length);
+    }
+    return;
+  }
+
+  // Several ranges go out as a multipart/byteranges body. Its framing and
+  // header lines are written into one block in the response's arena; the
+  // parts themselves are still sent from the file with sendfile.
+  char boundary[24];
+  auto boundary_length =
+      std::snprintf(boundary, sizeof(boundary), "%016llx", static_cast<unsigned long long>(++m_boundary));
+  std::string_view boundary_view(boundary, static_cast<std::size_t>(boundary_length));
+  // Never destroyed: the arena frees its memory when the request ends.
+  auto &block = *std::pmr::polymorphic_allocator<>(response.arena()).new_object<std::pmr::string>();
+  block.reserve(MULTIPART_BLOCK_RESERVE);
+  std::array<std::size_t, ByteRanges::MAX_RANGES + 1> part_starts{};
+  uint64_t content_length = 0;
+  for (std::size_t i = 0; i < ranges.count(); ++i) {
+    part_starts[i] = block.size();
+    auto length = std::snprintf(content_range, sizeof(content_range), "bytes %llu-%llu/%llu",
+                                static_cast<unsigned long long>(ranges[i].first),
+                                static_cast<unsigned long long>(ranges[i].first + ranges[i].length - 1),
+                                static_cast<unsigned long long>(file->size()));
+    block.append("\r\n--")
+        .append(boundary_view)
+        .append("\r\n")
+        .append(mime_type.header)
+        .append("Content-Range: ")
+        .append(content_range, static_cast<std::size_t>(length))
+        .append("\r\n\r\n");
+    content_length += ranges[i].length;
+  }
+  part_starts[ranges.count()] = block.size();
+  block.append("\r\n--").append(boundary_view).append("--\r\n");
+  auto framing_end = block.size();
+  content_length += framing_end;
+
+  char length_text[24];
+  auto length_end = std::to_chars(length_text, length_text + sizeof(length_text), content_length).ptr;
+  block.append("Content-Type: multipart/byteranges; boundary=")
+      .append(boundary_view)
+      .append("\r\nContent-Length: ")
+      .append(length_text, length_end)
+      .append("\r\n")
+      .append(file->validators());
+
+  std::string_view text(block);
+  response.headers(text.substr(framing_end));
+  if (encoding) {
+    response.headers(content_encoding_line(encoding));
+  }
+  if (vary) {
+    response.headers(VARY_LINE);
+  }
+  response.keep_alive(keep_alive).finish();
+  if (!head) {
+    for (std::size_t i = 0; i < ranges.count(); ++i) {
+      response.body(text.substr(part_starts[i], part_starts[i + 1] - part_starts[i]))
+          .body(file, ranges[i].first, ranges[i].length);
+    }
+    response.body(text.substr(part_starts[ranges.count()], framing_end - part_starts[ranges.count()]));
+  }
+}
+
+bool Server::compressible(const utils::MimeType &mime_type) const {
+  const auto &types = m_config->compression_types();
+  return std::find(types.begin(), types.end(), mime_type.essence()) != types.end();
+}
+
+bool Server::serve_compressed(Connection &connection, const Request &request,
+                              std::shared_ptr<const static_content::OpenFile> file,
+                              const utils::MimeType &mime_type, const ContentCoding::Coding coding,
+                              const bool keep_alive) {
+  auto head = request.method() == "HEAD";
+
+  // Files small enough for the cache are compressed once and kept there.
+  if (m_cache && m_cache->admits(file->size())) {
+    auto cached = compressed_file(*file, mime_type, coding);
+    if (!cached) {
+      return false;
+    }
+    auto &response = connection.respond(200)
+                         .headers(cached->headers)
+                         .headers(content_encoding_line(coding))
+                         .headers(VARY_LINE)
+                         .keep_alive(keep_alive);
+    response.finish(head ? std::string_view() : std::string_view(cached->body));
+    response.retain(std::move(cached));
+    return true;
+  }
+
+  // Anything bigger is compressed while it is sent, so its length is not
+  // known up front and it needs chunked transfer coding.
+  if (request.minor_version() < 1) {
+    return false;
+  }
+  CompressorPool::Handle compressor;
+  if (!head && !(compressor = m_compressors->acquire(coding))) {
+    return false;
+  }
+  auto &response = connection.respond(200)
+                       .headers(mime_type.header)
+                       .headers(file->validators(true))
+                       .headers(content_encoding_line(coding))
+                       .headers(VARY_LINE)
+                       .keep_alive(keep_alive);
+  // The validators are referenced from the file, which the response keeps.
+  response.retain(file);
+  if (head) {
+    response.header("Transfer-Encoding", "chunked").finish();
+    return true;
+  }
+  auto size = file->size();
+  compressor->start(std::move(file), 0, size);
+  response.finish(BodyStream::Ptr(compressor.release()));
+  return true;
+}
+
+void Server::start_watcher() {
+  const auto &mode = m_config->static_watch();
+  if (m_config->server_static_root().empty() || mode == "off" || m_watcher) {
+    return;
+  }
+  if (mode != "inotify" && mode != "poll") {
+    STAXYS_LOG(WARNING) << "Unknown static_watch '" << mode << "'; using inotify.";
+  }
+
+  m_watcher = std::make_unique<static_content::Watcher>(m_config->server_static_root());
+  auto preferred = mode == "poll" ? static_content::Watcher::Mode::POLL : static_content::Watcher::Mode::INOTIFY;
+  if (!m_watcher->start(preferred)) {
+    m_watcher.reset();
+    return;
+  }
+  // The watcher now reports every change, so resolutions need not expire.
+  m_resolutions.validity(0);
+}
+
+void Server::apply_changes() {
+  if (!m_watcher->take_changes(m_changes)) {
+    return;
+  }
+  if (m_changes.everything) {
+    m_open_files.clear();
+    m_resolutions.clear();
+    if (m_cache) {
+      m_cache->clear();
+    }
+    return;
+  }
+  for (const auto &path : m_changes.paths) {
+    m_open_files.invalidate(path);
+    m_resolutions.invalidate(path);
+    if (m_cache) {
+      m_cache->erase(path);
+      for (auto coding : ON_THE_FLY) {
+        compressed_key(m_sibling_path, path, coding);
+        m_cache->erase(m_sibling_path);
+      }
+    }
+  }
+}
+
+std::shared_ptr<const static_content::CachedFile> Server::cached_file(const std::string &path,
+                                                                     const static_content::OpenFile &file,
+                                                                     const utils::MimeType &mime_type) {
+  if (!m_cache || !m_cache->admits(file.size())) {
+    return nullptr;
+  }
+  if (auto cached = m_cache->find(path, file.info())) {
+    return cached;
+  }
+
+  auto entry = std::make_shared<static_content::CachedFile>();
+  entry->body.resize(file.size());
+  std::size_t filled = 0;
+  while (filled < entry->body.size()) {
+    auto got = pread(file.fd(), entry->body.data() + filled, entry->body.size() - filled, static_cast<off_t>(filled));
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    if (got <= 0) {
+      // Changed while we read it; sendfile copes, the cache would keep a torn copy.
+      return nullptr;
+    }
+    filled += static_cast<std::size_t>(got);
+  }
+
+  const auto &info = file.info();
+  entry->device = info.st_dev;
+  entry->inode = info.st_ino;
+  entry->size = info.st_size;
+  entry->modified = info.st_mtim;
+  entry->headers.append(mime_type.header)
+      .append("Content-Length: ")
+      .append(std::to_string(file.size()))
+      .append("\r\n")
+      .append(file.validators());
+
+  m_cache->insert(path, entry);
+  return entry;
+}
+
+std::shared_ptr<const static_content::CachedFile>
+Server::compressed_file(const static_content::OpenFile &file, const utils::MimeType &mime_type,
+                        const ContentCoding::Coding coding) {
+  compressed_key(m_sibling_path, m_path, coding);
+  if (auto cached = m_cache->find(m_sibling_path, file.info())) {
+    return cached;
+  }
+
+  auto original = cached_file(m_path, file, mime_type);
+  auto compressor = original ? m_compressors->acquire(coding) : nullptr;
+  if (!compressor) {
+    return nullptr;
+  }
+  auto entry = std::make_shared<static_content::CachedFile>();
+  if (!compressor->compress(original->body, entry->body)) {
+    return nullptr;
+  }
+
+  // Same identity as the original, so a change to the file drops both.
+  entry->device = original->device;
+  entry->inode = original->inode;
+  entry->size = original->size;
+  entry->modified = original->modified;
+  entry->headers.append(mime_type.header)
+      .append("Content-Length: ")
+      .append(std::to_string(entry->body.size()))
+      .append("\r\n")
+      .append(file.validators(true));
+
+  m_cache->insert(m_sibling_path, entry);
+  return entry;
+}
+
+void Server::compressed_key(std::string &key, const std::string &path, const ContentCoding::Coding coding) {
+  key.assign(path).push_back('\0');
+  key.append(ContentCoding::name(coding));
+}
+
+} // namespace staxys::network
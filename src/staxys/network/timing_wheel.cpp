@@ -0,0 +1,177 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/timing_wheel.h"
+#include <algorithm>
+#include <bit>
+#include <climits>
+
+namespace staxys::network {
+
+namespace {
+const uint64_t SLOT_MASK = TimingWheel::SLOTS - 1;
+const uint64_t MAX_TICKS = (uint64_t{1} << (TimingWheel::LEVEL_BITS * TimingWheel::LEVELS)) - 1;
+
+unsigned shift(const unsigned level) { return level * TimingWheel::LEVEL_BITS; }
+} // namespace
+
+TimingWheel::Timer::~Timer() {
+  if (m_wheel != nullptr) {
+    m_wheel->cancel(*this);
+  }
+}
+
+TimingWheel::TimingWheel(const uint64_t tick_ms, const uint64_t now_ms)
+    : m_tick_ms(std::max<uint64_t>(tick_ms, 1)), m_current(now_ms / m_tick_ms) {}
+
+TimingWheel::~TimingWheel() {
+  // Timers may outlive the wheel; they must not reach back into it.
+  for (auto &level : m_slots) {
+    for (auto head : level) {
+      for (auto timer = head; timer != nullptr; timer = timer->m_next) {
+        timer->m_wheel = nullptr;
+      }
+    }
+  }
+}
+
+void TimingWheel::arm(Timer &timer, const uint64_t delay_ms) {
+  if (timer.m_wheel != nullptr) {
+    unlink(timer);
+  } else {
+    ++m_size;
+  }
+  // At least one tick, so a timer armed while its slot fires waits a turn.
+  auto ticks = std::clamp<uint64_t>((delay_ms + m_tick_ms - 1) / m_tick_ms, 1, MAX_TICKS);
+  timer.m_wheel = this;
+  timer.m_expires = m_current + ticks;
+  insert(timer);
+}
+
+void TimingWheel::cancel(Timer &timer) {
+  if (timer.m_wheel != this) {
+    return;
+  }
+  unlink(timer);
+  timer.m_wheel = nullptr;
+  --m_size;
+}
+
+std::size_t TimingWheel::advance(const uint64_t now_ms, std::vector<Timer *> &expired) {
+  auto target = now_ms / m_tick_ms;
+  std::size_t count = 0;
+  while (m_current < target && m_size > 0) {
+    if (m_occupied[0] == 0) {
+      // Nothing can fire before the next cascade; skip straight to it.
+      auto boundary = ((m_current >> LEVEL_BITS) + 1) << LEVEL_BITS;
+      m_current = std::min(boundary, target + 1) - 1;
+      if (m_current == target) {
+        break;
+      }
+    }
+
+    ++m_current;
+    // Top down, so timers cascaded out of one level can cascade further in the same tick.
+    for (auto level = LEVELS - 1; level > 0; --level) {
+      if ((m_current & ((uint64_t{1} << shift(level)) - 1)) == 0) {
+        cascade(level, static_cast<unsigned>((m_current >> shift(level)) & SLOT_MASK));
+      }
+    }
+
+    auto slot = static_cast<unsigned>(m_current & SLOT_MASK);
+    while (m_slots[0][slot] != nullptr) {
+      auto timer = m_slots[0][slot];
+      cancel(*timer);
+      expired.push_back(timer);
+      ++count;
+    }
+  }
+  m_current = std::max(m_current, target);
+  return count;
+}
+
+int TimingWheel::timeout_ms(const uint64_t now_ms) const {
+  if (m_size == 0) {
+    return -1;
+  }
+
+  // The first occupied slot after the current one in each level; a slot in
+  // a higher level needs attention when the wheel reaches its start.
+  auto next = UINT64_MAX;
+  for (unsigned level = 0; level < LEVELS; ++level) {
+    if (m_occupied[level] == 0) {
+      continue;
+    }
+    auto position = (m_current >> shift(level)) + 1;
+    auto ahead = std::rotr(m_occupied[level], static_cast<int>(position & SLOT_MASK));
+    next = std::min(next, (position + static_cast<uint64_t>(std::countr_zero(ahead))) << shift(level));
+  }
+
+  auto deadline = next * m_tick_ms;
+  if (deadline <= now_ms) {
+    return 0;
+  }
+  return static_cast<int>(std::min<uint64_t>(deadline - now_ms, INT_MAX));
+}
+
+void TimingWheel::insert(Timer &timer) {
+  auto delta = timer.m_expires - m_current;
+  unsigned level = 0;
+  while (level + 1 < LEVELS && delta >= (uint64_t{1} << shift(level + 1))) {
+    ++level;
+  }
+  auto slot = static_cast<unsigned>((timer.m_expires >> shift(level)) & SLOT_MASK);
+
+  auto &head = m_slots[level][slot];
+  timer.m_level = static_cast<uint8_t>(level);
+  timer.m_slot = static_cast<uint8_t>(slot);
+  timer.m_previous = nullptr;
+  timer.m_next = head;
+  if (head != nullptr) {
+    head->m_previous = &timer;
+  }
+  head = &timer;
+  m_occupied[level] |= uint64_t{1} << slot;
+}
+
+void TimingWheel::unlink(Timer &timer) {
+  if (timer.m_previous != nullptr) {
+    timer.m_previous->m_next = timer.m_next;
+  } else {
+    auto &head = m_slots[timer.m_level][timer.m_slot];
+    head = timer.m_next;
+    if (head == nullptr) {
+      m_occupied[timer.m_level] &= ~(uint64_t{1} << timer.m_slot);
+    }
+  }
+  if (timer.m_next != nullptr) {
+    timer.m_next->m_previous = timer.m_previous;
+  }
+  timer.m_previous = timer.m_next = nullptr;
+}
+
+void TimingWheel::cascade(const unsigned level, const unsigned slot) {
+  auto timer = m_slots[level][slot];
+  m_slots[level][slot] = nullptr;
+  m_occupied[level] &= ~(uint64_t{1} << slot);
+  while (timer != nullptr) {
+    auto next = timer->m_next;
+    insert(*timer);
+    timer = next;
+  }
+}
+
+} // namespace staxys::network
@@ -15,15 +15,18 @@
  */
 
 #include "staxys/network/uri.h"
-#include "staxys/utils/uri_utils.h"
+#include <stdexcept>
 
-staxys::network::Uri::Uri(std::string uri) : m_raw(std::move(uri)) {
-  utils::UriUtils::UriComponents components;
-  utils::UriUtils::parse(m_raw, components);
-  m_scheme = components.scheme;
-  m_host = components.host;
-  m_port = components.port;
-  m_path = components.path;
-  m_query = components.query;
-  m_fragment = components.fragment;
-}
\ No newline at end of file
+staxys::network::Uri::Uri(const std::string_view uri, std::pmr::memory_resource *resource)
+    : m_raw(uri, resource), m_query(resource) {
+  m_is_valid = utils::UriUtils::parse(m_raw, m_parts);
+  m_query.assign(m_parts.query);
+}
+
+std::string_view staxys::network::Uri::query_parameter(const std::string_view key) const {
+  const auto *parameter = m_query.find(key);
+  if (parameter == nullptr) {
+    throw std::out_of_range("no query parameter named " + std::string(key));
+  }
+  return parameter->value;
+}
@@ -0,0 +1,833 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/uring_event_loop.h"
+#include "staxys/core/logger.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace staxys::network {
+
+namespace {
+const unsigned SUBMISSION_QUEUE_ENTRIES = 1024;
+const unsigned COMPLETION_QUEUE_ENTRIES = 4 * SUBMISSION_QUEUE_ENTRIES;
+
+// Receive buffers shared by every connection of this worker. The count must
+// be a power of two; ids travel in the upper 16 bits of cqe->flags.
+const uint16_t BUFFER_GROUP = 0;
+const unsigned BUFFER_COUNT = 1024;
+const unsigned BUFFER_SIZE = 4096;
+
+// Largest chunk of a file body read into a pooled buffer when the file
+// cannot be mapped.
+const std::size_t FILE_BUFFER_SIZE = BufferPool::BUFFER_SIZES.back();
+
+const int OPERATION_SHIFT = 56;
+const int GENERATION_SHIFT = 32;
+const uint64_t GENERATION_MASK = 0xFFFFFF;
+const uint64_t FD_MASK = 0xFFFFFFFF;
+
+int io_uring_setup(const unsigned entries, io_uring_params *params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int io_uring_enter(const int fd, const unsigned toSubmit, const unsigned minComplete, const unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int io_uring_register(const int fd, const unsigned opcode, void *arg, const unsigned count) {
+  return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+static_assert(sizeof(__kernel_timespec) == 2 * sizeof(int64_t));
+
+unsigned load_acquire(unsigned *value) { return std::atomic_ref<unsigned>(*value).load(std::memory_order_acquire); }
+
+void store_release(unsigned *value, const unsigned next) {
+  std::atomic_ref<unsigned>(*value).store(next, std::memory_order_release);
+}
+} // namespace
+
+UringEventLoop::~UringEventLoop() {
+  // Closing the ring cancels everything in flight, after which the kernel no
+  // longer touches the buffers or the connections.
+  if (m_ring_fd >= 0) {
+    close(m_ring_fd);
+  }
+  m_slots.clear();
+  if (m_buffers != nullptr) {
+    munmap(m_buffers, static_cast<std::size_t>(BUFFER_COUNT) * BUFFER_SIZE);
+  }
+  if (m_buffer_ring != nullptr) {
+    munmap(m_buffer_ring, m_buffer_ring_size);
+  }
+  if (m_sqes != nullptr) {
+    munmap(m_sqes, m_sqes_size);
+  }
+  if (m_cq_ring != nullptr && m_cq_ring != m_sq_ring) {
+    munmap(m_cq_ring, m_cq_ring_size);
+  }
+  if (m_sq_ring != nullptr) {
+    munmap(m_sq_ring, m_sq_ring_size);
+  }
+}
+
+uint64_t UringEventLoop::encode(const Operation operation, const int fd, const uint32_t generation) {
+  return (static_cast<uint64_t>(operation) << OPERATION_SHIFT) |
+         ((static_cast<uint64_t>(generation) & GENERATION_MASK) << GENERATION_SHIFT) |
+         (static_cast<uint64_t>(static_cast<uint32_t>(fd)) & FD_MASK);
+}
+
+bool UringEventLoop::init() {
+  if (!map_rings(SUBMISSION_QUEUE_ENTRIES) || !setup_buffer_ring()) {
+    return false;
+  }
+
+  for (auto fd : m_listeners) {
+    arm_accept(fd);
+  }
+  arm_wake();
+  return true;
+}
+
+bool UringEventLoop::map_rings(const unsigned entries) {
+  io_uring_params params{};
+  params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_COOP_TASKRUN;
+  params.cq_entries = COMPLETION_QUEUE_ENTRIES;
+  m_ring_fd = io_uring_setup(entries, &params);
+  if (m_ring_fd < 0 && errno == EINVAL) {
+    // Kernels before 6.0 reject the single-issuer hint; it is only an optimisation.
+    params = io_uring_params{};
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = COMPLETION_QUEUE_ENTRIES;
+    m_ring_fd = io_uring_setup(entries, &params);
+  }
+  if (m_ring_fd < 0) {
+    STAXYS_LOG(ERROR) << "io_uring_setup failed: " << strerror(errno);
+    return false;
+  }
+
+  m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  auto single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    m_sq_ring_size = m_cq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+  }
+
+  m_sq_ring = mmap(nullptr, m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd,
+                   IORING_OFF_SQ_RING);
+  if (m_sq_ring == MAP_FAILED) {
+    m_sq_ring = nullptr;
+    return false;
+  }
+
+  m_cq_ring = single_mmap ? m_sq_ring
+                          : mmap(nullptr, m_cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                 m_ring_fd, IORING_OFF_CQ_RING);
+  if (m_cq_ring == MAP_FAILED) {
+    m_cq_ring = nullptr;
+    return false;
+  }
+
+  m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+  auto sqes = mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring_fd,
+                   IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    return false;
+  }
+  m_sqes = static_cast<io_uring_sqe *>(sqes);
+
+  auto sq = static_cast<char *>(m_sq_ring);
+  m_sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+  m_sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  m_sq_mask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  m_sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  m_sq_entries = params.sq_entries;
+
+  auto cq = static_cast<char *>(m_cq_ring);
+  m_cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  m_cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  m_cq_mask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  m_cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+  return true;
+}
+
+bool UringEventLoop::setup_buffer_ring() {
+  auto buffers = mmap(nullptr, static_cast<std::size_t>(BUFFER_COUNT) * BUFFER_SIZE, PROT_READ | PROT_WRITE,
+                      MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+  if (buffers == MAP_FAILED) {
+    return false;
+  }
+  m_buffers = static_cast<char *>(buffers);
+
+  m_buffer_ring_size = BUFFER_COUNT * sizeof(io_uring_buf);
+  auto ring = m_buffer_ring_enabled
+                  ? mmap(nullptr, m_buffer_ring_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0)
+                  : MAP_FAILED;
+  if (ring != MAP_FAILED) {
+    m_buffer_ring = static_cast<io_uring_buf_ring *>(ring);
+    io_uring_buf_reg registration{};
+    registration.ring_addr = reinterpret_cast<uint64_t>(m_buffer_ring);
+    registration.ring_entries = BUFFER_COUNT;
+    registration.bgid = BUFFER_GROUP;
+    if (io_uring_register(m_ring_fd, IORING_REGISTER_PBUF_RING, &registration, 1) == 0) {
+      m_use_buffer_ring = true;
+      for (unsigned id = 0; id < BUFFER_COUNT; ++id) {
+        recycle_buffer(static_cast<uint16_t>(id));
+      }
+      if (probe_buffer_ring()) {
+        return true;
+      }
+      io_uring_buf_reg unregistration{};
+      unregistration.bgid = BUFFER_GROUP;
+      io_uring_register(m_ring_fd, IORING_UNREGISTER_PBUF_RING, &unregistration, 1);
+      m_use_buffer_ring = false;
+    }
+    munmap(m_buffer_ring, m_buffer_ring_size);
+    m_buffer_ring = nullptr;
+  }
+
+  // Kernels before 5.19 have no buffer rings, and some accept the
+  // registration without ever selecting from the ring.
+  provide_buffers(0, BUFFER_COUNT);
+  return true;
+}
+
+bool UringEventLoop::probe_buffer_ring() {
+  int sockets[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0) {
+    return false;
+  }
+
+  auto received = -1;
+  auto sqe = next_sqe();
+  if (sqe != nullptr && write(sockets[1], "x", 1) == 1) {
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = sockets[0];
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->len = BUFFER_SIZE;
+    if (submit_and_wait()) {
+      auto head = *m_cq_head;
+      if (head != load_acquire(m_cq_tail)) {
+        auto cqe = m_cqes[head & m_cq_mask];
+        store_release(m_cq_head, head + 1);
+        received = cqe.res;
+        if (cqe.flags & IORING_CQE_F_BUFFER) {
+          recycle_buffer(static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+        }
+      }
+    }
+  }
+
+  close(sockets[0]);
+  close(sockets[1]);
+  return received == 1;
+}
+
+void UringEventLoop::provide_buffers(const uint16_t first_id, const unsigned count) {
+  auto sqe = next_sqe();
+  if (sqe == nullptr) {
+    for (unsigned id = 0; id < count; ++id) {
+      m_returned_buffers.push_back(static_cast<uint16_t>(first_id + id));
+    }
+    return;
+  }
+  sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+  sqe->fd = static_cast<int>(count);
+  sqe->addr = reinterpret_cast<uint64_t>(m_buffers + static_cast<std::size_t>(first_id) * BUFFER_SIZE);
+  sqe->len = BUFFER_SIZE;
+  sqe->off = first_id;
+  sqe->buf_group = BUFFER_GROUP;
+  sqe->user_data = encode(Operation::PROVIDE, 0, 0);
+}
+
+void UringEventLoop::provide_returned_buffers() {
+  auto returned = std::move(m_returned_buffers);
+  m_returned_buffers.clear();
+  for (auto id : returned) {
+    provide_buffers(id, 1);
+  }
+}
+
+void UringEventLoop::recycle_buffer(const uint16_t buffer_id) {
+  if (!m_use_buffer_ring) {
+    provide_buffers(buffer_id, 1);
+    return;
+  }
+  auto &buffer = m_buffer_ring->bufs[m_buffer_tail & (BUFFER_COUNT - 1)];
+  buffer.addr = reinterpret_cast<uint64_t>(m_buffers + static_cast<std::size_t>(buffer_id) * BUFFER_SIZE);
+  buffer.len = BUFFER_SIZE;
+  buffer.bid = buffer_id;
+  ++m_buffer_tail;
+  std::atomic_ref<uint16_t>(m_buffer_ring->tail).store(m_buffer_tail, std::memory_order_release);
+}
+
+bool UringEventLoop::reserve_sqes(const unsigned count) {
+  if (*m_sq_tail - load_acquire(m_sq_head) + count <= m_sq_entries) {
+    return true;
+  }
+  // Queue full: hand what we have to the kernel without waiting.
+  auto submitted = io_uring_enter(m_ring_fd, m_to_submit, 0, 0);
+  if (submitted > 0) {
+    m_to_submit -= static_cast<unsigned>(submitted);
+  }
+  return *m_sq_tail - load_acquire(m_sq_head) + count <= m_sq_entries;
+}
+
+io_uring_sqe *UringEventLoop::next_sqe() {
+  if (!reserve_sqes(1)) {
+    return nullptr;
+  }
+
+  // Without SQPOLL the kernel reads entries only inside io_uring_enter, so
+  // publishing the tail before the entry is filled in is safe.
+  auto tail = *m_sq_tail;
+  auto index = tail & m_sq_mask;
+  auto sqe = &m_sqes[index];
+  std::memset(sqe, 0, sizeof(*sqe));
+  m_sq_array[index] = index;
+  store_release(m_sq_tail, tail + 1);
+  ++m_to_submit;
+  return sqe;
+}
+
+bool UringEventLoop::submit_and_wait() {
+  auto submitted = io_uring_enter(m_ring_fd, m_to_submit, 1, IORING_ENTER_GETEVENTS);
+  if (submitted < 0) {
+    if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+      return true;
+    }
+    STAXYS_LOG(ERROR) << "io_uring_enter failed: " << strerror(errno);
+    return false;
+  }
+  m_to_submit -= std::min(m_to_submit, static_cast<unsigned>(submitted));
+  return true;
+}
+
+int UringEventLoop::run() {
+  while (m_running.load(std::memory_order_relaxed)) {
+    if (!m_returned_buffers.empty()) {
+      provide_returned_buffers();
+    }
+    arm_timeout();
+    if (!submit_and_wait()) {
+      return EXIT_FAILURE;
+    }
+    stamp_wakeup();
+    // First, so timers armed below count from now rather than from before the wait.
+    close_expired();
+
+    auto head = *m_cq_head;
+    auto tail = load_acquire(m_cq_tail);
+    while (head != tail) {
+      // Copy out and release the slot first: handlers may submit, and a
+      // full completion queue would otherwise stall the kernel.
+      auto cqe = m_cqes[head & m_cq_mask];
+      store_release(m_cq_head, ++head);
+      handle_completion(cqe);
+      if (head == tail) {
+        tail = load_acquire(m_cq_tail);
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+void UringEventLoop::arm_accept(const int listener_fd) {
+  auto sqe = next_sqe();
+  if (sqe == nullptr) {
+    return;
+  }
+  sqe->opcode = IORING_OP_ACCEPT;
+  sqe->fd = listener_fd;
+  sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+  sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+  sqe->user_data = encode(Operation::ACCEPT, listener_fd, 0);
+}
+
+void UringEventLoop::arm_recv(const int fd) {
+  auto &slot = m_slots[fd];
+  auto sqe = next_sqe();
+  if (sqe == nullptr) {
+    close_connection(slot);
+    return;
+  }
+  sqe->opcode = IORING_OP_RECV;
+  sqe->fd = fd;
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = BUFFER_GROUP;
+  sqe->user_data = encode(Operation::RECV, fd, slot.generation);
+  slot.recv_armed = true;
+}
+
+void UringEventLoop::cancel_recv(const Slot &slot) {
+  auto sqe = next_sqe();
+  if (sqe == nullptr) {
+    return;
+  }
+  auto fd = slot.connection->fd();
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->addr = encode(Operation::RECV, fd, slot.generation);
+  sqe->user_data = encode(Operation::CANCEL, fd, slot.generation);
+}
+
+void UringEventLoop::pause_recv(Slot &slot) {
+  auto &connection = *slot.connection;
+  if (connection.input_paused()) {
+    return;
+  }
+  connection.input_paused(true);
+  if (slot.recv_armed) {
+    cancel_recv(slot);
+  }
+}
+
+bool UringEventLoop::unpark(Slot &slot) {
+  auto &buffer = slot.connection->read_buffer();
+  std::size_t count = 0;
+  for (; count < slot.parked.size(); ++count) {
+    auto [buffer_id, length] = slot.parked[count];
+    if (!buffer.append(m_buffers + static_cast<std::size_t>(buffer_id) * BUFFER_SIZE, length)) {
+      break;
+    }
+    recycle_buffer(buffer_id);
+    slot.parked_bytes -= length;
+  }
+  slot.parked.erase(slot.parked.begin(), slot.parked.begin() + static_cast<std::ptrdiff_t>(count));
+  return count > 0;
+}
+
+void UringEventLoop::arm_wake() {
+  auto sqe = next_sqe();
+  if (sqe == nullptr) {
+    return;
+  }
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = m_wake_fd;
+  sqe->poll32_events = POLLIN;
+  sqe->user_data = encode(Operation::WAKE, m_wake_fd, 0);
+}
+
+void UringEventLoop::arm_timeout() {
+  auto timeout = timer_timeout();
+  if (timeout < 0) {
+    return;
+  }
+  // An earlier timeout still wakes the loop in time; a later one in flight
+  // only costs a spurious wakeup when it completes.
+  auto deadline = monotonic_ms() + static_cast<uint64_t>(timeout);
+  if (deadline >= m_timeout_deadline) {
+    return;
+  }
+  auto sqe = next_sqe();
+  if (sqe == nullptr) {
+    return;
+  }
+  m_timeout_spec.seconds = timeout / 1000;
+  m_timeout_spec.nanoseconds = static_cast<int64_t>(timeout % 1000) * 1000000;
+  sqe->opcode = IORING_OP_TIMEOUT;
+  sqe->fd = -1;
+  sqe->addr = reinterpret_cast<uint64_t>(&m_timeout_spec);
+  sqe->len = 1;
+  sqe->user_data = encode(Operation::TIMEOUT, 0, 0);
+  m_timeout_deadline = deadline;
+}
+
+void UringEventLoop::handle_completion(const io_uring_cqe &cqe) {
+  auto operation = static_cast<Operation>(cqe.user_data >> OPERATION_SHIFT);
+  auto fd = static_cast<int>(cqe.user_data & FD_MASK);
+  auto generation = static_cast<uint32_t>((cqe.user_data >> GENERATION_SHIFT) & GENERATION_MASK);
+
+  if (operation == Operation::WAKE || operation == Operation::CANCEL || operation == Operation::PROVIDE) {
+    return;
+  }
+  if (operation == Operation::TIMEOUT) {
+    m_timeout_deadline = UINT64_MAX;
+    return;
+  }
+  if (operation == Operation::ACCEPT) {
+    on_accept(fd, cqe.res, cqe.flags);
+    return;
+  }
+
+  auto stale = static_cast<std::size_t>(fd) >= m_slots.size() || !m_slots[fd].connection ||
+               (m_slots[fd].generation & GENERATION_MASK) != generation;
+  if (stale) {
+    // The buffer goes back to the ring even though nobody wants its bytes.
+    if (cqe.flags & IORING_CQE_F_BUFFER) {
+      recycle_buffer(static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+    }
+    return;
+  }
+
+  auto &slot = m_slots[fd];
+  if (slot.closing) {
+    on_closing_completion(slot, operation, cqe.res, cqe.flags);
+    return;
+  }
+
+  switch (operation) {
+  case Operation::RECV:
+    on_recv(slot, cqe.res, cqe.flags);
+    break;
+  case Operation::SEND:
+    on_send(slot, cqe.res);
+    break;
+  case Operation::READ:
+    on_read(slot);
+    break;
+  case Operation::CLOSE:
+    on_close(slot, cqe.res);
+    break;
+  default:
+    break;
+  }
+}
+
+void UringEventLoop::on_accept(const int listener_fd, const int result, const uint32_t flags) {
+  if (!(flags & IORING_CQE_F_MORE) && m_running.load(std::memory_order_relaxed)) {
+    arm_accept(listener_fd);
+  }
+
+  if (result < 0) {
+    if (result != -EAGAIN && result != -ECONNABORTED && result != -EINTR) {
+      STAXYS_LOG(ERROR) << "io_uring accept failed: " << strerror(-result);
+    }
+    return;
+  }
+
+  auto fd = result;
+  if (m_connection_count >= m_max_connections) {
+    close(fd);
+    return;
+  }
+
+  int enable = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+  if (static_cast<std::size_t>(fd) >= m_slots.size()) {
+    m_slots.resize(static_cast<std::size_t>(fd) + 1);
+  }
+  auto &slot = m_slots[fd];
+  if (slot.connection) {
+    // A linked close already freed this fd number while the cancelled recv
+    // of the old connection has not completed yet; that completion is now
+    // stale. The fd belongs to the new socket, so the old connection must
+    // not close it, and its parked buffers will never be unparked.
+    // Its file read and send went before the close, so its file buffer goes
+    // back to the pool with the slot.
+    slot.connection->release_fd();
+    for (auto [buffer_id, length] : slot.parked) {
+      recycle_buffer(buffer_id);
+    }
+    --m_connection_count;
+  }
+  auto generation = slot.generation + 1;
+  slot = Slot{};
+  slot.generation = generation;
+  slot.connection = make_connection(fd);
+  ++m_connection_count;
+  arm_recv(fd);
+  if (slot.connection && !slot.closing) {
+    refresh_timer(*slot.connection);
+  }
+}
+
+void UringEventLoop::on_recv(Slot &slot, const int result, const uint32_t flags) {
+  if (!(flags & IORING_CQE_F_MORE)) {
+    slot.recv_armed = false;
+  }
+
+  auto &connection = *slot.connection;
+  if (result > 0) {
+    auto buffer_id = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+    auto data = m_buffers + static_cast<std::size_t>(buffer_id) * BUFFER_SIZE;
+    if (connection.close_after_write()) {
+      // Nothing after the last response is answered, e.g. the rest of a body
+      // refused as too large; dropping it keeps the response from being cut off.
+      recycle_buffer(buffer_id);
+    } else if (slot.parked.empty() && connection.read_buffer().append(data, static_cast<std::size_t>(result))) {
+      recycle_buffer(buffer_id);
+    } else if ((connection.input_paused() || slot.send_in_flight) &&
+               slot.parked_bytes + static_cast<std::size_t>(result) <= MAX_BUFFERED_INPUT) {
+      // Waits until the output in flight, e.g. an error response, is written.
+      slot.parked.emplace_back(buffer_id, static_cast<uint32_t>(result));
+      slot.parked_bytes += static_cast<std::size_t>(result);
+      pause_recv(slot);
+    } else {
+      // Too much arrived ahead of the unsent responses.
+      recycle_buffer(buffer_id);
+      close_connection(slot);
+      return;
+    }
+  } else if (result == 0) {
+    connection.close_after_write(true);
+  } else if (result != -ENOBUFS && result != -ECANCELED) {
+    close_connection(slot);
+    return;
+  }
+
+  if (connection.read_buffer().size() >= MAX_BUFFERED_INPUT && slot.send_in_flight) {
+    // The client keeps pipelining while its earlier responses are unsent;
+    // the rest waits in the socket until they have been written.
+    pause_recv(slot);
+  }
+
+  serve(slot);
+
+  // Multishot recv stops on EOF, errors, cancellation and buffer exhaustion;
+  // the last leaves a connection worth reading from again.
+  if (slot.connection && !slot.closing && !slot.recv_armed && !connection.input_paused() &&
+      !connection.close_after_write()) {
+    arm_recv(connection.fd());
+  }
+  if (slot.connection && !slot.closing) {
+    refresh_timer(connection);
+  }
+}
+
+void UringEventLoop::on_send(Slot &slot, const int result) {
+  slot.send_in_flight = false;
+  if (result < 0) {
+    close_connection(slot);
+    return;
+  }
+
+  slot.connection->advance_output(static_cast<std::size_t>(result));
+  if (!slot.read_in_flight) {
+    slot.file_buffer = {};
+  }
+  if (!slot.close_in_flight) {
+    serve(slot);
+  }
+  if (slot.connection && !slot.closing) {
+    refresh_timer(*slot.connection);
+  }
+}
+
+void UringEventLoop::on_read(Slot &slot) {
+  // A short read breaks the link, and the send that was to carry the chunk
+  // fails with -ECANCELED and closes the connection; nothing to do here
+  // unless that send has already been reaped.
+  slot.read_in_flight = false;
+  if (slot.send_in_flight) {
+    return;
+  }
+  slot.file_buffer = {};
+  if (!slot.close_in_flight) {
+    serve(slot);
+  }
+}
+
+void UringEventLoop::on_close(Slot &slot, const int result) {
+  slot.close_in_flight = false;
+  if (result == -ECANCELED) {
+    // The send before it came up short and broke the link; serve() submits
+    // the rest of the output and the close again.
+    if (!slot.send_in_flight) {
+      serve(slot);
+    }
+    return;
+  }
+
+  slot.connection->release_fd();
+  close_connection(slot);
+}
+
+void UringEventLoop::on_closing_completion(Slot &slot, const Operation operation, const int result,
+                                           const uint32_t flags) {
+  switch (operation) {
+  case Operation::RECV:
+    if (flags & IORING_CQE_F_BUFFER) {
+      recycle_buffer(static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT));
+    }
+    if (!(flags & IORING_CQE_F_MORE)) {
+      slot.recv_armed = false;
+    }
+    break;
+  case Operation::SEND:
+    slot.send_in_flight = false;
+    break;
+  case Operation::READ:
+    slot.read_in_flight = false;
+    break;
+  case Operation::CLOSE:
+    slot.close_in_flight = false;
+    if (result >= 0) {
+      slot.connection->release_fd();
+    }
+    break;
+  default:
+    break;
+  }
+  close_connection(slot);
+}
+
+void UringEventLoop::serve(Slot &slot) {
+  if (slot.send_in_flight || slot.read_in_flight || slot.close_in_flight) {
+    return;
+  }
+
+  auto &connection = *slot.connection;
+  // Parked input goes in as the requests before it are answered.
+  bool unparked;
+  do {
+    unparked = unpark(slot);
+    if (!m_handler.process(connection)) {
+      close_connection(slot);
+      return;
+    }
+  } while (unparked && !slot.parked.empty() && !connection.output_backlogged());
+  if (connection.output_backlogged()) {
+    pause_recv(slot);
+  } else if (connection.read_buffer().size() >= MAX_BUFFERED_INPUT || !slot.parked.empty()) {
+    close_connection(slot);
+    return;
+  } else if (connection.input_paused()) {
+    connection.input_paused(false);
+    if (!slot.recv_armed && !connection.close_after_write()) {
+      arm_recv(connection.fd());
+      if (!slot.connection || slot.closing) {
+        return;
+      }
+    }
+  }
+
+  if (!connection.has_pending_output()) {
+    if (connection.close_after_write()) {
+      close_connection(slot);
+    }
+    return;
+  }
+
+  // The message and its iovecs live in the Connection, which is heap
+  // allocated and not touched by the handler while the send is in flight.
+  auto message = connection.output_message();
+  Response::FileRange range{};
+  std::size_t chunk = 0;
+  if (connection.output_file(range)) {
+    // Each chunk is a submission of its own, so a large body takes turns
+    // with the other connections as sendfile_max_chunk asks for.
+    chunk = static_cast<std::size_t>(m_max_file_chunk > 0 ? std::min<uint64_t>(range.length, m_max_file_chunk)
+                                                          : range.length);
+    const auto *mapping = m_file_mapping_enabled ? range.file->mapping() : nullptr;
+    if (mapping != nullptr) {
+      // The send copies straight from the page cache, as sendfile would.
+      connection.extend_output(mapping + range.offset, chunk);
+    } else {
+      chunk = std::min(chunk, FILE_BUFFER_SIZE);
+      slot.file_buffer = m_buffer_pool.acquire(chunk);
+      connection.extend_output(slot.file_buffer.data(), chunk);
+    }
+  }
+
+  // With more output than one message holds, the close waits for the last send.
+  auto close = connection.close_after_write() && connection.output_is_final();
+  if (!reserve_sqes(4)) {
+    close_connection(slot);
+    return;
+  }
+
+  // The read, send and close go down as one linked chain. The armed recv
+  // holds its own reference to the socket, so it has to be cancelled for
+  // the close to free it; that goes first, outside the chain.
+  if (close && slot.recv_armed) {
+    cancel_recv(slot);
+  }
+
+  if (slot.file_buffer) {
+    auto read = next_sqe();
+    read->opcode = IORING_OP_READ;
+    read->fd = range.fd;
+    read->off = static_cast<uint64_t>(range.offset);
+    read->addr = reinterpret_cast<uint64_t>(slot.file_buffer.data());
+    read->len = static_cast<uint32_t>(chunk);
+    read->flags = IOSQE_IO_LINK;
+    read->user_data = encode(Operation::READ, connection.fd(), slot.generation);
+    slot.read_in_flight = true;
+  }
+
+  auto send = next_sqe();
+  send->opcode = IORING_OP_SENDMSG;
+  send->fd = connection.fd();
+  send->addr = reinterpret_cast<uint64_t>(message);
+  send->len = 1;
+  // MSG_WAITALL makes io_uring retry short sends itself, which keeps a
+  // linked close from being cancelled by a partial write. MSG_MORE corks
+  // output that more of a file body follows.
+  send->msg_flags = MSG_NOSIGNAL | MSG_WAITALL | (connection.output_is_final() ? 0 : MSG_MORE);
+  send->user_data = encode(Operation::SEND, connection.fd(), slot.generation);
+  slot.send_in_flight = true;
+  if (!close) {
+    return;
+  }
+
+  send->flags |= IOSQE_IO_LINK;
+  auto close_sqe = next_sqe();
+  close_sqe->opcode = IORING_OP_CLOSE;
+  close_sqe->fd = connection.fd();
+  close_sqe->user_data = encode(Operation::CLOSE, connection.fd(), slot.generation);
+  slot.close_in_flight = true;
+}
+
+void UringEventLoop::close_expired() {
+  for (auto timer : expire_timers()) {
+    close_connection(m_slots[timer->data]);
+  }
+}
+
+void UringEventLoop::close_connection(Slot &slot) {
+  if (!slot.connection) {
+    return;
+  }
+
+  auto fd = slot.connection->fd();
+  if (!slot.closing && fd >= 0) {
+    // Forces the armed recv and any send to complete, so the kernel drops
+    // its references to the socket and to our output buffer.
+    shutdown(fd, SHUT_RDWR);
+  }
+  slot.closing = true;
+  if (slot.recv_armed || slot.send_in_flight || slot.read_in_flight || slot.close_in_flight) {
+    return;
+  }
+
+  for (auto [buffer_id, length] : slot.parked) {
+    recycle_buffer(buffer_id);
+  }
+  slot.parked.clear();
+  slot.parked_bytes = 0;
+  ++slot.generation;
+  slot.connection.reset();
+  slot.file_buffer = {};
+  slot.closing = false;
+  --m_connection_count;
+}
+
+} // namespace staxys::network
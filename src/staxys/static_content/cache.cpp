@@ -14,4 +14,156 @@
  * limitations under the License.
  */
 
-#include "staxys/static_content/cache.h"
\ No newline at end of file
+#include "staxys/static_content/cache.h"
+#include <chrono>
+#include <functional>
+
+namespace staxys::static_content {
+
+namespace {
+// Rough cost of a node, its index slot and the CachedFile beyond their strings.
+const std::size_t ENTRY_OVERHEAD = 256;
+
+// Share of a shard's budget that entries hit more than once may hold.
+const std::size_t PROTECTED_PERCENT = 80;
+} // namespace
+
+bool CachedFile::matches(const struct stat &info) const {
+  return info.st_ino == inode && info.st_dev == device && info.st_size == size &&
+         info.st_mtim.tv_sec == modified.tv_sec && info.st_mtim.tv_nsec == modified.tv_nsec;
+}
+
+Cache::Cache(const std::size_t max_bytes, const std::size_t max_file_size, const uint64_t ttl_ms)
+    : m_shard_budget(max_bytes / SHARD_COUNT), m_protected_budget(max_bytes / SHARD_COUNT * PROTECTED_PERCENT / 100),
+      m_max_file_size(max_file_size), m_ttl_ms(ttl_ms) {}
+
+std::shared_ptr<const CachedFile> Cache::find(const std::string &path, const struct stat &info) {
+  auto &shard = shard_for(path);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+
+  auto found = shard.index.find(path);
+  if (found == shard.index.end()) {
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  auto node = found->second;
+  if (now_ms() >= node->expires_at || !node->file->matches(info)) {
+    unlink(shard, node);
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  if (node->protected_segment) {
+    shard.protected_nodes.splice(shard.protected_nodes.begin(), shard.protected_nodes, node);
+  } else {
+    promote(shard, node);
+  }
+  m_hits.fetch_add(1, std::memory_order_relaxed);
+  return node->file;
+}
+
+bool Cache::insert(const std::string &path, std::shared_ptr<const CachedFile> file) {
+  auto charge = path.size() + file->headers.size() + file->body.size() + ENTRY_OVERHEAD;
+  if (file->body.size() > m_max_file_size || charge > m_shard_budget) {
+    return false;
+  }
+
+  auto &shard = shard_for(path);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+
+  auto found = shard.index.find(path);
+  if (found != shard.index.end()) {
+    unlink(shard, found->second);
+  }
+
+  shard.probation.push_front({path, std::move(file), now_ms() + m_ttl_ms, charge, false});
+  auto node = shard.probation.begin();
+  shard.index.emplace(node->path, node);
+  shard.probation_bytes += charge;
+  m_insertions.fetch_add(1, std::memory_order_relaxed);
+
+  evict(shard);
+  return true;
+}
+
+void Cache::erase(const std::string &path) {
+  auto &shard = shard_for(path);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto found = shard.index.find(path);
+  if (found != shard.index.end()) {
+    unlink(shard, found->second);
+  }
+}
+
+void Cache::clear() {
+  for (auto &shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.index.clear();
+    shard.probation.clear();
+    shard.protected_nodes.clear();
+    shard.probation_bytes = shard.protected_bytes = 0;
+  }
+}
+
+Cache::Stats Cache::stats() const {
+  Stats stats;
+  stats.hits = m_hits.load(std::memory_order_relaxed);
+  stats.misses = m_misses.load(std::memory_order_relaxed);
+  stats.insertions = m_insertions.load(std::memory_order_relaxed);
+  stats.evictions = m_evictions.load(std::memory_order_relaxed);
+  for (auto &shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    stats.entries += shard.index.size();
+    stats.bytes += shard.probation_bytes + shard.protected_bytes;
+  }
+  return stats;
+}
+
+uint64_t Cache::now_ms() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+Cache::Shard &Cache::shard_for(const std::string &path) {
+  return m_shards[std::hash<std::string>{}(path) % SHARD_COUNT];
+}
+
+void Cache::unlink(Shard &shard, const NodeList::iterator node) {
+  shard.index.erase(node->path);
+  if (node->protected_segment) {
+    shard.protected_bytes -= node->charge;
+    shard.protected_nodes.erase(node);
+  } else {
+    shard.probation_bytes -= node->charge;
+    shard.probation.erase(node);
+  }
+}
+
+void Cache::promote(Shard &shard, const NodeList::iterator node) const {
+  shard.protected_nodes.splice(shard.protected_nodes.begin(), shard.probation, node);
+  node->protected_segment = true;
+  shard.probation_bytes -= node->charge;
+  shard.protected_bytes += node->charge;
+
+  while (shard.protected_bytes > m_protected_budget && shard.protected_nodes.size() > 1) {
+    auto demoted = std::prev(shard.protected_nodes.end());
+    shard.probation.splice(shard.probation.begin(), shard.protected_nodes, demoted);
+    demoted->protected_segment = false;
+    shard.protected_bytes -= demoted->charge;
+    shard.probation_bytes += demoted->charge;
+  }
+}
+
+void Cache::evict(Shard &shard) {
+  while (shard.probation_bytes + shard.protected_bytes > m_shard_budget) {
+    // The entry just inserted sits alone in probation when protected is full.
+    auto &segment = shard.probation.size() > 1 || shard.protected_nodes.empty() ? shard.probation
+                                                                                 : shard.protected_nodes;
+    unlink(shard, std::prev(segment.end()));
+    m_evictions.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+} // namespace staxys::static_content
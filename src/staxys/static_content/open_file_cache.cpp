@@ -0,0 +1,181 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/static_content/open_file_cache.h"
+#include "staxys/utils/date_utils.h"
+#include <cerrno>
+#include <cstdio>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace staxys::static_content {
+
+OpenFile::OpenFile(const int fd, const struct stat &info) : m_fd(fd), m_info(info) {
+  // The same form as nginx: modification time and size in hex.
+  char etag[48];
+  auto etag_length = std::snprintf(etag, sizeof(etag), "\"%llx-%llx\"",
+                                   static_cast<unsigned long long>(info.st_mtim.tv_sec),
+                                   static_cast<unsigned long long>(info.st_size));
+  m_etag_length = static_cast<std::size_t>(etag_length);
+  char date[utils::DateUtils::HTTP_DATE_LENGTH + 1];
+  auto date_length = utils::DateUtils::format_http_date(info.st_mtim.tv_sec, date);
+
+  for (auto weak : {true, false}) {
+    if (!weak) {
+      m_strong_offset = m_validators.size();
+    }
+    m_validators.append(weak ? "ETag: W/" : "ETag: ")
+        .append(etag, m_etag_length)
+        .append("\r\nLast-Modified: ")
+        .append(date, date_length)
+        .append("\r\n");
+  }
+}
+
+std::string_view OpenFile::etag() const {
+  // Past "ETag: ".
+  return std::string_view(m_validators).substr(m_strong_offset + 6, m_etag_length);
+}
+
+std::string_view OpenFile::last_modified() const {
+  // Past "ETag: ", the tag and "\r\nLast-Modified: ".
+  auto offset = m_strong_offset + 6 + m_etag_length + 17;
+  return std::string_view(m_validators).substr(offset, utils::DateUtils::HTTP_DATE_LENGTH);
+}
+
+std::string_view OpenFile::validators(const bool weak) const {
+  return weak ? std::string_view(m_validators).substr(0, m_strong_offset)
+              : std::string_view(m_validators).substr(m_strong_offset);
+}
+
+const char *OpenFile::mapping() const {
+  if (!m_mapped) {
+    m_mapped = true;
+    if (size() > 0) {
+      auto mapping = mmap(nullptr, size(), PROT_READ, MAP_SHARED, m_fd, 0);
+      m_mapping = mapping == MAP_FAILED ? nullptr : mapping;
+    }
+  }
+  return static_cast<const char *>(m_mapping);
+}
+
+OpenFile::~OpenFile() {
+  if (m_mapping != nullptr) {
+    munmap(m_mapping, size());
+  }
+  if (m_fd >= 0) {
+    close(m_fd);
+  }
+}
+
+std::shared_ptr<const OpenFile> OpenFileCache::open(const std::string &path, int &error) {
+  auto now = now_ns();
+  auto found = m_entries.find(path);
+  if (found != m_entries.end()) {
+    auto &entry = found->second;
+    if (now - entry.checked_at >= m_validity_ns) {
+      if (!still_valid(path, entry)) {
+        load(path, entry);
+      }
+      entry.checked_at = now;
+    }
+    m_order.splice(m_order.begin(), m_order, entry.position);
+    error = entry.error;
+    return entry.file;
+  }
+
+  if (m_capacity == 0) {
+    Entry entry;
+    load(path, entry);
+    error = entry.error;
+    return entry.file;
+  }
+
+  if (m_entries.size() >= m_capacity) {
+    m_entries.erase(m_order.back());
+    m_order.pop_back();
+  }
+
+  m_order.push_front(path);
+  auto &entry = m_entries[path];
+  entry.position = m_order.begin();
+  entry.checked_at = now;
+  load(path, entry);
+  error = entry.error;
+  return entry.file;
+}
+
+void OpenFileCache::invalidate(const std::string &path) {
+  auto found = m_entries.find(path);
+  if (found == m_entries.end()) {
+    return;
+  }
+  m_order.erase(found->second.position);
+  m_entries.erase(found);
+}
+
+void OpenFileCache::clear() {
+  m_entries.clear();
+  m_order.clear();
+}
+
+uint64_t OpenFileCache::now_ns() {
+  timespec now{};
+  clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000 + static_cast<uint64_t>(now.tv_nsec);
+}
+
+bool OpenFileCache::still_valid(const std::string &path, const Entry &entry) {
+  struct stat info {};
+  if (stat(path.c_str(), &info) != 0) {
+    return !entry.file && errno == entry.error;
+  }
+  if (!entry.file) {
+    return false;
+  }
+  // A replaced file has a new inode; one written in place a new size or mtime.
+  const auto &cached = entry.file->info();
+  return info.st_ino == cached.st_ino && info.st_dev == cached.st_dev && info.st_size == cached.st_size &&
+         info.st_mtim.tv_sec == cached.st_mtim.tv_sec && info.st_mtim.tv_nsec == cached.st_mtim.tv_nsec;
+}
+
+void OpenFileCache::load(const std::string &path, Entry &entry) {
+  entry.file.reset();
+  entry.error = 0;
+
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+  if (fd < 0) {
+    entry.error = errno;
+    return;
+  }
+
+  struct stat info {};
+  if (fstat(fd, &info) != 0) {
+    entry.error = errno;
+    close(fd);
+    return;
+  }
+  if (!S_ISREG(info.st_mode) && !S_ISDIR(info.st_mode)) {
+    entry.error = EACCES;
+    close(fd);
+    return;
+  }
+  entry.file = std::make_shared<const OpenFile>(fd, info);
+}
+
+} // namespace staxys::static_content
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/static_content/resolution_cache.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iterator>
+
+namespace staxys::static_content {
+
+ResolutionCache::ResolutionCache(const std::size_t capacity, const uint64_t validity_ms)
+    : m_shard_capacity(std::max<std::size_t>(capacity / SHARD_COUNT, 1)), m_validity_ms(validity_ms) {}
+
+std::shared_ptr<const Resolution> ResolutionCache::find(const std::string_view key) {
+  auto &shard = shard_for(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+
+  auto found = shard.index.find(key);
+  if (found == shard.index.end()) {
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  auto node = found->second;
+  if (node->expires_at != 0 && now_ms() >= node->expires_at) {
+    erase(shard, node);
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  shard.nodes.splice(shard.nodes.begin(), shard.nodes, node);
+  m_hits.fetch_add(1, std::memory_order_relaxed);
+  return node->resolution;
+}
+
+void ResolutionCache::insert(const std::string_view key, std::shared_ptr<const Resolution> resolution) {
+  auto &shard = shard_for(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+
+  auto found = shard.index.find(key);
+  if (found != shard.index.end()) {
+    erase(shard, found->second);
+  }
+
+  auto expires_at = m_validity_ms == 0 ? 0 : now_ms() + m_validity_ms;
+  shard.nodes.push_front({std::string(key), std::move(resolution), expires_at});
+  shard.index.emplace(shard.nodes.front().key, shard.nodes.begin());
+  shard.by_file.emplace(shard.nodes.front().resolution->path, shard.nodes.begin());
+
+  while (shard.nodes.size() > m_shard_capacity) {
+    erase(shard, std::prev(shard.nodes.end()));
+  }
+}
+
+void ResolutionCache::invalidate(const std::string_view path) {
+  // The files path may be a sibling of, from "a.css.gz" back to "a".
+  auto name = path.rfind('/') + 1;
+  for (auto &shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    // Everything at or below path sorts right after it.
+    auto entry = shard.by_file.lower_bound(path);
+    while (entry != shard.by_file.end() && entry->first.starts_with(path)) {
+      auto node = (entry++)->second;
+      erase(shard, node);
+    }
+    for (auto dot = path.rfind('.'); dot != std::string_view::npos && dot > name; dot = path.rfind('.', dot - 1)) {
+      auto base = path.substr(0, dot);
+      for (auto found = shard.by_file.find(base); found != shard.by_file.end(); found = shard.by_file.find(base)) {
+        erase(shard, found->second);
+      }
+    }
+  }
+}
+
+void ResolutionCache::clear() {
+  for (auto &shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.index.clear();
+    shard.by_file.clear();
+    shard.nodes.clear();
+  }
+}
+
+ResolutionCache::Stats ResolutionCache::stats() const {
+  Stats stats;
+  stats.hits = m_hits.load(std::memory_order_relaxed);
+  stats.misses = m_misses.load(std::memory_order_relaxed);
+  for (auto &shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    stats.entries += shard.index.size();
+  }
+  return stats;
+}
+
+uint64_t ResolutionCache::now_ms() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+void ResolutionCache::erase(Shard &shard, const NodeList::iterator node) {
+  auto [first, last] = shard.by_file.equal_range(node->resolution->path);
+  for (auto entry = first; entry != last; ++entry) {
+    if (entry->second == node) {
+      shard.by_file.erase(entry);
+      break;
+    }
+  }
+  shard.index.erase(node->key);
+  shard.nodes.erase(node);
+}
+
+ResolutionCache::Shard &ResolutionCache::shard_for(const std::string_view key) {
+  return m_shards[std::hash<std::string_view>{}(key) % SHARD_COUNT];
+}
+
+} // namespace staxys::static_content
@@ -0,0 +1,271 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/static_content/watcher.h"
+#include "staxys/core/logger.h"
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace staxys::static_content {
+
+namespace {
+const uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                            IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+// Beyond this many pending paths it is cheaper to drop everything.
+const std::size_t MAX_PENDING_PATHS = 4096;
+} // namespace
+
+Watcher::Watcher(std::string root, const std::chrono::milliseconds poll_interval)
+    : m_root(std::move(root)), m_poll_interval(poll_interval) {
+  while (m_root.size() > 1 && m_root.back() == '/') {
+    m_root.pop_back();
+  }
+}
+
+Watcher::~Watcher() { stop(); }
+
+bool Watcher::start(const Mode preferred) {
+  m_stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_stop_fd < 0) {
+    STAXYS_LOG(ERROR) << "Failed to create watcher stop fd: " << strerror(errno);
+    return false;
+  }
+  m_mode.store(preferred, std::memory_order_relaxed);
+
+  // Signals stay with the worker's thread, whose loop reacts to them.
+  sigset_t all;
+  sigset_t previous;
+  sigfillset(&all);
+  pthread_sigmask(SIG_BLOCK, &all, &previous);
+  try {
+    m_thread = std::thread(&Watcher::run, this, preferred);
+  } catch (const std::system_error &e) {
+    STAXYS_LOG(ERROR) << "Failed to start the watcher thread: " << e.what();
+  }
+  pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+  if (!m_thread.joinable()) {
+    stop();
+    return false;
+  }
+  return true;
+}
+
+void Watcher::stop() {
+  if (m_thread.joinable()) {
+    eventfd_write(m_stop_fd, 1);
+    m_thread.join();
+  }
+  if (m_inotify_fd >= 0) {
+    close(m_inotify_fd);
+    m_inotify_fd = -1;
+  }
+  if (m_stop_fd >= 0) {
+    close(m_stop_fd);
+    m_stop_fd = -1;
+  }
+}
+
+bool Watcher::take_changes(Changes &changes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_pending.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  changes.everything = m_changes.everything;
+  changes.paths.swap(m_changes.paths);
+  m_changes.everything = false;
+  m_changes.paths.clear();
+  m_pending.store(false, std::memory_order_relaxed);
+  return true;
+}
+
+void Watcher::run(const Mode preferred) {
+  // Setting up the watches walks the whole tree, so it happens here rather
+  // than in start() on the worker's thread.
+  if (preferred == Mode::INOTIFY && init_inotify() && run_inotify()) {
+    return;
+  }
+  if (preferred == Mode::INOTIFY) {
+    STAXYS_LOG(WARNING) << "inotify is unavailable for " << m_root << "; polling for changes instead.";
+    // Events may have been missed between the failure and the first scan.
+    report_everything();
+  }
+  m_mode.store(Mode::POLL, std::memory_order_relaxed);
+  run_poll();
+}
+
+bool Watcher::init_inotify() {
+  m_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_inotify_fd < 0) {
+    return false;
+  }
+  return add_watches(m_root);
+}
+
+bool Watcher::add_watches(const std::string &directory) {
+  std::vector<std::string> pending{directory};
+  while (!pending.empty()) {
+    auto current = std::move(pending.back());
+    pending.pop_back();
+
+    auto wd = inotify_add_watch(m_inotify_fd, current.c_str(), WATCH_MASK);
+    if (wd < 0) {
+      // Gone already is fine; out of watches (ENOSPC) is not.
+      if (errno == ENOENT || errno == ENOTDIR) {
+        continue;
+      }
+      return false;
+    }
+    m_directories[wd] = current;
+
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(current, error), end; !error && it != end; it.increment(error)) {
+      if (it->is_directory(error) && !it->is_symlink(error)) {
+        pending.push_back(it->path().string());
+      }
+    }
+  }
+  return true;
+}
+
+bool Watcher::run_inotify() {
+  alignas(inotify_event) char buffer[64 * 1024];
+  while (wait(-1)) {
+    auto length = read(m_inotify_fd, buffer, sizeof(buffer));
+    if (length < 0) {
+      if (errno == EINTR || errno == EAGAIN) {
+        continue;
+      }
+      return false;
+    }
+
+    for (auto *position = buffer; position < buffer + length;) {
+      const auto *event = reinterpret_cast<const inotify_event *>(position);
+      position += sizeof(inotify_event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        report_everything();
+        continue;
+      }
+      auto directory = m_directories.find(event->wd);
+      if (directory == m_directories.end()) {
+        continue;
+      }
+      if (event->mask & IN_IGNORED) {
+        m_directories.erase(directory);
+        continue;
+      }
+      if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+        report_everything();
+        continue;
+      }
+
+      auto path = directory->second + "/" + (event->len > 0 ? event->name : "");
+      if (event->mask & IN_ISDIR) {
+        // Anything below a directory that moved in or out may have been
+        // cached, or cached as missing.
+        if ((event->mask & (IN_CREATE | IN_MOVED_TO)) && !add_watches(path)) {
+          return false;
+        }
+        report_everything();
+        continue;
+      }
+      report(std::move(path));
+    }
+  }
+  return true;
+}
+
+void Watcher::run_poll() {
+  std::unordered_map<std::string, FileState> previous;
+  scan(previous);
+
+  std::unordered_map<std::string, FileState> current;
+  while (wait(static_cast<int>(m_poll_interval.count()))) {
+    current.clear();
+    scan(current);
+    for (const auto &[path, state] : current) {
+      auto found = previous.find(path);
+      if (found == previous.end() || found->second.inode != state.inode || found->second.size != state.size ||
+          found->second.modified_ns != state.modified_ns) {
+        report(path);
+      }
+    }
+    for (const auto &[path, state] : previous) {
+      if (current.find(path) == current.end()) {
+        report(path);
+      }
+    }
+    previous.swap(current);
+  }
+}
+
+void Watcher::scan(std::unordered_map<std::string, FileState> &files) const {
+  std::error_code error;
+  auto options = std::filesystem::directory_options::skip_permission_denied;
+  for (std::filesystem::recursive_directory_iterator it(m_root, options, error), end; !error && it != end;
+       it.increment(error)) {
+    struct stat info {};
+    if (!it->is_regular_file(error) || stat(it->path().c_str(), &info) != 0) {
+      continue;
+    }
+    files[it->path().string()] = {info.st_ino, info.st_size,
+                                  static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec};
+  }
+}
+
+bool Watcher::wait(const int timeout_ms) const {
+  pollfd fds[2] = {{m_stop_fd, POLLIN, 0}, {m_inotify_fd, POLLIN, 0}};
+  auto count = m_inotify_fd >= 0 && m_mode.load(std::memory_order_relaxed) == Mode::INOTIFY ? 2 : 1;
+  while (true) {
+    auto ready = poll(fds, count, timeout_ms);
+    if (ready < 0 && errno == EINTR) {
+      continue;
+    }
+    return ready < 0 ? false : !(fds[0].revents & POLLIN);
+  }
+}
+
+void Watcher::report(std::string path) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_changes.everything) {
+    if (m_changes.paths.size() < MAX_PENDING_PATHS) {
+      m_changes.paths.push_back(std::move(path));
+    } else {
+      m_changes.everything = true;
+      m_changes.paths.clear();
+    }
+  }
+  m_pending.store(true, std::memory_order_relaxed);
+}
+
+void Watcher::report_everything() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_changes.everything = true;
+  m_changes.paths.clear();
+  m_pending.store(true, std::memory_order_relaxed);
+}
+
+} // namespace staxys::static_content
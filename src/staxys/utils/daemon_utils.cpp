@@ -15,12 +15,12 @@
  */
 
 #include "staxys/utils/daemon_utils.h"
+#include "staxys/core/logger.h"
 #include <csignal>
 #include <cstring>
 #include <fcntl.h>
 #include <filesystem>
 #include <fstream>
-#include <iostream>
 #include <pwd.h>
 #include <staxys/utils/string_utils.h>
 #include <sys/stat.h>
@@ -29,7 +29,7 @@
 pid_t staxys::utils::DaemonUtils::safe_fork() {
   pid_t pid = fork();
   if (pid < 0) {
-    std::cerr << "Fork failed." << std::endl;
+    STAXYS_LOG(ERROR) << "Fork failed.";
     return -1;
   }
   return pid;
@@ -37,17 +37,17 @@ pid_t staxys::utils::DaemonUtils::safe_fork() {
 
 bool staxys::utils::DaemonUtils::start(const std::string &pidFile) {
   if (std::filesystem::exists(pidFile)) {
-    std::cerr << "Staxys is already running." << std::endl;
+    STAXYS_LOG(ERROR) << "Staxys is already running.";
     return false;
   }
 
   // Attempt to daemonize and write the PID file
   if (daemonize() && write_pid_file(pidFile)) {
-    std::cout << "Running as a daemon..." << std::endl;
-    std::cout << "PID File Path: " << pidFile << std::endl;
+    STAXYS_LOG(INFO) << "Running as a daemon...";
+    STAXYS_LOG(INFO) << "PID File Path: " << pidFile;
     return true;
   } else {
-    std::cerr << "Failed to start the application." << std::endl;
+    STAXYS_LOG(ERROR) << "Failed to start the application.";
     return false;
   }
 }
@@ -55,7 +55,7 @@ bool staxys::utils::DaemonUtils::start(const std::string &pidFile) {
 bool staxys::utils::DaemonUtils::stop(const std::string &pid_file) {
   std::ifstream file(pid_file);
   if (!file.is_open()) {
-    std::cerr << "Staxys is not running." << std::endl;
+    STAXYS_LOG(ERROR) << "Staxys is not running.";
     return false;
   }
 
@@ -64,7 +64,7 @@ bool staxys::utils::DaemonUtils::stop(const std::string &pid_file) {
   file.close();
 
   if (kill(pid, SIGTERM) != 0) {
-    std::cerr << "Failed to stop the process with PID " << pid << ". Error: " << strerror(errno) << std::endl;
+    STAXYS_LOG(ERROR) << "Failed to stop the process with PID " << pid << ". Error: " << strerror(errno);
     return false;
   }
 
@@ -72,8 +72,8 @@ bool staxys::utils::DaemonUtils::stop(const std::string &pid_file) {
   // error where the file is removed but the function returns a non-zero value
   auto remove_result = remove(pid_file.c_str());
   if (remove_result != 0) {
-    std::cerr << "Failed to remove PID file: " << pid_file << std::endl;
-    std::cerr << "Error: " << strerror(errno) << " (errno: " << errno << ")" << std::endl;
+    STAXYS_LOG(ERROR) << "Failed to remove PID file: " << pid_file;
+    STAXYS_LOG(ERROR) << "Error: " << strerror(errno) << " (errno: " << errno << ")";
     return false;
   }
 
@@ -81,19 +81,19 @@ bool staxys::utils::DaemonUtils::stop(const std::string &pid_file) {
 }
 
 bool staxys::utils::DaemonUtils::daemonize() {
-  std::cout << "Daemonizing the process..." << std::endl;
+  STAXYS_LOG(INFO) << "Daemonizing the process...";
   pid_t pid = safe_fork();
   if (pid < 0) {
-    std::cerr << "Failed to fork the process." << std::endl;
+    STAXYS_LOG(ERROR) << "Failed to fork the process.";
     return false;
   }
   if (pid > 0) {
-    std::cout << "Forked child process with PID: " << pid << std::endl;
+    STAXYS_LOG(INFO) << "Forked child process with PID: " << pid;
     exit(0);
   }
 
   if (setsid() < 0) {
-    std::cerr << "Failed to create a new session." << std::endl;
+    STAXYS_LOG(ERROR) << "Failed to create a new session.";
     return false;
   }
 
@@ -106,7 +106,7 @@ bool staxys::utils::DaemonUtils::daemonize() {
   }
 
   if (chdir("/") < 0) {
-    std::cerr << "Failed to change directory to /." << std::endl;
+    STAXYS_LOG(ERROR) << "Failed to change directory to /.";
     return false;
   }
 
@@ -124,20 +124,20 @@ bool staxys::utils::DaemonUtils::daemonize() {
 bool staxys::utils::DaemonUtils::write_pid_file(const std::string &pid_file) {
   std::ofstream file(pid_file);
   if (!file.is_open()) {
-    std::cerr << "Failed to open PID file for writing: " << pid_file << std::endl;
+    STAXYS_LOG(ERROR) << "Failed to open PID file for writing: " << pid_file;
     return false;
   }
 
   pid_t pid = getpid();
-  std::cout << "Writing PID " << pid << " to file: " << pid_file << std::endl;
+  STAXYS_LOG(INFO) << "Writing PID " << pid << " to file: " << pid_file;
   file << pid;
   if (!file.good()) {
-    std::cerr << "Failed to write PID to file: " << pid_file << std::endl;
+    STAXYS_LOG(ERROR) << "Failed to write PID to file: " << pid_file;
     return false;
   }
 
   file.close();
-  std::cout << "PID file written successfully." << std::endl;
+  STAXYS_LOG(INFO) << "PID file written successfully.";
   return true;
 }
 
@@ -145,15 +145,15 @@ bool staxys::utils::DaemonUtils::validate_daemon_configuration(const std::string
                                                                const std::string &pid_file) {
   struct passwd *pw = getpwnam(user_name.c_str());
   if (pw == nullptr) {
-    std::cerr << "User '" << user_name << "' does not exist." << std::endl;
+    STAXYS_LOG(ERROR) << "User '" << user_name << "' does not exist.";
     return false;
   }
 
   size_t pos = pid_file.find_last_of('/');
   auto parent_path = (pos == std::string::npos) ? "." : pid_file.substr(0, pos);
   if (access(parent_path.c_str(), W_OK) != 0) {
-    std::cerr << "Cannot write to directory: " << parent_path << std::endl;
-    std::cerr << "Error: " << strerror(errno) << std::endl;
+    STAXYS_LOG(ERROR) << "Cannot write to directory: " << parent_path;
+    STAXYS_LOG(ERROR) << "Error: " << strerror(errno);
     return false;
   }
   return true;
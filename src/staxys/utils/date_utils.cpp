@@ -0,0 +1,86 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/utils/date_utils.h"
+#include <cstdio>
+
+namespace {
+const char *const DAYS[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+const char *const MONTHS[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+/// Reads \p count digits of \p text from \p offset.
+/// \return -1 if any of them is not a digit.
+int digits(const std::string_view text, const std::size_t offset, const std::size_t count) {
+  int value = 0;
+  for (auto i = offset; i < offset + count; ++i) {
+    if (text[i] < '0' || text[i] > '9') {
+      return -1;
+    }
+    value = value * 10 + (text[i] - '0');
+  }
+  return value;
+}
+} // namespace
+
+/**
+ * Format a time as an IMF-fixdate.
+ * @param time The time to format, in seconds since the epoch.
+ * @param out Receives the date and a terminating NUL.
+ * @return The length of the date.
+ */
+std::size_t staxys::utils::DateUtils::format_http_date(const time_t time, char *out) {
+  tm parts{};
+  gmtime_r(&time, &parts);
+  auto length = std::snprintf(out, HTTP_DATE_LENGTH + 1, "%s, %02d %s %04d %02d:%02d:%02d GMT", DAYS[parts.tm_wday],
+                              parts.tm_mday, MONTHS[parts.tm_mon], parts.tm_year + 1900, parts.tm_hour, parts.tm_min,
+                              parts.tm_sec);
+  return length < 0 ? 0 : static_cast<std::size_t>(length);
+}
+
+/**
+ * Parse an IMF-fixdate such as "Sun, 06 Nov 1994 08:49:37 GMT".
+ * @param text The date; no surrounding whitespace is allowed.
+ * @param time Receives the time in seconds since the epoch.
+ * @return false if the text is not an IMF-fixdate.
+ */
+bool staxys::utils::DateUtils::parse_http_date(const std::string_view text, time_t &time) {
+  // "Sun, 06 Nov 1994 08:49:37 GMT"
+  //  0123456789012345678901234567
+  if (text.size() != HTTP_DATE_LENGTH || text.substr(3, 2) != ", " || text[7] != ' ' || text[11] != ' ' ||
+      text[16] != ' ' || text[19] != ':' || text[22] != ':' || text.substr(25) != " GMT") {
+    return false;
+  }
+
+  tm parts{};
+  parts.tm_mon = -1;
+  for (int month = 0; month < 12; ++month) {
+    if (text.substr(8, 3) == MONTHS[month]) {
+      parts.tm_mon = month;
+    }
+  }
+  parts.tm_mday = digits(text, 5, 2);
+  auto year = digits(text, 12, 4);
+  parts.tm_hour = digits(text, 17, 2);
+  parts.tm_min = digits(text, 20, 2);
+  parts.tm_sec = digits(text, 23, 2);
+  if (parts.tm_mon < 0 || parts.tm_mday < 1 || parts.tm_mday > 31 || year < 1970 || parts.tm_hour < 0 ||
+      parts.tm_hour > 23 || parts.tm_min < 0 || parts.tm_min > 59 || parts.tm_sec < 0 || parts.tm_sec > 60) {
+    return false;
+  }
+  parts.tm_year = year - 1900;
+  time = timegm(&parts);
+  return true;
+}
@@ -14,4 +14,41 @@
  * limitations under the License.
  */
 
-#include "staxys/utils/file_utils.h"
\ No newline at end of file
+#include "staxys/utils/file_utils.h"
+#include "staxys/utils/mime_types.h"
+#include "staxys/utils/uri_utils.h"
+
+/**
+ * Map a request target onto a path below the static root, refusing anything that could escape it.
+ * @param root The static root, without a trailing slash.
+ * @param target The request target as received, e.g. "/css/site.css?v=2".
+ * @param path Receives root followed by the decoded path.
+ * @return true if the target was mapped, false if it was refused.
+ */
+bool staxys::utils::FileUtils::map_target(const std::string_view root, const std::string_view target,
+                                          std::string &path) {
+  auto end = target.find_first_of("?#");
+  auto raw = target.substr(0, end);
+  path.assign(root);
+  while (!path.empty() && path.back() == '/') {
+    path.pop_back();
+  }
+
+  auto start = path.size();
+  path.resize(start + raw.size());
+  auto size = UriUtils::normalize_path(raw, path.data() + start);
+  if (size == std::string_view::npos) {
+    return false;
+  }
+  path.resize(start + size);
+  return true;
+}
+
+/**
+ * Look up the Content-Type of a file from its extension, ignoring case.
+ * @param path The file name or path.
+ * @return The MIME type, or application/octet-stream if the extension is unknown.
+ */
+std::string_view staxys::utils::FileUtils::mime_type(const std::string_view path) {
+  return MimeTypes::for_path(path).value();
+}
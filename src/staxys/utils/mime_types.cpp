@@ -0,0 +1,339 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/utils/mime_types.h"
+#include "staxys/core/logger.h"
+#include "staxys/utils/scan_utils.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+using staxys::utils::MimeType;
+
+struct Entry {
+  std::string_view extension;
+  MimeType type;
+};
+
+// Lowercase extensions; the header lines are sent exactly as written here.
+constexpr Entry BUILT_IN[] = {
+    {"html", {"Content-Type: text/html; charset=utf-8\r\n"}},
+    {"htm", {"Content-Type: text/html; charset=utf-8\r\n"}},
+    {"css", {"Content-Type: text/css; charset=utf-8\r\n"}},
+    {"js", {"Content-Type: text/javascript; charset=utf-8\r\n"}},
+    {"mjs", {"Content-Type: text/javascript; charset=utf-8\r\n"}},
+    {"json", {"Content-Type: application/json\r\n"}},
+    {"map", {"Content-Type: application/json\r\n"}},
+    {"webmanifest", {"Content-Type: application/manifest+json\r\n"}},
+    {"txt", {"Content-Type: text/plain; charset=utf-8\r\n"}},
+    {"md", {"Content-Type: text/markdown; charset=utf-8\r\n"}},
+    {"csv", {"Content-Type: text/csv; charset=utf-8\r\n"}},
+    {"xml", {"Content-Type: application/xml\r\n"}},
+    {"svg", {"Content-Type: image/svg+xml\r\n"}},
+    {"png", {"Content-Type: image/png\r\n"}},
+    {"jpg", {"Content-Type: image/jpeg\r\n"}},
+    {"jpeg", {"Content-Type: image/jpeg\r\n"}},
+    {"gif", {"Content-Type: image/gif\r\n"}},
+    {"webp", {"Content-Type: image/webp\r\n"}},
+    {"avif", {"Content-Type: image/avif\r\n"}},
+    {"ico", {"Content-Type: image/x-icon\r\n"}},
+    {"woff", {"Content-Type: font/woff\r\n"}},
+    {"woff2", {"Content-Type: font/woff2\r\n"}},
+    {"ttf", {"Content-Type: font/ttf\r\n"}},
+    {"otf", {"Content-Type: font/otf\r\n"}},
+    {"wasm", {"Content-Type: application/wasm\r\n"}},
+    {"pdf", {"Content-Type: application/pdf\r\n"}},
+    {"zip", {"Content-Type: application/zip\r\n"}},
+    {"gz", {"Content-Type: application/gzip\r\n"}},
+    {"mp4", {"Content-Type: video/mp4\r\n"}},
+    {"webm", {"Content-Type: video/webm\r\n"}},
+    {"mp3", {"Content-Type: audio/mpeg\r\n"}},
+    {"ogg", {"Content-Type: audio/ogg\r\n"}},
+    {"wav", {"Content-Type: audio/wav\r\n"}},
+};
+
+constexpr MimeType FALLBACK{"Content-Type: application/octet-stream\r\n"};
+
+constexpr uint16_t EMPTY_SLOT = UINT16_MAX;
+// Seeds are tried from 1 up; 0 is the unseeded hash that picks the bucket.
+constexpr uint32_t MAX_SEED = UINT16_MAX;
+
+constexpr unsigned char lower(const char c) {
+  return static_cast<unsigned char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+}
+
+/// FNV-1a over the lowercased extension from a basis varied by \p seed,
+/// with a final mix so that the low bits, which pick the slot, depend on
+/// every byte.
+constexpr uint32_t hash(const std::string_view extension, const uint32_t seed) {
+  uint32_t value = 2166136261U ^ (seed * 0x9e3779b9U);
+  for (auto c : extension) {
+    value = (value ^ lower(c)) * 16777619U;
+  }
+  value ^= value >> 15;
+  value *= 0x2c1b3c6dU;
+  return value ^ (value >> 12);
+}
+
+/// Power of two at least \p count and at least 1.
+constexpr std::size_t ceil_power_of_two(const std::size_t count) {
+  std::size_t power = 1;
+  while (power < count) {
+    power <<= 1;
+  }
+  return power;
+}
+
+/// About two keys per bucket, and twice as many slots as keys, so every
+/// bucket finds a seed within a few tries.
+constexpr std::size_t bucket_count(const std::size_t count) { return ceil_power_of_two(count / 2); }
+constexpr std::size_t slot_count(const std::size_t count) { return ceil_power_of_two(count * 2); }
+
+/// Lays out \p entries as a hash-and-displace perfect hash table: entries
+/// are grouped into buckets by their unseeded hash, and each bucket, largest
+/// first, gets the first seed under which all of its entries land in slots
+/// nobody has taken yet. Runs at compile time for the built-in types.
+/// \return false if some bucket finds no seed, e.g. for a duplicate extension.
+constexpr bool build(const Entry *entries, const std::size_t count, uint16_t *seeds, const std::size_t buckets,
+                     uint16_t *slots, const std::size_t slotCount) {
+  std::vector<std::vector<uint16_t>> members(buckets);
+  for (std::size_t i = 0; i < count; ++i) {
+    members[hash(entries[i].extension, 0) & (buckets - 1)].push_back(static_cast<uint16_t>(i));
+  }
+  std::vector<std::size_t> order(buckets);
+  std::iota(order.begin(), order.end(), std::size_t{0});
+  std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+    return members[a].size() != members[b].size() ? members[a].size() > members[b].size() : a < b;
+  });
+
+  std::fill(seeds, seeds + buckets, uint16_t{0});
+  std::fill(slots, slots + slotCount, EMPTY_SLOT);
+  std::vector<std::size_t> placed;
+  for (auto bucket : order) {
+    if (members[bucket].empty()) {
+      break;
+    }
+    uint32_t seed = 1;
+    for (; seed <= MAX_SEED; ++seed) {
+      placed.clear();
+      for (auto index : members[bucket]) {
+        auto slot = hash(entries[index].extension, seed) & (slotCount - 1);
+        if (slots[slot] != EMPTY_SLOT) {
+          break;
+        }
+        slots[slot] = index;
+        placed.push_back(slot);
+      }
+      if (placed.size() == members[bucket].size()) {
+        break;
+      }
+      for (auto slot : placed) {
+        slots[slot] = EMPTY_SLOT;
+      }
+    }
+    if (seed > MAX_SEED) {
+      return false;
+    }
+    seeds[bucket] = static_cast<uint16_t>(seed);
+  }
+  return true;
+}
+
+/// A laid out table; the arrays belong to whoever built it.
+struct Table {
+  const Entry *entries;
+  std::size_t count;
+  const uint16_t *seeds;
+  const uint16_t *slots;
+  std::size_t bucket_mask;
+  std::size_t slot_mask;
+};
+
+constexpr std::size_t BUILT_IN_COUNT = std::size(BUILT_IN);
+
+struct BuiltInLayout {
+  std::array<uint16_t, bucket_count(BUILT_IN_COUNT)> seeds{};
+  std::array<uint16_t, slot_count(BUILT_IN_COUNT)> slots{};
+  bool built = false;
+};
+
+constexpr BuiltInLayout lay_out_built_in() {
+  BuiltInLayout layout;
+  layout.built = build(BUILT_IN, BUILT_IN_COUNT, layout.seeds.data(), layout.seeds.size(), layout.slots.data(),
+                       layout.slots.size());
+  return layout;
+}
+
+constexpr BuiltInLayout BUILT_IN_LAYOUT = lay_out_built_in();
+static_assert(BUILT_IN_LAYOUT.built, "the built-in MIME types need distinct lowercase extensions");
+
+const Table BUILT_IN_TABLE = {BUILT_IN,
+                              BUILT_IN_COUNT,
+                              BUILT_IN_LAYOUT.seeds.data(),
+                              BUILT_IN_LAYOUT.slots.data(),
+                              BUILT_IN_LAYOUT.seeds.size() - 1,
+                              BUILT_IN_LAYOUT.slots.size() - 1};
+
+/// A table built from a mime.types file, owning the text its entries view.
+struct LoadedTable {
+  std::string text;
+  std::vector<Entry> entries;
+  std::vector<uint16_t> seeds;
+  std::vector<uint16_t> slots;
+  Table table{};
+};
+
+// Loaded tables are never freed, so types handed out stay valid.
+std::vector<std::unique_ptr<const LoadedTable>> loaded_tables;
+const Table *active_table = &BUILT_IN_TABLE;
+
+bool is_token(const std::string_view text) {
+  return !text.empty() && staxys::utils::ScanUtils::find_non_token(text.data(), text.size()) == text.size();
+}
+
+/// A media type as "type/subtype", both tokens (RFC 9110 section 8.3.1).
+bool is_media_type(const std::string_view text) {
+  auto slash = text.find('/');
+  return slash != std::string_view::npos && is_token(text.substr(0, slash)) && is_token(text.substr(slash + 1));
+}
+} // namespace
+
+const staxys::utils::MimeType &staxys::utils::MimeTypes::for_path(const std::string_view path) {
+  auto dot = path.rfind('.');
+  auto slash = path.rfind('/');
+  if (dot == std::string_view::npos || (slash != std::string_view::npos && dot < slash)) {
+    return FALLBACK;
+  }
+  return for_extension(path.substr(dot + 1));
+}
+
+const staxys::utils::MimeType &staxys::utils::MimeTypes::for_extension(const std::string_view extension) {
+  if (extension.size() > MAX_EXTENSION) {
+    return FALLBACK;
+  }
+  const auto &table = *active_table;
+  auto seed = table.seeds[hash(extension, 0) & table.bucket_mask];
+  auto index = table.slots[hash(extension, seed) & table.slot_mask];
+  if (index == EMPTY_SLOT) {
+    return FALLBACK;
+  }
+
+  const auto &entry = table.entries[index];
+  if (entry.extension.size() != extension.size()) {
+    return FALLBACK;
+  }
+  for (std::size_t i = 0; i < extension.size(); ++i) {
+    if (static_cast<unsigned char>(entry.extension[i]) != lower(extension[i])) {
+      return FALLBACK;
+    }
+  }
+  return entry.type;
+}
+
+const staxys::utils::MimeType &staxys::utils::MimeTypes::fallback() { return FALLBACK; }
+
+std::size_t staxys::utils::MimeTypes::size() { return active_table->count; }
+
+/**
+ * Load a mime.types file on top of the built-in types.
+ * @param path The file, e.g. /etc/staxys/mime_types.
+ * @return true if the file was read, false if it could not be opened.
+ */
+bool staxys::utils::MimeTypes::load(const std::string &path) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  // Later lines win over earlier ones, and the file over the built-in types.
+  std::unordered_map<std::string, std::string> types;
+  for (const auto &entry : BUILT_IN) {
+    types[std::string(entry.extension)] = entry.type.value();
+  }
+  std::string line;
+  std::size_t number = 0;
+  while (std::getline(file, line)) {
+    ++number;
+    std::istringstream words(line.substr(0, line.find('#')));
+    std::string type;
+    if (!(words >> type)) {
+      continue;
+    }
+    if (!is_media_type(type)) {
+      STAXYS_LOG(WARNING) << path << ':' << number << ": invalid media type '" << type << "'; line ignored.";
+      continue;
+    }
+    std::string extension;
+    while (words >> extension) {
+      if (!is_token(extension) || extension.size() > MAX_EXTENSION) {
+        STAXYS_LOG(WARNING) << path << ':' << number << ": invalid extension '" << extension << "'; ignored.";
+        continue;
+      }
+      std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return lower(c); });
+      types[extension] = type;
+    }
+  }
+  if (types.size() >= EMPTY_SLOT) {
+    STAXYS_LOG(WARNING) << path << ": more than " << EMPTY_SLOT - 1 << " extensions; file ignored.";
+    return false;
+  }
+
+  // Lay the text out first so that the entries can view it.
+  auto loaded = std::make_unique<LoadedTable>();
+  std::size_t text_size = 0;
+  for (const auto &[extension, type] : types) {
+    text_size += extension.size() + MimeType::HEADER_PREFIX.size() + type.size() + 2;
+  }
+  loaded->text.reserve(text_size);
+  std::vector<std::size_t> offsets;
+  offsets.reserve(types.size());
+  for (const auto &[extension, type] : types) {
+    offsets.push_back(loaded->text.size());
+    loaded->text.append(extension).append(MimeType::HEADER_PREFIX).append(type).append("\r\n");
+  }
+  std::string_view text(loaded->text);
+  std::size_t next = 0;
+  for (const auto &[extension, type] : types) {
+    auto offset = offsets[next++];
+    loaded->entries.push_back({text.substr(offset, extension.size()),
+                               {text.substr(offset + extension.size(),
+                                            MimeType::HEADER_PREFIX.size() + type.size() + 2)}});
+  }
+
+  auto count = loaded->entries.size();
+  loaded->seeds.resize(bucket_count(count));
+  loaded->slots.resize(slot_count(count));
+  if (!build(loaded->entries.data(), count, loaded->seeds.data(), loaded->seeds.size(), loaded->slots.data(),
+             loaded->slots.size())) {
+    STAXYS_LOG(WARNING) << path << ": could not lay out the MIME types; file ignored.";
+    return false;
+  }
+  loaded->table = {loaded->entries.data(), count,
+                   loaded->seeds.data(),   loaded->slots.data(),
+                   loaded->seeds.size() - 1, loaded->slots.size() - 1};
+  active_table = &loaded->table;
+  loaded_tables.push_back(std::move(loaded));
+  return true;
+}
+
+void staxys::utils::MimeTypes::reset() { active_table = &BUILT_IN_TABLE; }
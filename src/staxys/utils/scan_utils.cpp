@@ -0,0 +1,381 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/utils/scan_utils.h"
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using Table = std::array<bool, 256>;
+using Scan = std::size_t (*)(const char *, std::size_t);
+
+// tchar: the characters of methods and field names.
+constexpr Table TOKEN_CHARS = [] {
+  Table table{};
+  for (int c = '0'; c <= '9'; ++c) {
+    table[c] = true;
+  }
+  for (int c = 'a'; c <= 'z'; ++c) {
+    table[c] = true;
+    table[c - 'a' + 'A'] = true;
+  }
+  for (auto c : std::string_view("!#$%&'*+-.^_`|~")) {
+    table[static_cast<unsigned char>(c)] = true;
+  }
+  return table;
+}();
+
+// Field values: visible characters, obs-text, space and tab.
+constexpr Table VALUE_CHARS = [] {
+  Table table{};
+  for (int c = 0x20; c < 256; ++c) {
+    table[c] = c != 0x7F;
+  }
+  table['\t'] = true;
+  return table;
+}();
+
+// Request targets: visible characters; raw UTF-8 is tolerated as real clients send it.
+constexpr Table TARGET_CHARS = [] {
+  Table table{};
+  for (int c = 0x21; c < 256; ++c) {
+    table[c] = c != 0x7F;
+  }
+  return table;
+}();
+
+// unreserved (RFC 3986 section 2.3): the bytes percent-encoding leaves alone.
+constexpr Table UNRESERVED_CHARS = [] {
+  Table table{};
+  for (auto c : std::string_view("0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-._~")) {
+    table[static_cast<unsigned char>(c)] = true;
+  }
+  return table;
+}();
+
+std::size_t find_outside(const Table &table, const char *data, const std::size_t size) {
+  for (std::size_t i = 0; i < size; ++i) {
+    if (!table[static_cast<unsigned char>(data[i])]) {
+      return i;
+    }
+  }
+  return size;
+}
+
+std::size_t scalar_non_token(const char *data, const std::size_t size) { return find_outside(TOKEN_CHARS, data, size); }
+std::size_t scalar_non_value(const char *data, const std::size_t size) { return find_outside(VALUE_CHARS, data, size); }
+std::size_t scalar_non_target(const char *data, const std::size_t size) {
+  return find_outside(TARGET_CHARS, data, size);
+}
+std::size_t scalar_non_unreserved(const char *data, const std::size_t size) {
+  return find_outside(UNRESERVED_CHARS, data, size);
+}
+
+#if defined(__x86_64__)
+
+// SSE4.2: PCMPESTRI against byte ranges, as picohttpparser does. Each range
+// string lists the bytes that end a run as inclusive [low, high] pairs.
+// Eight pairs are not enough to describe the tchar complement exactly, so its
+// last range also covers '|' and '~'; hits are confirmed with the table.
+alignas(16) const char TOKEN_RANGES[16] = {'\x00', ' ', '"', '"', '(', ')', ',', ',',
+                                           '/',    '/', ':', '@', '[', ']', '{', '\xff'};
+alignas(16) const char VALUE_RANGES[16] = {'\x00', '\x08', '\x0a', '\x1f', '\x7f', '\x7f'};
+alignas(16) const char TARGET_RANGES[16] = {'\x00', ' ', '\x7f', '\x7f'};
+alignas(16) const char UNRESERVED_RANGES[16] = {'\x00', ',', '/', '/', ':', '@', '[', '^',
+                                                '`',    '`', '{', '}', '\x7f', '\xff'};
+
+__attribute__((target("sse4.2"))) std::size_t sse42_find(const char *ranges, const int ranges_size, const Table &table,
+                                                          const char *data, const std::size_t size) {
+  auto needles = _mm_load_si128(reinterpret_cast<const __m128i *>(ranges));
+  std::size_t i = 0;
+  while (size - i >= 16) {
+    auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    auto index = _mm_cmpestri(needles, ranges_size, chunk, 16,
+                              _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+    if (index == 16) {
+      i += 16;
+      continue;
+    }
+    i += static_cast<std::size_t>(index);
+    if (!table[static_cast<unsigned char>(data[i])]) {
+      return i;
+    }
+    ++i;
+  }
+  return i + find_outside(table, data + i, size - i);
+}
+
+std::size_t sse42_non_token(const char *data, const std::size_t size) {
+  return sse42_find(TOKEN_RANGES, 16, TOKEN_CHARS, data, size);
+}
+std::size_t sse42_non_value(const char *data, const std::size_t size) {
+  return sse42_find(VALUE_RANGES, 6, VALUE_CHARS, data, size);
+}
+std::size_t sse42_non_target(const char *data, const std::size_t size) {
+  return sse42_find(TARGET_RANGES, 4, TARGET_CHARS, data, size);
+}
+std::size_t sse42_non_unreserved(const char *data, const std::size_t size) {
+  return sse42_find(UNRESERVED_RANGES, 14, UNRESERVED_CHARS, data, size);
+}
+
+// AVX2: 32 bytes per step. tchars all have a high nibble between 2 and 7, so
+// membership is the AND of two 16-entry nibble lookups (VPSHUFB): one bit per
+// high nibble, set in the low-nibble entry for every tchar in that row.
+// Unreserved characters fall in the same rows and are looked up the same way.
+constexpr std::array<uint8_t, 16> low_nibbles(const Table &members) {
+  std::array<uint8_t, 16> table{};
+  for (int c = 0x20; c < 0x80; ++c) {
+    if (members[c]) {
+      table[c & 0x0F] |= static_cast<uint8_t>(1U << ((c >> 4) - 2));
+    }
+  }
+  return table;
+}
+
+constexpr std::array<uint8_t, 16> TOKEN_LOW_NIBBLES = low_nibbles(TOKEN_CHARS);
+constexpr std::array<uint8_t, 16> UNRESERVED_LOW_NIBBLES = low_nibbles(UNRESERVED_CHARS);
+
+constexpr std::array<uint8_t, 16> TOKEN_HIGH_NIBBLES = [] {
+  std::array<uint8_t, 16> table{};
+  for (int high = 2; high < 8; ++high) {
+    table[high] = static_cast<uint8_t>(1U << (high - 2));
+  }
+  return table;
+}();
+
+__attribute__((target("avx2"))) inline __m256i avx2_broadcast(const std::array<uint8_t, 16> &table) {
+  return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(table.data())));
+}
+
+/// Runs \p outside, which marks bytes outside the class, 32 bytes at a time.
+template <typename Outside>
+__attribute__((target("avx2"))) inline std::size_t avx2_find(const Table &table, const char *data,
+                                                             const std::size_t size, Outside outside) {
+  std::size_t i = 0;
+  while (size - i >= 32) {
+    auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(outside(chunk)));
+    if (mask != 0) {
+      return i + static_cast<std::size_t>(__builtin_ctz(mask));
+    }
+    i += 32;
+  }
+  return i + find_outside(table, data + i, size - i);
+}
+
+/// Finds the first byte outside a class whose members all have a high
+/// nibble between 2 and 7, by the nibble lookups described above.
+__attribute__((target("avx2"))) inline std::size_t avx2_find_by_nibbles(const std::array<uint8_t, 16> &lowNibbles,
+                                                                        const Table &table, const char *data,
+                                                                        const std::size_t size) {
+  auto low_table = avx2_broadcast(lowNibbles);
+  auto high_table = avx2_broadcast(TOKEN_HIGH_NIBBLES);
+  auto nibble = _mm256_set1_epi8(0x0F);
+  auto zero = _mm256_setzero_si256();
+  return avx2_find(table, data, size, [=](__m256i chunk) __attribute__((target("avx2"))) {
+    auto low = _mm256_shuffle_epi8(low_table, _mm256_and_si256(chunk, nibble));
+    auto high = _mm256_shuffle_epi8(high_table, _mm256_and_si256(_mm256_srli_epi16(chunk, 4), nibble));
+    return _mm256_cmpeq_epi8(_mm256_and_si256(low, high), zero);
+  });
+}
+
+__attribute__((target("avx2"))) std::size_t avx2_non_token(const char *data, const std::size_t size) {
+  return avx2_find_by_nibbles(TOKEN_LOW_NIBBLES, TOKEN_CHARS, data, size);
+}
+
+__attribute__((target("avx2"))) std::size_t avx2_non_unreserved(const char *data, const std::size_t size) {
+  return avx2_find_by_nibbles(UNRESERVED_LOW_NIBBLES, UNRESERVED_CHARS, data, size);
+}
+
+__attribute__((target("avx2"))) std::size_t avx2_non_value(const char *data, const std::size_t size) {
+  auto last_control = _mm256_set1_epi8(0x1F);
+  auto tab = _mm256_set1_epi8('\t');
+  auto del = _mm256_set1_epi8(0x7F);
+  return avx2_find(VALUE_CHARS, data, size, [=](__m256i chunk) __attribute__((target("avx2"))) {
+    auto control = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, last_control), chunk);
+    auto control_but_tab = _mm256_andnot_si256(_mm256_cmpeq_epi8(chunk, tab), control);
+    return _mm256_or_si256(control_but_tab, _mm256_cmpeq_epi8(chunk, del));
+  });
+}
+
+__attribute__((target("avx2"))) std::size_t avx2_non_target(const char *data, const std::size_t size) {
+  auto space = _mm256_set1_epi8(' ');
+  auto del = _mm256_set1_epi8(0x7F);
+  return avx2_find(TARGET_CHARS, data, size, [=](__m256i chunk) __attribute__((target("avx2"))) {
+    auto control_or_space = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, space), chunk);
+    return _mm256_or_si256(control_or_space, _mm256_cmpeq_epi8(chunk, del));
+  });
+}
+
+#endif
+
+struct Scanners {
+  staxys::utils::ScanUtils::Isa isa;
+  Scan non_token;
+  Scan non_value;
+  Scan non_target;
+  Scan non_unreserved;
+};
+
+const Scanners SCALAR_SCANNERS = {staxys::utils::ScanUtils::Isa::SCALAR, scalar_non_token, scalar_non_value,
+                                  scalar_non_target, scalar_non_unreserved};
+#if defined(__x86_64__)
+const Scanners SSE42_SCANNERS = {staxys::utils::ScanUtils::Isa::SSE42, sse42_non_token, sse42_non_value,
+                                 sse42_non_target, sse42_non_unreserved};
+const Scanners AVX2_SCANNERS = {staxys::utils::ScanUtils::Isa::AVX2, avx2_non_token, avx2_non_value,
+                                avx2_non_target, avx2_non_unreserved};
+#endif
+
+const Scanners *scanners_for(const staxys::utils::ScanUtils::Isa isa) {
+  if (!staxys::utils::ScanUtils::is_supported(isa)) {
+    return nullptr;
+  }
+#if defined(__x86_64__)
+  switch (isa) {
+  case staxys::utils::ScanUtils::Isa::AVX2:
+    return &AVX2_SCANNERS;
+  case staxys::utils::ScanUtils::Isa::SSE42:
+    return &SSE42_SCANNERS;
+  default:
+    break;
+  }
+#endif
+  return &SCALAR_SCANNERS;
+}
+
+const Scanners *detect_scanners() {
+  for (auto isa : {staxys::utils::ScanUtils::Isa::AVX2, staxys::utils::ScanUtils::Isa::SSE42}) {
+    if (auto scanners = scanners_for(isa)) {
+      return scanners;
+    }
+  }
+  return &SCALAR_SCANNERS;
+}
+
+const Scanners *active_scanners = detect_scanners();
+
+} // namespace
+
+/**
+ * Find the first byte that is not a tchar.
+ * @param data The bytes to scan.
+ * @param size The number of bytes to scan.
+ * @return The index of that byte, or size if every byte is a tchar.
+ */
+std::size_t staxys::utils::ScanUtils::find_non_token(const char *data, const std::size_t size) {
+  return active_scanners->non_token(data, size);
+}
+
+/**
+ * Find the first byte that may not appear in a field value.
+ * @param data The bytes to scan.
+ * @param size The number of bytes to scan.
+ * @return The index of that byte, or size if there is none.
+ */
+std::size_t staxys::utils::ScanUtils::find_non_value(const char *data, const std::size_t size) {
+  return active_scanners->non_value(data, size);
+}
+
+/**
+ * Find the first byte that may not appear in a request target.
+ * @param data The bytes to scan.
+ * @param size The number of bytes to scan.
+ * @return The index of that byte, or size if there is none.
+ */
+std::size_t staxys::utils::ScanUtils::find_non_target(const char *data, const std::size_t size) {
+  return active_scanners->non_target(data, size);
+}
+
+/**
+ * Find the first byte that percent-encoding would escape.
+ * @param data The bytes to scan.
+ * @param size The number of bytes to scan.
+ * @return The index of that byte, or size if every byte is unreserved.
+ */
+std::size_t staxys::utils::ScanUtils::find_non_unreserved(const char *data, const std::size_t size) {
+  return active_scanners->non_unreserved(data, size);
+}
+
+std::size_t staxys::utils::ScanUtils::find_non_token(const Isa isa, const char *data, const std::size_t size) {
+  auto scanners = scanners_for(isa);
+  return (scanners ? scanners : &SCALAR_SCANNERS)->non_token(data, size);
+}
+
+std::size_t staxys::utils::ScanUtils::find_non_value(const Isa isa, const char *data, const std::size_t size) {
+  auto scanners = scanners_for(isa);
+  return (scanners ? scanners : &SCALAR_SCANNERS)->non_value(data, size);
+}
+
+std::size_t staxys::utils::ScanUtils::find_non_target(const Isa isa, const char *data, const std::size_t size) {
+  auto scanners = scanners_for(isa);
+  return (scanners ? scanners : &SCALAR_SCANNERS)->non_target(data, size);
+}
+
+std::size_t staxys::utils::ScanUtils::find_non_unreserved(const Isa isa, const char *data, const std::size_t size) {
+  auto scanners = scanners_for(isa);
+  return (scanners ? scanners : &SCALAR_SCANNERS)->non_unreserved(data, size);
+}
+
+/**
+ * Check whether the running CPU can execute an instruction set.
+ * @param isa The instruction set to check.
+ * @return true if it can.
+ */
+bool staxys::utils::ScanUtils::is_supported(const Isa isa) {
+  switch (isa) {
+  case Isa::SCALAR:
+    return true;
+#if defined(__x86_64__)
+  case Isa::SSE42:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+  case Isa::AVX2:
+    // libgcc also checks through XGETBV that the OS saves the YMM registers.
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+  default:
+    return false;
+  }
+}
+
+staxys::utils::ScanUtils::Isa staxys::utils::ScanUtils::active_isa() { return active_scanners->isa; }
+
+bool staxys::utils::ScanUtils::use_isa(const Isa isa) {
+  auto scanners = scanners_for(isa);
+  if (scanners == nullptr) {
+    return false;
+  }
+  active_scanners = scanners;
+  return true;
+}
+
+const char *staxys::utils::ScanUtils::isa_name(const Isa isa) {
+  switch (isa) {
+  case Isa::SSE42:
+    return "sse4.2";
+  case Isa::AVX2:
+    return "avx2";
+  default:
+    return "scalar";
+  }
+}
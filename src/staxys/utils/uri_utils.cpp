@@ -15,148 +15,390 @@
  */
 
 #include "staxys/utils/uri_utils.h"
-#include "staxys/utils/string_utils.h"
-#include <iomanip>
-#include <iostream>
-#include <regex>
-#include <sstream>
+#include "staxys/utils/scan_utils.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
 
-bool staxys::utils::UriUtils::parse(const std::string &uri, UriComponents &components) {
-  if (uri.empty()) {
-    return false;
-  }
+namespace {
 
-  std::string uri_temp = uri;
-  if (!StringUtils::contains(uri_temp, "://")) {
-    uri_temp = "http://" + uri_temp;
-  }
+// Character classes of RFC 3986, one bit per URI part; percent-escapes are
+// allowed in every part but the scheme and the port.
+enum CharClass : uint8_t {
+  SCHEME = 1 << 0,   // ALPHA / DIGIT / "+" / "-" / "."
+  USERINFO = 1 << 1, // unreserved / sub-delims / ":"; also the inside of an IP literal
+  HOST = 1 << 2,     // unreserved / sub-delims
+  PATH = 1 << 3,     // pchar / "/"
+  QUERY = 1 << 4,    // pchar / "/" / "?"; also the fragment
+  DIGIT = 1 << 5,
+  HEX = 1 << 6,
+  ALPHA = 1 << 7,
+};
 
-  std::smatch match;
-  std::regex uri_regex(R"(^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?)");
+constexpr std::array<uint8_t, 256> CHAR_CLASSES = [] {
+  std::array<uint8_t, 256> table{};
+  auto add = [&table](std::string_view characters, const uint8_t classes) {
+    for (auto c : characters) {
+      table[static_cast<unsigned char>(c)] |= classes;
+    }
+  };
+  const uint8_t unreserved = USERINFO | HOST | PATH | QUERY;
+  add("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz", ALPHA | SCHEME | unreserved);
+  add("0123456789", SCHEME | unreserved | DIGIT | HEX);
+  add("ABCDEFabcdef", HEX);
+  add("+.-", SCHEME);
+  add("-._~!$&'()*+,;=", unreserved);
+  add(":", USERINFO | PATH | QUERY);
+  add("@/", PATH | QUERY);
+  add("?", QUERY);
+  return table;
+}();
 
-  if (!std::regex_match(uri_temp, match, uri_regex)) {
-    return false;
+constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+
+// Value of each hex digit; -1 for every other byte.
+constexpr std::array<int8_t, 256> HEX_VALUES = [] {
+  std::array<int8_t, 256> table{};
+  table.fill(-1);
+  for (int i = 0; i < 16; ++i) {
+    table[static_cast<unsigned char>(HEX_DIGITS[i])] = static_cast<int8_t>(i);
+    table[static_cast<unsigned char>("0123456789abcdef"[i])] = static_cast<int8_t>(i);
   }
+  return table;
+}();
 
-  components.scheme = match[2].str();
-  components.host = match[4].str();
+bool is(const char c, const uint8_t classes) { return (CHAR_CLASSES[static_cast<unsigned char>(c)] & classes) != 0; }
 
-  if (StringUtils::contains(components.host, ":")) {
-    auto pos = components.host.find(':');
-    components.port = components.host.substr(pos + 1);
-    components.host = components.host.substr(0, pos);
-  } else {
-    components.port = "";
+/// Skips characters of \p classes and percent-escapes from \p position.
+/// \return The position of the first other character, or npos at a
+///         malformed escape.
+std::size_t skip(std::string_view text, std::size_t position, const uint8_t classes) {
+  while (position < text.size()) {
+    if (text[position] == '%') {
+      if (text.size() - position < 3 || !is(text[position + 1], HEX) || !is(text[position + 2], HEX)) {
+        return std::string_view::npos;
+      }
+      position += 3;
+    } else if (is(text[position], classes)) {
+      ++position;
+    } else {
+      break;
+    }
   }
+  return position;
+}
 
-  components.path = match[5].str().empty() ? "/" : match[5].str();
+/// Skips characters of \p classes from \p position, with no escapes allowed.
+std::size_t skip_plain(std::string_view text, std::size_t position, const uint8_t classes) {
+  while (position < text.size() && is(text[position], classes)) {
+    ++position;
+  }
+  return position;
+}
 
-  if (!match[7].str().empty()) {
-    parse_query(match[7].str(), components.query);
+/// Parses the authority from \p position up to the first "/", "?" or "#".
+/// \return The position after it, or npos if it is malformed.
+std::size_t parse_authority(std::string_view uri, std::size_t position, staxys::utils::UriUtils::UriView &view) {
+  auto start = position;
+  auto userinfo_end = skip(uri, position, USERINFO);
+  if (userinfo_end == std::string_view::npos) {
+    return userinfo_end;
+  }
+  if (userinfo_end < uri.size() && uri[userinfo_end] == '@') {
+    view.userinfo = uri.substr(start, userinfo_end - start);
+    start = position = userinfo_end + 1;
   }
 
-  // match fragment
-  if (!match[9].str().empty()) {
-    components.fragment = match[9].str();
+  if (position < uri.size() && uri[position] == '[') {
+    position = skip_plain(uri, position + 1, USERINFO);
+    if (position == uri.size() || uri[position] != ']') {
+      return std::string_view::npos;
+    }
+    ++position;
+  } else {
+    position = skip(uri, position, HOST);
+    if (position == std::string_view::npos) {
+      return position;
+    }
   }
+  view.host = uri.substr(start, position - start);
 
-  return true;
+  if (position < uri.size() && uri[position] == ':') {
+    auto port_end = skip_plain(uri, position + 1, DIGIT);
+    view.port = uri.substr(position + 1, port_end - position - 1);
+    position = port_end;
+  }
+  if (position < uri.size() && uri[position] != '/' && uri[position] != '?' && uri[position] != '#') {
+    return std::string_view::npos;
+  }
+  return position;
 }
 
-std::string staxys::utils::UriUtils::encode(const std::string &component) {
-  std::ostringstream encoded;
-  for (unsigned char c : component) {
-    if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
-      encoded << c;
+/// Removes the "." and ".." segments of \p path, which starts with '/', into
+/// \p output as in RFC 3986 section 5.2.4; \p output may be path.data().
+/// \details With \p strict every segment is percent-decoded first, and a
+///          segment decoding to something with a '/' or NUL in it, or a ".."
+///          above the root, fails the path; otherwise ".." stops at the root.
+/// \return The size written, or npos if the path failed.
+std::size_t remove_dot_segments(std::string_view path, char *output, const bool strict) {
+  std::size_t written = 0;
+  bool dot_segment = false;
+  for (std::size_t segment = 1; segment <= path.size();) {
+    auto next = std::min(path.find('/', segment), path.size());
+    auto raw = path.substr(segment, next - segment);
+    output[written] = '/';
+    std::size_t size = raw.size();
+    if (strict) {
+      size = staxys::utils::UriUtils::decode(raw, output + written + 1);
+      if (size == std::string_view::npos) {
+        return size;
+      }
     } else {
-      encoded << "%" << std::hex << std::uppercase << std::setw(2) << std::setfill('0') << static_cast<int>(c);
+      std::memmove(output + written + 1, raw.data(), size);
+    }
+    std::string_view name(output + written + 1, size);
+    if (strict && (name.find('/') != std::string_view::npos || name.find('\0') != std::string_view::npos)) {
+      return std::string_view::npos;
     }
-  }
-  return encoded.str();
-}
 
-std::string staxys::utils::UriUtils::decode(const std::string &component) {
-  std::ostringstream decoded;
-  for (size_t i = 0; i < component.size(); i++) {
-    if (component[i] == '%') {
-      int value;
-      std::istringstream hex(component.substr(i + 1, 2));
-      hex >> std::hex >> value;
-      decoded << static_cast<char>(value);
-      i += 2;
-    } else {
-      decoded << component[i];
+    dot_segment = name == "." || name == "..";
+    if (name == "..") {
+      if (written == 0 && strict) {
+        return std::string_view::npos;
+      }
+      // Back to the '/' that starts the previous segment.
+      while (written > 0 && output[--written] != '/') {
+      }
+    } else if (name != ".") {
+      written += 1 + size;
     }
+    segment = next + 1;
   }
-  return decoded.str();
+  if (dot_segment || written == 0) {
+    output[written++] = '/';
+  }
+  return written;
 }
 
-std::string staxys::utils::UriUtils::resolve(const std::string &base, const std::string &relative) {
-  UriComponents components;
-  auto is_valid = parse(base, components);
-  if (!is_valid) {
-    return "";
+} // namespace
+
+bool staxys::utils::UriUtils::parse(const std::string_view uri, UriView &view) {
+  view = UriView{};
+  if (uri.empty()) {
+    return false;
   }
 
-  std::string port = (components.port.empty()) ? "" : ":" + components.port;
+  // scheme "://" authority, or the authority alone
+  std::size_t position = 0;
+  auto scheme_end = skip_plain(uri, 0, SCHEME);
+  if (scheme_end > 0 && is(uri[0], ALPHA) && uri.substr(scheme_end, 3) == "://") {
+    view.scheme = uri.substr(0, scheme_end);
+    position = scheme_end + 3;
+  } else {
+    view.scheme = "http";
+  }
+  position = parse_authority(uri, position, view);
+  if (position == std::string_view::npos) {
+    return false;
+  }
 
-  if (relative.empty()) {
-    return base;
+  auto path_end = skip(uri, position, PATH);
+  if (path_end == std::string_view::npos) {
+    return false;
   }
+  view.path = path_end == position ? std::string_view("/") : uri.substr(position, path_end - position);
+  position = path_end;
 
-  // If the relative URI is absolute, return it as is
-  if (relative.find("://") != std::string::npos) {
-    return relative;
+  if (position < uri.size() && uri[position] == '?') {
+    auto query_end = skip(uri, position + 1, QUERY);
+    if (query_end == std::string_view::npos) {
+      return false;
+    }
+    view.query = uri.substr(position + 1, query_end - position - 1);
+    position = query_end;
+  }
+
+  if (position < uri.size() && uri[position] == '#') {
+    auto fragment_end = skip(uri, position + 1, QUERY);
+    if (fragment_end == std::string_view::npos) {
+      return false;
+    }
+    view.fragment = uri.substr(position + 1, fragment_end - position - 1);
+    position = fragment_end;
   }
 
-  // If the relative URI is a path, resolve it against the base URI
-  if (relative[0] == '/') {
-    return components.scheme + "://" + components.host + port + relative;
+  return position == uri.size();
+}
+
+bool staxys::utils::UriUtils::parse(const std::string_view uri, UriComponents &components) {
+  UriView view;
+  if (!parse(uri, view)) {
+    return false;
   }
+  components.scheme.assign(view.scheme);
+  components.host.assign(view.host);
+  components.port.assign(view.port);
+  components.path.assign(view.path);
+  components.query.clear();
+  parse_query(view.query, components.query);
+  components.fragment.assign(view.fragment);
+  return true;
+}
 
-  // If the relative URI is a query or a fragment, resolve it against the base URI
-  if (relative[0] == '?' || relative[0] == '#') {
-    return components.scheme + "://" + components.host + port + components.path + relative;
+std::string staxys::utils::UriUtils::encode(const std::string &component) {
+  std::string encoded(encoded_size(component), '\0');
+  encode(component, encoded.data());
+  return encoded;
+}
+
+std::string staxys::utils::UriUtils::decode(const std::string &component) {
+  std::string decoded(component);
+  auto size = decode(decoded, decoded.data());
+  decoded.resize(size == std::string_view::npos ? 0 : size);
+  return decoded;
+}
+
+std::size_t staxys::utils::UriUtils::encoded_size(const std::string_view input) {
+  auto size = input.size();
+  for (std::size_t position = 0; position < input.size(); ++position) {
+    position += ScanUtils::find_non_unreserved(input.data() + position, input.size() - position);
+    if (position < input.size()) {
+      size += 2;
+    }
+  }
+  return size;
+}
+
+std::size_t staxys::utils::UriUtils::encode(const std::string_view input, char *output) {
+  std::size_t read = 0;
+  std::size_t written = 0;
+  while (read < input.size()) {
+    auto run = ScanUtils::find_non_unreserved(input.data() + read, input.size() - read);
+    std::memcpy(output + written, input.data() + read, run);
+    read += run;
+    written += run;
+    if (read == input.size()) {
+      break;
+    }
+    auto c = static_cast<unsigned char>(input[read++]);
+    output[written++] = '%';
+    output[written++] = HEX_DIGITS[c >> 4];
+    output[written++] = HEX_DIGITS[c & 0x0F];
   }
+  return written;
+}
 
-  std::string relative_url = relative;
+int staxys::utils::UriUtils::hex_value(const char c) { return HEX_VALUES[static_cast<unsigned char>(c)]; }
 
-  while (relative_url.find("../") == 0) {
-    auto pos = components.path.rfind('/');
-    if (pos != std::string::npos) {
-      components.path = components.path.substr(0, pos);
+std::size_t staxys::utils::UriUtils::decode(const std::string_view input, char *output) {
+  std::size_t read = 0;
+  std::size_t written = 0;
+  while (read < input.size()) {
+    const auto *escape = static_cast<const char *>(std::memchr(input.data() + read, '%', input.size() - read));
+    auto run = (escape == nullptr ? input.size() : static_cast<std::size_t>(escape - input.data())) - read;
+    if (output + written != input.data() + read) {
+      std::memmove(output + written, input.data() + read, run);
+    }
+    read += run;
+    written += run;
+    if (escape == nullptr) {
+      break;
+    }
+    if (input.size() - read < 3) {
+      return std::string_view::npos;
     }
-    relative_url = relative_url.substr(3);
-    std::cout << "Path: " << components.path << std::endl;
-    std::cout << "Relative Url: " << relative_url << std::endl;
+    auto high = HEX_VALUES[static_cast<unsigned char>(input[read + 1])];
+    auto low = HEX_VALUES[static_cast<unsigned char>(input[read + 2])];
+    if (high < 0 || low < 0) {
+      return std::string_view::npos;
+    }
+    output[written++] = static_cast<char>(high << 4 | low);
+    read += 3;
   }
+  return written;
+}
 
-  return components.scheme + "://" + components.host + port + components.path + "/" + relative_url;
+std::size_t staxys::utils::UriUtils::normalize_path(const std::string_view path, char *output) {
+  if (path.empty() || path.front() != '/') {
+    return std::string_view::npos;
+  }
+  return remove_dot_segments(path, output, true);
 }
 
-bool staxys::utils::UriUtils::validate(const std::string &uri) {
-  if (uri.empty()) {
-    return false;
+std::string staxys::utils::UriUtils::resolve(const std::string &base, const std::string &relative) {
+  UriView view;
+  if (!parse(base, view)) {
+    return "";
+  }
+  std::string_view reference(relative);
+  // A reference with a scheme of its own is already absolute.
+  auto colon = reference.find_first_of(":/?#");
+  if (colon != std::string_view::npos && colon > 0 && reference[colon] == ':' &&
+      std::isalpha(static_cast<unsigned char>(reference.front())) &&
+      std::all_of(reference.begin(), reference.begin() + static_cast<std::ptrdiff_t>(colon), [](const char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '+' || c == '-' || c == '.';
+      })) {
+    return relative;
+  }
+
+  std::string resolved(view.scheme);
+  resolved.append("://");
+  if (reference.starts_with("//")) {
+    // A network-path reference brings its own authority.
+    auto authority = reference.substr(2, reference.find_first_of("/?#", 2) - 2);
+    resolved.append(authority);
+    reference.remove_prefix(2 + authority.size());
+  } else {
+    if (!view.userinfo.empty()) {
+      resolved.append(view.userinfo).append("@");
+    }
+    resolved.append(view.host);
+    if (!view.port.empty()) {
+      resolved.append(":").append(view.port);
+    }
   }
 
-  std::string uri_temp = uri;
-  if (!StringUtils::contains(uri_temp, "://")) {
-    uri_temp = "http://" + uri_temp;
+  auto path = reference.substr(0, reference.find_first_of("?#"));
+  auto rest = reference.substr(path.size());
+  if (path.empty() && !relative.starts_with("//")) {
+    // Only a query or a fragment, or nothing: the base path, and its query
+    // unless replaced.
+    resolved.append(view.path);
+    if ((rest.empty() || rest.front() == '#') && !view.query.empty()) {
+      resolved.append("?").append(view.query);
+    }
+    return resolved.append(rest);
+  }
+  if (path.empty()) {
+    return resolved.append(rest);
   }
 
-  std::smatch match;
-  std::regex uri_regex(R"(^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?)");
+  std::string merged;
+  if (path.front() != '/') {
+    // RFC 3986 section 5.2.3: below the root if the base has no path.
+    merged.assign(view.path.empty() ? std::string_view("/") : view.path.substr(0, view.path.rfind('/') + 1));
+  }
+  merged.append(path);
+  auto start = resolved.size();
+  resolved.resize(start + merged.size());
+  resolved.resize(start + remove_dot_segments(merged, resolved.data() + start, false));
+  return resolved.append(rest);
+}
 
-  return std::regex_match(uri_temp, match, uri_regex);
+bool staxys::utils::UriUtils::validate(const std::string_view uri) {
+  UriView view;
+  return parse(uri, view);
 }
 
 std::string staxys::utils::UriUtils::get_path(const std::string &uri) {
   UriComponents components;
   parse(uri, components);
-  return components.path;
+  return std::string(components.path);
 }
 
-std::map<std::string, std::string> staxys::utils::UriUtils::get_query(const std::string &uri) {
+staxys::utils::UriUtils::QueryMap staxys::utils::UriUtils::get_query(const std::string &uri) {
   UriComponents components;
   parse(uri, components);
   return components.query;
@@ -166,18 +408,18 @@ std::string staxys::utils::UriUtils::join(const std::string &base, const std::st
   return std::string();
 }
 
-bool staxys::utils::UriUtils::parse_query(const std::string &queryString,
-                                          std::map<std::string, std::string> &queryParams) {
-  auto query = queryString[0] == '?' ? queryString.substr(1) : queryString;
-  std::istringstream query_stream(query);
-  std::string param;
-  while (std::getline(query_stream, param, '&')) {
+bool staxys::utils::UriUtils::parse_query(std::string_view queryString, QueryMap &queryParams) {
+  if (!queryString.empty() && queryString.front() == '?') {
+    queryString.remove_prefix(1);
+  }
+  while (!queryString.empty()) {
+    auto param = queryString.substr(0, queryString.find('&'));
+    queryString.remove_prefix(std::min(param.size() + 1, queryString.size()));
     auto pos = param.find('=');
-    if (pos != std::string::npos) {
-      auto key = param.substr(0, pos);
-      auto value = param.substr(pos + 1);
-      queryParams[key] = value;
+    if (pos != std::string_view::npos) {
+      queryParams.insert_or_assign(std::pmr::string(param.substr(0, pos), queryParams.get_allocator()),
+                                   std::pmr::string(param.substr(pos + 1), queryParams.get_allocator()));
     }
   }
   return true;
-}
\ No newline at end of file
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/config/loader.h"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+
+using staxys::config::EngineConfig;
+using staxys::config::Loader;
+
+namespace {
+/// Loads an engine config from a scratch file holding \p contents.
+std::shared_ptr<const EngineConfig> load(const std::string &contents) {
+  char path[] = "/tmp/staxys_loader_XXXXXX";
+  auto fd = mkstemp(path);
+  close(fd);
+  std::ofstream(path) << contents;
+  auto config = Loader::load_engine_config(path);
+  std::remove(path);
+  return config;
+}
+} // namespace
+
+TEST(LoaderTest, ParsesSizesAndDurations) {
+  auto config = load("client_max_body_size = 8m\n"
+                     "cache_max_size = 2g\n"
+                     "sendfile_max_chunk = 512\n"
+                     "keep_alive_timeout = 2m\n"
+                     "send_timeout = 30\n"
+                     "cache_duration = 1d\n");
+  ASSERT_EQ(8U * 1024 * 1024, config->client_max_body_size());
+  ASSERT_EQ(2ULL * 1024 * 1024 * 1024, config->cache_max_size());
+  ASSERT_EQ(512U, config->sendfile_max_chunk());
+  ASSERT_EQ(120, config->keep_alive_timeout());
+  ASSERT_EQ(30, config->send_timeout());
+  ASSERT_EQ(24 * 60 * 60, config->cache_duration());
+}
+
+TEST(LoaderTest, RejectsNegativeSizes) {
+  // Parsing stops at the bad line, so the lines after it keep their defaults.
+  auto defaults = std::make_shared<EngineConfig>();
+  auto config = load("client_max_body_size = -1\nkeep_alive_timeout = 5\n");
+  ASSERT_EQ(defaults->client_max_body_size(), config->client_max_body_size());
+  ASSERT_EQ(defaults->keep_alive_timeout(), config->keep_alive_timeout());
+}
+
+TEST(LoaderTest, RejectsSizesThatOverflowOnceScaled) {
+  auto defaults = std::make_shared<EngineConfig>();
+  ASSERT_EQ(defaults->cache_max_size(), load("cache_max_size = 18446744073709551615k\n")->cache_max_size());
+  ASSERT_EQ(defaults->cache_max_size(), load("cache_max_size = 17179869184g\n")->cache_max_size());
+  ASSERT_EQ(defaults->cache_max_size(), load("cache_max_size = 4x\n")->cache_max_size());
+}
+
+TEST(LoaderTest, RejectsNegativeAndOverflowingDurations) {
+  auto defaults = std::make_shared<EngineConfig>();
+  ASSERT_EQ(defaults->send_timeout(), load("send_timeout = -5\n")->send_timeout());
+  ASSERT_EQ(defaults->send_timeout(), load("send_timeout = -1m\n")->send_timeout());
+  ASSERT_EQ(defaults->send_timeout(), load("send_timeout = 30000d\n")->send_timeout());
+  ASSERT_EQ(defaults->send_timeout(), load("send_timeout = 40000000m\n")->send_timeout());
+  ASSERT_EQ(defaults->send_timeout(), load("send_timeout = 5w\n")->send_timeout());
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/core/cycle_clock.h"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+using staxys::core::CycleClock;
+
+TEST(CycleClockTest, TicksAtTheRateOfTheMonotonicClock) {
+  CycleClock::calibrate();
+  timespec before{};
+  clock_gettime(CLOCK_MONOTONIC, &before);
+  auto start = CycleClock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  auto ticks = CycleClock::now() - start;
+  timespec after{};
+  clock_gettime(CLOCK_MONOTONIC, &after);
+
+  auto elapsed_ns = (after.tv_sec - before.tv_sec) * 1000000000LL + (after.tv_nsec - before.tv_nsec);
+  auto measured_ns = static_cast<int64_t>(CycleClock::to_ns(ticks));
+  ASSERT_GE(measured_ns, 50000000);
+  // Within 2% of the reference, which was read a little before and after.
+  ASSERT_NEAR(static_cast<double>(elapsed_ns), static_cast<double>(measured_ns), elapsed_ns * 0.02);
+}
+
+TEST(CycleClockTest, ConvertsBothWays) {
+  CycleClock::calibrate();
+  for (uint64_t ns : {0ULL, 1000ULL, 250000ULL, 1000000000ULL, 3600000000000ULL}) {
+    auto back = CycleClock::to_ns(CycleClock::from_ns(ns));
+    ASSERT_LE(back, ns);
+    ASSERT_GE(back + 1 + ns / 1000000, ns);
+  }
+}
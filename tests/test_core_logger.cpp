@@ -0,0 +1,133 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/core/logger.h"
+#include <cstdlib>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+
+using staxys::core::Logger;
+
+namespace {
+/// Sends the log to a file in a scratch directory, and back to stderr after.
+class LoggerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    char pattern[] = "/tmp/staxys_logger_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(pattern));
+    m_directory = pattern;
+    m_path = m_directory + "/error.log";
+    ASSERT_TRUE(Logger::open(m_path));
+    ASSERT_TRUE(Logger::start());
+  }
+
+  void TearDown() override {
+    Logger::stop();
+    Logger::open("");
+    Logger::set_level(Logger::Level::INFO);
+    std::system(("rm -rf " + m_directory).c_str());
+  }
+
+  std::string read() const {
+    Logger::stop();
+    std::ifstream file(m_path);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  }
+
+  static std::size_t count(const std::string &text, const std::string &part) {
+    std::size_t found = 0;
+    for (auto at = text.find(part); at != std::string::npos; at = text.find(part, at + 1)) {
+      ++found;
+    }
+    return found;
+  }
+
+  std::string m_directory;
+  std::string m_path;
+};
+} // namespace
+
+TEST(LoggerLevelTest, ParsesLevels) {
+  auto level = Logger::Level::INFO;
+  ASSERT_TRUE(Logger::parse_level("debug", level));
+  ASSERT_EQ(Logger::Level::VERBOSE, level);
+  ASSERT_TRUE(Logger::parse_level("warn", level));
+  ASSERT_EQ(Logger::Level::WARNING, level);
+  ASSERT_TRUE(Logger::parse_level("off", level));
+  ASSERT_EQ(Logger::Level::OFF, level);
+  ASSERT_FALSE(Logger::parse_level("loud", level));
+  ASSERT_EQ(Logger::Level::OFF, level);
+  ASSERT_EQ("error", Logger::level_name(Logger::Level::ERROR));
+}
+
+TEST_F(LoggerTest, FormatsNothingBelowTheLevel) {
+  Logger::set_level(Logger::Level::WARNING);
+  int formatted = 0;
+  auto argument = [&formatted] { return ++formatted; };
+  STAXYS_LOG(INFO) << "hidden " << argument();
+  STAXYS_LOG(ERROR) << "shown " << argument() << ' ' << 2.5 << ' ' << true;
+  ASSERT_EQ(1, formatted);
+
+  auto text = read();
+  ASSERT_EQ(std::string::npos, text.find("hidden"));
+  ASSERT_NE(std::string::npos, text.find("] [error] "));
+  ASSERT_NE(std::string::npos, text.find(": shown 1 2.5 true\n"));
+}
+
+TEST_F(LoggerTest, CountsRepeatedMessages) {
+  auto before = Logger::stats();
+  for (int i = 0; i < 1000; ++i) {
+    STAXYS_LOG(ERROR) << "Connection reset by peer";
+  }
+  auto after = Logger::stats();
+  ASSERT_EQ(before.lines + 1, after.lines);
+  ASSERT_EQ(before.repeated + 999, after.repeated);
+
+  auto text = read();
+  ASSERT_EQ(1U, count(text, "Connection reset by peer"));
+  // Two counts if the messages straddled a second.
+  auto summaries = count(text, ": last message repeated ");
+  ASSERT_GE(summaries, 1U);
+  ASSERT_LE(summaries, 2U);
+  if (summaries == 1) {
+    ASSERT_NE(std::string::npos, text.find("test_core_logger.cpp:"));
+    ASSERT_NE(std::string::npos, text.find(": last message repeated 999 times\n"));
+  }
+}
+
+TEST_F(LoggerTest, SuppressesFloodsFromOneSite) {
+  auto before = Logger::stats();
+  for (int i = 0; i < 1000; ++i) {
+    STAXYS_LOG(WARNING) << "Bad request from client " << i;
+  }
+  auto after = Logger::stats();
+  auto lines = after.lines - before.lines;
+  ASSERT_GE(lines, Logger::LINES_PER_SECOND);
+  ASSERT_LE(lines, 2 * Logger::LINES_PER_SECOND);
+  ASSERT_EQ(1000U, lines + after.suppressed - before.suppressed);
+
+  auto text = read();
+  ASSERT_EQ(lines, count(text, "Bad request from client "));
+  ASSERT_NE(std::string::npos, text.find(" messages suppressed\n"));
+}
+
+TEST_F(LoggerTest, CutsLongMessagesShort) {
+  STAXYS_LOG(ERROR) << std::string(2 * Logger::MAX_MESSAGE, 'x');
+  auto text = read();
+  ASSERT_EQ(Logger::MAX_MESSAGE, count(text, "x"));
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/core/metrics.h"
+#include "staxys/core/cycle_clock.h"
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using staxys::core::CycleClock;
+using staxys::core::Histogram;
+using staxys::core::Metrics;
+using staxys::core::WorkerMetrics;
+
+TEST(HistogramTest, BucketsCoverEveryValueWithinAnEighth) {
+  for (uint64_t value : {0ULL, 1ULL, 7ULL, 8ULL, 9ULL, 15ULL, 16ULL, 17ULL, 1000ULL, 123456789ULL, ~0ULL >> 1, ~0ULL}) {
+    auto index = Histogram::bucket(value);
+    ASSERT_LT(index, Histogram::BUCKETS);
+    ASSERT_LE(Histogram::lower_bound(index), value);
+    ASSERT_GE(Histogram::upper_bound(index), value);
+    ASSERT_LE(Histogram::upper_bound(index) - Histogram::lower_bound(index), value / 8);
+  }
+  for (std::size_t i = 1; i < Histogram::BUCKETS; ++i) {
+    ASSERT_EQ(Histogram::upper_bound(i - 1) + 1, Histogram::lower_bound(i));
+  }
+  ASSERT_EQ(~0ULL, Histogram::upper_bound(Histogram::BUCKETS - 1));
+}
+
+TEST(HistogramTest, MergesAndFindsQuantiles) {
+  Histogram first;
+  Histogram second;
+  ASSERT_EQ(0U, first.quantile(0.5));
+  for (uint64_t value = 1; value <= 900; ++value) {
+    first.record(1000);
+  }
+  for (uint64_t value = 1; value <= 100; ++value) {
+    second.record(1000000);
+  }
+
+  Histogram merged;
+  merged.merge(first);
+  merged.merge(second);
+  ASSERT_EQ(1000U, merged.count());
+  ASSERT_EQ(900U * 1000 + 100U * 1000000, merged.sum());
+  ASSERT_EQ(Histogram::upper_bound(Histogram::bucket(1000)), merged.quantile(0.5));
+  ASSERT_EQ(Histogram::upper_bound(Histogram::bucket(1000)), merged.quantile(0.9));
+  ASSERT_EQ(Histogram::upper_bound(Histogram::bucket(1000000)), merged.quantile(0.99));
+  ASSERT_EQ(900U, merged.count_below(2000));
+}
+
+TEST(MetricsTest, SumsTheWorkersAcrossProcesses) {
+  auto metrics = Metrics::create(2);
+  ASSERT_NE(nullptr, metrics);
+  ASSERT_EQ(0U, reinterpret_cast<uintptr_t>(&metrics->worker(1)) % 64);
+
+  // Each worker is a process of its own writing its own slot.
+  for (std::size_t worker = 0; worker < 2; ++worker) {
+    auto pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+      auto &slot = metrics->worker(worker);
+      for (int i = 0; i < 10; ++i) {
+        slot.requests.add();
+        slot.respond(i < 8 ? 200 : 404);
+        slot.time(WorkerMetrics::HANDLE, CycleClock::from_ns(i < 9 ? 50000 : 5000000));
+        slot.time(WorkerMetrics::TOTAL, CycleClock::from_ns(200000));
+      }
+      slot.cache_hits.add(3);
+      slot.cache_misses.add(1);
+      slot.connections_active.set(5);
+      _exit(0);
+    }
+    int status = 0;
+    ASSERT_EQ(pid, waitpid(pid, &status, 0));
+    ASSERT_EQ(0, status);
+  }
+
+  std::pmr::string text;
+  metrics->render(text);
+  std::string body(text);
+  ASSERT_NE(std::string::npos, body.find("# TYPE staxys_requests_total counter\nstaxys_requests_total 20\n"));
+  ASSERT_NE(std::string::npos, body.find("staxys_responses_total{code=\"2xx\"} 16\n"));
+  ASSERT_NE(std::string::npos, body.find("staxys_responses_total{code=\"4xx\"} 4\n"));
+  ASSERT_NE(std::string::npos, body.find("staxys_connections_active 10\n"));
+  ASSERT_NE(std::string::npos, body.find("staxys_cache_hit_ratio 0.75\n"));
+  ASSERT_NE(std::string::npos, body.find("staxys_request_duration_seconds_bucket{le=\"0.0001\"} 0\n"));
+  ASSERT_NE(std::string::npos, body.find("staxys_request_duration_seconds_bucket{le=\"0.00025\"} 20\n"));
+  ASSERT_NE(std::string::npos, body.find("staxys_request_duration_seconds_count 20\n"));
+  ASSERT_NE(std::string::npos, body.find("# TYPE staxys_request_phase_seconds summary\n"));
+  ASSERT_NE(std::string::npos, body.find("staxys_request_phase_seconds_count{phase=\"handle\"} 20\n"));
+  ASSERT_NE(std::string::npos, body.find("staxys_request_phase_seconds_count{phase=\"connect\"} 0\n"));
+
+  // Quantiles are the upper ends of their buckets, at most an eighth above the values.
+  auto quantile = [&body](const std::string &labels) {
+    auto name = "staxys_request_phase_seconds{" + labels + "} ";
+    auto position = body.find(name);
+    EXPECT_NE(std::string::npos, position) << labels;
+    return std::stod(body.substr(position + name.size()));
+  };
+  ASSERT_NEAR(0.00005, quantile(R"(phase="handle",quantile="0.5")"), 0.00005 / 8 + 1e-7);
+  ASSERT_NEAR(0.005, quantile(R"(phase="handle",quantile="0.999")"), 0.005 / 8 + 1e-6);
+  ASSERT_EQ(0.0, quantile(R"(phase="send",quantile="0.99")"));
+
+  metrics->worker(0).clear_gauges();
+  text.clear();
+  metrics->render(text);
+  ASSERT_NE(std::string::npos, text.find("staxys_connections_active 5\n"));
+  ASSERT_NE(std::string::npos, text.find("staxys_requests_total 20\n"));
+}
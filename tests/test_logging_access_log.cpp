@@ -0,0 +1,266 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/logging/access_log.h"
+#include <chrono>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <gtest/gtest.h>
+#include <regex>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using staxys::logging::AccessLog;
+using staxys::logging::AccessRecord;
+using staxys::logging::AccessRecordDecoder;
+
+namespace {
+/// An access log in a scratch directory.
+class AccessLogTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    char pattern[] = "/tmp/staxys_access_log_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(pattern));
+    m_directory = pattern;
+    m_path = m_directory + "/access.log";
+  }
+
+  void TearDown() override { std::system(("rm -rf " + m_directory).c_str()); }
+
+  static std::vector<std::string> read_lines(const std::string &path) {
+    std::vector<std::string> lines;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+      lines.push_back(line);
+    }
+    return lines;
+  }
+
+  static AccessRecord entry(const std::string_view target) {
+    AccessRecord entry;
+    entry.client = "192.0.2.1";
+    entry.method = "GET";
+    entry.target = target;
+    entry.status = 200;
+    entry.bytes = 1234;
+    return entry;
+  }
+
+  static std::string read_file(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  }
+
+  std::string m_directory;
+  std::string m_path;
+};
+} // namespace
+
+TEST_F(AccessLogTest, WritesALinePerRequest) {
+  AccessLog log(m_path);
+  ASSERT_TRUE(log.start());
+  auto first = entry("/index.html");
+  first.referer = "https://example.com/";
+  first.user_agent = "curl/8.5.0";
+  log.log(first);
+  AccessRecord refused;
+  refused.status = 400;
+  log.log(refused);
+  log.stop();
+
+  auto lines = read_lines(m_path);
+  ASSERT_EQ(2U, lines.size());
+  std::regex format(R"(192\.0\.2\.1 - \[\d{2}/[A-Z][a-z]{2}/\d{4}:\d{2}:\d{2}:\d{2} \+0000\] )"
+                      R"("GET /index\.html HTTP/1\.1" 200 1234 "https://example\.com/" "curl/8\.5\.0")");
+  ASSERT_TRUE(std::regex_match(lines[0], format)) << lines[0];
+  const std::string unparsed = R"( "-" 400 - "-" "-")";
+  ASSERT_EQ(lines[1].size() - unparsed.size(), lines[1].find(unparsed)) << lines[1];
+  ASSERT_EQ(0U, lines[1].find("- - ["));
+
+  auto stats = log.stats();
+  ASSERT_EQ(2U, stats.lines);
+  ASSERT_EQ(0U, stats.dropped);
+  ASSERT_EQ(lines[0].size() + lines[1].size() + 2, stats.bytes_written);
+}
+
+TEST_F(AccessLogTest, EscapesFieldsAndCutsLongLines) {
+  AccessLog log(m_path);
+  ASSERT_TRUE(log.start());
+  auto forged = entry("/a\"b\\c");
+  forged.user_agent = "x\" 200 0 \"\n\xff";
+  log.log(forged);
+  log.log(entry(std::string(2 * AccessLog::MAX_LINE, 'a')));
+  log.stop();
+
+  auto lines = read_lines(m_path);
+  ASSERT_EQ(2U, lines.size());
+  ASSERT_NE(std::string::npos, lines[0].find(R"("GET /a\x22b\x5Cc HTTP/1.1")")) << lines[0];
+  ASSERT_NE(std::string::npos, lines[0].find(R"("x\x22 200 0 \x22\x0A\xFF")")) << lines[0];
+  ASSERT_EQ(AccessLog::MAX_LINE - 1, lines[1].size());
+}
+
+TEST_F(AccessLogTest, DropsOrWaitsWhenTheRingIsFull) {
+  // Nothing reads the FIFO until the ring and the pipe buffer are full.
+  ASSERT_EQ(0, mkfifo(m_path.c_str(), 0600));
+  auto reader = open(m_path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+  ASSERT_GE(reader, 0);
+  auto drain = [reader](const std::chrono::milliseconds period) {
+    char buffer[65536];
+    std::size_t total = 0;
+    auto deadline = std::chrono::steady_clock::now() + period;
+    while (std::chrono::steady_clock::now() < deadline) {
+      auto count = read(reader, buffer, sizeof(buffer));
+      if (count > 0) {
+        total += static_cast<std::size_t>(count);
+      } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+    return total;
+  };
+
+  const std::string target(500, 't');
+  const int count = 1000;
+  {
+    AccessLog log(m_path, 0, AccessLog::Overflow::DROP);
+    ASSERT_TRUE(log.start());
+    for (int i = 0; i < count; ++i) {
+      log.log(entry(target));
+    }
+    auto stats = log.stats();
+    ASSERT_GT(stats.dropped, 0U);
+    ASSERT_EQ(static_cast<uint64_t>(count), stats.lines + stats.dropped);
+    std::thread reading([&] { drain(std::chrono::milliseconds(200)); });
+    log.stop();
+    reading.join();
+  }
+
+  AccessLog log(m_path, 0, AccessLog::Overflow::BLOCK);
+  ASSERT_TRUE(log.start());
+  std::size_t received = 0;
+  std::thread reading([&] { received = drain(std::chrono::milliseconds(500)); });
+  for (int i = 0; i < count; ++i) {
+    log.log(entry(target));
+  }
+  log.stop();
+  reading.join();
+  close(reader);
+  auto stats = log.stats();
+  ASSERT_EQ(static_cast<uint64_t>(count), stats.lines);
+  ASSERT_EQ(0U, stats.dropped);
+  ASSERT_EQ(stats.bytes_written, received);
+}
+
+TEST_F(AccessLogTest, ReopensTheFileForRotation) {
+  AccessLog log(m_path);
+  ASSERT_TRUE(log.start());
+  log.log(entry("/before"));
+  ASSERT_EQ(0, rename(m_path.c_str(), (m_path + ".1").c_str()));
+  log.reopen();
+
+  struct stat info {};
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (stat(m_path.c_str(), &info) != 0 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  log.log(entry("/after"));
+  log.stop();
+
+  auto rotated = read_lines(m_path + ".1");
+  auto current = read_lines(m_path);
+  ASSERT_EQ(1U, rotated.size());
+  ASSERT_NE(std::string::npos, rotated[0].find("GET /before "));
+  ASSERT_EQ(1U, current.size());
+  ASSERT_NE(std::string::npos, current[0].find("GET /after "));
+}
+
+TEST_F(AccessLogTest, WritesTheSameRecordsInBinary) {
+  AccessLog text(m_path);
+  AccessLog binary(m_path + ".bin", AccessLog::DEFAULT_CAPACITY, AccessLog::Overflow::BLOCK,
+                   AccessLog::DEFAULT_FLUSH_INTERVAL, AccessLog::Format::BINARY);
+  ASSERT_TRUE(text.start());
+  ASSERT_TRUE(binary.start());
+  std::vector<AccessRecord> records;
+  for (int i = 0; i < 50; ++i) {
+    auto record = entry(i % 2 == 0 ? "/index.html" : "/style.css");
+    record.time = 1736676000000000 + i * 1500;
+    record.user_agent = "Mozilla/5.0 (X11; Linux x86_64) Firefox/134.0";
+    record.bytes = i == 7 ? -1 : i;
+    records.push_back(record);
+    text.log(record);
+    binary.log(record);
+  }
+  text.stop();
+  binary.stop();
+
+  // Decoding the binary log and formatting it gives the text log.
+  auto data = read_file(m_path + ".bin");
+  std::string_view rest = data;
+  std::string decoded;
+  AccessRecordDecoder decoder;
+  std::size_t count = 0;
+  while (!rest.empty()) {
+    uint64_t payload_size = 0;
+    auto header_size = AccessRecordDecoder::parse_frame_header(rest, payload_size);
+    ASSERT_GT(header_size, 0);
+    auto payload = rest.substr(static_cast<std::size_t>(header_size), payload_size);
+    rest.remove_prefix(static_cast<std::size_t>(header_size) + payload_size);
+    decoder.reset();
+    AccessRecord record;
+    while (decoder.decode(payload, record) == AccessRecordDecoder::Status::RECORD) {
+      ASSERT_EQ(records[count].time, record.time);
+      ASSERT_EQ(records[count].target, record.target);
+      ASSERT_EQ(records[count].bytes, record.bytes);
+      char time[staxys::logging::AccessRecordText::TIME_SIZE];
+      auto time_length = staxys::logging::AccessRecordText::format_time(record.time / 1000000, time);
+      char line[AccessLog::MAX_LINE];
+      decoded.append(line, staxys::logging::AccessRecordText::to_text(record, {time, time_length}, line));
+      ++count;
+    }
+  }
+  ASSERT_EQ(records.size(), count);
+  auto lines = read_file(m_path);
+  ASSERT_EQ(lines, decoded);
+  ASSERT_LT(data.size() * 4, lines.size());
+  ASSERT_EQ(data.size(), binary.stats().bytes_written);
+}
+
+TEST_F(AccessLogTest, ParsesOverflowPolicies) {
+  auto overflow = AccessLog::Overflow::BLOCK;
+  ASSERT_TRUE(AccessLog::parse_overflow("drop", overflow));
+  ASSERT_EQ(AccessLog::Overflow::DROP, overflow);
+  ASSERT_TRUE(AccessLog::parse_overflow("block", overflow));
+  ASSERT_EQ(AccessLog::Overflow::BLOCK, overflow);
+  ASSERT_FALSE(AccessLog::parse_overflow("wait", overflow));
+  ASSERT_EQ(AccessLog::Overflow::BLOCK, overflow);
+  ASSERT_FALSE(AccessLog(m_directory + "/missing/access.log").start());
+}
+
+TEST_F(AccessLogTest, ParsesFormats) {
+  auto format = AccessLog::Format::TEXT;
+  ASSERT_TRUE(AccessLog::parse_format("binary", format));
+  ASSERT_EQ(AccessLog::Format::BINARY, format);
+  ASSERT_TRUE(AccessLog::parse_format("text", format));
+  ASSERT_EQ(AccessLog::Format::TEXT, format);
+  ASSERT_FALSE(AccessLog::parse_format("json", format));
+  ASSERT_EQ(AccessLog::Format::TEXT, format);
+}
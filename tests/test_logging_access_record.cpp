@@ -0,0 +1,180 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/logging/access_record.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using staxys::logging::AccessRecord;
+using staxys::logging::AccessRecordDecoder;
+using staxys::logging::AccessRecordEncoder;
+using staxys::logging::AccessRecordText;
+
+namespace {
+AccessRecord record(const std::string_view target, const int64_t time) {
+  AccessRecord record;
+  record.time = time;
+  record.client = "2001:db8::1";
+  record.method = "GET";
+  record.target = target;
+  record.status = 200;
+  record.bytes = 512;
+  record.referer = "https://example.com/";
+  record.user_agent = "curl/8.5.0";
+  return record;
+}
+
+/// Encodes \p records as the payload of one frame.
+std::string encode(AccessRecordEncoder &encoder, const std::vector<AccessRecord> &records) {
+  std::string payload;
+  char out[AccessRecordEncoder::MAX_RECORD];
+  for (const auto &each : records) {
+    payload.append(out, encoder.encode(each, out));
+  }
+  return payload;
+}
+
+std::string text(const AccessRecord &record) {
+  char time[AccessRecordText::TIME_SIZE];
+  auto time_length = AccessRecordText::format_time(record.time / 1000000, time);
+  char line[AccessRecordText::MAX_LINE];
+  return {line, AccessRecordText::to_text(record, {time, time_length}, line)};
+}
+} // namespace
+
+TEST(AccessRecordTest, RoundTripsRecordsWithInternedStrings) {
+  std::vector<AccessRecord> records = {record("/index.html", 1736676000000000), record("/a.css", 1736676000000250),
+                                       record("/index.html", 1736675999999999)};
+  records[1].bytes = -1;
+  records[1].minor_version = 0;
+  records[1].referer = {};
+  records[2].method = "HEAD";
+  records[2].status = 304;
+  records[2].bytes = 0;
+
+  // Within a frame, each repeated string is written once.
+  AccessRecordEncoder interning;
+  auto payload = encode(interning, records);
+  AccessRecordEncoder plain(false);
+  std::string separate;
+  for (const auto &each : records) {
+    plain.reset();
+    separate += encode(plain, {each});
+  }
+  ASSERT_LT(payload.size() + 64, separate.size());
+
+  AccessRecordDecoder decoder;
+  std::string_view rest = payload;
+  for (const auto &expected : records) {
+    AccessRecord decoded;
+    ASSERT_EQ(AccessRecordDecoder::Status::RECORD, decoder.decode(rest, decoded));
+    ASSERT_EQ(expected.time, decoded.time);
+    ASSERT_EQ(expected.client, decoded.client);
+    ASSERT_EQ(expected.method, decoded.method);
+    ASSERT_EQ(expected.target, decoded.target);
+    ASSERT_EQ(expected.minor_version, decoded.minor_version);
+    ASSERT_EQ(expected.status, decoded.status);
+    ASSERT_EQ(expected.bytes, decoded.bytes);
+    ASSERT_EQ(expected.referer, decoded.referer);
+    ASSERT_EQ(expected.user_agent, decoded.user_agent);
+    ASSERT_EQ(text(expected), text(decoded));
+  }
+  AccessRecord end;
+  ASSERT_EQ(AccessRecordDecoder::Status::END, decoder.decode(rest, end));
+}
+
+TEST(AccessRecordTest, CutsLongStringsShortToFitARecord) {
+  const std::string target(2 * AccessRecordEncoder::MAX_RECORD, 't');
+  auto long_record = record(target, 1);
+  AccessRecordEncoder encoder;
+  char out[AccessRecordEncoder::MAX_RECORD];
+  auto length = encoder.encode(long_record, out);
+  ASSERT_LE(length, AccessRecordEncoder::MAX_RECORD);
+
+  AccessRecordDecoder decoder;
+  std::string_view payload(out, length);
+  AccessRecord decoded;
+  ASSERT_EQ(AccessRecordDecoder::Status::RECORD, decoder.decode(payload, decoded));
+  ASSERT_GT(decoded.target.size(), AccessRecordEncoder::MAX_RECORD - 64);
+  ASSERT_EQ(std::string(decoded.target.size(), 't'), decoded.target);
+  ASSERT_TRUE(decoded.referer.empty());
+  ASSERT_TRUE(decoded.user_agent.empty());
+}
+
+TEST(AccessRecordTest, SkipsFieldsItDoesNotKnowAndRejectsBadRecords) {
+  AccessRecordEncoder encoder;
+  char out[AccessRecordEncoder::MAX_RECORD];
+  auto length = encoder.encode(record("/", 5), out);
+
+  // A record from a later version with two more bytes of fields.
+  std::string extended(out + 1, length - 1);
+  extended += "\x01\x02";
+  extended.insert(0, 1, static_cast<char>(extended.size()));
+  extended += std::string(out, length);
+  AccessRecordDecoder decoder;
+  std::string_view payload = extended;
+  AccessRecord decoded;
+  ASSERT_EQ(AccessRecordDecoder::Status::RECORD, decoder.decode(payload, decoded));
+  ASSERT_EQ("/", decoded.target);
+  ASSERT_EQ(AccessRecordDecoder::Status::RECORD, decoder.decode(payload, decoded));
+  ASSERT_EQ(10, decoded.time);
+
+  // Cut off, and referring to a string that never came.
+  decoder.reset();
+  std::string_view cut(out, length - 1);
+  ASSERT_EQ(AccessRecordDecoder::Status::INVALID, decoder.decode(cut, decoded));
+  decoder.reset();
+  const std::string dangling("\x09\x00\x00\x00\x00\x04\x00\x00\x00\x00", 10);
+  std::string_view reference = dangling;
+  ASSERT_EQ(AccessRecordDecoder::Status::INVALID, decoder.decode(reference, decoded));
+}
+
+TEST(AccessRecordTest, ReadsFrameHeaders) {
+  char header[AccessRecordEncoder::MAX_FRAME_HEADER];
+  auto length = AccessRecordEncoder::frame_header(300, header);
+  ASSERT_EQ(AccessRecordEncoder::MAGIC.size() + 2, length);
+
+  uint64_t payload_size = 0;
+  ASSERT_EQ(static_cast<int>(length), AccessRecordDecoder::parse_frame_header({header, length}, payload_size));
+  ASSERT_EQ(300U, payload_size);
+  ASSERT_EQ(0, AccessRecordDecoder::parse_frame_header({header, length - 1}, payload_size));
+  ASSERT_EQ(0, AccessRecordDecoder::parse_frame_header({header, 2}, payload_size));
+  ASSERT_EQ(-1, AccessRecordDecoder::parse_frame_header("192.0.2.1 - [", payload_size));
+  ASSERT_EQ(-1, AccessRecordDecoder::parse_frame_header("1", payload_size));
+}
+
+TEST(AccessRecordTest, FormatsJson) {
+  auto escaped = record("/a\"b\\c", 1736676000123456);
+  escaped.user_agent = "x\n\xff";
+  escaped.bytes = -1;
+  char line[AccessRecordText::MAX_LINE];
+  std::string json(line, AccessRecordText::to_json(escaped, line));
+  ASSERT_EQ(R"({"time":"2025-01-12T10:00:00.123456Z","client":"2001:db8::1","method":"GET",)"
+            R"("target":"/a\"b\\c","protocol":"HTTP/1.1","status":200,"bytes":null,)"
+            R"("referer":"https://example.com/","user_agent":"x\u000A\u00FF"})"
+            "\n",
+            json);
+
+  // Cut short, the object is still closed.
+  const std::string target(2 * AccessRecordText::MAX_LINE, '"');
+  auto long_record = record(target, 0);
+  long_record.user_agent = target;
+  json.assign(line, AccessRecordText::to_json(long_record, line));
+  ASSERT_LT(json.size(), AccessRecordText::MAX_LINE);
+  ASSERT_EQ("\"}\n", json.substr(json.size() - 3));
+  ASSERT_NE(std::string::npos, json.find(R"("status":200,"bytes":512,"referer":"","user_agent":""})"));
+}
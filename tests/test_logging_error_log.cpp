@@ -0,0 +1,102 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/logging/error_log.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+
+using staxys::logging::ErrorLog;
+
+namespace {
+/// An error log in a scratch directory.
+class ErrorLogTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    char pattern[] = "/tmp/staxys_error_log_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(pattern));
+    m_directory = pattern;
+    m_path = m_directory + "/error.log";
+  }
+
+  void TearDown() override { std::system(("rm -rf " + m_directory).c_str()); }
+
+  static std::string read(const std::string &path) {
+    std::ifstream file(path);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  }
+
+  std::string m_directory;
+  std::string m_path;
+};
+} // namespace
+
+TEST_F(ErrorLogTest, WritesRightAwayUntilStartedAndFromTheWriterAfter) {
+  ErrorLog log(m_path);
+  ASSERT_TRUE(log.open());
+  log.write("first\n");
+  ASSERT_EQ("first\n", read(m_path));
+
+  ASSERT_TRUE(log.start());
+  for (int i = 0; i < 100; ++i) {
+    log.write("line " + std::to_string(i) + "\n");
+  }
+  log.stop();
+  auto text = read(m_path);
+  ASSERT_EQ(0U, text.find("first\nline 0\n"));
+  ASSERT_EQ(text.size() - 8, text.find("line 99\n"));
+  ASSERT_EQ(0U, log.dropped());
+
+  log.write("last\n");
+  ASSERT_EQ("last\n", read(m_path).substr(text.size()));
+}
+
+TEST_F(ErrorLogTest, DropsLinesThatDoNotFit) {
+  ErrorLog log(m_path, 16, std::chrono::milliseconds(10));
+  ASSERT_TRUE(log.open());
+  ASSERT_TRUE(log.start());
+  log.write(std::string(32, 'x') + "\n");
+  log.write("fits\n");
+  log.stop();
+  ASSERT_EQ(1U, log.dropped());
+  ASSERT_EQ("fits\n", read(m_path));
+}
+
+TEST_F(ErrorLogTest, ReopensAfterRotation) {
+  ErrorLog log(m_path);
+  ASSERT_TRUE(log.open());
+  ASSERT_TRUE(log.start());
+  log.write("before\n");
+  auto rotated = m_path + ".1";
+  ASSERT_EQ(0, std::rename(m_path.c_str(), rotated.c_str()));
+  log.reopen();
+
+  struct stat info{};
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (stat(m_path.c_str(), &info) != 0 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  log.write("after\n");
+  log.stop();
+  ASSERT_EQ("before\n", read(rotated));
+  ASSERT_EQ("after\n", read(m_path));
+}
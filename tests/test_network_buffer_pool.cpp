@@ -0,0 +1,111 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/buffer_pool.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+
+using staxys::network::BufferPool;
+using staxys::network::ReadBuffer;
+
+TEST(BufferPoolTest, LendsTheSmallestBufferThatFits) {
+  BufferPool pool;
+  ASSERT_EQ(4096U, pool.acquire(1).capacity());
+  ASSERT_EQ(16384U, pool.acquire(4097).capacity());
+  ASSERT_EQ(65536U, pool.acquire(65536).capacity());
+  ASSERT_FALSE(pool.acquire(65537));
+}
+
+TEST(BufferPoolTest, ReusesReturnedBuffersAndTracksOccupancy) {
+  BufferPool pool;
+  char *first;
+  {
+    auto a = pool.acquire(100);
+    auto b = pool.acquire(100);
+    first = a.data();
+    ASSERT_EQ(2U, pool.stats()[0].in_use);
+  }
+  auto stats = pool.stats()[0];
+  ASSERT_EQ(0U, stats.in_use);
+  ASSERT_EQ(2U, stats.idle);
+  ASSERT_EQ(2U, stats.high_water);
+
+  // The most recently returned buffer goes out first.
+  auto again = pool.acquire(100);
+  ASSERT_EQ(first, again.data());
+  ASSERT_EQ(2U, pool.stats()[0].high_water);
+}
+
+TEST(BufferPoolTest, FreesBuffersBeyondTheIdleLimit) {
+  BufferPool pool(2 * 4096);
+  {
+    auto a = pool.acquire(1);
+    auto b = pool.acquire(1);
+    auto c = pool.acquire(1);
+  }
+  ASSERT_EQ(2U, pool.stats()[0].idle);
+  ASSERT_EQ(3U, pool.stats()[0].high_water);
+}
+
+TEST(ReadBufferTest, BorrowsOnlyWhileInputIsBuffered) {
+  BufferPool pool;
+  ReadBuffer buffer(pool);
+  ASSERT_TRUE(buffer.empty());
+  ASSERT_EQ(0U, pool.stats()[0].in_use);
+
+  ASSERT_TRUE(buffer.append("GET / HTTP/1.1\r\n", 16));
+  ASSERT_EQ(1U, pool.stats()[0].in_use);
+  buffer.consume(4);
+  ASSERT_EQ("/ HTTP/1.1\r\n", std::string_view(buffer.data(), buffer.size()));
+  buffer.consume(buffer.size());
+  ASSERT_TRUE(buffer.empty());
+  ASSERT_EQ(0U, pool.stats()[0].in_use);
+
+  // A read that came back empty gives the buffer back on trim().
+  ASSERT_FALSE(buffer.prepare().empty());
+  ASSERT_EQ(1U, pool.stats()[0].in_use);
+  buffer.trim();
+  ASSERT_EQ(0U, pool.stats()[0].in_use);
+}
+
+TEST(ReadBufferTest, GrowsThroughTheSizesUpToTheLargest) {
+  BufferPool pool;
+  ReadBuffer buffer(pool);
+  std::string received;
+  while (true) {
+    auto space = buffer.prepare();
+    if (space.empty()) {
+      break;
+    }
+    // Fill with a running pattern so moves between buffers can be checked.
+    for (auto &c : space) {
+      c = static_cast<char>('a' + received.size() % 26);
+      received.push_back(c);
+    }
+    buffer.commit(space.size());
+  }
+  ASSERT_EQ(65536U, buffer.size());
+  ASSERT_EQ(received, std::string(buffer.data(), buffer.size()));
+  ASSERT_FALSE(buffer.append("x", 1));
+
+  auto stats = pool.stats();
+  ASSERT_EQ(0U, stats[0].in_use);
+  ASSERT_EQ(0U, stats[1].in_use);
+  ASSERT_EQ(1U, stats[2].in_use);
+  ASSERT_EQ(1U, stats[0].idle);
+  ASSERT_EQ(1U, stats[1].idle);
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/byte_ranges.h"
+#include <gtest/gtest.h>
+
+using staxys::network::ByteRanges;
+
+namespace {
+/// The parsed ranges as "first+length" pairs, e.g. "0+100 200+50".
+std::string describe(const ByteRanges &ranges) {
+  std::string text;
+  for (std::size_t i = 0; i < ranges.count(); ++i) {
+    text += (i > 0 ? " " : "") + std::to_string(ranges[i].first) + "+" + std::to_string(ranges[i].length);
+  }
+  return text;
+}
+} // namespace
+
+TEST(ByteRangesTest, ParsesTheThreeForms) {
+  ByteRanges ranges;
+  ASSERT_EQ(ByteRanges::Result::SATISFIABLE, ranges.parse("bytes=0-99", 1000));
+  ASSERT_EQ("0+100", describe(ranges));
+  ASSERT_EQ(ByteRanges::Result::SATISFIABLE, ranges.parse("bytes=900-", 1000));
+  ASSERT_EQ("900+100", describe(ranges));
+  ASSERT_EQ(ByteRanges::Result::SATISFIABLE, ranges.parse("bytes=-10", 1000));
+  ASSERT_EQ("990+10", describe(ranges));
+  ASSERT_EQ(ByteRanges::Result::SATISFIABLE, ranges.parse("Bytes = 0-0 , 500-599,", 1000));
+  ASSERT_EQ("0+1 500+100", describe(ranges));
+}
+
+TEST(ByteRangesTest, ClampsToTheRepresentation) {
+  ByteRanges ranges;
+  ASSERT_EQ(ByteRanges::Result::SATISFIABLE, ranges.parse("bytes=900-5000", 1000));
+  ASSERT_EQ("900+100", describe(ranges));
+  ASSERT_EQ(ByteRanges::Result::SATISFIABLE, ranges.parse("bytes=-5000", 1000));
+  ASSERT_EQ("0+1000", describe(ranges));
+  ASSERT_EQ(ByteRanges::Result::SATISFIABLE, ranges.parse("bytes=1000-,0-9", 1000));
+  ASSERT_EQ("0+10", describe(ranges));
+}
+
+TEST(ByteRangesTest, ReportsUnsatisfiableRanges) {
+  ByteRanges ranges;
+  ASSERT_EQ(ByteRanges::Result::UNSATISFIABLE, ranges.parse("bytes=1000-", 1000));
+  ASSERT_EQ(ByteRanges::Result::UNSATISFIABLE, ranges.parse("bytes=-0", 1000));
+  ASSERT_EQ(ByteRanges::Result::UNSATISFIABLE, ranges.parse("bytes=0-", 0));
+}
+
+TEST(ByteRangesTest, IgnoresWhatItDoesNotUnderstand) {
+  ByteRanges ranges;
+  ASSERT_EQ(ByteRanges::Result::IGNORED, ranges.parse("items=0-1", 1000));
+  ASSERT_EQ(ByteRanges::Result::IGNORED, ranges.parse("bytes=5-1", 1000));
+  ASSERT_EQ(ByteRanges::Result::IGNORED, ranges.parse("bytes=a-b", 1000));
+  ASSERT_EQ(ByteRanges::Result::IGNORED, ranges.parse("bytes=10", 1000));
+  ASSERT_EQ(ByteRanges::Result::IGNORED, ranges.parse("bytes=", 1000));
+  ASSERT_EQ(ByteRanges::Result::IGNORED, ranges.parse("bytes=99999999999999999999-", 1000));
+}
+
+TEST(ByteRangesTest, MergesOverlappingAndAdjacentRanges) {
+  ByteRanges ranges;
+  ASSERT_EQ(ByteRanges::Result::SATISFIABLE, ranges.parse("bytes=500-599,0-9,10-19,550-700,-1", 1000));
+  ASSERT_EQ("0+20 500+201 999+1", describe(ranges));
+  ASSERT_EQ(ByteRanges::Result::SATISFIABLE, ranges.parse("bytes=0-,0-,0-,0-,0-,0-,0-,0-,0-,0-", 1000));
+  ASSERT_EQ("0+1000", describe(ranges));
+  ASSERT_EQ(ByteRanges::Result::SATISFIABLE, ranges.parse("bytes=50-59,30-39,10-19,20-29", 1000));
+  ASSERT_EQ("10+30 50+10", describe(ranges));
+}
+
+TEST(ByteRangesTest, IgnoresTooManySeparateRanges) {
+  ByteRanges ranges;
+  std::string header = "bytes=";
+  for (std::size_t i = 0; i < ByteRanges::MAX_RANGES; ++i) {
+    header += std::to_string(i * 10) + "-" + std::to_string(i * 10 + 1) + ",";
+  }
+  ASSERT_EQ(ByteRanges::Result::SATISFIABLE, ranges.parse(header, 1000));
+  ASSERT_EQ(ByteRanges::MAX_RANGES, ranges.count());
+  ASSERT_EQ(ByteRanges::Result::IGNORED, ranges.parse(header + "500-501", 1000));
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/compressor.h"
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+using staxys::network::BodyStream;
+using staxys::network::Compressor;
+using staxys::network::CompressorPool;
+using staxys::network::ContentCoding;
+
+namespace {
+std::string gunzip(const std::string &compressed) {
+  z_stream stream{};
+  inflateInit2(&stream, 15 + 16);
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(compressed.data()));
+  stream.avail_in = static_cast<uInt>(compressed.size());
+  std::string output;
+  char buffer[4096];
+  int result = Z_OK;
+  while (result == Z_OK) {
+    stream.next_out = reinterpret_cast<Bytef *>(buffer);
+    stream.avail_out = sizeof(buffer);
+    result = inflate(&stream, Z_NO_FLUSH);
+    output.append(buffer, sizeof(buffer) - stream.avail_out);
+  }
+  inflateEnd(&stream);
+  return result == Z_STREAM_END ? output : "<corrupt>";
+}
+
+/// Text that is larger than one buffer but compresses well.
+std::string sample_text() {
+  std::string text;
+  for (int i = 0; text.size() < 3 * Compressor::BUFFER_SIZE; ++i) {
+    text += "<li class=\"entry\">Entry number " + std::to_string(i) + "</li>\n";
+  }
+  return text;
+}
+} // namespace
+
+TEST(CompressorTest, CompressesMemoryInOneGo) {
+  Compressor compressor(ContentCoding::GZIP, 6);
+  ASSERT_TRUE(compressor.valid());
+  auto text = sample_text();
+  std::string compressed;
+  ASSERT_TRUE(compressor.compress(text, compressed));
+  ASSERT_LT(compressed.size(), text.size() / 4);
+  ASSERT_EQ(text, gunzip(compressed));
+
+  // The context is reusable.
+  ASSERT_TRUE(compressor.compress("", compressed));
+  ASSERT_EQ("", gunzip(compressed));
+}
+
+TEST(CompressorTest, StreamsAFileRangeInBoundedChunks) {
+  auto text = sample_text();
+  auto *temporary = std::tmpfile();
+  std::fputs(text.c_str(), temporary);
+  std::fflush(temporary);
+  struct stat info {};
+  fstat(fileno(temporary), &info);
+  auto file = std::make_shared<staxys::static_content::OpenFile>(dup(fileno(temporary)), info);
+  std::fclose(temporary);
+
+  Compressor compressor(ContentCoding::GZIP, 1);
+  compressor.start(file, 10, text.size() - 20);
+  std::string compressed;
+  std::string_view chunk;
+  int chunks = 0;
+  while (compressor.next(chunk) && !chunk.empty()) {
+    ASSERT_LE(chunk.size(), Compressor::BUFFER_SIZE);
+    compressed.append(chunk);
+    ++chunks;
+  }
+  ASSERT_GT(chunks, 0);
+  ASSERT_EQ(text.substr(10, text.size() - 20), gunzip(compressed));
+
+  // Asking for more than the file holds fails instead of ending early.
+  compressor.start(file, 0, text.size() + 1);
+  while (compressor.next(chunk)) {
+    ASSERT_FALSE(chunk.empty());
+  }
+}
+
+TEST(CompressorTest, PoolReusesContextsUpToItsCapacity) {
+  CompressorPool pool(6, 2);
+  ASSERT_TRUE(CompressorPool::supported() & ContentCoding::GZIP);
+  ASSERT_EQ(nullptr, pool.acquire(ContentCoding::BROTLI));
+
+  auto first = pool.acquire(ContentCoding::GZIP);
+  auto second = pool.acquire(ContentCoding::GZIP);
+  ASSERT_NE(nullptr, first);
+  ASSERT_NE(nullptr, second);
+  ASSERT_EQ(nullptr, pool.acquire(ContentCoding::GZIP));
+  ASSERT_EQ(2U, pool.size());
+
+  auto *context = first.get();
+  first.reset();
+  auto again = pool.acquire(ContentCoding::GZIP);
+  ASSERT_EQ(context, again.get());
+  ASSERT_EQ(2U, pool.size());
+
+  // Handed to a response as a BodyStream, it still goes back to the pool.
+  BodyStream::Ptr stream(again.release());
+  stream.reset();
+  ASSERT_EQ(context, pool.acquire(ContentCoding::GZIP).get());
+}
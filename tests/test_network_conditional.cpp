@@ -0,0 +1,77 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/conditional.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using staxys::network::Conditional;
+using staxys::network::Request;
+
+namespace {
+const std::string ETAG = "\"2ebc98a1-a\"";
+const std::string LAST_MODIFIED = "Sun, 06 Nov 1994 08:49:37 GMT";
+const time_t MODIFIED = 784111777;
+
+/// A parsed GET carrying \p headers, each ending in CRLF.
+struct Parsed {
+  explicit Parsed(const std::string &headers) : text("GET / HTTP/1.1\r\nHost: x\r\n" + headers + "\r\n") {
+    request.parse(text);
+  }
+  std::string text;
+  Request request;
+};
+} // namespace
+
+TEST(ConditionalTest, MatchesEntityTagsWeakly) {
+  ASSERT_TRUE(Conditional::etag_listed("*", ETAG, true));
+  ASSERT_TRUE(Conditional::etag_listed(ETAG, ETAG, true));
+  ASSERT_TRUE(Conditional::etag_listed("\"a,b\", W/" + ETAG, ETAG, true));
+  ASSERT_TRUE(Conditional::etag_listed(ETAG, "W/" + ETAG, true));
+  ASSERT_FALSE(Conditional::etag_listed("\"other\"", ETAG, true));
+  ASSERT_FALSE(Conditional::etag_listed("2ebc98a1-a", ETAG, true));
+  ASSERT_FALSE(Conditional::etag_listed("", ETAG, true));
+}
+
+TEST(ConditionalTest, StrongComparisonRefusesWeakTags) {
+  ASSERT_TRUE(Conditional::etag_listed(ETAG, ETAG, false));
+  ASSERT_FALSE(Conditional::etag_listed("W/" + ETAG, ETAG, false));
+  ASSERT_FALSE(Conditional::etag_listed(ETAG, "W/" + ETAG, false));
+}
+
+TEST(ConditionalTest, AnswersNotModified) {
+  ASSERT_FALSE(Conditional::not_modified(Parsed("").request, ETAG, MODIFIED));
+  ASSERT_TRUE(Conditional::not_modified(Parsed("If-None-Match: " + ETAG + "\r\n").request, ETAG, MODIFIED));
+  ASSERT_TRUE(
+      Conditional::not_modified(Parsed("If-Modified-Since: " + LAST_MODIFIED + "\r\n").request, ETAG, MODIFIED));
+  ASSERT_FALSE(
+      Conditional::not_modified(Parsed("If-Modified-Since: " + LAST_MODIFIED + "\r\n").request, ETAG, MODIFIED + 1));
+  ASSERT_FALSE(Conditional::not_modified(Parsed("If-Modified-Since: yesterday\r\n").request, ETAG, MODIFIED));
+
+  // If-None-Match wins over If-Modified-Since.
+  Parsed both("If-None-Match: \"other\"\r\nIf-Modified-Since: " + LAST_MODIFIED + "\r\n");
+  ASSERT_FALSE(Conditional::not_modified(both.request, ETAG, MODIFIED));
+}
+
+TEST(ConditionalTest, AppliesRangesOnlyToTheNamedRepresentation) {
+  ASSERT_TRUE(Conditional::range_applies(Parsed("").request, ETAG, LAST_MODIFIED));
+  ASSERT_TRUE(Conditional::range_applies(Parsed("If-Range: " + ETAG + "\r\n").request, ETAG, LAST_MODIFIED));
+  ASSERT_TRUE(Conditional::range_applies(Parsed("If-Range: " + LAST_MODIFIED + "\r\n").request, ETAG, LAST_MODIFIED));
+  ASSERT_FALSE(Conditional::range_applies(Parsed("If-Range: W/" + ETAG + "\r\n").request, ETAG, LAST_MODIFIED));
+  ASSERT_FALSE(Conditional::range_applies(Parsed("If-Range: \"other\"\r\n").request, ETAG, LAST_MODIFIED));
+  ASSERT_FALSE(Conditional::range_applies(Parsed("If-Range: Mon, 07 Nov 1994 08:49:37 GMT\r\n").request, ETAG,
+                                          LAST_MODIFIED));
+}
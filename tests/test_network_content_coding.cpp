@@ -0,0 +1,50 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/content_coding.h"
+#include <gtest/gtest.h>
+
+using staxys::network::ContentCoding;
+
+TEST(ContentCodingTest, AcceptsListedCodings) {
+  ASSERT_EQ(ContentCoding::GZIP | ContentCoding::BROTLI | ContentCoding::ZSTD,
+            ContentCoding::accepted("gzip, deflate, br, zstd"));
+  ASSERT_EQ(ContentCoding::GZIP, ContentCoding::accepted("deflate,gzip"));
+  ASSERT_EQ(0, ContentCoding::accepted(""));
+  ASSERT_EQ(0, ContentCoding::accepted("identity"));
+}
+
+TEST(ContentCodingTest, IgnoresCaseAndTreatsXGzipAsGzip) {
+  ASSERT_EQ(ContentCoding::GZIP | ContentCoding::BROTLI, ContentCoding::accepted(" GZip ,\tBR"));
+  ASSERT_EQ(ContentCoding::GZIP, ContentCoding::accepted("x-gzip"));
+}
+
+TEST(ContentCodingTest, RefusesCodingsWeightedZero) {
+  ASSERT_EQ(ContentCoding::GZIP, ContentCoding::accepted("gzip;q=0.5, br;q=0"));
+  ASSERT_EQ(ContentCoding::GZIP, ContentCoding::accepted("gzip; Q=1.000, br ; q=0.000"));
+  ASSERT_EQ(ContentCoding::BROTLI, ContentCoding::accepted("br;level=1;q=0.001, gzip;q=0.0"));
+}
+
+TEST(ContentCodingTest, StarCoversUnlistedCodings) {
+  ASSERT_EQ(ContentCoding::BROTLI | ContentCoding::ZSTD, ContentCoding::accepted("gzip;q=0, *"));
+  ASSERT_EQ(ContentCoding::GZIP, ContentCoding::accepted("gzip, *;q=0"));
+}
+
+TEST(ContentCodingTest, NamesCodings) {
+  ASSERT_EQ("gzip", ContentCoding::name(ContentCoding::GZIP));
+  ASSERT_EQ("br", ContentCoding::name(ContentCoding::BROTLI));
+  ASSERT_EQ("zstd", ContentCoding::name(ContentCoding::ZSTD));
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/server.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using staxys::network::Server;
+
+namespace {
+const std::string REQUEST = "GET /index.html HTTP/1.1\r\nHost: a\r\n\r\n";
+const std::size_t BODY_SIZE = 900;
+
+/// A Server on the epoll loop, listening on a free loopback port and serving
+/// a scratch static root.
+class EpollEventLoopTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    char pattern[] = "/tmp/staxys_epoll_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(pattern));
+    m_root = pattern;
+    std::ofstream(m_root + "/index.html") << std::string(BODY_SIZE, 'x');
+
+    // The port is only free until the server binds it, which is soon enough here.
+    int probe = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    ASSERT_GE(probe, 0);
+    m_address.sin_family = AF_INET;
+    m_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(0, bind(probe, reinterpret_cast<sockaddr *>(&m_address), sizeof(m_address)));
+    socklen_t length = sizeof(m_address);
+    ASSERT_EQ(0, getsockname(probe, reinterpret_cast<sockaddr *>(&m_address), &length));
+    close(probe);
+  }
+
+  void TearDown() override {
+    if (m_result.valid()) {
+      stop();
+    }
+    m_server.reset();
+    std::system(("rm -rf " + m_root).c_str());
+  }
+
+  /// Creates the server and binds its listener, without running the loop yet.
+  void listen(const int workerConnections = 1024) {
+    auto config = std::make_shared<staxys::config::EngineConfig>();
+    config->listen_ports({"127.0.0.1:" + std::to_string(ntohs(m_address.sin_port))});
+    config->io_backend("epoll");
+    config->worker_connections(workerConnections);
+    config->server_static_root(m_root);
+    m_server = std::make_unique<Server>(config);
+    ASSERT_TRUE(m_server->listen());
+  }
+
+  /// Runs the loop on a thread of its own.
+  void run() {
+    m_result = std::async(std::launch::async, [this] { return m_server->run(); });
+  }
+
+  /// Stops the loop and waits for run() to return.
+  void stop() {
+    m_server->stop();
+    ASSERT_EQ(std::future_status::ready, m_result.wait_for(std::chrono::seconds(5)));
+    ASSERT_EQ(EXIT_SUCCESS, m_result.get());
+  }
+
+  int connect_client() const {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    EXPECT_EQ(0, connect(fd, reinterpret_cast<const sockaddr *>(&m_address), sizeof(m_address)));
+    timeval timeout{5, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return fd;
+  }
+
+  /// Sends REQUEST on \p fd and reads the response to it.
+  /// \return Whether a complete 200 response came back.
+  static bool exchange(const int fd) {
+    if (send(fd, REQUEST.data(), REQUEST.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(REQUEST.size())) {
+      return false;
+    }
+    std::string received;
+    char buffer[4096];
+    while (true) {
+      auto head_end = received.find("\r\n\r\n");
+      if (head_end != std::string::npos && received.size() >= head_end + 4 + BODY_SIZE) {
+        return received.compare(0, 17, "HTTP/1.1 200 OK\r\n") == 0;
+      }
+      auto count = recv(fd, buffer, sizeof(buffer), 0);
+      if (count <= 0) {
+        return false;
+      }
+      received.append(buffer, static_cast<std::size_t>(count));
+    }
+  }
+
+  std::string m_root;
+  sockaddr_in m_address{};
+  std::unique_ptr<Server> m_server;
+  std::future<int> m_result;
+};
+} // namespace
+
+TEST_F(EpollEventLoopTest, ClosesConnectionsBeyondWorkerConnections) {
+  listen(2);
+  run();
+  auto first = connect_client();
+  auto second = connect_client();
+  ASSERT_TRUE(exchange(first));
+  ASSERT_TRUE(exchange(second));
+
+  // Accepted and closed at once, before it can send anything.
+  auto third = connect_client();
+  char byte;
+  auto count = recv(third, &byte, 1, 0);
+  ASSERT_TRUE(count == 0 || (count < 0 && errno == ECONNRESET)) << count;
+
+  ASSERT_TRUE(exchange(first));
+  ASSERT_TRUE(exchange(second));
+  close(first);
+  close(second);
+  close(third);
+}
+
+TEST_F(EpollEventLoopTest, AcceptsEveryQueuedConnectionOnOneEdge) {
+  // The connections wait in the backlog before the loop runs, so the listener
+  // becomes readable once for all of them.
+  listen();
+  std::vector<int> clients;
+  for (int i = 0; i < 32; ++i) {
+    clients.push_back(connect_client());
+  }
+  run();
+  for (auto client : clients) {
+    ASSERT_TRUE(exchange(client));
+  }
+  for (auto client : clients) {
+    close(client);
+  }
+}
+
+TEST_F(EpollEventLoopTest, ReusesKeepAliveConnections) {
+  listen();
+  run();
+  auto client = connect_client();
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(exchange(client));
+  }
+  close(client);
+  stop();
+  const auto &metrics = m_server->metrics().worker(0);
+  ASSERT_EQ(1U, metrics.connections_accepted.value());
+  ASSERT_EQ(100U, metrics.requests.value());
+}
+
+TEST_F(EpollEventLoopTest, StopsWhileIdle) {
+  listen();
+  run();
+  // Once a request has been answered the loop is known to be waiting in
+  // epoll_wait, from which only the wake fd brings it back.
+  auto client = connect_client();
+  ASSERT_TRUE(exchange(client));
+  stop();
+  close(client);
+}
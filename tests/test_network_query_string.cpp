@@ -0,0 +1,88 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/query_string.h"
+#include <array>
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using staxys::network::QueryString;
+
+TEST(QueryStringTest, SplitsParametersInOrder) {
+  QueryString query;
+  query.assign("a=1&b=&c&&a=2&d=x=y");
+  ASSERT_EQ(5U, query.size());
+  std::vector<std::pair<std::string_view, std::string_view>> parameters;
+  for (const auto &parameter : query) {
+    parameters.emplace_back(parameter.name, parameter.value);
+  }
+  std::vector<std::pair<std::string_view, std::string_view>> expected = {
+      {"a", "1"}, {"b", ""}, {"c", ""}, {"a", "2"}, {"d", "x=y"}};
+  ASSERT_EQ(expected, parameters);
+  ASSERT_EQ("1", query.find("a")->value);
+  ASSERT_EQ(2U, query.count("a"));
+  ASSERT_EQ(nullptr, query.find("e"));
+}
+
+TEST(QueryStringTest, EmptyQueryHasNoParameters) {
+  QueryString query;
+  ASSERT_TRUE(query.empty());
+  query.assign("&&");
+  ASSERT_TRUE(query.empty());
+  ASSERT_EQ("&&", query.raw());
+}
+
+TEST(QueryStringTest, DecodesNamesAndValuesOnDemand) {
+  QueryString query;
+  query.assign("first+name=Ada+Lovelace&x%26y=1%2B1%3D2&bad=%zz");
+  ASSERT_EQ("Ada+Lovelace", query.find("first name")->value);
+
+  std::pmr::string value;
+  ASSERT_TRUE(query.value("first name", value));
+  ASSERT_EQ("Ada Lovelace", value);
+  ASSERT_TRUE(query.value("x&y", value));
+  ASSERT_EQ("1+1=2", value);
+  ASSERT_FALSE(query.value("bad", value));
+  ASSERT_FALSE(query.value("missing", value));
+  ASSERT_EQ(nullptr, query.find("x%26y"));
+}
+
+TEST(QueryStringTest, DecodesInPlace) {
+  std::string text = "a+b%20c+";
+  text.resize(QueryString::decode(text, text.data()));
+  ASSERT_EQ("a b c ", text);
+  ASSERT_EQ(std::string_view::npos, QueryString::decode("a+%4", text.data()));
+}
+
+TEST(QueryStringTest, ParsesOnlyWhenRead) {
+  std::array<std::byte, 1024> storage;
+  std::pmr::monotonic_buffer_resource arena(storage.data(), storage.size(), std::pmr::null_memory_resource());
+  QueryString query(&arena);
+  query.assign("a=1&b=2");
+  auto *before = arena.allocate(1, 1);
+  ASSERT_EQ(2U, query.size());
+  auto *after = arena.allocate(1, 1);
+  // Splitting took memory from the arena in between, and only once.
+  ASSERT_GT(static_cast<std::byte *>(after) - static_cast<std::byte *>(before), 1);
+  auto *again = arena.allocate(1, 1);
+  ASSERT_EQ(query.find("b")->value, "2");
+  ASSERT_EQ(static_cast<std::byte *>(again) + 1, static_cast<std::byte *>(arena.allocate(1, 1)));
+
+  query.assign("c=3");
+  ASSERT_EQ("3", query.find("c")->value);
+}
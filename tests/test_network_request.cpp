@@ -0,0 +1,215 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/request.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using staxys::network::Request;
+
+namespace {
+const std::string SIMPLE_REQUEST = "GET /index.html?lang=en HTTP/1.1\r\n"
+                                   "Host: example.com\r\n"
+                                   "User-Agent:  curl/8.0 \r\n"
+                                   "Accept: */*\r\n"
+                                   "\r\n";
+} // namespace
+
+TEST(RequestTest, ParsesRequestLineAndHeaders) {
+  Request request;
+  ASSERT_EQ(Request::Status::COMPLETE, request.parse(SIMPLE_REQUEST));
+  ASSERT_EQ("GET", request.method());
+  ASSERT_EQ("/index.html?lang=en", request.target());
+  ASSERT_EQ("HTTP/1.1", request.version());
+  ASSERT_EQ(1, request.minor_version());
+  ASSERT_TRUE(request.keep_alive());
+  ASSERT_EQ(3U, request.header_count());
+  ASSERT_EQ("Host", request.header(0).name);
+  ASSERT_EQ("example.com", request.header(0).value);
+  ASSERT_EQ("curl/8.0", request.header("user-agent"));
+  ASSERT_EQ("", request.header("Referer"));
+  ASSERT_EQ(SIMPLE_REQUEST.size(), request.size());
+}
+
+TEST(RequestTest, SlicesPointIntoTheInput) {
+  Request request;
+  ASSERT_EQ(Request::Status::COMPLETE, request.parse(SIMPLE_REQUEST));
+  ASSERT_EQ(SIMPLE_REQUEST.data(), request.method().data());
+  ASSERT_EQ(SIMPLE_REQUEST.data() + SIMPLE_REQUEST.find("example.com"), request.header("Host").data());
+}
+
+TEST(RequestTest, ResumesAtEverySplitPoint) {
+  for (std::size_t split = 0; split <= SIMPLE_REQUEST.size(); ++split) {
+    Request request;
+    std::string buffer = SIMPLE_REQUEST.substr(0, split);
+    auto first = request.parse(buffer);
+    if (split < SIMPLE_REQUEST.size()) {
+      ASSERT_EQ(Request::Status::INCOMPLETE, first) << "split at " << split;
+    }
+    buffer = SIMPLE_REQUEST;
+    ASSERT_EQ(Request::Status::COMPLETE, request.parse(buffer)) << "split at " << split;
+    ASSERT_EQ("/index.html?lang=en", request.target());
+    ASSERT_EQ("curl/8.0", request.header("User-Agent"));
+  }
+}
+
+TEST(RequestTest, ResumesByteByByte) {
+  Request request;
+  std::string buffer;
+  for (auto c : SIMPLE_REQUEST) {
+    ASSERT_EQ(Request::Status::INCOMPLETE, request.status());
+    buffer.push_back(c);
+    buffer.shrink_to_fit();
+    request.parse(buffer);
+  }
+  ASSERT_EQ(Request::Status::COMPLETE, request.status());
+  ASSERT_EQ("*/*", request.header("Accept"));
+}
+
+TEST(RequestTest, ParsesPipelinedRequests) {
+  std::string buffer = SIMPLE_REQUEST + "HEAD /second HTTP/1.1\r\nHost: a\r\n\r\n" + "GET /thi";
+  Request request;
+  ASSERT_EQ(Request::Status::COMPLETE, request.parse(buffer));
+  buffer.erase(0, request.size());
+  request.reset();
+
+  ASSERT_EQ(Request::Status::COMPLETE, request.parse(buffer));
+  ASSERT_EQ("HEAD", request.method());
+  ASSERT_EQ("/second", request.target());
+  buffer.erase(0, request.size());
+  request.reset();
+
+  ASSERT_EQ(Request::Status::INCOMPLETE, request.parse(buffer));
+}
+
+TEST(RequestTest, WaitsForContentLengthBody) {
+  std::string buffer = "POST /form HTTP/1.1\r\nHost: a\r\nContent-Length: 5\r\n\r\nab";
+  Request request;
+  ASSERT_EQ(Request::Status::INCOMPLETE, request.parse(buffer));
+  buffer += "cdeGET";
+  ASSERT_EQ(Request::Status::COMPLETE, request.parse(buffer));
+  ASSERT_EQ(5U, request.content_length());
+  ASSERT_EQ("abcde", request.body());
+  ASSERT_EQ(buffer.size() - 3, request.size());
+}
+
+TEST(RequestTest, AcceptsBareLineFeedsAndLeadingBlankLines) {
+  Request request;
+  ASSERT_EQ(Request::Status::COMPLETE, request.parse("\r\n\nGET / HTTP/1.1\nHost: a\n\n"));
+  ASSERT_EQ("/", request.target());
+  ASSERT_EQ("a", request.header("host"));
+}
+
+TEST(RequestTest, AppliesConnectionSemantics) {
+  Request request;
+  ASSERT_EQ(Request::Status::COMPLETE, request.parse("GET / HTTP/1.0\r\n\r\n"));
+  ASSERT_FALSE(request.keep_alive());
+
+  request.reset();
+  ASSERT_EQ(Request::Status::COMPLETE, request.parse("GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n"));
+  ASSERT_TRUE(request.keep_alive());
+
+  request.reset();
+  ASSERT_EQ(Request::Status::COMPLETE, request.parse("GET / HTTP/1.1\r\nHost: a\r\nConnection: te, close\r\n\r\n"));
+  ASSERT_FALSE(request.keep_alive());
+}
+
+TEST(RequestTest, RejectsMalformedRequests) {
+  const char *requests[] = {
+      "GET  / HTTP/1.1\r\nHost: a\r\n\r\n",
+      "GET /\r\n\r\n",
+      "G@T / HTTP/1.1\r\nHost: a\r\n\r\n",
+      "GET / HTTP/1.1\r\nHost : a\r\n\r\n",
+      "GET / HTTP/1.1\r\nHost: a\r\n folded\r\n\r\n",
+      "GET / HTTP/1.1\r\nNo colon\r\n\r\n",
+      "GET / HTTP/1.1\r\n\r\n",
+      "GET / HTTP/1.1\r\nHost: a\r\nHost: b\r\n\r\n",
+      "GET / HTTP/1.1\r\nHost: a\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n",
+      "GET / HTTP/1.1\r\nHost: a\r\nContent-Length: -1\r\n\r\n",
+      "GET / HTTP/1.1\r\nHost: a\x01\r\n\r\n",
+      "GET / HTTQ/1.1\r\nHost: a\r\n\r\n",
+  };
+  for (auto text : requests) {
+    Request request;
+    ASSERT_EQ(Request::Status::BAD_REQUEST, request.parse(text)) << text;
+    ASSERT_TRUE(request.failed());
+  }
+}
+
+TEST(RequestTest, ReportsUnsupportedFeatures) {
+  Request request;
+  ASSERT_EQ(Request::Status::VERSION_NOT_SUPPORTED, request.parse("GET / HTTP/2.0\r\n\r\n"));
+
+  request.reset();
+  ASSERT_EQ(Request::Status::NOT_IMPLEMENTED,
+            request.parse("POST / HTTP/1.1\r\nHost: a\r\nTransfer-Encoding: chunked\r\n\r\n"));
+}
+
+TEST(RequestTest, EnforcesHeadSizeLimit) {
+  Request request(64);
+  ASSERT_EQ(Request::Status::URI_TOO_LONG, request.parse("GET /" + std::string(100, 'a')));
+
+  request.reset();
+  ASSERT_EQ(Request::Status::HEADERS_TOO_LARGE,
+            request.parse("GET / HTTP/1.1\r\nHost: a\r\nX-Long: " + std::string(100, 'b') + "\r\n\r\n"));
+
+  request.reset();
+  ASSERT_EQ(Request::Status::INCOMPLETE, request.parse("GET / HTTP/1.1\r\nHost: a\r\n"));
+}
+
+TEST(RequestTest, EnforcesBodySizeLimits) {
+  const std::string head = "POST /form HTTP/1.1\r\nHost: a\r\nContent-Length: ";
+  Request request;
+  request.limit_size(10, 100);
+  ASSERT_EQ(Request::Status::COMPLETE, request.parse(head + "10\r\n\r\n0123456789"));
+
+  // Refused as soon as the head is complete, before any of the body.
+  request.reset();
+  ASSERT_EQ(Request::Status::PAYLOAD_TOO_LARGE, request.parse(head + "11\r\n\r\n"));
+  request.reset();
+  ASSERT_EQ(Request::Status::PAYLOAD_TOO_LARGE, request.parse(head + "999999999999999\r\n\r\n"));
+
+  // The head counts towards the size of the whole request.
+  request.limit_size(100, 61);
+  request.reset();
+  ASSERT_EQ(Request::Status::PAYLOAD_TOO_LARGE, request.parse(head + "10\r\n\r\n"));
+  request.limit_size(100, 62);
+  request.reset();
+  ASSERT_EQ(Request::Status::COMPLETE, request.parse(head + "10\r\n\r\n0123456789"));
+}
+
+TEST(RequestTest, EnforcesHeaderCountLimit) {
+  std::string text = "GET / HTTP/1.1\r\nHost: a\r\n";
+  for (int i = 0; i < 4; ++i) {
+    text += "X-Header: " + std::to_string(i) + "\r\n";
+  }
+  text += "\r\n";
+
+  Request request(Request::MAX_HEAD_SIZE, 4);
+  ASSERT_EQ(Request::Status::HEADERS_TOO_LARGE, request.parse(text));
+
+  Request larger(Request::MAX_HEAD_SIZE, 5);
+  ASSERT_EQ(Request::Status::COMPLETE, larger.parse(text));
+  ASSERT_EQ(5U, larger.header_count());
+}
+
+TEST(RequestTest, ErrorsAreSticky) {
+  Request request;
+  ASSERT_EQ(Request::Status::BAD_REQUEST, request.parse("BAD\r\n"));
+  ASSERT_EQ(Request::Status::BAD_REQUEST, request.parse(SIMPLE_REQUEST));
+  request.reset();
+  ASSERT_EQ(Request::Status::COMPLETE, request.parse(SIMPLE_REQUEST));
+}
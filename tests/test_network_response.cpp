@@ -0,0 +1,271 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/response.h"
+#include <algorithm>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <memory>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using staxys::network::Response;
+
+namespace {
+/// Concatenates what gather() would hand to writev.
+std::string serialize(const Response &response) {
+  iovec vectors[Response::MAX_SEGMENTS];
+  auto count = response.gather(vectors, Response::MAX_SEGMENTS);
+  std::string output;
+  for (std::size_t i = 0; i < count; ++i) {
+    output.append(static_cast<const char *>(vectors[i].iov_base), vectors[i].iov_len);
+  }
+  return output;
+}
+} // namespace
+
+TEST(ResponseTest, SerializesStatusLineHeadersAndBody) {
+  const std::string body = "hello";
+  Response response(200);
+  response.header("Content-Type", "text/plain").content_length(body.size()).keep_alive(true).finish(body);
+
+  auto output = serialize(response);
+  ASSERT_TRUE(response.finished());
+  ASSERT_EQ(output.size(), response.size());
+  ASSERT_EQ(0U, output.find("HTTP/1.1 200 OK\r\nServer: staxys\r\nDate: "));
+  ASSERT_NE(std::string::npos, output.find("\r\nContent-Type: text/plain\r\n"));
+  ASSERT_NE(std::string::npos, output.find("\r\nContent-Length: 5\r\n"));
+  ASSERT_NE(std::string::npos, output.find("\r\nConnection: keep-alive\r\n\r\nhello"));
+  ASSERT_EQ(5, response.body_size());
+}
+
+TEST(ResponseTest, FormatsDateAsImfFixdate) {
+  Response response(404);
+  response.content_length(0).keep_alive(false).finish();
+
+  auto output = serialize(response);
+  std::regex date(R"(\r\nDate: (Mon|Tue|Wed|Thu|Fri|Sat|Sun), \d{2} )"
+                  R"((Jan|Feb|Mar|Apr|May|Jun|Jul|Aug|Sep|Oct|Nov|Dec) \d{4} \d{2}:\d{2}:\d{2} GMT\r\n)");
+  ASSERT_TRUE(std::regex_search(output, date)) << output;
+  ASSERT_NE(std::string::npos, output.find("Connection: close\r\n\r\n"));
+}
+
+TEST(ResponseTest, FormatsUnknownStatusCodes) {
+  Response response(299);
+  response.finish();
+  ASSERT_EQ(0U, serialize(response).find("HTTP/1.1 299 \r\n"));
+  ASSERT_EQ("Not Found", Response::reason(404));
+  ASSERT_EQ("", Response::reason(299));
+}
+
+TEST(ResponseTest, ReferencesValuesAndCopiesOnRequest) {
+  std::string value = "abc";
+  Response referenced(200);
+  referenced.header("X-Test", value).finish();
+  Response copied(200);
+  copied.header_copy("X-Test", value).finish();
+  value[0] = 'z';
+
+  ASSERT_NE(std::string::npos, serialize(referenced).find("X-Test: zbc\r\n"));
+  ASSERT_NE(std::string::npos, serialize(copied).find("X-Test: abc\r\n"));
+}
+
+TEST(ResponseTest, MergesConsecutiveCopiesIntoOneSegment) {
+  Response response(200);
+  iovec vectors[Response::MAX_SEGMENTS];
+  // Status line, then the Server and Date lines in scratch.
+  ASSERT_EQ(2U, response.gather(vectors, Response::MAX_SEGMENTS));
+  response.content_length(0);
+  ASSERT_EQ(2U, response.gather(vectors, Response::MAX_SEGMENTS));
+}
+
+TEST(ResponseTest, ResumesAfterPartialWrites) {
+  const std::string body(100, 'x');
+  Response response(200);
+  response.content_length(body.size()).keep_alive(true).finish(body);
+  auto expected = serialize(response);
+
+  std::string written;
+  iovec vectors[Response::MAX_SEGMENTS];
+  while (response.remaining() > 0) {
+    auto count = response.gather(vectors, 2);
+    ASSERT_GT(count, 0U);
+    // Write 7 bytes at a time, which splits most segments somewhere inside.
+    std::size_t chunk = std::min<std::size_t>(7, vectors[0].iov_len);
+    written.append(static_cast<const char *>(vectors[0].iov_base), chunk);
+    ASSERT_EQ(0U, response.advance(chunk));
+  }
+  ASSERT_EQ(expected, written);
+  ASSERT_EQ(5U, response.advance(5));
+}
+
+TEST(ResponseTest, ResetStartsOver) {
+  Response response(200);
+  response.content_length(3).finish("abc");
+  response.advance(response.size());
+  response.reset(204);
+  ASSERT_FALSE(response.finished());
+  ASSERT_EQ(204, response.status());
+  ASSERT_EQ(response.size(), response.remaining());
+  ASSERT_EQ(0U, serialize(response).find("HTTP/1.1 204 No Content\r\n"));
+}
+
+TEST(ResponseTest, ThrowsWhenSegmentsRunOut) {
+  Response response(200);
+  ASSERT_THROW(
+      {
+        for (int i = 0; i < 10; ++i) {
+          response.header("X-Header", "value");
+        }
+      },
+      std::length_error);
+}
+
+TEST(ResponseTest, StopsGatheringAtAFileBody) {
+  auto *temporary = std::tmpfile();
+  std::fputs("0123456789", temporary);
+  std::fflush(temporary);
+  struct stat info {};
+  fstat(fileno(temporary), &info);
+  auto file = std::make_shared<staxys::static_content::OpenFile>(dup(fileno(temporary)), info);
+  std::fclose(temporary);
+
+  Response response(200);
+  response.content_length(4).finish(file, 3, 4);
+  ASSERT_EQ(serialize(response).size() + 4, response.size());
+
+  Response::FileRange range{};
+  ASSERT_FALSE(response.pending_file(range));
+  ASSERT_TRUE(response.next_file(range));
+  ASSERT_EQ(3, range.offset);
+  ASSERT_EQ(4U, range.length);
+  response.advance(response.size() - 4);
+  ASSERT_TRUE(response.pending_file(range));
+  ASSERT_EQ(file->fd(), range.fd);
+  ASSERT_EQ(3, range.offset);
+  ASSERT_EQ(4U, range.length);
+
+  response.advance(1);
+  ASSERT_TRUE(response.pending_file(range));
+  ASSERT_EQ(4, range.offset);
+  ASSERT_EQ(3U, range.length);
+  ASSERT_TRUE(response.next_file(range));
+  ASSERT_EQ(4, range.offset);
+  ASSERT_EQ(3U, range.length);
+  response.advance(3);
+  ASSERT_FALSE(response.pending_file(range));
+  ASSERT_FALSE(response.next_file(range));
+  ASSERT_EQ(0U, response.remaining());
+}
+
+namespace {
+/// Hands out the given pieces, then ends or fails.
+class PieceStream final : public staxys::network::BodyStream {
+public:
+  PieceStream(std::vector<std::string> pieces, bool fail) : m_pieces(std::move(pieces)), m_fail(fail) {}
+
+  bool next(std::string_view &chunk) override {
+    if (m_next == m_pieces.size()) {
+      chunk = {};
+      return !m_fail;
+    }
+    chunk = m_pieces[m_next++];
+    return true;
+  }
+
+  void release() override { released = true; }
+
+  bool released = false;
+
+private:
+  std::vector<std::string> m_pieces;
+  std::size_t m_next = 0;
+  bool m_fail;
+};
+
+/// Writes a response out completely, as a loop would.
+std::string drain(Response &response) {
+  std::string written;
+  while (response.remaining() > 0) {
+    auto chunk = serialize(response);
+    written += chunk;
+    response.advance(chunk.size());
+  }
+  return written;
+}
+} // namespace
+
+TEST(ResponseTest, StreamsABodyAsChunks) {
+  PieceStream stream({"hello", std::string(300, 'x')}, false);
+  Response response(200);
+  response.keep_alive(true).finish(staxys::network::BodyStream::Ptr(&stream));
+  ASSERT_TRUE(response.streaming());
+  ASSERT_EQ(-1, response.body_size());
+
+  auto output = drain(response);
+  ASSERT_NE(std::string::npos, output.find("\r\nTransfer-Encoding: chunked\r\n"));
+  auto body = output.substr(output.find("\r\n\r\n") + 4);
+  ASSERT_EQ("5\r\nhello\r\n12c\r\n" + std::string(300, 'x') + "\r\n0\r\n\r\n", body);
+  ASSERT_FALSE(response.streaming());
+  ASSERT_FALSE(response.failed());
+  ASSERT_TRUE(stream.released);
+}
+
+TEST(ResponseTest, MarksABrokenStreamAsFailed) {
+  PieceStream stream({"hello"}, true);
+  Response response(200);
+  response.finish(staxys::network::BodyStream::Ptr(&stream));
+
+  auto output = drain(response);
+  ASSERT_EQ(std::string::npos, output.find("0\r\n\r\n"));
+  ASSERT_TRUE(response.failed());
+  ASSERT_TRUE(stream.released);
+}
+
+TEST(ResponseTest, InterleavesBodyPartsWithFileRanges) {
+  auto *temporary = std::tmpfile();
+  std::fputs("0123456789", temporary);
+  std::fflush(temporary);
+  struct stat info {};
+  fstat(fileno(temporary), &info);
+  auto file = std::make_shared<staxys::static_content::OpenFile>(dup(fileno(temporary)), info);
+  std::fclose(temporary);
+
+  Response response(206);
+  response.finish().body("[").body(file, 2, 3).body("][").body(file, 7, 2).body("]");
+  ASSERT_EQ(serialize(response).size() + 3 + 2 + 2 + 1, response.size());
+
+  // Memory before a file range goes out, then the range, then what follows.
+  std::string written;
+  Response::FileRange range{};
+  while (response.remaining() > 0) {
+    if (response.pending_file(range)) {
+      std::string part(range.length, '\0');
+      ASSERT_EQ(static_cast<ssize_t>(range.length), pread(range.fd, part.data(), range.length, range.offset));
+      written += part;
+      response.advance(range.length);
+      continue;
+    }
+    auto chunk = serialize(response);
+    written += chunk;
+    response.advance(chunk.size());
+  }
+  ASSERT_EQ("[234][78]", written.substr(written.find("\r\n\r\n") + 4));
+}
@@ -0,0 +1,307 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/server.h"
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Counts global-heap allocations made by this thread while counting is on;
+// replacing the global operators covers every test in the binary, but only
+// the tests below switch counting on.
+namespace {
+thread_local bool counting = false;
+thread_local std::size_t allocations = 0;
+
+void *counted_allocation(const std::size_t size) {
+  if (counting) {
+    ++allocations;
+  }
+  if (auto memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+} // namespace
+
+void *operator new(const std::size_t size) { return counted_allocation(size); }
+void *operator new[](const std::size_t size) { return counted_allocation(size); }
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t) noexcept { std::free(memory); }
+
+using staxys::network::BufferPool;
+using staxys::network::Connection;
+using staxys::network::Server;
+
+namespace {
+/// A server over a scratch static root, answering on one end of a socket pair.
+class ServerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    char pattern[] = "/tmp/staxys_server_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(pattern));
+    m_root = pattern;
+    std::ofstream(m_root + "/index.html") << std::string(900, 'x');
+    std::ofstream(m_root + "/style.css") << std::string(300, 'y');
+  }
+
+  void TearDown() override { std::system(("rm -rf " + m_root).c_str()); }
+
+  std::unique_ptr<Server> make_server(const bool cache, const std::string &accessLog = "") {
+    auto config = std::make_shared<staxys::config::EngineConfig>();
+    config->server_static_root(m_root);
+    config->cache_enabled(cache);
+    config->access_log(accessLog);
+    return std::make_unique<Server>(config);
+  }
+
+  /// Has \p server answer \p request and reads the response off the socket.
+  /// \return The bytes the client received.
+  static std::size_t exchange(Server &server, Connection &connection, const int peer, const std::string &request) {
+    connection.read_buffer().append(request.data(), request.size());
+    EXPECT_TRUE(server.process(connection));
+    EXPECT_EQ(Connection::FlushResult::DONE, connection.flush());
+    std::size_t received = 0;
+    char buffer[4096];
+    ssize_t count;
+    while ((count = read(peer, buffer, sizeof(buffer))) > 0) {
+      received += static_cast<std::size_t>(count);
+    }
+    return received;
+  }
+
+  /// Allocations made by \p rounds exchanges once the first two have warmed up
+  /// the caches, pools and queues, on a connection counting into \p metrics.
+  std::size_t steady_state_allocations(Server &server, const std::string &request, const int rounds = 100,
+                                       staxys::core::WorkerMetrics *metrics = nullptr) {
+    int sockets[2];
+    EXPECT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sockets));
+    Connection connection(sockets[0], m_buffers, &m_arenas, metrics);
+    exchange(server, connection, sockets[1], request);
+    exchange(server, connection, sockets[1], request);
+    allocations = 0;
+    counting = true;
+    std::size_t received = 0;
+    for (int round = 0; round < rounds; ++round) {
+      received += exchange(server, connection, sockets[1], request);
+    }
+    counting = false;
+    close(sockets[1]);
+    EXPECT_GT(received, 0U);
+    return allocations;
+  }
+
+  std::string m_root;
+  BufferPool m_buffers;
+  std::pmr::unsynchronized_pool_resource m_arenas;
+};
+} // namespace
+
+TEST_F(ServerTest, SendsFilesWithoutAllocating) {
+  auto server = make_server(false);
+  ASSERT_EQ(0U, steady_state_allocations(*server, "GET /index.html HTTP/1.1\r\nHost: a\r\n\r\n"));
+}
+
+TEST_F(ServerTest, AnswersFromTheCacheWithoutAllocating) {
+  auto server = make_server(true);
+  ASSERT_EQ(0U, steady_state_allocations(
+                    *server, "GET /style.css HTTP/1.1\r\nHost: a\r\nAccept-Encoding: gzip\r\n\r\n"));
+}
+
+TEST_F(ServerTest, RevalidatesWithoutAllocating) {
+  auto server = make_server(true);
+  ASSERT_EQ(0U, steady_state_allocations(
+                    *server, "GET / HTTP/1.1\r\nHost: a\r\nIf-Modified-Since: Fri, 01 Jan 2100 00:00:00 GMT\r\n\r\n"));
+}
+
+TEST_F(ServerTest, AnswersRangesAndMissesWithoutAllocating) {
+  auto server = make_server(false);
+  ASSERT_EQ(0U, steady_state_allocations(*server, "GET /index.html HTTP/1.1\r\nHost: a\r\nRange: bytes=0-99\r\n\r\n"));
+  ASSERT_EQ(0U, steady_state_allocations(*server, "GET /missing.html HTTP/1.1\r\nHost: a\r\n\r\n"));
+}
+
+TEST_F(ServerTest, BuildsMultipartBodiesInTheRequestArena) {
+  auto server = make_server(false);
+  ASSERT_EQ(0U, steady_state_allocations(
+                    *server, "GET /index.html HTTP/1.1\r\nHost: a\r\nRange: bytes=0-9,20-29,100-\r\n\r\n"));
+}
+
+TEST_F(ServerTest, ResolvesNormalizedPathsWithoutAllocating) {
+  auto server = make_server(false);
+  ASSERT_EQ(0U, steady_state_allocations(*server, "GET /docs/./../%69ndex.html HTTP/1.1\r\nHost: a\r\n\r\n"));
+}
+
+TEST_F(ServerTest, LogsRequestsWithoutAllocating) {
+  auto server = make_server(false, m_root + "/access.log");
+  ASSERT_NE(nullptr, server->access_log());
+  ASSERT_EQ(0U, steady_state_allocations(
+                    *server, "GET /index.html HTTP/1.1\r\nHost: a\r\nUser-Agent: test \"quoted\"\r\n\r\n", 10));
+  ASSERT_EQ(12U, server->access_log()->stats().lines);
+  server.reset();
+
+  std::ifstream log(m_root + "/access.log");
+  std::string line;
+  std::size_t lines = 0;
+  // A socket pair has no address to log.
+  const std::string expected = R"( +0000] "GET /index.html HTTP/1.1" 200 900 "-" "test \x22quoted\x22")";
+  while (std::getline(log, line)) {
+    ++lines;
+    ASSERT_EQ(0U, line.find("- - [")) << line;
+    ASSERT_EQ(line.size() - expected.size(), line.find(expected)) << line;
+  }
+  ASSERT_EQ(12U, lines);
+}
+
+TEST_F(ServerTest, StopsAnsweringPipelinedRequestsWhileTheResponsesAreUnsent) {
+  auto server = make_server(false);
+  int sockets[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sockets));
+  Connection connection(sockets[0], m_buffers, &m_arenas);
+  const std::string request = "GET /index.html HTTP/1.1\r\nHost: a\r\n\r\n";
+  std::string requests;
+  for (int i = 0; i < 100; ++i) {
+    requests += request;
+  }
+  connection.read_buffer().append(requests.data(), requests.size());
+
+  // The client reads nothing, so the queue stops growing however often it is served.
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(server->process(connection));
+    ASSERT_TRUE(connection.output_backlogged());
+    ASSERT_EQ(Connection::MAX_QUEUED_RESPONSES, connection.queued_responses());
+    ASSERT_EQ(requests.size() - Connection::MAX_QUEUED_RESPONSES * request.size(), connection.read_buffer().size());
+  }
+
+  // Once the client reads, the rest are answered.
+  std::string received;
+  char buffer[4096];
+  while (!connection.read_buffer().empty() || connection.has_pending_output()) {
+    ASSERT_TRUE(server->process(connection));
+    ASSERT_LE(connection.queued_responses(), Connection::MAX_QUEUED_RESPONSES);
+    ASSERT_NE(Connection::FlushResult::FAILED, connection.flush());
+    ssize_t count;
+    while ((count = read(sockets[1], buffer, sizeof(buffer))) > 0) {
+      received.append(buffer, static_cast<std::size_t>(count));
+    }
+  }
+  close(sockets[1]);
+  std::size_t responses = 0;
+  for (auto at = received.find("HTTP/1.1 200 OK\r\n"); at != std::string::npos;
+       at = received.find("HTTP/1.1 200 OK\r\n", at + 1)) {
+    ++responses;
+  }
+  ASSERT_EQ(100U, responses);
+}
+
+TEST_F(ServerTest, RedirectsLongDirectoryPaths) {
+  const std::string directory = "/" + std::string(200, 'd');
+  ASSERT_EQ(0, mkdir((m_root + directory).c_str(), 0755));
+  auto server = make_server(false);
+  int sockets[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sockets));
+  Connection connection(sockets[0], m_buffers, &m_arenas);
+  const std::string request = "GET " + directory + "?q HTTP/1.1\r\nHost: a\r\n\r\n";
+  connection.read_buffer().append(request.data(), request.size());
+  ASSERT_TRUE(server->process(connection));
+  ASSERT_EQ(Connection::FlushResult::DONE, connection.flush());
+  char buffer[4096];
+  auto count = read(sockets[1], buffer, sizeof(buffer));
+  close(sockets[1]);
+  ASSERT_GT(count, 0);
+  std::string_view response(buffer, static_cast<std::size_t>(count));
+  ASSERT_EQ(0U, response.find("HTTP/1.1 301 Moved Permanently\r\n")) << response;
+  ASSERT_NE(std::string_view::npos, response.find("\r\nLocation: " + directory + "/\r\n")) << response;
+}
+
+TEST_F(ServerTest, RefusesBodiesBeyondTheLimit) {
+  auto server = make_server(false);
+  int sockets[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sockets));
+  Connection connection(sockets[0], m_buffers, &m_arenas);
+  connection.request().limit_size(1024, 64 * 1024);
+  const std::string request = "POST /upload HTTP/1.1\r\nHost: a\r\nContent-Length: 100000\r\n\r\n";
+  connection.read_buffer().append(request.data(), request.size());
+  ASSERT_TRUE(server->process(connection));
+  ASSERT_TRUE(connection.close_after_write());
+  ASSERT_EQ(Connection::FlushResult::DONE, connection.flush());
+  char buffer[4096];
+  auto count = read(sockets[1], buffer, sizeof(buffer));
+  close(sockets[1]);
+  ASSERT_GT(count, 0);
+  ASSERT_EQ(0U, std::string_view(buffer, static_cast<std::size_t>(count)).find("HTTP/1.1 413 Content Too Large\r\n"));
+}
+
+TEST_F(ServerTest, AnswersHealthChecksWithoutAllocating) {
+  auto config = std::make_shared<staxys::config::EngineConfig>();
+  config->server_static_root(m_root);
+  config->health_check_enabled(true);
+  config->health_check_url("/healthz");
+  Server server(config);
+  ASSERT_EQ(0U, steady_state_allocations(server, "GET /healthz?probe=1 HTTP/1.1\r\nHost: a\r\n\r\n"));
+  ASSERT_EQ(102U, server.metrics().worker(0).responses[1].value());
+}
+
+TEST_F(ServerTest, ServesMetrics) {
+  auto config = std::make_shared<staxys::config::EngineConfig>();
+  config->server_static_root(m_root);
+  config->metrics_url("/metrics");
+  config->request_timing(true);
+  auto metrics = staxys::core::Metrics::create(1);
+  ASSERT_NE(nullptr, metrics);
+  auto &worker = metrics->worker(0);
+  Server server(config, metrics.get(), 0);
+  ASSERT_EQ(0U, steady_state_allocations(server, "GET /index.html HTTP/1.1\r\nHost: a\r\n\r\n", 8, &worker));
+  ASSERT_EQ(0U, steady_state_allocations(server, "GET /missing.html HTTP/1.1\r\nHost: a\r\n\r\n", 1, &worker));
+  ASSERT_EQ(13U, worker.phases[staxys::core::WorkerMetrics::SEND].count());
+
+  int sockets[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sockets));
+  Connection connection(sockets[0], m_buffers, &m_arenas, &worker);
+  auto sent = worker.bytes_sent.value();
+  const std::string request = "GET /metrics HTTP/1.1\r\nHost: a\r\n\r\n";
+  connection.read_buffer().append(request.data(), request.size());
+  ASSERT_TRUE(server.process(connection));
+  ASSERT_EQ(Connection::FlushResult::DONE, connection.flush());
+  std::string response;
+  char buffer[4096];
+  ssize_t count;
+  while ((count = read(sockets[1], buffer, sizeof(buffer))) > 0) {
+    response.append(buffer, static_cast<std::size_t>(count));
+  }
+  close(sockets[1]);
+
+  ASSERT_EQ(0U, response.find("HTTP/1.1 200 OK\r\n"));
+  ASSERT_NE(std::string::npos, response.find("Content-Type: text/plain; version=0.0.4\r\n"));
+  ASSERT_NE(std::string::npos, response.find("\nstaxys_requests_total 13\n"));
+  ASSERT_NE(std::string::npos, response.find("\nstaxys_responses_total{code=\"2xx\"} 10\n"));
+  ASSERT_NE(std::string::npos, response.find("\nstaxys_responses_total{code=\"4xx\"} 3\n"));
+  ASSERT_NE(std::string::npos, response.find("\nstaxys_request_duration_seconds_count 13\n"));
+  ASSERT_NE(std::string::npos, response.find("\nstaxys_request_phase_seconds_count{phase=\"handle\"} 13\n"));
+  ASSERT_NE(std::string::npos, response.find("\nstaxys_request_phase_seconds{phase=\"receive\",quantile=\"0.99\"} "));
+  ASSERT_EQ(14U, worker.requests.value());
+  ASSERT_EQ(14U, worker.phases[staxys::core::WorkerMetrics::TOTAL].count());
+  ASSERT_EQ(response.size(), worker.bytes_sent.value() - sent);
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/slab_allocator.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+using staxys::network::SlabAllocator;
+
+namespace {
+struct Tracked {
+  explicit Tracked(int value, int &alive) : value(value), alive(alive) {
+    if (value < 0) {
+      throw std::invalid_argument("negative");
+    }
+    ++alive;
+  }
+  ~Tracked() { --alive; }
+
+  int value;
+  int &alive;
+  char padding[100];
+};
+} // namespace
+
+TEST(SlabAllocatorTest, ConstructsAndDestroysInPlace) {
+  int alive = 0;
+  SlabAllocator<Tracked> slab(4);
+  {
+    auto object = slab.make(7, alive);
+    ASSERT_EQ(7, object->value);
+    ASSERT_EQ(1, alive);
+    ASSERT_EQ(1U, slab.stats().in_use);
+    ASSERT_EQ(4U, slab.stats().capacity);
+  }
+  ASSERT_EQ(0, alive);
+  ASSERT_EQ(0U, slab.stats().in_use);
+}
+
+TEST(SlabAllocatorTest, ReusesFreedSlotsBeforeAddingSlabs) {
+  int alive = 0;
+  SlabAllocator<Tracked> slab(4);
+  std::vector<SlabAllocator<Tracked>::Ptr> objects;
+  for (int i = 0; i < 6; ++i) {
+    objects.push_back(slab.make(i, alive));
+  }
+  ASSERT_EQ(8U, slab.stats().capacity);
+
+  auto *freed = objects[2].get();
+  objects[2].reset();
+  objects[2] = slab.make(20, alive);
+  ASSERT_EQ(freed, objects[2].get());
+
+  // Churn within the peak adds no slabs.
+  for (int round = 0; round < 100; ++round) {
+    objects.clear();
+    for (int i = 0; i < 8; ++i) {
+      objects.push_back(slab.make(i, alive));
+    }
+  }
+  ASSERT_EQ(8U, slab.stats().capacity);
+  ASSERT_EQ(8U, slab.stats().high_water);
+  objects.clear();
+  ASSERT_EQ(0, alive);
+}
+
+TEST(SlabAllocatorTest, KeepsTheSlotWhenAConstructorThrows) {
+  int alive = 0;
+  SlabAllocator<Tracked> slab(1);
+  ASSERT_THROW(slab.make(-1, alive), std::invalid_argument);
+  ASSERT_EQ(0U, slab.stats().in_use);
+  auto object = slab.make(1, alive);
+  ASSERT_EQ(1U, slab.stats().capacity);
+}
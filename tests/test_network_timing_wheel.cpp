@@ -0,0 +1,133 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/timing_wheel.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+using staxys::network::TimingWheel;
+
+namespace {
+/// Advances \p wheel to \p nowMs and returns the data of the expired timers.
+std::vector<uint64_t> expire(TimingWheel &wheel, const uint64_t now_ms) {
+  std::vector<TimingWheel::Timer *> expired;
+  wheel.advance(now_ms, expired);
+  std::vector<uint64_t> data;
+  for (auto timer : expired) {
+    data.push_back(timer->data);
+  }
+  return data;
+}
+} // namespace
+
+TEST(TimingWheelTest, FiresOnceTheDelayHasPassed) {
+  TimingWheel wheel(100, 1000);
+  TimingWheel::Timer timer;
+  timer.data = 7;
+  wheel.arm(timer, 250);
+  ASSERT_TRUE(timer.armed());
+  ASSERT_EQ(1U, wheel.size());
+
+  ASSERT_TRUE(expire(wheel, 1299).empty());
+  ASSERT_EQ(std::vector<uint64_t>{7}, expire(wheel, 1300));
+  ASSERT_FALSE(timer.armed());
+  ASSERT_EQ(0U, wheel.size());
+  ASSERT_TRUE(expire(wheel, 5000).empty());
+}
+
+TEST(TimingWheelTest, RearmingAndCancellingMoveTheTimer) {
+  TimingWheel wheel(100, 0);
+  TimingWheel::Timer timer;
+  wheel.arm(timer, 500);
+  wheel.arm(timer, 1000);
+  ASSERT_EQ(1U, wheel.size());
+  ASSERT_TRUE(expire(wheel, 900).empty());
+  ASSERT_EQ(1U, expire(wheel, 1000).size());
+
+  wheel.arm(timer, 500);
+  wheel.cancel(timer);
+  wheel.cancel(timer);
+  ASSERT_FALSE(timer.armed());
+  ASSERT_EQ(0U, wheel.size());
+  ASSERT_TRUE(expire(wheel, 10000).empty());
+}
+
+TEST(TimingWheelTest, CascadesLongTimeoutsDownTheLevels) {
+  TimingWheel wheel(100, 0);
+  // 75s and 2m lie in the second level, 3h in the third.
+  const uint64_t delays[] = {75000, 120000, 3 * 3600 * 1000, 6300, 6400, 409600};
+  std::vector<std::unique_ptr<TimingWheel::Timer>> timers;
+  for (auto delay : delays) {
+    timers.push_back(std::make_unique<TimingWheel::Timer>());
+    timers.back()->data = delay;
+    wheel.arm(*timers.back(), delay);
+  }
+
+  // Step along in uneven strides; each timer fires in the tick it is due.
+  std::vector<uint64_t> fired;
+  for (uint64_t now = 0; now <= 3 * 3600 * 1000 + 1000; now += 700) {
+    for (auto data : expire(wheel, now)) {
+      ASSERT_GE(now, data);
+      ASSERT_LT(now, data + 700);
+      fired.push_back(data);
+    }
+  }
+  ASSERT_EQ((std::vector<uint64_t>{6300, 6400, 75000, 120000, 409600, 3 * 3600 * 1000}), fired);
+}
+
+TEST(TimingWheelTest, ReportsTheTimeUntilTheNextSlot) {
+  TimingWheel wheel(100, 0);
+  ASSERT_EQ(-1, wheel.timeout_ms(0));
+
+  TimingWheel::Timer soon;
+  TimingWheel::Timer later;
+  wheel.arm(later, 75000);
+  // Not yet in the first level: wake up when its slot cascades.
+  ASSERT_EQ(70400, wheel.timeout_ms(0));
+  wheel.arm(soon, 2000);
+  ASSERT_EQ(1950, wheel.timeout_ms(50));
+  ASSERT_EQ(0, wheel.timeout_ms(2500));
+
+  ASSERT_EQ(1U, expire(wheel, 2000).size());
+  ASSERT_EQ(68400, wheel.timeout_ms(2000));
+  ASSERT_TRUE(expire(wheel, 70400).empty());
+  ASSERT_EQ(4600, wheel.timeout_ms(70400));
+  ASSERT_EQ(1U, expire(wheel, 75000).size());
+  ASSERT_EQ(-1, wheel.timeout_ms(75000));
+}
+
+TEST(TimingWheelTest, ExpiresTimersArmedTogetherInOneBatch) {
+  TimingWheel wheel(100, 0);
+  std::vector<TimingWheel::Timer> timers(1000);
+  for (std::size_t i = 0; i < timers.size(); ++i) {
+    timers[i].data = i;
+    wheel.arm(timers[i], 75000);
+  }
+  ASSERT_TRUE(expire(wheel, 74999).empty());
+  ASSERT_EQ(1000U, expire(wheel, 75000).size());
+}
+
+TEST(TimingWheelTest, DestroyedTimersLeaveTheWheel) {
+  TimingWheel wheel(100, 0);
+  {
+    TimingWheel::Timer timer;
+    wheel.arm(timer, 1000);
+    ASSERT_EQ(1U, wheel.size());
+  }
+  ASSERT_EQ(0U, wheel.size());
+  ASSERT_TRUE(expire(wheel, 2000).empty());
+}
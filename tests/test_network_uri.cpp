@@ -26,4 +26,37 @@
 //    ASSERT_EQ("/path/to/resource", u.getPath());
 //    ASSERT_EQ(1, u.getQuerySize());
 //    ASSERT_EQ("param", u.getQueryParameter("query"));
-//}
\ No newline at end of file
+//}
+#include "staxys/network/uri.h"
+#include <array>
+#include <gtest/gtest.h>
+#include <memory_resource>
+
+TEST(UriTest, KeepsItsTextInTheGivenResource) {
+  std::array<std::byte, 4096> storage;
+  std::pmr::monotonic_buffer_resource arena(storage.data(), storage.size(), std::pmr::null_memory_resource());
+  staxys::network::Uri uri("https://www.example.com:8080/a/fairly/long/path/to/a/resource?first=one&second=two#top",
+                           &arena);
+  ASSERT_TRUE(uri.is_valid_uri());
+  ASSERT_EQ("https", uri.scheme());
+  ASSERT_EQ("www.example.com", uri.host());
+  ASSERT_EQ("8080", uri.port());
+  ASSERT_EQ("/a/fairly/long/path/to/a/resource", uri.path());
+  ASSERT_EQ(2, uri.query_size());
+  ASSERT_EQ("two", uri.query_parameter("second"));
+  ASSERT_THROW(uri.query_parameter("third"), std::out_of_range);
+  ASSERT_EQ("top", uri.fragment());
+  ASSERT_EQ(&arena, uri.raw().get_allocator().resource());
+  ASSERT_EQ(uri.raw().data() + uri.raw().find("/a/"), uri.path().data());
+  ASSERT_EQ(uri.raw().data() + uri.raw().find("first"), uri.query().begin()->name.data());
+}
+
+TEST(UriTest, KeepsRepeatedQueryParameters) {
+  staxys::network::Uri uri("/search?tag=a&tag=b&q=caf%C3%A9+au+lait");
+  ASSERT_EQ(3, uri.query_size());
+  ASSERT_EQ(2U, uri.query().count("tag"));
+  ASSERT_EQ("a", uri.query_parameter("tag"));
+  std::pmr::string value;
+  ASSERT_TRUE(uri.query().value("q", value));
+  ASSERT_EQ("caf\xc3\xa9 au lait", value);
+}
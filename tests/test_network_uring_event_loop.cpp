@@ -0,0 +1,336 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/network/uring_event_loop.h"
+#include "staxys/network/server.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <string>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using staxys::network::Server;
+using staxys::network::UringEventLoop;
+
+namespace {
+const std::string REQUEST = "GET /index.html HTTP/1.1\r\nHost: a\r\n\r\n";
+const std::size_t BODY_SIZE = 64 * 1024;
+
+/// An io_uring loop on a loopback listener, answering with a Server over a
+/// scratch static root; skipped where the kernel has no io_uring.
+class UringEventLoopTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    char pattern[] = "/tmp/staxys_uring_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(pattern));
+    m_root = pattern;
+    std::ofstream(m_root + "/index.html") << std::string(BODY_SIZE, 'x');
+    auto config = std::make_shared<staxys::config::EngineConfig>();
+    config->server_static_root(m_root);
+    m_server = std::make_unique<Server>(config);
+
+    m_listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    ASSERT_GE(m_listener, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(0, bind(m_listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)));
+    ASSERT_EQ(0, listen(m_listener, SOMAXCONN));
+    socklen_t length = sizeof(m_address);
+    ASSERT_EQ(0, getsockname(m_listener, reinterpret_cast<sockaddr *>(&m_address), &length));
+    m_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    ASSERT_GE(m_wake_fd, 0);
+  }
+
+  void TearDown() override {
+    if (m_thread.joinable()) {
+      stop();
+    }
+    m_loop.reset();
+    m_server.reset();
+    close(m_listener);
+    close(m_wake_fd);
+    std::system(("rm -rf " + m_root).c_str());
+  }
+
+  /// Starts the loop on a thread of its own, which also sets it up since
+  /// the ring only takes submissions from the thread that created it.
+  /// \return false if io_uring is unavailable here.
+  bool start(const bool bufferRing = true, const bool fileMapping = true) {
+    m_loop = std::make_unique<UringEventLoop>(std::vector<int>{m_listener}, m_wake_fd, 64, m_running, *m_server);
+    m_loop->buffer_ring(bufferRing);
+    m_loop->file_mapping(fileMapping);
+    std::promise<bool> ready;
+    auto initialized = ready.get_future();
+    m_thread = std::thread([this, &ready] {
+      auto available = m_loop->init();
+      ready.set_value(available);
+      m_result = available ? m_loop->run() : EXIT_SUCCESS;
+    });
+    if (!initialized.get()) {
+      m_thread.join();
+      return false;
+    }
+    return true;
+  }
+
+  void stop() {
+    m_running.store(false, std::memory_order_relaxed);
+    eventfd_write(m_wake_fd, 1);
+    m_thread.join();
+    EXPECT_EQ(EXIT_SUCCESS, m_result);
+  }
+
+  /// Connects \p fd, or a new socket if it is -1.
+  int connect_client(int fd = -1) const {
+    if (fd < 0) {
+      fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    }
+    EXPECT_EQ(0, connect(fd, reinterpret_cast<const sockaddr *>(&m_address), sizeof(m_address)));
+    timeval timeout{5, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return fd;
+  }
+
+  static void send_all(const int fd, const std::string &data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+      auto count = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+      ASSERT_GT(count, 0);
+      sent += static_cast<std::size_t>(count);
+    }
+  }
+
+  /// Reads \p count responses to REQUEST off \p fd.
+  /// \return How many of them were complete 200 responses.
+  static std::size_t read_responses(const int fd, const std::size_t count) {
+    std::string received;
+    std::size_t responses = 0;
+    char buffer[16 * 1024];
+    while (responses < count) {
+      auto head_end = received.find("\r\n\r\n");
+      if (head_end != std::string::npos && received.size() >= head_end + 4 + BODY_SIZE) {
+        if (received.compare(0, 17, "HTTP/1.1 200 OK\r\n") != 0) {
+          break;
+        }
+        received.erase(0, head_end + 4 + BODY_SIZE);
+        ++responses;
+        continue;
+      }
+      auto read = recv(fd, buffer, sizeof(buffer), 0);
+      if (read <= 0) {
+        break;
+      }
+      received.append(buffer, static_cast<std::size_t>(read));
+    }
+    return responses;
+  }
+
+  /// Reads one response off \p fd.
+  /// \return Its body, or an empty string if the connection broke off.
+  static std::string read_body(const int fd) {
+    std::string received;
+    char buffer[16 * 1024];
+    while (true) {
+      auto head_end = received.find("\r\n\r\n");
+      if (head_end != std::string::npos) {
+        auto length = std::stoull(received.substr(received.find("Content-Length: ") + 16));
+        if (received.size() >= head_end + 4 + length) {
+          return received.substr(head_end + 4, length);
+        }
+      }
+      auto read = recv(fd, buffer, sizeof(buffer), 0);
+      if (read <= 0) {
+        return {};
+      }
+      received.append(buffer, static_cast<std::size_t>(read));
+    }
+  }
+
+  /// The server's end of the connection \p client opened.
+  static int accepted_fd(const int client) {
+    sockaddr_in local{};
+    socklen_t length = sizeof(local);
+    getsockname(client, reinterpret_cast<sockaddr *>(&local), &length);
+    for (int fd = 0; fd < 1024; ++fd) {
+      sockaddr_in address{};
+      length = sizeof(address);
+      if (fd != client && getpeername(fd, reinterpret_cast<sockaddr *>(&address), &length) == 0 &&
+          address.sin_port == local.sin_port) {
+        return fd;
+      }
+    }
+    return -1;
+  }
+
+  std::string m_root;
+  std::unique_ptr<Server> m_server;
+  int m_listener = -1;
+  int m_wake_fd = -1;
+  sockaddr_in m_address{};
+  std::atomic<bool> m_running{true};
+  std::unique_ptr<UringEventLoop> m_loop;
+  std::thread m_thread;
+  int m_result = EXIT_FAILURE;
+};
+} // namespace
+
+TEST_F(UringEventLoopTest, KeepsConnectionsAlive) {
+  if (!start()) {
+    GTEST_SKIP() << "io_uring is unavailable";
+  }
+  auto client = connect_client();
+  for (int i = 0; i < 10; ++i) {
+    send_all(client, REQUEST);
+    ASSERT_EQ(1U, read_responses(client, 1));
+  }
+  close(client);
+}
+
+TEST_F(UringEventLoopTest, AnswersPipelinedRequestsBeyondTheBacklog) {
+  if (!start()) {
+    GTEST_SKIP() << "io_uring is unavailable";
+  }
+  // Far more output than a connection may queue, so the recv is paused and
+  // input parked until the client reads.
+  auto client = connect_client();
+  std::string requests;
+  for (int i = 0; i < 200; ++i) {
+    requests += REQUEST;
+  }
+  send_all(client, requests);
+  ASSERT_EQ(200U, read_responses(client, 200));
+  close(client);
+}
+
+TEST_F(UringEventLoopTest, ClosesAfterTheFinalResponse) {
+  if (!start()) {
+    GTEST_SKIP() << "io_uring is unavailable";
+  }
+  auto client = connect_client();
+  send_all(client, REQUEST + "GET /index.html HTTP/1.1\r\nHost: a\r\nConnection: close\r\n\r\n");
+  ASSERT_EQ(2U, read_responses(client, 2));
+  char byte;
+  ASSERT_EQ(0, recv(client, &byte, 1, 0));
+  close(client);
+}
+
+TEST_F(UringEventLoopTest, FallsBackToProvidedBuffers) {
+  if (!start(false)) {
+    GTEST_SKIP() << "io_uring is unavailable";
+  }
+  auto client = connect_client();
+  std::string requests;
+  for (int i = 0; i < 50; ++i) {
+    requests += REQUEST;
+  }
+  for (int round = 0; round < 3; ++round) {
+    send_all(client, requests);
+    ASSERT_EQ(50U, read_responses(client, 50));
+  }
+  close(client);
+}
+
+TEST_F(UringEventLoopTest, KeepsTheSocketOfAnAcceptThatReusesAnOpenSlot) {
+  if (!start()) {
+    GTEST_SKIP() << "io_uring is unavailable";
+  }
+  auto first = connect_client();
+  send_all(first, REQUEST);
+  ASSERT_EQ(1U, read_responses(first, 1));
+
+  // Frees the fd number the way a linked close does, before the loop has seen
+  // the old connection go; its armed recv keeps the socket itself open.
+  // Lower fd numbers are filled so that the next accept gets this one.
+  auto fd = accepted_fd(first);
+  ASSERT_GE(fd, 0);
+  auto second = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  ASSERT_EQ(0, close(fd));
+  std::vector<int> fillers;
+  for (auto filler = dup(m_listener); filler != fd; filler = dup(m_listener)) {
+    ASSERT_LT(filler, fd);
+    fillers.push_back(filler);
+  }
+  ASSERT_EQ(0, close(fd));
+
+  connect_client(second);
+  send_all(second, REQUEST);
+  ASSERT_EQ(1U, read_responses(second, 1));
+  ASSERT_EQ(fd, accepted_fd(second));
+  for (auto filler : fillers) {
+    close(filler);
+  }
+  for (int i = 0; i < 3; ++i) {
+    send_all(second, REQUEST);
+    ASSERT_EQ(1U, read_responses(second, 1));
+  }
+  close(first);
+  close(second);
+}
+
+TEST_F(UringEventLoopTest, SendsMappedFileBodies) {
+  std::string content;
+  for (int i = 0; content.size() < 300 * 1024; ++i) {
+    content += std::to_string(i) + ',';
+  }
+  std::ofstream(m_root + "/large.txt") << content;
+  if (!start()) {
+    GTEST_SKIP() << "io_uring is unavailable";
+  }
+  auto client = connect_client();
+  for (int i = 0; i < 3; ++i) {
+    send_all(client, "GET /large.txt HTTP/1.1\r\nHost: a\r\n\r\n");
+    ASSERT_EQ(content, read_body(client));
+  }
+  send_all(client, "GET /large.txt HTTP/1.1\r\nHost: a\r\nRange: bytes=1000-70999\r\n\r\n");
+  ASSERT_EQ(content.substr(1000, 70000), read_body(client));
+  close(client);
+}
+
+TEST_F(UringEventLoopTest, ReadsFileBodiesIntoPooledBuffersWithoutAMapping) {
+  std::string content;
+  for (int i = 0; content.size() < 300 * 1024; ++i) {
+    content += std::to_string(i) + ',';
+  }
+  std::ofstream(m_root + "/large.txt") << content;
+  if (!start(true, false)) {
+    GTEST_SKIP() << "io_uring is unavailable";
+  }
+  // Sends that stall on a small receive window while none of the clients
+  // reads keep their buffers lent out.
+  std::vector<int> clients;
+  for (int i = 0; i < 20; ++i) {
+    auto client = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int size = 4096;
+    setsockopt(client, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    clients.push_back(connect_client(client));
+    send_all(client, "GET /large.txt HTTP/1.1\r\nHost: a\r\n\r\n");
+  }
+  for (auto client : clients) {
+    ASSERT_EQ(content, read_body(client));
+  }
+  for (auto client : clients) {
+    close(client);
+  }
+}
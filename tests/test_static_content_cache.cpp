@@ -0,0 +1,132 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/static_content/cache.h"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using staxys::static_content::Cache;
+using staxys::static_content::CachedFile;
+
+namespace {
+struct stat identity(const ino_t inode, const off_t size) {
+  struct stat info {};
+  info.st_ino = inode;
+  info.st_size = size;
+  return info;
+}
+
+std::shared_ptr<CachedFile> cached(const ino_t inode, const std::string &body) {
+  auto file = std::make_shared<CachedFile>();
+  file->inode = inode;
+  file->size = static_cast<off_t>(body.size());
+  file->headers = "Content-Length: " + std::to_string(body.size()) + "\r\n";
+  file->body = body;
+  return file;
+}
+} // namespace
+
+TEST(CacheTest, CountsHitsAndMisses) {
+  Cache cache(1024 * 1024, 4096, 60000);
+  ASSERT_EQ(nullptr, cache.find("/www/a", identity(1, 5)));
+  ASSERT_TRUE(cache.insert("/www/a", cached(1, "hello")));
+  auto hit = cache.find("/www/a", identity(1, 5));
+  ASSERT_NE(nullptr, hit);
+  ASSERT_EQ("hello", hit->body);
+
+  auto stats = cache.stats();
+  ASSERT_EQ(1U, stats.hits);
+  ASSERT_EQ(1U, stats.misses);
+  ASSERT_EQ(1U, stats.insertions);
+  ASSERT_EQ(1U, stats.entries);
+  ASSERT_GT(stats.bytes, 5U);
+}
+
+TEST(CacheTest, DropsEntriesThatNoLongerMatchTheFile) {
+  Cache cache(1024 * 1024, 4096, 60000);
+  cache.insert("/www/a", cached(1, "hello"));
+  // Same inode, new size: written in place.
+  ASSERT_EQ(nullptr, cache.find("/www/a", identity(1, 6)));
+  ASSERT_EQ(0U, cache.stats().entries);
+
+  cache.insert("/www/a", cached(1, "hello"));
+  // Replaced by a new file.
+  ASSERT_EQ(nullptr, cache.find("/www/a", identity(2, 5)));
+}
+
+TEST(CacheTest, ExpiresEntriesAfterTheTtl) {
+  Cache cache(1024 * 1024, 4096, 1);
+  cache.insert("/www/a", cached(1, "hello"));
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  ASSERT_EQ(nullptr, cache.find("/www/a", identity(1, 5)));
+}
+
+TEST(CacheTest, RefusesFilesAboveTheLimit) {
+  Cache cache(1024 * 1024, 4, 60000);
+  ASSERT_FALSE(cache.admits(5));
+  ASSERT_FALSE(cache.insert("/www/a", cached(1, "hello")));
+  ASSERT_EQ(0U, cache.stats().entries);
+}
+
+TEST(CacheTest, StaysWithinItsBudget) {
+  // One shard's share fits only a few 1 KiB bodies.
+  Cache cache(Cache::SHARD_COUNT * 4096, 4096, 60000);
+  for (int i = 0; i < 1000; ++i) {
+    cache.insert("/www/" + std::to_string(i), cached(i, std::string(1024, 'x')));
+  }
+  auto stats = cache.stats();
+  ASSERT_LE(stats.bytes, Cache::SHARD_COUNT * 4096U);
+  ASSERT_EQ(1000U, stats.insertions);
+  ASSERT_EQ(stats.insertions - stats.entries, stats.evictions);
+}
+
+TEST(CacheTest, ScansDoNotEvictHotEntries) {
+  Cache cache(Cache::SHARD_COUNT * 16384, 4096, 60000);
+  cache.insert("/www/hot", cached(1, std::string(1024, 'h')));
+  ASSERT_NE(nullptr, cache.find("/www/hot", identity(1, 1024)));
+
+  // A stream of files requested once each only churns the probationary segment.
+  for (int i = 0; i < 1000; ++i) {
+    cache.insert("/www/scan/" + std::to_string(i), cached(100 + i, std::string(1024, 's')));
+  }
+  ASSERT_NE(nullptr, cache.find("/www/hot", identity(1, 1024)));
+}
+
+TEST(CacheTest, ServesConcurrentReaders) {
+  Cache cache(1024 * 1024, 4096, 60000);
+  for (int i = 0; i < 64; ++i) {
+    cache.insert("/www/" + std::to_string(i), cached(i, "body"));
+  }
+
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&cache] {
+      for (int round = 0; round < 1000; ++round) {
+        for (int i = 0; i < 64; ++i) {
+          cache.find("/www/" + std::to_string(i), identity(i, 4));
+        }
+      }
+    });
+  }
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  ASSERT_EQ(4U * 1000 * 64, cache.stats().hits);
+}
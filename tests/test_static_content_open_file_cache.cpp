@@ -0,0 +1,140 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/static_content/open_file_cache.h"
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using staxys::static_content::OpenFileCache;
+
+namespace {
+/// A scratch directory that is removed with everything in it.
+class OpenFileCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    char pattern[] = "/tmp/staxys_open_file_cache_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(pattern));
+    m_directory = pattern;
+  }
+
+  void TearDown() override { std::system(("rm -rf " + m_directory).c_str()); }
+
+  std::string write(const std::string &name, const std::string &content) {
+    auto path = m_directory + "/" + name;
+    std::ofstream(path) << content;
+    return path;
+  }
+
+  std::string m_directory;
+};
+} // namespace
+
+TEST_F(OpenFileCacheTest, ReusesTheDescriptorOfAHit) {
+  auto path = write("a.txt", "hello");
+  OpenFileCache cache;
+  int error = 0;
+  auto first = cache.open(path, error);
+  ASSERT_NE(nullptr, first);
+  ASSERT_EQ(5U, first->size());
+  ASSERT_FALSE(first->is_directory());
+  auto second = cache.open(path, error);
+  ASSERT_EQ(first, second);
+  ASSERT_EQ(1U, cache.size());
+}
+
+TEST_F(OpenFileCacheTest, CachesMissingFiles) {
+  OpenFileCache cache;
+  int error = 0;
+  ASSERT_EQ(nullptr, cache.open(m_directory + "/missing", error));
+  ASSERT_EQ(ENOENT, error);
+  ASSERT_EQ(1U, cache.size());
+
+  auto directory = cache.open(m_directory, error);
+  ASSERT_NE(nullptr, directory);
+  ASSERT_TRUE(directory->is_directory());
+}
+
+TEST_F(OpenFileCacheTest, ReopensChangedFilesOnceStale) {
+  auto path = write("a.txt", "hello");
+  OpenFileCache cache(OpenFileCache::DEFAULT_CAPACITY, 0);
+  int error = 0;
+  auto first = cache.open(path, error);
+  write("a.txt", "hello, world");
+  auto second = cache.open(path, error);
+  ASSERT_NE(first, second);
+  ASSERT_EQ(12U, second->size());
+  // The replaced descriptor stays usable for whoever still holds it.
+  ASSERT_EQ(5U, first->size());
+  ASSERT_NE(-1, fcntl(first->fd(), F_GETFD));
+
+  unlink(path.c_str());
+  ASSERT_EQ(nullptr, cache.open(path, error));
+  ASSERT_EQ(ENOENT, error);
+}
+
+TEST_F(OpenFileCacheTest, EvictsTheLeastRecentlyUsed) {
+  auto a = write("a", "a");
+  auto b = write("b", "b");
+  auto c = write("c", "c");
+  OpenFileCache cache(2);
+  int error = 0;
+  auto first = cache.open(a, error);
+  cache.open(b, error);
+  cache.open(a, error);
+  cache.open(c, error);
+  ASSERT_EQ(2U, cache.size());
+  // "a" was used more recently than "b", so it is still cached.
+  ASSERT_EQ(first, cache.open(a, error));
+
+  cache.invalidate(a);
+  ASSERT_NE(first, cache.open(a, error));
+}
+
+TEST_F(OpenFileCacheTest, FormatsValidatorsFromTheFstat) {
+  auto path = write("v.txt", "0123456789");
+  timespec times[2] = {{784111777, 0}, {784111777, 0}};
+  ASSERT_EQ(0, utimensat(AT_FDCWD, path.c_str(), times, 0));
+  OpenFileCache cache;
+  int error = 0;
+  auto file = cache.open(path, error);
+  ASSERT_NE(nullptr, file);
+
+  ASSERT_EQ("\"2ebc98a1-a\"", file->etag());
+  ASSERT_EQ("Sun, 06 Nov 1994 08:49:37 GMT", file->last_modified());
+  ASSERT_EQ("ETag: \"2ebc98a1-a\"\r\nLast-Modified: Sun, 06 Nov 1994 08:49:37 GMT\r\n", file->validators());
+  ASSERT_EQ("ETag: W/\"2ebc98a1-a\"\r\nLast-Modified: Sun, 06 Nov 1994 08:49:37 GMT\r\n", file->validators(true));
+}
+
+TEST_F(OpenFileCacheTest, MapsTheFileOnFirstUse) {
+  OpenFileCache cache;
+  int error = 0;
+  auto file = cache.open(write("m.txt", "mapped"), error);
+  ASSERT_NE(nullptr, file);
+  auto mapping = file->mapping();
+  ASSERT_NE(nullptr, mapping);
+  ASSERT_EQ("mapped", std::string(mapping, file->size()));
+  ASSERT_EQ(mapping, file->mapping());
+
+  auto empty = cache.open(write("e.txt", ""), error);
+  ASSERT_NE(nullptr, empty);
+  ASSERT_EQ(nullptr, empty->mapping());
+}
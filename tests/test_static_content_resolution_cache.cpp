@@ -0,0 +1,123 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/static_content/resolution_cache.h"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+
+using staxys::static_content::Resolution;
+using staxys::static_content::ResolutionCache;
+
+namespace {
+std::shared_ptr<const Resolution> resolution(const std::string &path) {
+  auto resolved = std::make_shared<Resolution>();
+  resolved->path = path;
+  resolved->mime_type = &staxys::utils::MimeTypes::for_extension("txt");
+  return resolved;
+}
+} // namespace
+
+TEST(ResolutionCacheTest, FindsWhatWasInserted) {
+  ResolutionCache cache(64, 0);
+  ASSERT_EQ(nullptr, cache.find("/var/www/docs/"));
+  auto docs = resolution("/var/www/docs/index.html");
+  cache.insert("/var/www/docs/", docs);
+  ASSERT_EQ(docs, cache.find(std::string_view("/var/www/docs/?", 14)));
+
+  auto replacement = resolution("/var/www/docs/index.html");
+  cache.insert("/var/www/docs/", replacement);
+  ASSERT_EQ(replacement, cache.find("/var/www/docs/"));
+
+  auto stats = cache.stats();
+  ASSERT_EQ(2U, stats.hits);
+  ASSERT_EQ(1U, stats.misses);
+  ASSERT_EQ(1U, stats.entries);
+}
+
+TEST(ResolutionCacheTest, ExpiresAfterTheValidityPeriod) {
+  ResolutionCache cache(64, 20);
+  cache.insert("/var/www/a", resolution("/var/www/a"));
+  ASSERT_NE(nullptr, cache.find("/var/www/a"));
+  std::this_thread::sleep_for(std::chrono::milliseconds(40));
+  ASSERT_EQ(nullptr, cache.find("/var/www/a"));
+  ASSERT_EQ(0U, cache.stats().entries);
+
+  cache.validity(0);
+  cache.insert("/var/www/a", resolution("/var/www/a"));
+  std::this_thread::sleep_for(std::chrono::milliseconds(40));
+  ASSERT_NE(nullptr, cache.find("/var/www/a"));
+}
+
+TEST(ResolutionCacheTest, InvalidatesFilesSiblingsAndDirectories) {
+  ResolutionCache cache(64, 0);
+  cache.insert("/var/www/site.css", resolution("/var/www/site.css"));
+  cache.insert("/var/www/docs/", resolution("/var/www/docs/index.html"));
+  cache.insert("/var/www/docs/a.html", resolution("/var/www/docs/a.html"));
+  cache.insert("/var/www/other.html", resolution("/var/www/other.html"));
+
+  // A new precompressed copy makes the file resolve differently.
+  cache.invalidate("/var/www/site.css.gz");
+  ASSERT_EQ(nullptr, cache.find("/var/www/site.css"));
+  ASSERT_NE(nullptr, cache.find("/var/www/docs/"));
+
+  cache.invalidate("/var/www/docs/index.html");
+  ASSERT_EQ(nullptr, cache.find("/var/www/docs/"));
+  ASSERT_NE(nullptr, cache.find("/var/www/docs/a.html"));
+
+  cache.invalidate("/var/www/docs");
+  ASSERT_EQ(nullptr, cache.find("/var/www/docs/a.html"));
+  ASSERT_NE(nullptr, cache.find("/var/www/other.html"));
+
+  // Siblings may add more than one extension.
+  cache.insert("/var/www/app.js", resolution("/var/www/app.js"));
+  cache.invalidate("/var/www/app.js.map.gz");
+  ASSERT_EQ(nullptr, cache.find("/var/www/app.js"));
+  ASSERT_NE(nullptr, cache.find("/var/www/other.html"));
+
+  cache.clear();
+  ASSERT_EQ(0U, cache.stats().entries);
+}
+
+TEST(ResolutionCacheTest, EvictsTheLeastRecentlyUsedBeyondCapacity) {
+  // One entry per shard.
+  ResolutionCache cache(ResolutionCache::SHARD_COUNT, 0);
+  for (int i = 0; i < 1000; ++i) {
+    auto key = "/var/www/" + std::to_string(i);
+    cache.insert(key, resolution(key));
+  }
+  ASSERT_LE(cache.stats().entries, ResolutionCache::SHARD_COUNT);
+  ASSERT_NE(nullptr, cache.find("/var/www/999"));
+}
+
+TEST(ResolutionCacheTest, InvalidatesEvictedAndReplacedEntriesSafely) {
+  ResolutionCache cache(ResolutionCache::SHARD_COUNT * 4, 0);
+  for (int i = 0; i < 1000; ++i) {
+    auto key = "/var/www/d" + std::to_string(i % 10) + "/" + std::to_string(i);
+    cache.insert(key, resolution(key));
+    cache.insert(key, resolution(key));
+  }
+  cache.insert("/var/www/d3/", resolution("/var/www/d3/index.html"));
+  cache.insert("/var/www/d3/index.html", resolution("/var/www/d3/index.html"));
+  cache.invalidate("/var/www/d3");
+  ASSERT_EQ(nullptr, cache.find("/var/www/d3/"));
+  ASSERT_EQ(nullptr, cache.find("/var/www/d3/index.html"));
+  ASSERT_NE(nullptr, cache.find("/var/www/d9/999"));
+  cache.invalidate("/var/www");
+  ASSERT_EQ(0U, cache.stats().entries);
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/static_content/watcher.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+
+using staxys::static_content::Watcher;
+
+namespace {
+class WatcherTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    char pattern[] = "/tmp/staxys_watcher_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(pattern));
+    m_root = pattern;
+    std::ofstream(m_root + "/index.html") << "one";
+  }
+
+  void TearDown() override { std::system(("rm -rf " + m_root).c_str()); }
+
+  /// Waits up to two seconds for the watcher to report something.
+  static bool wait_for_changes(Watcher &watcher, Watcher::Changes &changes) {
+    for (int i = 0; i < 200; ++i) {
+      if (watcher.take_changes(changes)) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+  }
+
+  static bool contains(const Watcher::Changes &changes, const std::string &path) {
+    return std::find(changes.paths.begin(), changes.paths.end(), path) != changes.paths.end();
+  }
+
+  std::string m_root;
+};
+} // namespace
+
+TEST_F(WatcherTest, ReportsWrittenCreatedAndDeletedFiles) {
+  Watcher watcher(m_root + "/");
+  ASSERT_TRUE(watcher.start());
+  // Let the thread set up its watches before changing anything.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_EQ(Watcher::Mode::INOTIFY, watcher.mode());
+
+  Watcher::Changes changes;
+  std::ofstream(m_root + "/index.html") << "two";
+  ASSERT_TRUE(wait_for_changes(watcher, changes));
+  ASSERT_FALSE(changes.everything);
+  ASSERT_TRUE(contains(changes, m_root + "/index.html"));
+
+  std::ofstream(m_root + "/new.css") << "body{}";
+  ASSERT_TRUE(wait_for_changes(watcher, changes));
+  ASSERT_TRUE(contains(changes, m_root + "/new.css"));
+
+  std::remove((m_root + "/index.html").c_str());
+  ASSERT_TRUE(wait_for_changes(watcher, changes));
+  ASSERT_TRUE(contains(changes, m_root + "/index.html"));
+}
+
+TEST_F(WatcherTest, ReportsEverythingWhenADirectoryChanges) {
+  Watcher watcher(m_root);
+  ASSERT_TRUE(watcher.start());
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  Watcher::Changes changes;
+  mkdir((m_root + "/assets").c_str(), 0755);
+  ASSERT_TRUE(wait_for_changes(watcher, changes));
+  ASSERT_TRUE(changes.everything);
+
+  // The new directory is watched as well.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  watcher.take_changes(changes);
+  std::ofstream(m_root + "/assets/site.js") << "1";
+  ASSERT_TRUE(wait_for_changes(watcher, changes));
+  ASSERT_TRUE(contains(changes, m_root + "/assets/site.js"));
+}
+
+TEST_F(WatcherTest, PollsWhenAskedTo) {
+  mkdir((m_root + "/docs").c_str(), 0755);
+  Watcher watcher(m_root, std::chrono::milliseconds(20));
+  ASSERT_TRUE(watcher.start(Watcher::Mode::POLL));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_EQ(Watcher::Mode::POLL, watcher.mode());
+
+  Watcher::Changes changes;
+  std::ofstream(m_root + "/docs/a.txt") << "a";
+  ASSERT_TRUE(wait_for_changes(watcher, changes));
+  ASSERT_FALSE(changes.everything);
+  ASSERT_TRUE(contains(changes, m_root + "/docs/a.txt"));
+
+  std::remove((m_root + "/docs/a.txt").c_str());
+  ASSERT_TRUE(wait_for_changes(watcher, changes));
+  ASSERT_TRUE(contains(changes, m_root + "/docs/a.txt"));
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/utils/date_utils.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using staxys::utils::DateUtils;
+
+TEST(DateUtilsTest, FormatsImfFixdate) {
+  char date[DateUtils::HTTP_DATE_LENGTH + 1];
+  ASSERT_EQ(DateUtils::HTTP_DATE_LENGTH, DateUtils::format_http_date(784111777, date));
+  ASSERT_EQ(std::string("Sun, 06 Nov 1994 08:49:37 GMT"), date);
+  DateUtils::format_http_date(0, date);
+  ASSERT_EQ(std::string("Thu, 01 Jan 1970 00:00:00 GMT"), date);
+}
+
+TEST(DateUtilsTest, ParsesWhatItFormats) {
+  time_t time = 0;
+  ASSERT_TRUE(DateUtils::parse_http_date("Sun, 06 Nov 1994 08:49:37 GMT", time));
+  ASSERT_EQ(784111777, time);
+  ASSERT_TRUE(DateUtils::parse_http_date("Tue, 29 Feb 2028 23:59:59 GMT", time));
+  char date[DateUtils::HTTP_DATE_LENGTH + 1];
+  DateUtils::format_http_date(time, date);
+  ASSERT_EQ(std::string("Tue, 29 Feb 2028 23:59:59 GMT"), date);
+}
+
+TEST(DateUtilsTest, RefusesOtherForms) {
+  time_t time = 0;
+  ASSERT_FALSE(DateUtils::parse_http_date("Sunday, 06-Nov-94 08:49:37 GMT", time));
+  ASSERT_FALSE(DateUtils::parse_http_date("Sun Nov  6 08:49:37 1994", time));
+  ASSERT_FALSE(DateUtils::parse_http_date("Sun, 06 Nov 1994 08:49:37 UTC", time));
+  ASSERT_FALSE(DateUtils::parse_http_date("Sun, 06 Xyz 1994 08:49:37 GMT", time));
+  ASSERT_FALSE(DateUtils::parse_http_date("Sun, 06 Nov 1994 24:49:37 GMT", time));
+  ASSERT_FALSE(DateUtils::parse_http_date("Sun, 0x Nov 1994 08:49:37 GMT", time));
+  ASSERT_FALSE(DateUtils::parse_http_date("", time));
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/utils/file_utils.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using staxys::utils::FileUtils;
+
+TEST(FileUtilsTest, MapsTargetsBelowTheRoot) {
+  std::string path;
+  ASSERT_TRUE(FileUtils::map_target("/var/www", "/index.html", path));
+  ASSERT_EQ("/var/www/index.html", path);
+  ASSERT_TRUE(FileUtils::map_target("/var/www/", "/css/site.css?v=2#top", path));
+  ASSERT_EQ("/var/www/css/site.css", path);
+  ASSERT_TRUE(FileUtils::map_target("/var/www", "/docs/", path));
+  ASSERT_EQ("/var/www/docs/", path);
+  ASSERT_TRUE(FileUtils::map_target("/var/www", "/a%20file.txt", path));
+  ASSERT_EQ("/var/www/a file.txt", path);
+  ASSERT_TRUE(FileUtils::map_target("/var/www", "/..hidden/x..y", path));
+  ASSERT_EQ("/var/www/..hidden/x..y", path);
+}
+
+TEST(FileUtilsTest, RemovesDotSegments) {
+  std::string path;
+  ASSERT_TRUE(FileUtils::map_target("/var/www", "/a/..", path));
+  ASSERT_EQ("/var/www/", path);
+  ASSERT_TRUE(FileUtils::map_target("/var/www", "/./a", path));
+  ASSERT_EQ("/var/www/a", path);
+  ASSERT_TRUE(FileUtils::map_target("/var/www", "/a/./b/../c%2e/%2E", path));
+  ASSERT_EQ("/var/www/a/c./", path);
+  ASSERT_TRUE(FileUtils::map_target("/var/www", "/a/b/%2e%2e/../index.html", path));
+  ASSERT_EQ("/var/www/index.html", path);
+}
+
+TEST(FileUtilsTest, RefusesTargetsThatLeaveTheRoot) {
+  std::string path;
+  ASSERT_FALSE(FileUtils::map_target("/var/www", "/../etc/passwd", path));
+  ASSERT_FALSE(FileUtils::map_target("/var/www", "/a/../../etc/passwd", path));
+  ASSERT_FALSE(FileUtils::map_target("/var/www", "/%2e%2e/etc/passwd", path));
+  ASSERT_FALSE(FileUtils::map_target("/var/www", "/a/./../..", path));
+  ASSERT_FALSE(FileUtils::map_target("/var/www", "/a%2f..%2fb", path));
+  ASSERT_FALSE(FileUtils::map_target("/var/www", "/a%00.html", path));
+  ASSERT_FALSE(FileUtils::map_target("/var/www", "/a%zz", path));
+  ASSERT_FALSE(FileUtils::map_target("/var/www", "/a%2", path));
+  ASSERT_FALSE(FileUtils::map_target("/var/www", "http://example.com/", path));
+  ASSERT_FALSE(FileUtils::map_target("/var/www", "*", path));
+}
+
+TEST(FileUtilsTest, LooksUpMimeTypesByExtension) {
+  ASSERT_EQ("text/html; charset=utf-8", FileUtils::mime_type("/var/www/index.html"));
+  ASSERT_EQ("text/css; charset=utf-8", FileUtils::mime_type("site.CSS"));
+  ASSERT_EQ("image/png", FileUtils::mime_type("/img/logo.png"));
+  ASSERT_EQ("application/octet-stream", FileUtils::mime_type("/bin/data"));
+  ASSERT_EQ("application/octet-stream", FileUtils::mime_type("/v1.2/README"));
+  ASSERT_EQ("application/octet-stream", FileUtils::mime_type("archive.tar.unknown"));
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/utils/mime_types.h"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+
+using staxys::utils::MimeTypes;
+
+TEST(MimeTypesTest, LooksUpBuiltInTypesIgnoringCase) {
+  ASSERT_EQ("Content-Type: text/html; charset=utf-8\r\n", MimeTypes::for_path("/var/www/index.html").header);
+  ASSERT_EQ("text/css; charset=utf-8", MimeTypes::for_path("site.CSS").value());
+  ASSERT_EQ("image/png", MimeTypes::for_extension("Png").value());
+  ASSERT_EQ("font/woff2", MimeTypes::for_path("/fonts/a.b.woff2").value());
+  ASSERT_EQ(&MimeTypes::for_extension("jpg"), &MimeTypes::for_path("/img/photo.JPG"));
+}
+
+TEST(MimeTypesTest, FallsBackForUnknownExtensions) {
+  const auto *fallback = &MimeTypes::fallback();
+  ASSERT_EQ("application/octet-stream", fallback->value());
+  ASSERT_EQ(fallback, &MimeTypes::for_path("/bin/data"));
+  ASSERT_EQ(fallback, &MimeTypes::for_path("/v1.2/README"));
+  ASSERT_EQ(fallback, &MimeTypes::for_path("archive.tar.unknown"));
+  ASSERT_EQ(fallback, &MimeTypes::for_path("trailing."));
+  ASSERT_EQ(fallback, &MimeTypes::for_extension("htm" + std::string(MimeTypes::MAX_EXTENSION, 'l')));
+  // Same length as a known extension, and likely the same slot for some.
+  ASSERT_EQ(fallback, &MimeTypes::for_extension("htmx"));
+  ASSERT_EQ(fallback, &MimeTypes::for_extension("cs"));
+}
+
+TEST(MimeTypesTest, SplitsTheHeaderLine) {
+  const auto &html = MimeTypes::for_extension("html");
+  ASSERT_EQ("text/html; charset=utf-8", html.value());
+  ASSERT_EQ("text/html", html.essence());
+  ASSERT_EQ("image/svg+xml", MimeTypes::for_extension("svg").essence());
+}
+
+TEST(MimeTypesTest, LoadsAFileOnTopOfTheBuiltInTypes) {
+  char path[] = "/tmp/staxys_mime_types_XXXXXX";
+  auto fd = mkstemp(path);
+  ASSERT_NE(-1, fd);
+  close(fd);
+  std::ofstream(path) << "# Extra types\n"
+                      << "text/x-go go\n"
+                      << "image/svg+xml  svg SVGZ   # compressed too\n"
+                      << "not-a-type md\n"
+                      << "text/plain md a/b\n";
+
+  const auto *built_in_svg = &MimeTypes::for_extension("svg");
+  auto built_in_size = MimeTypes::size();
+  ASSERT_TRUE(MimeTypes::load(path));
+  std::remove(path);
+
+  ASSERT_EQ(built_in_size + 2, MimeTypes::size());
+  ASSERT_EQ("Content-Type: text/x-go\r\n", MimeTypes::for_path("main.go").header);
+  ASSERT_EQ("image/svg+xml", MimeTypes::for_path("logo.svgz").value());
+  ASSERT_EQ("text/plain", MimeTypes::for_extension("md").value());
+  ASSERT_EQ("text/html; charset=utf-8", MimeTypes::for_extension("HTML").value());
+  ASSERT_EQ(&MimeTypes::fallback(), &MimeTypes::for_extension("b"));
+  // Types handed out before the load are still valid.
+  ASSERT_EQ("image/svg+xml", built_in_svg->value());
+
+  MimeTypes::reset();
+  ASSERT_EQ(built_in_size, MimeTypes::size());
+  ASSERT_EQ(&MimeTypes::fallback(), &MimeTypes::for_extension("go"));
+}
+
+TEST(MimeTypesTest, KeepsTheTypesIfTheFileCannotBeRead) {
+  auto size = MimeTypes::size();
+  ASSERT_FALSE(MimeTypes::load("/nonexistent/mime_types"));
+  ASSERT_EQ(size, MimeTypes::size());
+  ASSERT_EQ("image/png", MimeTypes::for_extension("png").value());
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "staxys/utils/scan_utils.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+using staxys::utils::ScanUtils;
+
+namespace {
+
+const ScanUtils::Isa VECTOR_ISAS[] = {ScanUtils::Isa::SSE42, ScanUtils::Isa::AVX2};
+
+/// Runs every scan on \p isa and on the scalar path over \p text and every
+/// suffix of it, so each byte is seen at every lane position.
+void expect_same_as_scalar(const ScanUtils::Isa isa, const std::string &text) {
+  for (std::size_t offset = 0; offset <= text.size(); ++offset) {
+    auto data = text.data() + offset;
+    auto size = text.size() - offset;
+    ASSERT_EQ(ScanUtils::find_non_token(ScanUtils::Isa::SCALAR, data, size), ScanUtils::find_non_token(isa, data, size))
+        << ScanUtils::isa_name(isa) << " token, offset " << offset;
+    ASSERT_EQ(ScanUtils::find_non_value(ScanUtils::Isa::SCALAR, data, size), ScanUtils::find_non_value(isa, data, size))
+        << ScanUtils::isa_name(isa) << " value, offset " << offset;
+    ASSERT_EQ(ScanUtils::find_non_target(ScanUtils::Isa::SCALAR, data, size),
+              ScanUtils::find_non_target(isa, data, size))
+        << ScanUtils::isa_name(isa) << " target, offset " << offset;
+    ASSERT_EQ(ScanUtils::find_non_unreserved(ScanUtils::Isa::SCALAR, data, size),
+              ScanUtils::find_non_unreserved(isa, data, size))
+        << ScanUtils::isa_name(isa) << " unreserved, offset " << offset;
+  }
+}
+
+} // namespace
+
+TEST(ScanUtilsTest, ScalarClassifiesBytes) {
+  std::string name = "Content-Type: text/html";
+  ASSERT_EQ(12U, ScanUtils::find_non_token(ScanUtils::Isa::SCALAR, name.data(), name.size()));
+
+  std::string value = "text/html; charset=utf-8\r\n";
+  ASSERT_EQ(24U, ScanUtils::find_non_value(ScanUtils::Isa::SCALAR, value.data(), value.size()));
+
+  std::string target = "/index.html?a=b HTTP/1.1";
+  ASSERT_EQ(15U, ScanUtils::find_non_target(ScanUtils::Isa::SCALAR, target.data(), target.size()));
+
+  std::string tokens = "!#$%&'*+-.^_`|~09AZaz";
+  ASSERT_EQ(tokens.size(), ScanUtils::find_non_token(ScanUtils::Isa::SCALAR, tokens.data(), tokens.size()));
+  ASSERT_EQ(0U, ScanUtils::find_non_token(ScanUtils::Isa::SCALAR, "}", 1));
+  ASSERT_EQ(1U, ScanUtils::find_non_value(ScanUtils::Isa::SCALAR, "\t\x7f", 2));
+
+  std::string unreserved = "AZaz09-._~/";
+  ASSERT_EQ(10U, ScanUtils::find_non_unreserved(ScanUtils::Isa::SCALAR, unreserved.data(), unreserved.size()));
+}
+
+TEST(ScanUtilsTest, EveryByteMatchesScalarAtEveryPosition) {
+  for (auto isa : VECTOR_ISAS) {
+    if (!ScanUtils::is_supported(isa)) {
+      continue;
+    }
+    for (int byte = 0; byte < 256; ++byte) {
+      std::string text(70, 'a');
+      text[47] = static_cast<char>(byte);
+      expect_same_as_scalar(isa, text);
+    }
+  }
+}
+
+TEST(ScanUtilsTest, RandomInputMatchesScalar) {
+  std::mt19937 random(20250112);
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::uniform_int_distribution<int> length(0, 300);
+  for (auto isa : VECTOR_ISAS) {
+    if (!ScanUtils::is_supported(isa)) {
+      continue;
+    }
+    for (int round = 0; round < 200; ++round) {
+      // Mostly tchars, so runs are long enough to cross vector boundaries.
+      std::string text(static_cast<std::size_t>(length(random)), 'x');
+      for (auto &c : text) {
+        auto roll = byte(random);
+        c = roll < 8 ? static_cast<char>(byte(random)) : static_cast<char>('a' + roll % 26);
+      }
+      expect_same_as_scalar(isa, text);
+    }
+  }
+}
+
+TEST(ScanUtilsTest, HeadersMatchScalar) {
+  std::string head = "GET /assets/app.js?v=3 HTTP/1.1\r\n"
+                     "Host: www.example.com\r\n"
+                     "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko)\r\n"
+                     "Accept: */*\r\n"
+                     "Cookie: a=1; b=\"two\"; c={3}|~\r\n"
+                     "\r\n";
+  for (auto isa : VECTOR_ISAS) {
+    if (ScanUtils::is_supported(isa)) {
+      expect_same_as_scalar(isa, head);
+    }
+  }
+}
+
+TEST(ScanUtilsTest, SwitchesInstructionSet) {
+  auto original = ScanUtils::active_isa();
+  ASSERT_TRUE(ScanUtils::use_isa(ScanUtils::Isa::SCALAR));
+  ASSERT_EQ(ScanUtils::Isa::SCALAR, ScanUtils::active_isa());
+  ASSERT_EQ(4U, ScanUtils::find_non_token("Host: a", 7));
+  ASSERT_TRUE(ScanUtils::use_isa(original));
+  ASSERT_EQ(original, ScanUtils::active_isa());
+}
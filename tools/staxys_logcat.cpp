@@ -0,0 +1,188 @@
+/*
+ * Copyright 2025 Michael Goodwin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Turns a binary access log (access_log_format = "binary") into text.
+//
+// Usage: staxys-logcat [--json] [file...]
+//
+// Every record becomes the line the text access log would have had for it,
+// or a JSON object per line with --json. Reads standard input if no file or
+// "-" is given.
+
+#include "staxys/logging/access_record.h"
+#include <boost/program_options.hpp>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace program_options = boost::program_options;
+using staxys::logging::AccessRecord;
+using staxys::logging::AccessRecordDecoder;
+using staxys::logging::AccessRecordText;
+
+namespace {
+
+/// Writes the records of one input to stdout.
+class Printer {
+public:
+  explicit Printer(bool json) : m_json(json) {}
+
+  /// Prints the records of the frames in the file at \p fd.
+  /// \return false if the input could not be read or is not a complete binary log.
+  bool print(int fd, const std::string &name) {
+    std::string buffer;
+    std::size_t start = 0;
+    uint64_t offset = 0;
+    char chunk[65536];
+    bool ended = false;
+    while (true) {
+      // Print every complete frame in the buffer.
+      while (true) {
+        std::string_view data(buffer.data() + start, buffer.size() - start);
+        uint64_t payload_size = 0;
+        auto header_size = AccessRecordDecoder::parse_frame_header(data, payload_size);
+        if (header_size < 0) {
+          std::cerr << "staxys-logcat: " << name << ": no frame at offset " << offset << std::endl;
+          return false;
+        }
+        if (header_size == 0 || data.size() - static_cast<std::size_t>(header_size) < payload_size) {
+          break;
+        }
+        if (!print_frame(data.substr(static_cast<std::size_t>(header_size), payload_size))) {
+          std::cerr << "staxys-logcat: " << name << ": invalid record in the frame at offset " << offset
+                    << std::endl;
+        }
+        auto frame_size = static_cast<std::size_t>(header_size) + payload_size;
+        start += frame_size;
+        offset += frame_size;
+      }
+      if (ended) {
+        break;
+      }
+
+      buffer.erase(0, start);
+      start = 0;
+      auto count = read(fd, chunk, sizeof(chunk));
+      if (count < 0 && errno == EINTR) {
+        continue;
+      }
+      if (count < 0) {
+        std::cerr << "staxys-logcat: " << name << ": " << strerror(errno) << std::endl;
+        return false;
+      }
+      if (count == 0) {
+        ended = true;
+      }
+      buffer.append(chunk, static_cast<std::size_t>(count));
+    }
+    if (start != buffer.size()) {
+      std::cerr << "staxys-logcat: " << name << ": incomplete frame at offset " << offset << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+private:
+  /// \return false if the frame ends in a record that cannot be read.
+  bool print_frame(std::string_view payload) {
+    AccessRecord record;
+    m_decoder.reset();
+    while (true) {
+      auto status = m_decoder.decode(payload, record);
+      if (status != AccessRecordDecoder::Status::RECORD) {
+        return status == AccessRecordDecoder::Status::END;
+      }
+      std::size_t length;
+      if (m_json) {
+        length = AccessRecordText::to_json(record, m_line);
+      } else {
+        auto second = record.time / 1000000 - (record.time % 1000000 < 0 ? 1 : 0);
+        if (second != m_second) {
+          m_time_length = AccessRecordText::format_time(second, m_time);
+          m_second = second;
+        }
+        length = AccessRecordText::to_text(record, {m_time, m_time_length}, m_line);
+      }
+      std::fwrite(m_line, 1, length, stdout);
+    }
+  }
+
+  bool m_json;
+  AccessRecordDecoder m_decoder;
+  int64_t m_second = -1;
+  char m_time[AccessRecordText::TIME_SIZE]{};
+  std::size_t m_time_length = 0;
+  char m_line[AccessRecordText::MAX_LINE];
+};
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  program_options::options_description desc("Usage: staxys-logcat [options...] [file...]");
+  desc.add_options()("help,h", "display help information")("json,j", "print a JSON object per record");
+
+  program_options::positional_options_description p;
+  p.add("file", -1);
+
+  program_options::options_description all_options;
+  all_options.add(desc).add_options()("file", program_options::value<std::vector<std::string>>(),
+                                      "binary access logs to read, or - for standard input");
+
+  program_options::variables_map variables_map;
+  try {
+    store(program_options::command_line_parser(argc, argv).options(all_options).positional(p).run(),
+          variables_map);
+    notify(variables_map);
+  } catch (program_options::error &e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  if (variables_map.contains("help")) {
+    std::cout << desc << "\n";
+    return EXIT_SUCCESS;
+  }
+
+  std::vector<std::string> files = {"-"};
+  if (variables_map.contains("file")) {
+    files = variables_map["file"].as<std::vector<std::string>>();
+  }
+
+  Printer printer(variables_map.contains("json"));
+  auto result = EXIT_SUCCESS;
+  for (const auto &file : files) {
+    if (file == "-") {
+      result = printer.print(STDIN_FILENO, "stdin") ? result : EXIT_FAILURE;
+      continue;
+    }
+    auto fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      std::cerr << "staxys-logcat: " << file << ": " << strerror(errno) << std::endl;
+      result = EXIT_FAILURE;
+      continue;
+    }
+    result = printer.print(fd, file) ? result : EXIT_FAILURE;
+    close(fd);
+  }
+  std::fflush(stdout);
+  return result;
+}